@@ -0,0 +1,144 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Generators for the documents used by the benchmarks. Everything here is deterministic, so
+// results are comparable between runs.
+
+namespace limes::serializing::benchmarks
+{
+
+/** Returns a JSON array of numRecords small, log-record-like objects. */
+[[nodiscard]] inline std::string makeRecordsJSON (std::size_t numRecords)
+{
+	std::string text { "[" };
+
+	for (auto i = 0UL; i < numRecords; ++i)
+	{
+		if (i > 0)
+			text += ",\n";
+
+		const auto idx = std::to_string (i);
+
+		text += R"({ "id": )" + idx
+			  + R"(, "name": "record number )" + idx
+			  + R"(", "level": ")" + (i % 7 == 0 ? "warning" : "info")
+			  + R"(", "tags": [ 1, 2, 3 ], "ok": )" + (i % 3 == 0 ? "false" : "true")
+			  + R"(, "parent": null })";
+	}
+
+	text += "]";
+
+	return text;
+}
+
+/** Returns a JSON document made of objects nested depth levels deep, each of which also holds a
+	few scalar values and a small array.
+ */
+[[nodiscard]] inline std::string makeNestedJSON (std::size_t depth)
+{
+	std::string text;
+
+	for (auto i = 0UL; i < depth; ++i)
+	{
+		const auto idx = std::to_string (i);
+
+		text += R"({ "level": )" + idx + R"(, "label": "level )" + idx + R"(", "values": [ 1, 2, 3 ], "child": )";
+	}
+
+	text += "null";
+	text.append (depth, '}');
+
+	return text;
+}
+
+/** Returns a JSON array of numStrings long strings, each made of the given sentence repeated
+	a number of times. This is for measuring the throughput of string scanning.
+ */
+[[nodiscard]] inline std::string makeTextJSON (std::size_t numStrings, std::string_view sentence)
+{
+	std::string text { "[" };
+
+	for (auto i = 0UL; i < numStrings; ++i)
+	{
+		text += i > 0 ? ",\n  \"" : "\n  \"";
+
+		for (auto j = 0UL; j < 8 + i % 8; ++j)
+			text += sentence;
+
+		text += '"';
+	}
+
+	text += "\n]";
+
+	return text;
+}
+
+/** Returns an XML feed of numEntries entries, each with attributes, text with an entity in it, and
+	a repeated child element. This is roughly the shape of an Atom or RSS feed.
+ */
+[[nodiscard]] inline std::string makeFeedXML (std::size_t numEntries)
+{
+	std::string text { "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<feed>\n" };
+
+	for (auto i = 0UL; i < numEntries; ++i)
+	{
+		const auto idx = std::to_string (i);
+
+		text += R"(  <entry id=")" + idx + R"(" lang=")" + (i % 5 == 0 ? "de" : "en") + R"(">)"
+			  + "\n    <title>Entry number " + idx + "</title>"
+			  + "\n    <summary>A short summary of entry " + idx + " &amp; the things it links to.</summary>"
+			  + "\n    <price currency=\"USD\">" + std::to_string (i % 100) + ".99</price>"
+			  + "\n    <tags><tag>news</tag><tag>item " + std::to_string (i % 10) + "</tag></tags>"
+			  + "\n  </entry>\n";
+	}
+
+	text += "</feed>\n";
+
+	return text;
+}
+
+/** Returns a YAML stream of numDocuments Kubernetes-style manifests, separated by \c --- . Each
+	document uses block mappings and sequences, flow sequences, a literal block scalar, comments,
+	an anchor with an alias of it, and a merge key.
+ */
+[[nodiscard]] inline std::string makeManifestsYAML (std::size_t numDocuments)
+{
+	std::string text { "# generated manifests\n" };
+
+	for (auto i = 0UL; i < numDocuments; ++i)
+	{
+		const auto idx = std::to_string (i);
+
+		text += "---\napiVersion: apps/v1\nkind: Deployment\nmetadata:\n  name: service-" + idx
+			  + "\n  labels: &labels\n    app: service-" + idx + "\n    tier: " + (i % 3 == 0 ? "frontend" : "backend")
+			  + "\nspec:\n  replicas: " + std::to_string (i % 5 + 1)
+			  + "\n  selector:\n    matchLabels: *labels"
+			  + "\n  template:\n    metadata:\n      labels:\n        <<: *labels\n        version: \"1." + std::to_string (i % 10) + "\""
+			  + "\n    spec:\n      containers:\n        - name: main  # the application\n          image: registry.example.com/service-" + idx
+			  + ":1.0\n          args: [--port, \"8080\", --verbose]\n          ports:\n            - containerPort: 8080\n              protocol: TCP"
+			  + "\n          resources:\n            limits: {cpu: 500m, memory: 128Mi}"
+			  + "\n          command:\n            - /bin/sh\n            - -c\n            - |\n              echo starting " + idx
+			  + "\n              exec /app/server\n";
+	}
+
+	return text;
+}
+
+}  // namespace limes::serializing::benchmarks
@@ -0,0 +1,71 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_Binary.h"
+#include "lserializing/lserializing_JSON.h"
+#include "BenchmarkData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <filesystem>
+#include <string>
+
+#define TAGS "[serializing][Binary][benchmark]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("Binary - opening a file and looking up one value", TAGS)
+{
+	const serial::JSONFormat   json;
+	const serial::BinaryFormat binary;
+
+	constexpr auto numRecords = 500000UL;
+
+	const auto jsonPath	  = std::filesystem::temp_directory_path() / "lserial_benchmark_records.json";
+	const auto binaryPath = std::filesystem::temp_directory_path() / "lserial_benchmark_records.lsb";
+
+	{
+		const auto records = json.parse (serial::benchmarks::makeRecordsJSON (numRecords));
+
+		json.serializeToFile (records, jsonPath);
+		binary.serializeToFile (records, binaryPath);
+	}
+
+	BENCHMARK ("JSON: parseFile, then look up")
+	{
+		const auto root = json.parseFile (jsonPath);
+		return root[numRecords / 2]["name"].getString().size();
+	};
+
+	BENCHMARK ("Binary: parseFile, then look up")
+	{
+		const auto root = binary.parseFile (binaryPath);
+		return root[numRecords / 2]["name"].getString().size();
+	};
+
+	BENCHMARK ("Binary: map the file, then look up in place")
+	{
+		const serial::BinaryFile file { binaryPath };
+		return file.getRoot()[numRecords / 2]["name"].getString().size();
+	};
+
+	const serial::BinaryFile file { binaryPath };
+
+	BENCHMARK ("Binary: look up in an open file")
+	{
+		return file.getRoot()[numRecords / 2]["name"].getString().size();
+	};
+
+	std::filesystem::remove (jsonPath);
+	std::filesystem::remove (binaryPath);
+}
@@ -0,0 +1,90 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_CBOR.h"
+#include "lserializing/lserializing_JSON.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cmath>
+#include <string>
+
+#define TAGS "[serializing][CBOR][benchmark]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("CBOR - numeric arrays", TAGS)
+{
+	const serial::JSONFormat json;
+	const serial::CBORFormat cbor;
+
+	constexpr auto numSamples = 1000000;
+
+	serial::Node samples { serial::ObjectType::Array };
+
+	for (auto i = 0; i < numSamples; ++i)
+		samples.addChildNumber (std::sin (i * 0.001) * 1000.);
+
+	serial::CBORPrinterOptions options;
+	options.typedArrays = true;
+
+	const auto typedPrinter = cbor.createPrinter (options);
+
+	const auto jsonText = json.serialize (samples);
+	const auto plain	= cbor.serialize (samples);
+	const auto typed	= typedPrinter->print (samples);
+
+	// the sizes are part of the names, so that they appear in the results
+	const auto suffix = " (JSON " + std::to_string (jsonText.size()) + " bytes, CBOR " + std::to_string (plain.size())
+					  + " bytes, typed array " + std::to_string (typed.size()) + " bytes)";
+
+	BENCHMARK ("JSON: serialize" + suffix)
+	{
+		return json.serialize (samples);
+	};
+
+	BENCHMARK ("CBOR: serialize" + suffix)
+	{
+		return cbor.serialize (samples);
+	};
+
+	BENCHMARK ("CBOR typed array: serialize" + suffix)
+	{
+		return typedPrinter->print (samples);
+	};
+
+	BENCHMARK ("JSON: parse" + suffix)
+	{
+		return json.parse (jsonText);
+	};
+
+	BENCHMARK ("CBOR: parse" + suffix)
+	{
+		return cbor.parse (plain);
+	};
+
+	BENCHMARK ("CBOR typed array: parse" + suffix)
+	{
+		return cbor.parse (typed);
+	};
+
+	BENCHMARK ("CBOR: parseNumberArray" + suffix)
+	{
+		return cbor.parseNumberArray (plain);
+	};
+
+	BENCHMARK ("CBOR typed array: parseNumberArray" + suffix)
+	{
+		return cbor.parseNumberArray (typed);
+	};
+}
@@ -0,0 +1,103 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_Columns.h"
+#include "lserializing/lserializing_Node.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define TAGS "[serializing][Columns][benchmark]"
+
+namespace serial = limes::serializing;
+using Node		 = serial::Node;
+using ObjectType = serial::ObjectType;
+
+// a million rows is about as many as fit in memory as Nodes on a small machine; the columns themselves take a fraction of that
+static constexpr auto numRows = std::size_t { 1000000 };
+
+static Node makeRows()
+{
+	Node array { ObjectType::Array };
+
+	for (auto i = 0UL; i < numRows; ++i)
+	{
+		auto& row = array.addChildObject();
+
+		row.addChildNumber (static_cast<double> (i), "id");
+		row.addChildNumber (static_cast<double> (i % 1000) * 0.25, "price");
+		row.addChildString ("record number " + std::to_string (i), "name");
+		row.addChildBoolean (i % 3 == 0, "ok");
+
+		if (i % 5 == 0)
+			row.addChildNull ("parent");
+		else
+			row.addChildNumber (static_cast<double> (i / 5), "parent");
+	}
+
+	return array;
+}
+
+TEST_CASE ("Columns - converting a million rows", TAGS)
+{
+	const auto rows = makeRows();
+
+	// the conversion this replaces: walking operator[] for every row and field
+	BENCHMARK ("Node::operator[]: gather columns")
+	{
+		std::vector<double>		 ids, prices, parents;
+		std::vector<std::string> names;
+		std::vector<bool>		 oks;
+
+		for (auto i = 0UL; i < rows.getNumChildren(); ++i)
+		{
+			const auto& row = rows[i];
+
+			ids.push_back (row["id"].getNumber());
+			prices.push_back (row["price"].getNumber());
+			names.emplace_back (row["name"].getString());
+			oks.push_back (row["ok"].getBoolean());
+
+			const auto& parent = row["parent"];
+			parents.push_back (parent.isNull() ? 0. : parent.getNumber());
+		}
+
+		return ids.size() + prices.size() + names.size() + oks.size() + parents.size();
+	};
+
+	BENCHMARK ("toColumns: one thread")
+	{
+		return serial::toColumns (rows);
+	};
+
+	BENCHMARK ("toColumns: all threads")
+	{
+		return serial::toColumns (rows, 0);
+	};
+
+	const auto table = serial::toColumns (rows);
+
+	BENCHMARK ("fromColumns: one thread")
+	{
+		return serial::fromColumns (table);
+	};
+
+	BENCHMARK ("fromColumns: all threads")
+	{
+		return serial::fromColumns (table, 0);
+	};
+}
@@ -0,0 +1,69 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_Compression.h"
+#include "lserializing/lserializing_JSON.h"
+#include "BenchmarkData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <filesystem>
+#include <string>
+
+#define TAGS "[serializing][Compression][benchmark]"
+
+namespace serial = limes::serializing;
+using serial::CompressionType;
+
+TEST_CASE ("Compression - loading a compressed snapshot", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto node = format.parse (serial::benchmarks::makeRecordsJSON (200000));
+
+	for (const auto type : { CompressionType::None, CompressionType::LZ4, CompressionType::Gzip })
+	{
+		if (! serial::isCompressionAvailable (type))
+			continue;
+
+		const auto path = std::filesystem::temp_directory_path()
+						/ ("lserial_benchmark_snapshot.json" + std::string { serial::getFileExtension (type) });
+
+		format.serializeToFile (node, path, false, type);
+
+		const auto name = std::string { type == CompressionType::None ? "uncompressed" : serial::getFileExtension (type) }
+						+ " (" + std::to_string (std::filesystem::file_size (path)) + " bytes)";
+
+		BENCHMARK ("serializeToFile: " + name)
+		{
+			format.serializeToFile (node, path, false, type);
+		};
+
+		BENCHMARK ("parseFile: " + name)
+		{
+			return format.parseFile (path);
+		};
+
+		if (type != CompressionType::None)
+		{
+			const auto compressed = serial::compress (format.serialize (node), type);
+
+			BENCHMARK ("decompress only: " + name)
+			{
+				return serial::decompress (compressed);
+			};
+		}
+
+		std::filesystem::remove (path);
+	}
+}
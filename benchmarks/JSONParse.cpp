@@ -0,0 +1,73 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_JSON.h"
+#include "BenchmarkData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <string>
+#include <thread>
+
+#define TAGS "[serializing][JSON][benchmark]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("JSON - parsing mostly-ASCII and CJK-heavy documents", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto records = serial::benchmarks::makeRecordsJSON (50000);
+	const auto ascii   = serial::benchmarks::makeTextJSON (5000, "The quick brown fox jumps over the lazy dog. ");
+	const auto cjk	   = serial::benchmarks::makeTextJSON (5000, "\xE6\x95\x8F\xE6\x8D\xB7\xE7\x9A\x84\xE6\xA3\x95\xE8\x89\xB2"
+																	 "\xE7\x8B\x90\xE7\x8B\xB8\xE8\xB7\xB3\xE8\xBF\x87\xE4\xBA\x86"
+																	 "\xE9\x82\xA3\xE5\x8F\xAA\xE6\x87\x92\xE7\x8B\x97\xE3\x80\x82");
+
+	BENCHMARK ("parse, records")
+	{
+		return format.parse (records);
+	};
+
+	BENCHMARK ("parse, ASCII text")
+	{
+		return format.parse (ascii);
+	};
+
+	BENCHMARK ("parse, CJK text")
+	{
+		return format.parse (cjk);
+	};
+}
+
+TEST_CASE ("JSON - parallel parsing of a large array", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto text = serial::benchmarks::makeRecordsJSON (250000);
+
+	BENCHMARK ("parse")
+	{
+		return format.parse (text);
+	};
+
+	const auto maxThreads = std::max (1U, std::thread::hardware_concurrency());
+
+	for (auto numThreads = 1U; numThreads <= maxThreads; ++numThreads)
+	{
+		BENCHMARK ("parseParallel, " + std::to_string (numThreads) + " thread(s)")
+		{
+			return format.parseParallel (text, numThreads);
+		};
+	}
+}
@@ -0,0 +1,252 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_JSON.h"
+#include "lserializing/lserializing_Serializer.h"
+#include "lserializing/lserializing_SHA256Sink.h"
+#include "BenchmarkData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#define TAGS "[serializing][JSON][benchmark]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("JSON - serializing wide and deep trees", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto wide = format.parse (serial::benchmarks::makeRecordsJSON (50000));
+	const auto deep = format.parse (serial::benchmarks::makeNestedJSON (500));
+
+	BENCHMARK ("serialize, wide")
+	{
+		return format.serialize (wide);
+	};
+
+	BENCHMARK ("serialize into a StringSink, wide")
+	{
+		serial::StringSink sink;
+		format.serialize (wide, sink);
+		return sink.getString().size();
+	};
+
+	BENCHMARK ("serialize, deep")
+	{
+		return format.serialize (deep);
+	};
+
+	BENCHMARK ("serialize into a StringSink, deep")
+	{
+		serial::StringSink sink;
+		format.serialize (deep, sink);
+		return sink.getString().size();
+	};
+}
+
+TEST_CASE ("JSON - escaping ASCII-heavy and emoji-heavy strings", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto ascii = format.parse (serial::benchmarks::makeTextJSON (5000, "The quick brown fox jumps over the lazy dog. "));
+	const auto emoji = format.parse (serial::benchmarks::makeTextJSON (5000, "Launch day \xF0\x9F\x9A\x80\xF0\x9F\x8E\x89 so excited \xF0\x9F\x98\x80\xE2\x9C\xA8 "));
+
+	const auto escapingPrinter = format.createPrinter (serial::JSONPrinterOptions {});
+	const auto utf8Printer	   = format.createPrinter (serial::JSONPrinterOptions { .escapeNonASCII = false });
+
+	BENCHMARK ("serialize with \\u escapes, ASCII text")
+	{
+		return escapingPrinter->print (ascii);
+	};
+
+	BENCHMARK ("serialize with \\u escapes, emoji text")
+	{
+		return escapingPrinter->print (emoji);
+	};
+
+	BENCHMARK ("serialize raw UTF-8, ASCII text")
+	{
+		return utf8Printer->print (ascii);
+	};
+
+	BENCHMARK ("serialize raw UTF-8, emoji text")
+	{
+		return utf8Printer->print (emoji);
+	};
+}
+
+TEST_CASE ("JSON - measuring output before serializing", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto text = format.parse (serial::benchmarks::makeTextJSON (20000, "The quick brown fox jumps over the lazy dog. "));
+
+	const auto path = std::filesystem::temp_directory_path() / "lserializing_JSONSerialize.json";
+
+	BENCHMARK ("serialize into a growing StringSink")
+	{
+		serial::StringSink sink;
+		format.serialize (text, sink);
+		return sink.getString().size();
+	};
+
+	BENCHMARK ("serialize, measured first")
+	{
+		return format.serialize (text);
+	};
+
+	BENCHMARK ("serialize into a FileSink")
+	{
+		serial::FileSink sink { path };
+		format.serialize (text, sink);
+		sink.flush();
+	};
+
+	BENCHMARK ("serializeToFile, measured and preallocated")
+	{
+		format.serializeToFile (text, path);
+	};
+
+	std::filesystem::remove (path);
+}
+
+TEST_CASE ("JSON - serializing many small messages", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto records = format.parse (serial::benchmarks::makeRecordsJSON (1000));
+
+	const auto& messages = records.getArray();
+
+	BENCHMARK ("Format::serialize, 1000 messages")
+	{
+		std::size_t total { 0 };
+
+		for (const auto& message : messages)
+			total += format.serialize (message).size();
+
+		return total;
+	};
+
+	serial::Serializer serializer { format };
+
+	BENCHMARK ("Serializer::serialize, 1000 messages")
+	{
+		std::size_t total { 0 };
+
+		for (const auto& message : messages)
+			total += serializer.serialize (message).size();
+
+		return total;
+	};
+
+	std::string batch;
+
+	BENCHMARK ("Serializer::serializeInto a reused buffer, 1000 messages")
+	{
+		batch.clear();
+
+		for (const auto& message : messages)
+			serializer.serializeInto (message, batch);
+
+		return batch.size();
+	};
+}
+
+TEST_CASE ("JSON - parallel serializing of a large array", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto records = format.parse (serial::benchmarks::makeRecordsJSON (250000));
+
+	BENCHMARK ("serialize")
+	{
+		return format.serialize (records);
+	};
+
+	const auto maxThreads = std::max (1U, std::thread::hardware_concurrency());
+
+	for (auto numThreads = 1U; numThreads <= maxThreads; ++numThreads)
+	{
+		BENCHMARK ("serializeParallel, " + std::to_string (numThreads) + " thread(s)")
+		{
+			return format.serializeParallel (records, numThreads);
+		};
+	}
+}
+
+TEST_CASE ("JSON - canonicalizing and hashing", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto records = format.parse (serial::benchmarks::makeRecordsJSON (50000));
+
+	const auto printer = format.createPrinter (serial::JSONPrinterOptions { .canonical = true });
+
+	const auto canonical = printer->print (records);
+
+	BENCHMARK ("SHA-256 of the canonical text")
+	{
+		serial::SHA256Sink sink;
+		sink.write (canonical);
+		return sink.getDigest();
+	};
+
+	BENCHMARK ("canonicalize into a string, then hash")
+	{
+		serial::SHA256Sink sink;
+		sink.write (printer->print (records));
+		return sink.getDigest();
+	};
+
+	BENCHMARK ("canonicalize straight into a SHA256Sink")
+	{
+		serial::SHA256Sink sink;
+		printer->print (records, sink);
+		return sink.getDigest();
+	};
+}
+
+TEST_CASE ("JSON - chunked printing", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto records = format.parse (serial::benchmarks::makeRecordsJSON (50000));
+
+	BENCHMARK ("print into a CountingSink")
+	{
+		return format.createPrinter ({})->measure (records);
+	};
+
+	for (const auto chunkSize : { 1024UL, 16384UL, 65536UL })
+	{
+		BENCHMARK ("read in chunks of " + std::to_string (chunkSize) + " bytes")
+		{
+			const auto printer = format.createChunkedPrinter (records);
+
+			std::string chunk (chunkSize, '\0');
+
+			std::size_t total = 0;
+
+			while (const auto size = printer->read (chunk.data(), chunk.size()))
+				total += size;
+
+			return total;
+		};
+	}
+}
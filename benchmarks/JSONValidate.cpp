@@ -0,0 +1,53 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_JSON.h"
+#include "BenchmarkData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#define TAGS "[serializing][JSON][benchmark]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("JSON - validation vs parse and discard", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto records = serial::benchmarks::makeRecordsJSON (50000);
+	const auto text	   = serial::benchmarks::makeTextJSON (5000, "The quick brown fox jumps over the lazy dog. ");
+
+	REQUIRE (format.validate (records));
+	REQUIRE (format.validate (text));
+
+	BENCHMARK ("validate, records")
+	{
+		return format.validate (records);
+	};
+
+	BENCHMARK ("tryParse and discard, records")
+	{
+		return format.tryParse (records).hasValue();
+	};
+
+	BENCHMARK ("validate, text")
+	{
+		return format.validate (text);
+	};
+
+	BENCHMARK ("tryParse and discard, text")
+	{
+		return format.tryParse (text).hasValue();
+	};
+}
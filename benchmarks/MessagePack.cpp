@@ -0,0 +1,68 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_JSON.h"
+#include "lserializing/lserializing_MessagePack.h"
+#include "BenchmarkData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <string>
+#include <utility>
+
+#define TAGS "[serializing][MessagePack][benchmark]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("MessagePack - encoding and decoding compared to JSON", TAGS)
+{
+	const serial::JSONFormat		json;
+	const serial::MessagePackFormat msgpack;
+
+	const std::pair<const char*, std::string> documents[] = {
+		{ "records", serial::benchmarks::makeRecordsJSON (50000) },
+		{ "nested", serial::benchmarks::makeNestedJSON (500) }
+	};
+
+	for (const auto& [name, text] : documents)
+	{
+		const auto node = json.parse (text);
+
+		const auto jsonText = json.serialize (node);
+		const auto encoded	= msgpack.serialize (node);
+
+		// the sizes are part of the names, so that they appear in the results
+		const auto suffix = std::string { ", " } + name + " (JSON " + std::to_string (jsonText.size())
+						  + " bytes, MessagePack " + std::to_string (encoded.size()) + " bytes)";
+
+		BENCHMARK ("JSON: serialize" + suffix)
+		{
+			return json.serialize (node);
+		};
+
+		BENCHMARK ("MessagePack: serialize" + suffix)
+		{
+			return msgpack.serialize (node);
+		};
+
+		BENCHMARK ("JSON: parse" + suffix)
+		{
+			return json.parse (jsonText);
+		};
+
+		BENCHMARK ("MessagePack: parse" + suffix)
+		{
+			return msgpack.parse (encoded);
+		};
+	}
+}
@@ -0,0 +1,72 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_JSON.h"
+#include "lserializing/lserializing_MessagePack.h"
+#include "lserializing/lserializing_Packed.h"
+#include "BenchmarkData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <string>
+
+#define TAGS "[serializing][Packed][benchmark]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("Packed - a log corpus compared to JSON and MessagePack", TAGS)
+{
+	const serial::JSONFormat		json;
+	const serial::MessagePackFormat msgpack;
+	const serial::PackedFormat		packed;
+
+	const auto node = json.parse (serial::benchmarks::makeRecordsJSON (100000));
+
+	const auto jsonText	   = json.serialize (node);
+	const auto msgpackData = msgpack.serialize (node);
+	const auto packedData  = packed.serialize (node);
+
+	// the sizes are part of the names, so that they appear in the results
+	const auto suffix = " (JSON " + std::to_string (jsonText.size()) + " bytes, MessagePack " + std::to_string (msgpackData.size())
+					  + " bytes, Packed " + std::to_string (packedData.size()) + " bytes)";
+
+	BENCHMARK ("JSON: serialize" + suffix)
+	{
+		return json.serialize (node);
+	};
+
+	BENCHMARK ("MessagePack: serialize" + suffix)
+	{
+		return msgpack.serialize (node);
+	};
+
+	BENCHMARK ("Packed: serialize" + suffix)
+	{
+		return packed.serialize (node);
+	};
+
+	BENCHMARK ("JSON: parse" + suffix)
+	{
+		return json.parse (jsonText);
+	};
+
+	BENCHMARK ("MessagePack: parse" + suffix)
+	{
+		return msgpack.parse (msgpackData);
+	};
+
+	BENCHMARK ("Packed: parse" + suffix)
+	{
+		return packed.parse (packedData);
+	};
+}
@@ -0,0 +1,67 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_JSON.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <array>
+#include <string_view>
+
+#define TAGS "[serializing][JSON][benchmark]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("JSON - cost of rejecting invalid input", TAGS)
+{
+	const serial::JSONFormat format;
+
+	static constexpr std::array<std::string_view, 6> inputs {
+		R"({ "key": "value", "other": [ 1, 2, 3, )",
+		R"([ 1, 2, 3 ] ])",
+		R"({ "a": tru })",
+		"key: value\nother: [1, 2, 3]\n",
+		"<root><child attr=\"1\"/></root>",
+		"[section]\nkey = value\n"
+	};
+
+	BENCHMARK ("parse() and catch the ParseError")
+	{
+		int numRejected = 0;
+
+		for (const auto input : inputs)
+		{
+			try
+			{
+				[[maybe_unused]] const auto node = format.parse (input);
+			}
+			catch (const serial::ParseError&)
+			{
+				++numRejected;
+			}
+		}
+
+		return numRejected;
+	};
+
+	BENCHMARK ("tryParse()")
+	{
+		int numRejected = 0;
+
+		for (const auto input : inputs)
+			if (! format.tryParse (input))
+				++numRejected;
+
+		return numRejected;
+	};
+}
@@ -0,0 +1,65 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_JSON.h"
+#include "BenchmarkData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#define TAGS "[serializing][JSON][benchmark]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("JSON - parsing from a file", TAGS)
+{
+	const serial::JSONFormat format;
+
+	for (const auto numMegabytes : { 10UL, 100UL })
+	{
+		const auto path = std::filesystem::temp_directory_path()
+						/ ("lserial_benchmark_" + std::to_string (numMegabytes) + "MB.json");
+
+		{
+			// each string is 360-675 bytes, so this gives roughly the requested file size
+			const auto text = serial::benchmarks::makeTextJSON (numMegabytes * 2000,
+																"The quick brown fox jumps over the lazy dog. ");
+
+			std::ofstream stream { path, std::ios::binary };
+			stream << text;
+		}
+
+		const auto sizeName = std::to_string (numMegabytes) + " MB";
+
+		BENCHMARK ("read into a string, then parse, " + sizeName)
+		{
+			std::string text (std::filesystem::file_size (path), '\0');
+
+			std::ifstream stream { path, std::ios::binary };
+			stream.read (text.data(), static_cast<std::streamsize> (text.size()));
+
+			return format.parse (text);
+		};
+
+		BENCHMARK ("parseFile, " + sizeName)
+		{
+			return format.parseFile (path);
+		};
+
+		std::filesystem::remove (path);
+	}
+}
@@ -0,0 +1,102 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_Printer.h"
+#include "lserializing/lserializing_StaticPrinter.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include "lserializing/lserializing_Node.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <string_view>
+
+#define TAGS "[serializing][Printer][benchmark]"
+
+namespace serial = limes::serializing;
+
+// Both printers write one character per value, so that the cost of dispatching on each node
+// dominates. They differ only in their base class.
+template <class Base>
+class ScalarPrinter : public Base
+{
+public:
+	void printNull (serial::OutputSink& sink) final
+	{
+		sink.write ('n');
+	}
+
+	void printNumber (double, serial::OutputSink& sink) final
+	{
+		sink.write ('0');
+	}
+
+	void printString (std::string_view, serial::OutputSink& sink) final
+	{
+		sink.write ('s');
+	}
+
+	void printBoolean (bool, serial::OutputSink& sink) final
+	{
+		sink.write ('b');
+	}
+
+	void printArray (const serial::Array& array, serial::OutputSink& sink) final
+	{
+		for (const auto& element : array)
+			this->print (element, sink);
+	}
+
+	void printObject (const serial::Object& object, serial::OutputSink& sink) final
+	{
+		for (const auto& element : object)
+			this->print (element.second, sink);
+	}
+};
+
+class VirtualScalarPrinter final : public ScalarPrinter<serial::Printer>
+{
+};
+
+class StaticScalarPrinter final : public ScalarPrinter<serial::StaticPrinter<StaticScalarPrinter>>
+{
+};
+
+TEST_CASE ("Printer - per-node dispatch on millions of scalars", TAGS)
+{
+	serial::Node root { serial::ObjectType::Array };
+
+	for (auto i = 0; i < 2000000; ++i)
+	{
+		switch (i % 3)
+		{
+			case 0 : root.addChildNumber (static_cast<double> (i)); break;
+			case 1 : root.addChildBoolean (i % 2 == 0); break;
+			default : root.addChildNull(); break;
+		}
+	}
+
+	VirtualScalarPrinter virtualPrinter;
+	StaticScalarPrinter	 staticPrinter;
+
+	REQUIRE (virtualPrinter.measure (root) == staticPrinter.measure (root));
+
+	BENCHMARK ("virtual Printer")
+	{
+		return virtualPrinter.measure (root);
+	};
+
+	BENCHMARK ("StaticPrinter")
+	{
+		return staticPrinter.measure (root);
+	};
+}
@@ -0,0 +1,77 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_JSON.h"
+#include "lserializing/lserializing_Protobuf.h"
+#include "BenchmarkData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <string>
+
+#define TAGS "[serializing][Protobuf][benchmark]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("Protobuf - encoding and decoding compared to JSON", TAGS)
+{
+	const serial::JSONFormat json;
+
+	const serial::ProtobufFormat protobuf { json.parse (R"({
+		"root": "Log",
+		"messages": {
+			"Log": {
+				"records": { "number": 1, "type": "message", "message": "Record", "repeated": true }
+			},
+			"Record": {
+				"id":     { "number": 1, "type": "int64" },
+				"name":   { "number": 2, "type": "string" },
+				"level":  { "number": 3, "type": "string" },
+				"tags":   { "number": 4, "type": "int32", "repeated": true },
+				"ok":     { "number": 5, "type": "bool" },
+				"parent": { "number": 6, "type": "message", "message": "Record" }
+			}
+		}
+	})") };
+
+	// a protobuf message must be an object, so the records are wrapped in one
+	const auto text = R"({ "records": )" + serial::benchmarks::makeRecordsJSON (50000) + " }";
+
+	const auto node = json.parse (text);
+
+	const auto jsonText = json.serialize (node);
+	const auto encoded	= protobuf.serialize (node);
+
+	// the sizes are part of the names, so that they appear in the results
+	const auto suffix = " (JSON " + std::to_string (jsonText.size()) + " bytes, Protobuf " + std::to_string (encoded.size()) + " bytes)";
+
+	BENCHMARK ("JSON: serialize" + suffix)
+	{
+		return json.serialize (node);
+	};
+
+	BENCHMARK ("Protobuf: serialize" + suffix)
+	{
+		return protobuf.serialize (node);
+	};
+
+	BENCHMARK ("JSON: parse" + suffix)
+	{
+		return json.parse (jsonText);
+	};
+
+	BENCHMARK ("Protobuf: parse" + suffix)
+	{
+		return protobuf.parse (encoded);
+	};
+}
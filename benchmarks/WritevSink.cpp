@@ -0,0 +1,138 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_JSON.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#if ! defined(_WIN32)
+#	include <fcntl.h>
+#	include <unistd.h>
+
+#	define TAGS "[serializing][JSON][benchmark]"
+
+namespace serial = limes::serializing;
+
+// 2000 strings of 8 KiB each, which need no escaping
+static serial::Node makeStringHeavyDocument()
+{
+	serial::Node root { serial::ObjectType::Array };
+
+	std::string text;
+
+	while (text.size() < 8192)
+		text += "The quick brown fox jumps over the lazy dog. ";
+
+	for (auto i = 0; i < 2000; ++i)
+		root.addChildString (std::to_string (i) + text, "");
+
+	return root;
+}
+
+// writes the whole string, retrying after partial writes
+static void writeAll (int fd, const std::string& text)
+{
+	for (std::size_t offset = 0; offset < text.size();)
+	{
+		const auto numWritten = ::write (fd, text.data() + offset, text.size() - offset);
+
+		if (numWritten <= 0)
+			return;
+
+		offset += static_cast<std::size_t> (numWritten);
+	}
+}
+
+TEST_CASE ("JSON - writing string-heavy documents to a file", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto document = makeStringHeavyDocument();
+
+	const auto path = std::filesystem::temp_directory_path() / "lserializing_WritevSink.json";
+
+	BENCHMARK ("serialize to a string, then write()")
+	{
+		const auto fd = ::open (path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		writeAll (fd, format.serialize (document));
+		::close (fd);
+	};
+
+	BENCHMARK ("FileSink")
+	{
+		serial::FileSink sink { path };
+		format.serialize (document, sink);
+		sink.flush();
+	};
+
+	BENCHMARK ("WritevSink")
+	{
+		const auto fd = ::open (path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+		{
+			serial::WritevSink sink { fd };
+			format.serialize (document, sink);
+			sink.flush();
+		}
+
+		::close (fd);
+	};
+
+	std::filesystem::remove (path);
+}
+
+TEST_CASE ("JSON - writing string-heavy documents to a pipe", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto document = makeStringHeavyDocument();
+
+	int fds[2];
+
+	REQUIRE (::pipe (fds) == 0);
+
+	// drains the pipe for as long as the benchmarks run
+	std::thread reader { [fd = fds[0]]
+						 {
+							 char buffer[65536];
+
+							 while (::read (fd, buffer, sizeof (buffer)) > 0)
+								 ;
+						 } };
+
+	BENCHMARK ("serialize to a string, then write()")
+	{
+		writeAll (fds[1], format.serialize (document));
+	};
+
+	BENCHMARK ("WritevSink")
+	{
+		serial::WritevSink sink { fds[1] };
+		format.serialize (document, sink);
+		sink.flush();
+	};
+
+	::close (fds[1]);
+
+	reader.join();
+
+	::close (fds[0]);
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_XML.h"
+#include "lserializing/lserializing_JSON.h"
+#include "BenchmarkData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#define TAGS "[serializing][XML][benchmark]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("XML - parsing", TAGS)
+{
+	const serial::XMLFormat	 xml;
+	const serial::JSONFormat json;
+
+	const auto text = serial::benchmarks::makeFeedXML (50000);
+
+	// the same data as JSON, for comparison
+	const auto jsonText = json.serialize (xml.parse (text));
+
+	// counts the events, so that the SAX benchmark measures the parser alone
+	struct Counter final : public serial::XMLHandler
+	{
+		void startElement (std::string_view, std::span<const serial::XMLAttribute> attributes) final
+		{
+			numElements += 1;
+			numAttributes += attributes.size();
+		}
+
+		void endElement (std::string_view) final
+		{
+		}
+
+		void text (std::string_view text) final
+		{
+			numTextBytes += text.size();
+		}
+
+		std::size_t numElements { 0 }, numAttributes { 0 }, numTextBytes { 0 };
+	};
+
+	// the sizes are part of the names, so that throughput can be worked out from the results
+	const auto suffix = " (XML " + std::to_string (text.size()) + " bytes, JSON " + std::to_string (jsonText.size()) + " bytes)";
+
+	BENCHMARK ("XML: parse to Nodes" + suffix)
+	{
+		return xml.parse (text);
+	};
+
+	BENCHMARK ("XML: SAX events only" + suffix)
+	{
+		Counter counter;
+		xml.parse (text, counter);
+		return counter.numElements + counter.numAttributes + counter.numTextBytes;
+	};
+
+	BENCHMARK ("JSON: parse to Nodes" + suffix)
+	{
+		return json.parse (jsonText);
+	};
+}
+
+TEST_CASE ("XML - printing compared to JSON", TAGS)
+{
+	const serial::XMLFormat	 xml;
+	const serial::JSONFormat json;
+
+	const std::pair<const char*, serial::Node> documents[] = {
+		{ "records", json.parse (serial::benchmarks::makeRecordsJSON (50000)) },
+		{ "feed", xml.parse (serial::benchmarks::makeFeedXML (50000)) }
+	};
+
+	for (const auto& [name, node] : documents)
+	{
+		// the sizes are part of the names, so that throughput can be worked out from the results
+		const auto suffix = std::string { ", " } + name + " (XML " + std::to_string (xml.serialize (node).size())
+						  + " bytes, JSON " + std::to_string (json.serialize (node).size()) + " bytes)";
+
+		BENCHMARK ("XML: serialize" + suffix)
+		{
+			return xml.serialize (node);
+		};
+
+		BENCHMARK ("JSON: serialize" + suffix)
+		{
+			return json.serialize (node);
+		};
+	}
+}
@@ -0,0 +1,97 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_YAML.h"
+#include "lserializing/lserializing_JSON.h"
+#include "BenchmarkData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cstddef>
+#include <string>
+
+#define TAGS "[serializing][YAML][benchmark]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("YAML - parsing compared to JSON", TAGS)
+{
+	const serial::YAMLFormat yaml;
+	const serial::JSONFormat json;
+
+	const auto text = serial::benchmarks::makeManifestsYAML (5000);
+
+	// the same data as JSON, for comparison
+	const auto node		= yaml.parse (text);
+	const auto jsonText = json.serialize (node);
+
+	// the sizes are part of the names, so that throughput can be worked out from the results
+	const auto suffix = " (YAML " + std::to_string (text.size()) + " bytes, JSON " + std::to_string (jsonText.size()) + " bytes)";
+
+	BENCHMARK ("YAML: parse" + suffix)
+	{
+		return yaml.parse (text);
+	};
+
+	BENCHMARK ("JSON: parse" + suffix)
+	{
+		return json.parse (jsonText);
+	};
+
+	BENCHMARK ("YAML: serialize" + suffix)
+	{
+		return yaml.serialize (node);
+	};
+
+	BENCHMARK ("JSON: serialize" + suffix)
+	{
+		return json.serialize (node);
+	};
+}
+
+TEST_CASE ("YAML - streaming documents", TAGS)
+{
+	const serial::YAMLFormat yaml;
+
+	const auto text = serial::benchmarks::makeManifestsYAML (20000);
+
+	const auto suffix = " (" + std::to_string (text.size()) + " bytes)";
+
+	// counts the documents, so that they're freed as they arrive
+	auto parseWithThreads = [&yaml, &text] (std::size_t numThreads)
+	{
+		auto numDocuments = std::size_t { 0 };
+
+		yaml.parseDocuments (
+			text, [&numDocuments] (serial::Node& document)
+			{ numDocuments += document.getNumChildren(); },
+			numThreads);
+
+		return numDocuments;
+	};
+
+	BENCHMARK ("YAML: parse into a vector" + suffix)
+	{
+		return yaml.parseDocuments (text);
+	};
+
+	BENCHMARK ("YAML: stream with a callback" + suffix)
+	{
+		return parseWithThreads (1);
+	};
+
+	BENCHMARK ("YAML: stream with a callback, all hardware threads" + suffix)
+	{
+		return parseWithThreads (0);
+	};
+}
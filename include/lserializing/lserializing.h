@@ -87,7 +87,6 @@
 	@todo SerializedNumber - store the value as a double, but retain info about number of decimal places, etc
 	@todo MusicXML wrapper library
 	@todo nlohmann json integration
-	@todo protobuf integration
 	@todo docs
 	@todo make all format classes public and document them
 	@todo CLI tool for converting serialization formats
@@ -111,11 +110,26 @@
 
 // IWYU pragma: begin_exports
 #include "lserializing/lserializing_Version.h"
+// #include "lserializing/lserializing_Binary.h"
+// #include "lserializing/lserializing_CBOR.h"
+#include "lserializing/lserializing_ChunkedPrinter.h"
+#include "lserializing/lserializing_Columns.h"
+#include "lserializing/lserializing_Compression.h"
 #include "lserializing/lserializing_Enums.h"
+// #include "lserializing/lserializing_JSON.h"
 // #include "lserializing/lserializing_KnownFormats.h"
+// #include "lserializing/lserializing_MessagePack.h"
 #include "lserializing/lserializing_Node.h"
+#include "lserializing/lserializing_OutputSink.h"
+// #include "lserializing/lserializing_Packed.h"
 #include "lserializing/lserializing_Printer.h"
+// #include "lserializing/lserializing_Protobuf.h"
 #include "lserializing/lserializing_Schema.h"
 #include "lserializing/lserializing_SerializableData.h"
+#include "lserializing/lserializing_Serializer.h"
 // #include "lserializing/lserializing_SerializingFormat.h"
+#include "lserializing/lserializing_SHA256Sink.h"
+#include "lserializing/lserializing_StaticPrinter.h"
+// #include "lserializing/lserializing_XML.h"
+// #include "lserializing/lserializing_YAML.h"
 // IWYU pragma: end_exports
@@ -0,0 +1,276 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "lserializing/lserializing_Export.h"
+#include "lserializing/lserializing_SerializingFormat.h"
+#include "lserializing/lserializing_Node.h"
+
+/** @file
+	This file defines the serializing::BinaryFormat, serializing::BinaryView and
+	serializing::BinaryFile classes.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+class MappedFile;
+
+/** A read-only view of one value inside a document in the native binary format.
+
+	A view is just a pointer into the document's bytes, so creating, copying and querying views
+	never allocates or copies any data: strings are returned as views into the document, array
+	elements are found through an offset table, and object members are found by a binary search
+	over the object's sorted key table. This offers the same query API as \c Node , so code that
+	reads a tree can usually be switched to a binary document just by changing types.
+
+	The document's bytes must stay alive and unchanged for as long as any view into them is used.
+
+	Views check every offset they follow against the bounds of the document, so a corrupt or
+	malicious document can't cause reads outside of it; a \c ParseError is thrown instead.
+
+	@see BinaryFormat::createView(), BinaryFile
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT BinaryView final
+{
+public:
+	/** @name Type queries */
+	///@{
+	/** Returns true if this value is a Number. */
+	[[nodiscard]] bool isNumber() const noexcept;
+
+	/** Returns true if this value is a String. */
+	[[nodiscard]] bool isString() const noexcept;
+
+	/** Returns true if this value is a Boolean. */
+	[[nodiscard]] bool isBoolean() const noexcept;
+
+	/** Returns true if this value is an Array. */
+	[[nodiscard]] bool isArray() const noexcept;
+
+	/** Returns true if this value is an Object. */
+	[[nodiscard]] bool isObject() const noexcept;
+
+	/** Returns true if this value is null. */
+	[[nodiscard]] bool isNull() const noexcept;
+
+	/** Returns the type of this value. */
+	[[nodiscard]] ObjectType getType() const;
+
+	/** Returns a string representation of the type of this value. */
+	[[nodiscard]] std::string_view getTypeAsString() const;
+	///@}
+
+	/** @name Value accessors */
+	///@{
+	/** Returns the value as a number.
+		@throws std::runtime_error An exception will be thrown if this value is not a Number.
+	 */
+	[[nodiscard]] double getNumber() const;
+
+	/** Returns the value as a string. The returned view points into the document.
+		@throws std::runtime_error An exception will be thrown if this value is not a String.
+	 */
+	[[nodiscard]] std::string_view getString() const;
+
+	/** Returns the value as a boolean.
+		@throws std::runtime_error An exception will be thrown if this value is not a Boolean.
+	 */
+	[[nodiscard]] bool getBoolean() const;
+	///@}
+
+	/** @name Children */
+	///@{
+	/** Returns the number of children of an Array or Object, or 0 for any other type. */
+	[[nodiscard]] std::size_t getNumChildren() const;
+
+	/** Returns true if this value is an Object with a member with the given name. */
+	[[nodiscard]] bool hasChildWithName (std::string_view childName) const;
+
+	/** Returns the member of this Object with the given name.
+
+		@throws std::runtime_error An exception is thrown if this value is not an Object, or if
+		it has no member with the given name.
+	 */
+	[[nodiscard]] BinaryView operator[] (std::string_view childName) const;
+	[[nodiscard]] BinaryView operator[] (const char* childName) const;
+
+	/** Returns the child at the given index.
+
+		For an Object, the members are indexed in sorted order of their names, which is the order
+		in which an \c Object iterates them.
+
+		@throws std::runtime_error An exception is thrown if this value is not an Array or an Object.
+		@throws std::out_of_range An exception is thrown if the index is out of range.
+	 */
+	[[nodiscard]] BinaryView operator[] (std::size_t idx) const;
+
+	/** Returns the name of the Object member at the given index.
+
+		@throws std::runtime_error An exception is thrown if this value is not an Object.
+		@throws std::out_of_range An exception is thrown if the index is out of range.
+	 */
+	[[nodiscard]] std::string_view getChildName (std::size_t idx) const;
+	///@}
+
+	/** Copies this value and all of its children into a new \c Node .
+
+		Containers may be nested at most 512 deep. A document written by \c BinaryFormat never
+		refers to the same array or object from more than one place; a document that does is
+		rejected if its shared records would expand to more Nodes than the document has offsets.
+
+		@throws ParseError An exception is thrown if the document is malformed.
+	 */
+	[[nodiscard]] Node toNode() const;
+
+private:
+	friend class BinaryFormat;
+
+	BinaryView (const char* documentToUse, std::size_t documentSizeToUse, std::uint64_t offsetToUse) noexcept;
+
+	[[nodiscard]] unsigned char getTag() const noexcept;
+
+	[[nodiscard]] Node toNode (std::size_t depth, std::uint64_t& nodesLeft) const;
+
+	[[nodiscard]] BinaryView getChildAt (std::uint64_t childOffset) const;
+
+	[[nodiscard]] std::uint64_t readCount (std::size_t entrySize, std::uint64_t& tableStart) const;
+
+	[[nodiscard]] std::string_view readString (std::uint64_t stringOffset) const;
+
+	[[nodiscard]] bool findMember (std::string_view childName, std::uint64_t& valueOffset) const;
+
+	[[nodiscard]] std::uint64_t readOffset (std::uint64_t position) const;
+
+	const char* document { nullptr };
+
+	std::size_t documentSize { 0 };
+
+	std::uint64_t offset { 0 };
+};
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+/** A document in the native binary format, memory-mapped from a file.
+
+	Opening the file only maps it and checks its header, so it takes the same time for any size
+	of document; pages of the file are only read from disk when a \c BinaryView touches them.
+
+	@code
+	const BinaryFile file { "snapshot.lsb" };
+
+	const auto name = file.getRoot()["users"][41]["name"].getString();
+	@endcode
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT BinaryFile final
+{
+public:
+	/** Maps the file.
+
+		@throws std::system_error An exception is thrown if the file can't be opened or mapped.
+		@throws ParseError An exception is thrown if the file isn't a binary document.
+	 */
+	explicit BinaryFile (const std::filesystem::path& path);
+
+	/** Destructor. This unmaps the file, so views into it must not be used afterwards. */
+	~BinaryFile();
+
+	BinaryFile (const BinaryFile&)			  = delete;
+	BinaryFile& operator= (const BinaryFile&) = delete;
+
+	BinaryFile (BinaryFile&& other) noexcept;
+	BinaryFile& operator= (BinaryFile&& other) noexcept;
+
+	/** Returns a view of the document's root value. */
+	[[nodiscard]] BinaryView getRoot() const;
+
+	/** Returns the raw bytes of the document. */
+	[[nodiscard]] std::string_view getData() const noexcept;
+
+private:
+	std::unique_ptr<MappedFile> file;
+};
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+/** The native binary serialization format.
+
+	This format lays out a tree of Nodes so that it can be read in place, without any parsing:
+	every value is a type-tagged record, arrays hold a table of the offsets of their elements,
+	and objects hold a table of (name, value) offsets sorted by name. All offsets are relative to
+	the start of the document, so a document can be written to a file and memory-mapped at any
+	address; see \c BinaryFile . Object names are only stored once per document, however many
+	objects use them.
+
+	Children are always written before their parent, so a document can be printed into any
+	\c OutputSink in a single pass, and the root's offset is stored in the last 8 bytes. All
+	integers and numbers are stored little-endian.
+
+	\c parse() copies a whole document into a \c Node ; to read a document without copying it,
+	use \c createView() or \c BinaryFile instead.
+
+	@see formats::Binary
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT BinaryFormat final : public Format
+{
+public:
+	/** @name Information queries */
+	///@{
+	[[nodiscard]] std::string_view getName() const noexcept final;
+
+	[[nodiscard]] const std::vector<std::string_view>& getFileExtensions() const noexcept final;
+
+	bool supportsComments() const noexcept final;
+
+	/** Returns true if the data starts with the binary format's header. */
+	[[nodiscard]] bool probablyMatchesString (std::string_view string) const noexcept final;
+	///@}
+
+	/** @name Parsing */
+	///@{
+	[[nodiscard]] Node parse (std::string_view string) const final;
+
+	/** Returns a view of the root value of a binary document, without parsing or copying it.
+
+		Only the document's header and the offset of its root are checked here; everything else
+		is checked as it's accessed.
+
+		@throws ParseError An exception is thrown if the data isn't a binary document.
+	 */
+	[[nodiscard]] static BinaryView createView (std::string_view data);
+	///@}
+
+	/** @name Printing */
+	///@{
+	/** Creates a printer that writes the binary format. There is no pretty printing for this format. */
+	[[nodiscard]] std::unique_ptr<Printer> createPrinter (bool shouldPrettyPrint) const noexcept final;
+	///@}
+};
+
+}  // namespace limes::serializing
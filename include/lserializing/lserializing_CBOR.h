@@ -0,0 +1,120 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "lserializing/lserializing_Export.h"
+#include "lserializing/lserializing_SerializingFormat.h"
+#include "lserializing/lserializing_Node.h"
+
+/** @file
+	This file defines the serializing::CBORFormat class.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+/** Options for the printers created by \c CBORFormat::createPrinter() .
+
+	@ingroup limes_serializing
+ */
+struct LSERIAL_EXPORT CBORPrinterOptions final
+{
+	/** If true, an array whose elements are all numbers is written as an RFC 8746 typed array
+		of little-endian 64-bit floats (tag 86), which is smaller for large arrays of non-integral
+		numbers and much faster to read and write. Decoders that don't understand RFC 8746 will
+		see a tagged byte string instead of an array, so this is off by default.
+	 */
+	bool typedArrays { false };
+
+	/** Arrays with fewer elements than this are never written as typed arrays. */
+	std::size_t minTypedArraySize { 8 };
+};
+
+/** The CBOR serialization format, as specified by RFC 8949.
+
+	Numbers are written in CBOR's preferred serialization: integral values as the smallest
+	integer that holds them, and other values as the shortest of half, single or double
+	precision floats that represents them exactly. Containers are always written with definite
+	lengths.
+
+	The parser accepts definite and indefinite-length strings, arrays and maps; half, single and
+	double precision floats; and the RFC 8746 typed arrays of integers and of 16, 32 and 64-bit
+	floats in either byte order, which become Array Nodes of numbers. Text and byte strings
+	both become String Nodes, \c undefined becomes null, and other tags are ignored, so their
+	content is parsed as if it weren't tagged. As for JSON, map keys must be non-empty strings
+	that are unique within their map. Containers may be nested at most 512 deep. Errors are
+	reported with their byte offset in the message; their line and column aren't meaningful.
+
+	An instance of this class is registered with \c KnownFormats .
+
+	@see formats::CBOR
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT CBORFormat final : public Format
+{
+public:
+	/** @name Information queries */
+	///@{
+	[[nodiscard]] std::string_view getName() const noexcept final;
+
+	[[nodiscard]] const std::vector<std::string_view>& getFileExtensions() const noexcept final;
+
+	bool supportsComments() const noexcept final;
+
+	/** Returns true if the data starts with CBOR's self-describe tag, or with an array or map
+		header whose first element looks plausible. This only looks at the first few bytes.
+	 */
+	[[nodiscard]] bool probablyMatchesString (std::string_view string) const noexcept final;
+	///@}
+
+	/** @name Parsing */
+	///@{
+	[[nodiscard]] Node parse (std::string_view string) const final;
+
+	/** Parses the given data, without throwing if it isn't valid CBOR.
+
+		Like the JSON parser, the CBOR parser reports errors without any stack unwinding.
+	 */
+	[[nodiscard]] ParseResult tryParse (std::string_view string) const final;
+
+	/** Parses data holding a single array of numbers straight into packed storage, without
+		creating any Nodes.
+
+		The data can be any typed array, or a regular array whose elements are all numbers. A
+		typed array of little-endian doubles is copied with a single \c memcpy() on little-endian
+		machines.
+
+		@throws ParseError An exception is thrown if the data isn't a CBOR array of numbers.
+	 */
+	[[nodiscard]] std::vector<double> parseNumberArray (std::string_view string) const;
+	///@}
+
+	/** @name Printing */
+	///@{
+	[[nodiscard]] std::unique_ptr<Printer> createPrinter (bool shouldPrettyPrint) const noexcept final;
+
+	/** Creates a printer with the given options. */
+	[[nodiscard]] std::unique_ptr<Printer> createPrinter (const CBORPrinterOptions& options) const;
+	///@}
+};
+
+}  // namespace limes::serializing
@@ -0,0 +1,70 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include "lserializing/lserializing_Export.h"
+
+/** @file
+	This file defines the serializing::ChunkedPrinter class.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+/** A printer that produces its output a chunk at a time, only when asked for it.
+
+	A \c Printer pushes the whole document into its sink in one call. A chunked printer instead
+	keeps its place in the tree between calls to \c read() , so the caller decides when the next
+	piece of output is produced -- for example, when a socket has room for more data. Only the
+	path from the root to the current node is stored, along with a small amount of output that
+	didn't fit in the last chunk, so the memory used doesn't depend on the size of the document.
+
+	The Node being printed must stay alive and unchanged until the printer is finished or destroyed.
+
+	@code
+	const auto printer = JSONFormat {}.createChunkedPrinter (document);
+
+	char chunk[65536];
+
+	while (const auto size = printer->read (chunk, sizeof (chunk)))
+		socket.send (chunk, size);
+	@endcode
+
+	@see JSONFormat::createChunkedPrinter()
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT ChunkedPrinter
+{
+public:
+	/** Destructor. */
+	virtual ~ChunkedPrinter() = default;
+
+	/** Writes up to \c maxBytes of the next part of the output into the buffer.
+
+		The buffer is filled completely unless the end of the output is reached.
+
+		@returns The number of bytes written. This is only 0 once all of the output has been read.
+	 */
+	virtual std::size_t read (char* buffer, std::size_t maxBytes) = 0;
+
+	/** Returns true once all of the output has been read. */
+	[[nodiscard]] virtual bool isFinished() const noexcept = 0;
+};
+
+}  // namespace limes::serializing
@@ -0,0 +1,209 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "lserializing/lserializing_Export.h"
+#include "lserializing/lserializing_Node.h"
+
+/** @file
+	This file defines the serializing::ColumnTable class and the functions that convert between
+	arrays of objects and columns.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+/** An allocator that aligns its memory to 64 bytes, which is the alignment Arrow recommends for
+	its buffers, so that the columns can be handed to SIMD code or Arrow libraries as they are.
+
+	@ingroup limes_serializing
+ */
+template <typename T>
+struct ColumnAllocator
+{
+	using value_type = T;
+
+	static constexpr auto alignment = std::size_t { 64 };
+
+	ColumnAllocator() noexcept = default;
+
+	template <typename U>
+	ColumnAllocator (const ColumnAllocator<U>&) noexcept  // NOLINT
+	{
+	}
+
+	[[nodiscard]] T* allocate (std::size_t n)
+	{
+		return static_cast<T*> (::operator new (n * sizeof (T), std::align_val_t { alignment }));
+	}
+
+	void deallocate (T* pointer, std::size_t) noexcept
+	{
+		::operator delete (pointer, std::align_val_t { alignment });
+	}
+
+	template <typename U>
+	bool operator== (const ColumnAllocator<U>&) const noexcept
+	{
+		return true;
+	}
+};
+
+/** A buffer of a column's data, whose memory is 64-byte aligned.
+	@ingroup limes_serializing
+ */
+template <typename T>
+using ColumnBuffer = std::vector<T, ColumnAllocator<T>>;
+
+/** The types of values a \c Column can hold.
+	@ingroup limes_serializing
+ */
+enum class ColumnType
+{
+	Null,	  ///< Every value is null, and there are no buffers, as in Arrow's Null type.
+	Boolean,  ///< The values are bits in \c Column::booleans , as in Arrow's Boolean type.
+	Int64,	  ///< The values are in \c Column::integers , as in Arrow's Int64 type.
+	Double,	  ///< The values are in \c Column::doubles , as in Arrow's Float64 type.
+	String	  ///< The values are in \c Column::offsets and \c Column::bytes , as in Arrow's Utf8 type.
+};
+
+/** One field of an array of objects, stored contiguously, in Arrow's memory layout.
+
+	Bitmaps, both the validity bitmap and the values of a Boolean column, use Arrow's
+	least-significant-bit-first numbering, so row \c i is bit <tt>i % 8</tt> of byte
+	<tt>i / 8</tt> . The slots of null values hold zeros, and null strings are empty.
+
+	Only the buffers for the column's type are used; the others are empty.
+
+	@see ColumnTable
+
+	@ingroup limes_serializing
+ */
+struct LSERIAL_EXPORT Column final
+{
+	/** The name of the field this column holds. */
+	std::string name;
+
+	ColumnType type { ColumnType::Null };
+
+	/** The number of values, including nulls. */
+	std::size_t length { 0 };
+
+	/** The number of null values. */
+	std::size_t nullCount { 0 };
+
+	/** A bit for each row, which is set if the row's value isn't null. As Arrow allows, this is
+		empty if there are no nulls.
+	 */
+	ColumnBuffer<std::uint8_t> validity;
+
+	/** For a Boolean column, a bit for each row, which is set if the row's value is true. */
+	ColumnBuffer<std::uint8_t> booleans;
+
+	/** For an Int64 column, the values. */
+	ColumnBuffer<std::int64_t> integers;
+
+	/** For a Double column, the values. */
+	ColumnBuffer<double> doubles;
+
+	/** For a String column, \c length + 1 offsets into \c bytes ; row \c i 's string is
+		the bytes from <tt>offsets[i]</tt> up to <tt>offsets[i + 1]</tt> .
+	 */
+	ColumnBuffer<std::int32_t> offsets;
+
+	/** For a String column, the characters of all of the strings, one after another. */
+	ColumnBuffer<char> bytes;
+
+	/** Returns true if the given row's value is null. */
+	[[nodiscard]] bool isNull (std::size_t row) const noexcept;
+
+	/** Returns the given row's value in a Boolean column. */
+	[[nodiscard]] bool getBoolean (std::size_t row) const noexcept;
+
+	/** Returns the given row's value in a String column. */
+	[[nodiscard]] std::string_view getString (std::size_t row) const noexcept;
+};
+
+/** A table of columns, each of which has a value for every row.
+
+	@see toColumns(), fromColumns()
+
+	@ingroup limes_serializing
+ */
+struct LSERIAL_EXPORT ColumnTable final
+{
+	/** The columns, in the order their fields were first seen. */
+	std::vector<Column> columns;
+
+	std::size_t numRows { 0 };
+
+	/** Returns the column with the given name, or nullptr if there isn't one. */
+	[[nodiscard]] const Column* getColumn (std::string_view name) const noexcept;
+};
+
+/** Converts an array of objects to a table with a column for each field.
+
+	This replaces walking \c Node::operator[] for every row and field: the rows are visited
+	once, and each value is appended to its column's buffers. A column's type is decided by
+	the values seen in it. Numbers start out as Int64 if they're integral, and the column is
+	converted to Double in place if it later sees a number that isn't (or whose magnitude is
+	beyond 2^53). Null values, and fields that some rows don't have, become nulls.
+
+	The rows can be split into ranges that are converted on separate threads, and the results
+	are then concatenated. The ranges are multiples of 64 rows long, so that concatenating
+	bitmaps is a plain copy.
+
+	@param array An Array Node whose children are all Objects.
+	@param numThreads The maximum number of threads to use. If this is 0, the number of
+	hardware threads is used. Small arrays are always converted on the calling thread.
+
+	@throws std::runtime_error An exception is thrown if the node isn't an array of objects,
+	if a field holds an Array or Object, or if a field holds values of different types, such
+	as strings in some rows and numbers in others. One is also thrown if a String column's
+	bytes don't fit Arrow's 32-bit offsets.
+
+	@see fromColumns()
+
+	@ingroup limes_serializing
+ */
+[[nodiscard]] LSERIAL_EXPORT ColumnTable toColumns (const Node& array, std::size_t numThreads = 1);
+
+/** Converts a table back to an array of objects.
+
+	Each row becomes an Object with a member for each column; null values become null members.
+	Int64 values become numbers, so values beyond 2^53 lose precision.
+
+	@param table The table to convert.
+	@param numThreads The maximum number of threads to use. If this is 0, the number of
+	hardware threads is used. Small tables are always converted on the calling thread.
+
+	@throws std::runtime_error An exception is thrown if a column's length or buffers don't
+	match the table's number of rows.
+
+	@see toColumns()
+
+	@ingroup limes_serializing
+ */
+[[nodiscard]] LSERIAL_EXPORT Node fromColumns (const ColumnTable& table, std::size_t numThreads = 1);
+
+}  // namespace limes::serializing
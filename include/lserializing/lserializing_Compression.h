@@ -0,0 +1,175 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "lserializing/lserializing_Export.h"
+#include "lserializing/lserializing_OutputSink.h"
+
+/** @file
+	This file defines the serializing::CompressingSink class and functions for compressing and
+	decompressing serialized data.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+namespace compression
+{
+class Encoder;
+}
+
+/** The compressed container formats that serialized data can be wrapped in.
+
+	@see detectCompression(), CompressingSink
+
+	@ingroup limes_serializing
+ */
+enum class CompressionType
+{
+	None,  ///< The data isn't compressed.
+	Gzip,  ///< The gzip format (RFC 1952). This is only available if the library was built with zlib.
+	LZ4	   ///< The LZ4 frame format, with independent 256 KB blocks. This is built into the library.
+};
+
+/** @exception CompressionError
+	Thrown when data can't be compressed or decompressed, including when the data is corrupt or
+	uses a compression type that isn't available.
+
+	@ingroup limes_serializing
+ */
+struct LSERIAL_EXPORT CompressionError final : public std::runtime_error
+{
+	explicit CompressionError (const std::string& message);
+};
+
+/** Returns true if data can be compressed and decompressed with the given type in this build of the library. */
+[[nodiscard]] LSERIAL_EXPORT bool isCompressionAvailable (CompressionType type) noexcept;
+
+/** Returns the type of compressed data that the given data starts with, based on its magic bytes.
+	@ingroup limes_serializing
+ */
+[[nodiscard]] LSERIAL_EXPORT CompressionType detectCompression (std::string_view data) noexcept;
+
+/** Returns the conventional file extension for the given compression type, such as ".gz", or an
+	empty string for \c CompressionType::None .
+
+	@ingroup limes_serializing
+ */
+[[nodiscard]] LSERIAL_EXPORT std::string_view getFileExtension (CompressionType type) noexcept;
+
+/** Compresses some data.
+
+	@throws CompressionError An exception is thrown if the compression type isn't available.
+
+	@see CompressingSink
+
+	@ingroup limes_serializing
+ */
+[[nodiscard]] LSERIAL_EXPORT std::string compress (std::string_view data, CompressionType type);
+
+/** Decompresses some data, writing the output into a sink one block at a time.
+
+	The type of compression is detected from the data's magic bytes. Concatenated gzip members
+	and LZ4 frames are all decompressed, and LZ4 skippable frames are skipped.
+
+	@throws CompressionError An exception is thrown if the data isn't compressed in an available
+	format, or is corrupt.
+
+	@ingroup limes_serializing
+ */
+LSERIAL_EXPORT void decompress (std::string_view data, OutputSink& sink);
+
+/** Decompresses some data into a string.
+
+	The string is allocated once, when the compressed data records the size of its contents.
+
+	@throws CompressionError An exception is thrown if the data isn't compressed in an available
+	format, or is corrupt.
+
+	@ingroup limes_serializing
+ */
+[[nodiscard]] LSERIAL_EXPORT std::string decompress (std::string_view data);
+
+/** An output sink that compresses everything written to it, and writes the compressed data to
+	another sink.
+
+	This lets any printer write compressed output without the uncompressed text ever being held
+	in memory: the text is buffered one block at a time, and each block is compressed as soon as
+	it is full.
+
+	Call \c finish() when everything has been written, to compress the last block and write the
+	end of the compressed stream. \c flush() compresses whatever is buffered and flushes the
+	destination, but leaves the stream open.
+
+	@code
+	FileSink file { "snapshot.json.lz4" };
+	CompressingSink sink { file, CompressionType::LZ4 };
+	format.serialize (node, sink);
+	sink.finish();
+	file.flush();
+	@endcode
+
+	@see Format::serializeToFile()
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT CompressingSink final : public OutputSink
+{
+public:
+	/** Creates a sink that writes compressed data into the destination, which must outlive this sink.
+		@throws CompressionError An exception is thrown if the compression type isn't available.
+	 */
+	CompressingSink (OutputSink& destinationSink, CompressionType type);
+
+	/** Finishes the compressed stream, if \c finish() hasn't been called. Errors that occur here
+		are ignored, so call \c finish() first if you need to know about them.
+	 */
+	~CompressingSink() override;
+
+	CompressingSink (const CompressingSink&)			= delete;
+	CompressingSink& operator= (const CompressingSink&) = delete;
+
+	void write (std::string_view text) final;
+
+	void write (char character) final;
+
+	/** Compresses any buffered text and flushes the destination sink. This ends the current block,
+		so flushing often makes the compression worse.
+	 */
+	void flush() final;
+
+	/** Compresses any buffered text and writes the end of the compressed stream. Nothing can be
+		written after this is called.
+	 */
+	void finish();
+
+private:
+	OutputSink& destination;
+
+	std::unique_ptr<compression::Encoder> encoder;
+
+	std::string buffer;
+
+	bool finished { false };
+};
+
+}  // namespace limes::serializing
@@ -0,0 +1,208 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include "lserializing/lserializing_Export.h"
+#include "lserializing/lserializing_SerializingFormat.h"
+#include "lserializing/lserializing_Node.h"
+#include "lserializing/lserializing_ChunkedPrinter.h"
+#include "lserializing/lserializing_OutputSink.h"
+
+/** @file
+	This file defines the serializing::JSONFormat class.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+/** Limits enforced by \c JSONFormat::validate() .
+
+	@ingroup limes_serializing
+ */
+struct LSERIAL_EXPORT JSONValidationLimits final
+{
+	/** The maximum nesting depth of arrays and objects. The top-level container has a depth of 1. */
+	std::size_t maxDepth { 512 };
+
+	/** The maximum size of the input, in bytes. */
+	std::size_t maxSize { std::numeric_limits<std::size_t>::max() };
+};
+
+/** Options for the printers created by \c JSONFormat::createPrinter() .
+
+	@ingroup limes_serializing
+ */
+struct LSERIAL_EXPORT JSONPrinterOptions final
+{
+	/** If true, every non-ASCII character in a string is written as a \\u escape, so the output
+		is pure ASCII. If false, UTF-8 text is copied into the output unchanged, which is much
+		faster and more compact for non-English text; any invalid UTF-8 in the input strings is
+		replaced with U+FFFD.
+	 */
+	bool escapeNonASCII { true };
+
+	/** If true, the output is canonical JSON as specified by RFC 8785 (the JSON Canonicalization
+		Scheme), so that equal trees always produce identical bytes, which can be hashed or signed.
+
+		Canonical output has no whitespace, object keys are sorted by their UTF-16 code units,
+		numbers are written in the shortest form that round-trips (formatted as ECMAScript
+		does), and strings are written as UTF-8 with only quotes, backslashes and control
+		characters escaped. \c escapeNonASCII is ignored.
+
+		NaN and infinite numbers can't be represented in canonical JSON, so printing one throws
+		a \c std::runtime_error .
+
+		@see SHA256Sink
+	 */
+	bool canonical { false };
+};
+
+/** The JSON serialization format.
+
+	An instance of this class is registered with \c KnownFormats as the default format, so you
+	usually don't need to create one yourself. This class is public so that the JSON-specific
+	APIs it offers in addition to the \c Format interface are accessible.
+
+	@see formats::JSON
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT JSONFormat final : public Format
+{
+public:
+	/** @name Information queries */
+	///@{
+	[[nodiscard]] std::string_view getName() const noexcept final;
+
+	[[nodiscard]] const std::vector<std::string_view>& getFileExtensions() const noexcept final;
+
+	bool supportsComments() const noexcept final;
+	///@}
+
+	/** @name Parsing */
+	///@{
+
+	[[nodiscard]] Node parse (std::string_view string) const final;
+
+	/** Parses the given string, without throwing if it isn't valid JSON.
+
+		The JSON parser reports errors without any stack unwinding, so this is much cheaper
+		than catching the exception thrown by \c parse() when rejecting invalid input.
+	 */
+	[[nodiscard]] ParseResult tryParse (std::string_view string) const final;
+
+	/** Parses the given string, splitting the work across multiple threads if the string is
+		one large top-level array.
+
+		The elements of the top-level array are located with a quick scan that only tracks
+		strings and bracket nesting. The elements are then divided into contiguous ranges,
+		each of which is parsed on its own thread, and the resulting nodes are moved into the
+		final array in their original order.
+
+		If the input isn't a top-level array, or is too small for the threading overhead to
+		pay off, this just calls \c parse() on the calling thread. The resulting \c Node is
+		identical to the one \c parse() would produce, and any \c ParseError thrown is the one
+		describing the earliest error in the input.
+
+		@param string The JSON input
+		@param numThreads The maximum number of threads to use. If this is 0, the number of
+		hardware threads is used.
+	 */
+	[[nodiscard]] Node parseParallel (std::string_view string, std::size_t numThreads = 0) const;
+
+	/** Returns true if the given string is well-formed JSON, without building any Nodes.
+
+		This checks the full RFC 8259 grammar: the top level must be a single object or array
+		followed only by whitespace, numbers and literals must be well-formed, strings may not
+		contain raw control characters or invalid escape sequences, and any \\u escape of a
+		UTF-16 surrogate must be one half of a complete pair. The text inside strings must also
+		be valid UTF-8.
+
+		Like \c parse() , this also rejects objects with empty or duplicate keys. Keys are compared
+		after decoding any escape sequences.
+
+		Whitespace and string contents are scanned 16 bytes at a time, so this is much faster
+		than calling \c tryParse() and discarding the result.
+
+		@param string The text to check
+		@param limits Inputs that are larger or more deeply nested than these limits are rejected
+	 */
+	[[nodiscard]] bool validate (std::string_view string, const JSONValidationLimits& limits = {}) const noexcept;
+
+	/** Returns the result of calling \c validate() with the default limits. */
+	[[nodiscard]] bool probablyMatchesString (std::string_view string) const noexcept final;
+
+	///@}
+
+	/** @name Schema and printing */
+	///@{
+	[[nodiscard]] std::unique_ptr<Printer> createPrinter (bool shouldPrettyPrint) const noexcept final;
+
+	/** Creates a printer with the given options. */
+	[[nodiscard]] std::unique_ptr<Printer> createPrinter (const JSONPrinterOptions& options) const;
+
+	/** Serializes the \c Node into the sink, splitting the work across multiple threads if the
+		node is a large array or object.
+
+		The container's children are divided into contiguous ranges with equal numbers of
+		children, each range is printed into its own buffer on its own thread, and the buffers
+		are then written to the sink in order. The output is identical to what a printer created
+		with the same options would produce.
+
+		If the node isn't an array or object, or has too few children for the threading overhead
+		to pay off, it is printed sequentially on the calling thread. Only the node's own children
+		are divided between threads, so this works best for a container of many similarly-sized
+		records.
+
+		@param node The node to serialize
+		@param sink The sink to write the output to
+		@param numThreads The maximum number of threads to use. If this is 0, the number of
+		hardware threads is used.
+		@param options The printer options to use
+	 */
+	void serializeParallel (const Node& node, OutputSink& sink, std::size_t numThreads = 0,
+							const JSONPrinterOptions& options = {}) const;
+
+	/** Serializes the \c Node into a string, splitting the work across multiple threads if the
+		node is a large array or object.
+
+		@see serializeParallel(const Node&, OutputSink&, std::size_t, const JSONPrinterOptions&) const
+	 */
+	[[nodiscard]] std::string serializeParallel (const Node& node, std::size_t numThreads = 0,
+												 const JSONPrinterOptions& options = {}) const;
+
+	/** Creates a printer that produces the JSON for the \c Node a chunk at a time.
+
+		The output is identical to what a printer created with the same options would produce,
+		but it's only generated as it's read, so a large document can be streamed to a socket or
+		pipe without ever being held in memory. Long strings are escaped a few kilobytes at a time.
+
+		The \c Node must stay alive and unchanged while the chunked printer is in use.
+	 */
+	[[nodiscard]] std::unique_ptr<ChunkedPrinter> createChunkedPrinter (const Node& node, const JSONPrinterOptions& options = {}) const;
+
+	[[nodiscard]] std::unique_ptr<Schema> createSchemaFrom (const Node& data) const noexcept final;
+	///@}
+};
+
+}  // namespace limes::serializing
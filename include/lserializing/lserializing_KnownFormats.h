@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <filesystem>
 #include <stdexcept>
 #include <memory>
 #include <type_traits>
@@ -56,6 +57,32 @@ LSERIAL_EXPORT static constexpr auto INI = "INI";
 /** The TOML serialization format. */
 LSERIAL_EXPORT static constexpr auto TOML = "TOML";
 
+/** The native binary format, which can be read in place without parsing.
+	@see BinaryFormat
+ */
+LSERIAL_EXPORT static constexpr auto Binary = "Binary";
+
+/** The MessagePack binary serialization format.
+	@see MessagePackFormat
+ */
+LSERIAL_EXPORT static constexpr auto MessagePack = "MessagePack";
+
+/** The CBOR binary serialization format, as specified by RFC 8949.
+	@see CBORFormat
+ */
+LSERIAL_EXPORT static constexpr auto CBOR = "CBOR";
+
+/** The compact binary format that writes the keys of arrays of same-shaped objects once.
+	@see PackedFormat
+ */
+LSERIAL_EXPORT static constexpr auto Packed = "Packed";
+
+/** The Protobuf wire format. This format needs a message descriptor to be created, so it
+	isn't registered with KnownFormats.
+	@see ProtobufFormat
+ */
+LSERIAL_EXPORT static constexpr auto Protobuf = "Protobuf";
+
 }  // namespace formats
 
 /** @exception FormatNotFoundError
@@ -84,6 +111,10 @@ concept IsFormat = std::is_base_of_v<Format, T>;
 	- YAML
 	- TOML
 	- INI
+	- Binary
+	- MessagePack
+	- CBOR
+	- Packed
 
 	Other third party libraries may add new serialization formats and register
 	them with the KnownFormats object, allowing Limes code to find and use
@@ -138,6 +169,21 @@ class LSERIAL_EXPORT KnownFormats final
 
 	[[nodiscard]] Node parse (std::string_view string) const;
 
+	/** Parses the contents of a file, choosing the format from the file's extension.
+
+		If no registered format handles the file's extension, the format is deduced from the
+		file's contents instead, as in \c parse() . The file is memory-mapped rather than read
+		into a string where the platform supports it.
+
+		Compressed files are decompressed first. For a file such as \c data.json.gz , the format
+		is chosen from the extension before the compression's extension.
+
+		@throws FormatNotFoundError An exception is thrown if no format can be found for the file.
+
+		@see Format::parseFile()
+	 */
+	[[nodiscard]] Node parseFile (const std::filesystem::path& path) const;
+
 	void deserialize (SerializableData& data, std::string_view string) const noexcept;
 
 	///@}
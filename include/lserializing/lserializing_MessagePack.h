@@ -0,0 +1,101 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "lserializing/lserializing_Export.h"
+#include "lserializing/lserializing_SerializingFormat.h"
+#include "lserializing/lserializing_Node.h"
+
+/** @file
+	This file defines the serializing::MessagePackFormat class.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+/** The MessagePack serialization format.
+
+	MessagePack is a compact binary encoding of the same data model as JSON. Numbers that hold
+	integral values are written as the smallest MessagePack integer that can hold them, other
+	numbers are written as 32-bit floats if that's lossless and as 64-bit floats otherwise, and
+	strings, arrays and maps use the smallest header for their size.
+
+	When parsing, both \c str and \c bin values become String Nodes, and map keys must be
+	non-empty strings that are unique within their map, as in JSON. Extension types aren't
+	supported, and are reported as parse errors. Containers may be nested at most 512 deep, so
+	that a small malicious input can't exhaust the stack. Errors are reported with their byte
+	offset in the message; their line and column aren't meaningful.
+
+	Printing a string, array or object with more than 2^32 - 1 elements throws a
+	\c std::runtime_error , because MessagePack can't represent its size. \c Format::serialize()
+	is \c noexcept , so it returns an empty string instead.
+
+	An instance of this class is registered with \c KnownFormats .
+
+	@see formats::MessagePack
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT MessagePackFormat final : public Format
+{
+public:
+	/** @name Information queries */
+	///@{
+	[[nodiscard]] std::string_view getName() const noexcept final;
+
+	[[nodiscard]] const std::vector<std::string_view>& getFileExtensions() const noexcept final;
+
+	bool supportsComments() const noexcept final;
+
+	/** Returns true if the data starts with a MessagePack map or array header whose first
+		element looks plausible. This only looks at the first few bytes.
+	 */
+	[[nodiscard]] bool probablyMatchesString (std::string_view string) const noexcept final;
+	///@}
+
+	/** @name Parsing */
+	///@{
+	[[nodiscard]] Node parse (std::string_view string) const final;
+
+	/** Parses the given data, without throwing if it isn't valid MessagePack.
+
+		Like the JSON parser, the MessagePack parser reports errors without any stack unwinding.
+	 */
+	[[nodiscard]] ParseResult tryParse (std::string_view string) const final;
+	///@}
+
+	/** @name Printing */
+	///@{
+	/** Creates a printer that writes MessagePack. There is no pretty printing for this format. */
+	[[nodiscard]] std::unique_ptr<Printer> createPrinter (bool shouldPrettyPrint) const noexcept final;
+
+	using Format::serialize;
+
+	/** Serializes the \c Node to a string.
+
+		Returns an empty string if the Node contains a string or container that's too large for
+		MessagePack to represent.
+	 */
+	[[nodiscard]] std::string serialize (const Node& node, bool shouldPrettyPrint = false) const noexcept final;
+	///@}
+};
+
+}  // namespace limes::serializing
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string_view>
 #include <string>
 #include <vector>
@@ -318,6 +319,27 @@ class LSERIAL_EXPORT Node final
 		return get<DataType<Type>>();
 	}
 
+	/** Calls the visitor with this node's value, and returns whatever the visitor returns.
+
+		The visitor is called with a \c std::nullptr_t for a Null node, a \c double , a
+		\c std::string_view , a \c bool , a \c const \c Array& , or a \c const \c Object& .
+		This dispatches on the node's type exactly once, so it is cheaper than a chain of
+		\c isX() checks followed by one of the checked accessors above.
+	 */
+	template <typename Visitor>
+	decltype (auto) visit (Visitor&& visitor) const
+	{
+		switch (type)
+		{
+			case (ObjectType::Number) : return std::forward<Visitor> (visitor) (*std::get_if<double> (&data));
+			case (ObjectType::String) : return std::forward<Visitor> (visitor) (std::string_view { *std::get_if<std::string> (&data) });
+			case (ObjectType::Boolean) : return std::forward<Visitor> (visitor) (*std::get_if<bool> (&data));
+			case (ObjectType::Array) : return std::forward<Visitor> (visitor) (*std::get_if<Array> (&data));
+			case (ObjectType::Object) : return std::forward<Visitor> (visitor) (*std::get_if<Object> (&data));
+			default : return std::forward<Visitor> (visitor) (nullptr);
+		}
+	}
+
 	///@}
 
 	/** @name Assignment operators */
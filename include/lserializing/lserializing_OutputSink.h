@@ -0,0 +1,269 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ostream>
+#include "lserializing/lserializing_Export.h"
+
+/** @file
+	This file defines the serializing::OutputSink class and its basic implementations.
+
+	@ingroup limes_serializing
+ */
+
+// WritevSink keeps its output as the iovecs that it passes to writev()
+struct iovec;
+
+namespace limes::serializing
+{
+
+/** The destination that a \c Printer writes its output into.
+
+	A printer appends everything it produces to a single sink, so a whole tree of Nodes can
+	be serialized without building any intermediate strings.
+
+	@see Printer, StringSink, StreamSink
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT OutputSink
+{
+public:
+	/** Destructor. */
+	virtual ~OutputSink() = default;
+
+	/** Appends some text to the output. */
+	virtual void write (std::string_view text) = 0;
+
+	/** Appends a single character to the output.
+		The default implementation calls \c write() with a one-character string.
+	 */
+	virtual void write (char character);
+
+	/** Appends some text to the output, which the sink may keep a reference to instead of
+		copying it. The text must remain valid until the next call to \c flush() , or until the
+		sink is destroyed.
+
+		Printers call this for any run of text that comes straight from the Nodes being
+		printed, and sinks that reference text decide for themselves which runs are long enough
+		to be worth it. The default implementation calls \c write() .
+
+		@see WritevSink
+	 */
+	virtual void writeReferenced (std::string_view text);
+
+	/** Pushes any buffered output to its final destination. The default implementation does nothing. */
+	virtual void flush() { }
+
+	/** Tells the sink that about this many more bytes are going to be written, so that it can
+		allocate space for them up front. The default implementation does nothing.
+
+		@see Printer::measure()
+	 */
+	virtual void reserve (std::size_t /*numBytes*/) { }
+};
+
+/** An output sink that appends to a \c std::string .
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT StringSink final : public OutputSink
+{
+public:
+	/** Creates a sink that appends to its own internal string. */
+	StringSink() = default;
+
+	/** Creates a sink that appends to the given string, which must outlive the sink. */
+	explicit StringSink (std::string& stringToAppendTo) noexcept;
+
+	StringSink (const StringSink&)			  = delete;
+	StringSink& operator= (const StringSink&) = delete;
+
+	void write (std::string_view text) final;
+
+	void write (char character) final;
+
+	void reserve (std::size_t numBytes) final;
+
+	/** Returns the string that has been written so far. */
+	[[nodiscard]] std::string& getString() noexcept;
+
+private:
+	std::string	 ownedString;
+	std::string& string { ownedString };
+};
+
+/** An output sink that writes to a \c std::ostream .
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT StreamSink final : public OutputSink
+{
+public:
+	/** Creates a sink that writes to the given stream, which must outlive the sink. */
+	explicit StreamSink (std::ostream& streamToWriteTo) noexcept;
+
+	void write (std::string_view text) final;
+
+	void write (char character) final;
+
+	void flush() final;
+
+private:
+	std::ostream& stream;
+};
+
+/** An output sink that discards its output, and only counts how many bytes were written to it.
+
+	@see Printer::measure()
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT CountingSink final : public OutputSink
+{
+public:
+	void write (std::string_view text) final;
+
+	void write (char character) final;
+
+	/** Returns the total number of bytes written so far. */
+	[[nodiscard]] std::size_t getNumBytesWritten() const noexcept;
+
+private:
+	std::size_t numBytes { 0 };
+};
+
+/** An output sink that writes to a file through a fixed-size buffer.
+
+	The file is created if it doesn't exist, and truncated if it does. When \c reserve() is
+	called, the space is preallocated on disk where the platform supports it, which avoids
+	fragmentation and makes running out of disk space an early error.
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT FileSink final : public OutputSink
+{
+public:
+	/** Opens the file for writing.
+		@throws std::system_error An exception is thrown if the file can't be opened.
+	 */
+	explicit FileSink (const std::filesystem::path& path);
+
+	/** Flushes any buffered output and closes the file. Errors that occur while flushing are
+		ignored here, so call \c flush() first if you need to know about them.
+	 */
+	~FileSink() override;
+
+	FileSink (const FileSink&)			  = delete;
+	FileSink& operator= (const FileSink&) = delete;
+
+	/** @throws std::system_error An exception is thrown if writing to the file fails. */
+	void write (std::string_view text) final;
+
+	/** @throws std::system_error An exception is thrown if writing to the file fails. */
+	void write (char character) final;
+
+	/** @throws std::system_error An exception is thrown if writing to the file fails. */
+	void flush() final;
+
+	void reserve (std::size_t numBytes) final;
+
+private:
+	void writeToFile (const char* data, std::size_t size);
+
+	static constexpr std::size_t bufferSize = 65536;
+
+	int fileDescriptor { -1 };
+
+	std::size_t fileOffset { 0 };
+
+	std::unique_ptr<char[]> buffer;
+	std::size_t				numBuffered { 0 };
+};
+
+/** An output sink that writes to a file descriptor with scatter-gather I/O.
+
+	Text passed to \c write() is copied into a buffer, but long runs of text passed to
+	\c writeReferenced() are referenced where they are. The output is kept as a list of segments,
+	some pointing into the buffer and some pointing into the Nodes being printed, and is written
+	with a single \c writev() call per batch. This means that long strings that need no escaping
+	are never copied in user space.
+
+	Because the printed Nodes are referenced, call \c flush() (or destroy the sink) before any
+	of those Nodes are modified or destroyed.
+
+	The file descriptor isn't owned by the sink, and must be in blocking mode. On platforms
+	without \c writev() , the segments are written one at a time.
+
+	@code
+	{
+		WritevSink sink { socketFileDescriptor };
+		format.serialize (node, sink);
+		sink.flush();
+	}
+	@endcode
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT WritevSink final : public OutputSink
+{
+public:
+	/** Creates a sink that writes to the given file descriptor, which must stay open while the sink exists. */
+	explicit WritevSink (int fileDescriptorToWriteTo);
+
+	/** Writes any pending output. Errors that occur while writing are ignored here, so call
+		\c flush() first if you need to know about them.
+	 */
+	~WritevSink() override;
+
+	WritevSink (const WritevSink&)			  = delete;
+	WritevSink& operator= (const WritevSink&) = delete;
+
+	/** @throws std::system_error An exception is thrown if writing to the file descriptor fails. */
+	void write (std::string_view text) final;
+
+	/** @throws std::system_error An exception is thrown if writing to the file descriptor fails. */
+	void write (char character) final;
+
+	/** Text shorter than a few hundred bytes is copied, because a separate segment would cost more than the copy.
+		@throws std::system_error An exception is thrown if writing to the file descriptor fails.
+	 */
+	void writeReferenced (std::string_view text) final;
+
+	/** @throws std::system_error An exception is thrown if writing to the file descriptor fails. */
+	void flush() final;
+
+private:
+	void addSegment (const char* data, std::size_t size);
+
+	void writeSegments();
+
+	static constexpr std::size_t bufferSize = 65536;
+
+	int fileDescriptor;
+
+	std::unique_ptr<char[]> buffer;
+	std::size_t				numBuffered { 0 };
+
+	std::vector<::iovec> segments;
+};
+
+}  // namespace limes::serializing
@@ -0,0 +1,122 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "lserializing/lserializing_Export.h"
+#include "lserializing/lserializing_SerializingFormat.h"
+#include "lserializing/lserializing_Node.h"
+
+/** @file
+	This file defines the serializing::PackedFormat class.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+/** Limits enforced while parsing the packed format.
+
+	@see PackedFormat
+
+	@ingroup limes_serializing
+ */
+struct LSERIAL_EXPORT PackedParserLimits final
+{
+	/** The maximum number of bytes of key text that the tables in one document can copy into
+		their rows, in total. Each row gets a copy of every key in its table's shape, so a small
+		document with long keys and many rows can otherwise expand to a huge tree. Set this to the
+		largest \c std::size_t to remove the limit.
+	 */
+	std::size_t maxTableKeyBytes { std::size_t { 64 } * 1024 * 1024 };
+};
+
+/** A compact binary format for documents made of arrays of objects that all have the same keys,
+	such as logs and table exports.
+
+	In JSON and the other self-describing formats, every object repeats all of its keys, so for
+	an array of many small records, the key text can be a large part of the document. This
+	format writes an array of two or more non-empty objects that all have exactly the same keys
+	as a table: the set of keys (its "shape") is written once, and then each row holds only its
+	values, in the same order. Shapes are numbered as they're first written, so later tables with
+	the same keys, even nested ones, refer to the shape by number instead of repeating it.
+
+	Everything else is written much as in MessagePack: integral numbers as zigzag varints, other
+	numbers as 8-byte doubles, and strings and containers with a varint length. Data in this
+	format starts with the bytes \c "LSPK" and a version byte.
+
+	When parsing, each table row is built from the shape's keys, which are already in the sorted
+	order an Object keeps, so each member is simply appended to the row. Parsing fails if the rows
+	of a document's tables would copy more than \c PackedParserLimits::maxTableKeyBytes bytes of
+	keys.
+
+	Containers may be nested at most 512 deep. Errors are reported with their byte offset in the
+	message; their line and column aren't meaningful.
+
+	An instance of this class is registered with \c KnownFormats .
+
+	@see formats::Packed
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT PackedFormat final : public Format
+{
+public:
+	/** Creates a format that parses with the default limits. This is the one registered with \c KnownFormats . */
+	PackedFormat() = default;
+
+	/** Creates a format that parses with the given limits. */
+	explicit PackedFormat (const PackedParserLimits& limitsToUse) noexcept;
+
+	/** Returns the limits that this format parses with. */
+	[[nodiscard]] const PackedParserLimits& getLimits() const noexcept;
+
+	/** @name Information queries */
+	///@{
+	[[nodiscard]] std::string_view getName() const noexcept final;
+
+	[[nodiscard]] const std::vector<std::string_view>& getFileExtensions() const noexcept final;
+
+	bool supportsComments() const noexcept final;
+
+	/** Returns true if the data starts with this format's header. */
+	[[nodiscard]] bool probablyMatchesString (std::string_view string) const noexcept final;
+	///@}
+
+	/** @name Parsing */
+	///@{
+	[[nodiscard]] Node parse (std::string_view string) const final;
+
+	/** Parses the given data, without throwing if it isn't valid.
+
+		Like the JSON parser, this parser reports errors without any stack unwinding.
+	 */
+	[[nodiscard]] ParseResult tryParse (std::string_view string) const final;
+	///@}
+
+	/** @name Printing */
+	///@{
+	[[nodiscard]] std::unique_ptr<Printer> createPrinter (bool shouldPrettyPrint) const noexcept final;
+	///@}
+
+private:
+	PackedParserLimits limits;
+};
+
+}  // namespace limes::serializing
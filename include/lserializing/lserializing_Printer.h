@@ -14,10 +14,12 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string_view>
 #include <string>
 #include "lserializing/lserializing_Export.h"
 #include "lserializing/lserializing_Node.h"
+#include "lserializing/lserializing_OutputSink.h"
 
 /** @file
 	This file defines the serializing::Printer class.
@@ -28,19 +30,22 @@
 namespace limes::serializing
 {
 
-/** This class prints some data into a string in a specific serialization
-	format, and offers an API for controlling pretty printing, etc.
+/** This class prints some data in a specific serialization format, and offers
+	an API for controlling pretty printing, etc.
+
+	A printer appends its output to an \c OutputSink as it traverses the tree of
+	Nodes, so each byte of the output is written exactly once, into one final
+	destination.
 
 	Formats can define their own printer types, and users can also choose to
 	create a custom printer to use instead of a format's default printer.
 
-	Printer objects should generally be temporary; you should create one, call
-	its \c print() method to get your string, and then create a new printer
-	object the next time you need to serialize to a string.
+	A printer may be reused once \c print() has returned, so a single printer
+	can serialize any number of Nodes. Printers aren't thread-safe, though.
 
 	@ingroup limes_serializing
 
-	@see Format
+	@see Format, OutputSink, Serializer
  */
 class LSERIAL_EXPORT Printer
 {
@@ -48,29 +53,44 @@ class LSERIAL_EXPORT Printer
 	/** Destructor. */
 	virtual ~Printer() = default;
 
-	/** Serializes the \c Node into a string, using the formatting rules of this
-		printer.
+	/** Serializes the \c Node into the output sink, using the formatting rules of
+		this printer.
 
-		The default implementation traverses the tree of Nodes and calls all of the
-		private virtual methods to print each node in the tree, but implementations
+		The default implementation dispatches on the type of the node and calls the
+		private virtual methods to print it; the \c printArray() and \c printObject()
+		implementations call this method again for each child node. Implementations
 		can override this method to provide entirely custom behavior. Note that if
 		you override this, you are responsible for calling \c arrayBegin() and friends,
 		they normally get called by the base class's implementation of this method.
 	 */
-	[[nodiscard]] virtual std::string print (const Node& node);
+	virtual void print (const Node& node, OutputSink& sink);
+
+	/** Serializes the \c Node into a string, using the formatting rules of this
+		printer. This just calls the other \c print() overload with a \c StringSink .
+	 */
+	[[nodiscard]] std::string print (const Node& node);
+
+	/** Returns the exact number of bytes that \c print() would write for the \c Node .
+
+		This runs the printer into a \c CountingSink , so the sizes of escaped strings and
+		formatted numbers are computed by exactly the same code that prints them. It's useful
+		for allocating the output buffer once, or preallocating an output file; see
+		\c OutputSink::reserve() .
+	 */
+	[[nodiscard]] std::size_t measure (const Node& node);
 
 private:
 	/** Must output a representation of a "null" Node. */
-	virtual std::string printNull() = 0;
+	virtual void printNull (OutputSink& sink) = 0;
 
 	/** Must print the given number. */
-	virtual std::string printNumber (double) = 0;
+	virtual void printNumber (double, OutputSink& sink) = 0;
 
 	/** Must print the given string. */
-	virtual std::string printString (std::string_view) = 0;
+	virtual void printString (std::string_view, OutputSink& sink) = 0;
 
 	/** Must print the given boolean. */
-	virtual std::string printBoolean (bool) = 0;
+	virtual void printBoolean (bool, OutputSink& sink) = 0;
 
 	/** Must print the given array.
 
@@ -78,7 +98,7 @@ class LSERIAL_EXPORT Printer
 
 		@todo provide a default implementation of this?
 	 */
-	virtual std::string printArray (const Array&) = 0;
+	virtual void printArray (const Array&, OutputSink& sink) = 0;
 
 	/** Must print the given object.
 
@@ -86,7 +106,7 @@ class LSERIAL_EXPORT Printer
 
 		@todo provide a default implementation of this?
 	 */
-	virtual std::string printObject (const Object&) = 0;
+	virtual void printObject (const Object&, OutputSink& sink) = 0;
 
 	/** Called before \c printArray() ; implementations can override this to be
 		informed when they're about to begin printing an array.
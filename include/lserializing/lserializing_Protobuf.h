@@ -0,0 +1,143 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "lserializing/lserializing_Export.h"
+#include "lserializing/lserializing_SerializingFormat.h"
+#include "lserializing/lserializing_Node.h"
+
+/** @file
+	This file defines the serializing::ProtobufFormat class.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+namespace protobuf
+{
+struct Descriptor;
+}
+
+/** An exception thrown by the \c ProtobufFormat constructor if its descriptor is malformed.
+	@ingroup limes_serializing
+ */
+struct LSERIAL_EXPORT ProtobufDescriptorError final : public std::runtime_error
+{
+	explicit ProtobufDescriptorError (const std::string& message);
+};
+
+/** Reads and writes the Protobuf wire format, without needing libprotobuf or generated code.
+
+	Since the wire format only identifies fields by number, each instance of this class is
+	created with a descriptor of the messages it handles, which is itself a Node. It looks like
+	this, in JSON:
+
+	@code{.json}
+	{
+	  "root": "Person",
+	  "messages": {
+	    "Person": {
+	      "id":       { "number": 1, "type": "int64" },
+	      "name":     { "number": 2, "type": "string" },
+	      "scores":   { "number": 3, "type": "double", "repeated": true },
+	      "children": { "number": 4, "type": "message", "message": "Person", "repeated": true }
+	    }
+	  }
+	}
+	@endcode
+
+	Each message maps field names to field descriptors. Field types are the scalar types of the
+	\c .proto language, \c "enum" (which is read and written as an int32), and \c "message" ,
+	which names another message in the descriptor. Repeated numeric fields are written packed,
+	as in proto3, unless their descriptor has \c "packed": false ; the parser accepts both
+	encodings.
+
+	Messages are Object Nodes whose members are named by their fields' names. Fields that are
+	missing or null aren't written, and fields that aren't in the message are skipped when
+	parsing, as protobuf does. Strings and \c bytes fields are String Nodes; 64-bit integers are
+	numbers, so values beyond 2^53 lose precision. Groups aren't supported, and messages may be
+	nested at most 100 deep, which is protobuf's own default limit.
+
+	Printing a Node that doesn't fit the descriptor, such as one with a member that isn't a
+	field, or a field with the wrong type or an out of range value, throws a
+	\c std::runtime_error . \c Format::serialize() is \c noexcept , so it returns an empty
+	string instead, which is also the encoding of an empty message; use the sink overload of
+	\c serialize() or print through \c createPrinter() if the Node might not fit.
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT ProtobufFormat final : public Format
+{
+public:
+	/** Creates a format for the messages described by the given descriptor.
+
+		The descriptor is compiled into lookup tables once, here, so that parsing and printing
+		never look anything up by name in the descriptor.
+
+		@throws ProtobufDescriptorError An exception is thrown if the descriptor is malformed.
+	 */
+	explicit ProtobufFormat (const Node& descriptor);
+
+	/** @name Information queries */
+	///@{
+	[[nodiscard]] std::string_view getName() const noexcept final;
+
+	[[nodiscard]] const std::vector<std::string_view>& getFileExtensions() const noexcept final;
+
+	bool supportsComments() const noexcept final;
+
+	/** Always returns false, because the wire format has no signature to recognize it by. */
+	[[nodiscard]] bool probablyMatchesString (std::string_view string) const noexcept final;
+	///@}
+
+	/** @name Parsing */
+	///@{
+	[[nodiscard]] Node parse (std::string_view string) const final;
+
+	/** Parses the given data, without throwing if it isn't a valid message.
+
+		Like the JSON parser, the Protobuf parser reports errors without any stack unwinding.
+	 */
+	[[nodiscard]] ParseResult tryParse (std::string_view string) const final;
+	///@}
+
+	/** @name Printing */
+	///@{
+	[[nodiscard]] std::unique_ptr<Printer> createPrinter (bool shouldPrettyPrint) const noexcept final;
+
+	using Format::serialize;
+
+	/** Serializes the message in the \c Node to a string.
+
+		The printer measures its output before writing any of it anyway, so unlike the base
+		class's implementation, this doesn't run a separate measuring pass first.
+
+		Returns an empty string if the Node doesn't fit the descriptor.
+	 */
+	[[nodiscard]] std::string serialize (const Node& node, bool shouldPrettyPrint = false) const noexcept final;
+	///@}
+
+private:
+	std::shared_ptr<const protobuf::Descriptor> descriptor;
+};
+
+}  // namespace limes::serializing
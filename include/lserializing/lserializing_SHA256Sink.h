@@ -0,0 +1,83 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "lserializing/lserializing_Export.h"
+#include "lserializing/lserializing_OutputSink.h"
+
+/** @file
+	This file defines the serializing::SHA256Sink class.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+/** An output sink that computes the SHA-256 hash of everything written to it.
+
+	The output is hashed as it's written, 64 bytes at a time, so the serialized text is never
+	stored. Combined with a canonical printer, this hashes a document in a single streaming pass:
+
+	@code
+	SHA256Sink sink;
+
+	JSONFormat {}.createPrinter (JSONPrinterOptions { .canonical = true })->print (document, sink);
+
+	const auto digest = sink.getHexDigest();
+	@endcode
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT SHA256Sink final : public OutputSink
+{
+public:
+	/** The hash of the data, in big-endian byte order. */
+	using Digest = std::array<std::uint8_t, 32>;
+
+	/** Creates a sink with nothing written to it yet. */
+	SHA256Sink() noexcept;
+
+	void write (std::string_view text) final;
+
+	void write (char character) final;
+
+	/** Returns the hash of everything that has been written so far.
+		The sink can continue to be written to afterwards.
+	 */
+	[[nodiscard]] Digest getDigest() const noexcept;
+
+	/** Returns the hash of everything that has been written so far, as 64 lowercase hex digits. */
+	[[nodiscard]] std::string getHexDigest() const;
+
+	/** Discards everything written so far, so the sink can be used to hash something else. */
+	void reset() noexcept;
+
+private:
+	std::array<std::uint32_t, 8> state;
+
+	std::array<std::uint8_t, 64> block;
+
+	std::size_t numBuffered { 0 };
+
+	std::uint64_t totalLength { 0 };
+};
+
+}  // namespace limes::serializing
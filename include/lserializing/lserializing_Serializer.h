@@ -0,0 +1,99 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include "lserializing/lserializing_Export.h"
+#include "lserializing/lserializing_Node.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include "lserializing/lserializing_Printer.h"
+
+/** @file
+	This file defines the serializing::Serializer class.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+class Format;
+
+/** A reusable object for serializing many Nodes with the same printer.
+
+	\c Format::serialize() creates a new printer and a new output string for every call. When
+	serializing large numbers of small messages, those allocations can cost as much as the
+	printing itself. A Serializer creates its printer once, and keeps its output buffer between
+	calls, so once the buffer has grown to the size of the largest message, serializing doesn't
+	allocate at all.
+
+	A Serializer isn't thread-safe; use one per thread.
+
+	@code
+	Serializer serializer { JSONFormat {} };
+
+	for (const auto& message : messages)
+		socket.send (serializer.serialize (message));
+	@endcode
+
+	@see Format::serialize()
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT Serializer final
+{
+public:
+	/** Creates a serializer that uses the printer created by the format's \c createPrinter() method.
+		The format object isn't used after this constructor returns.
+	 */
+	explicit Serializer (const Format& format, bool shouldPrettyPrint = false);
+
+	/** Creates a serializer that uses the given printer. */
+	explicit Serializer (std::unique_ptr<Printer> printerToUse) noexcept;
+
+	/** Serializes the \c Node into the serializer's internal buffer.
+
+		The returned view is only valid until the next call to this method, or until the
+		serializer is destroyed.
+	 */
+	[[nodiscard]] std::string_view serialize (const Node& node);
+
+	/** Serializes the \c Node by appending it to the given string.
+
+		This is useful for batching several messages into a buffer that the caller owns and
+		reuses. Nothing is allocated if the string already has enough capacity.
+	 */
+	void serializeInto (const Node& node, std::string& output);
+
+	/** Serializes the \c Node into the given output sink. */
+	void serialize (const Node& node, OutputSink& sink);
+
+	/** Frees the memory used by the internal buffer.
+		Call this after serializing an unusually large message, if the memory is needed elsewhere.
+	 */
+	void releaseBuffer() noexcept;
+
+	/** Returns the printer used by this serializer. */
+	[[nodiscard]] Printer& getPrinter() const noexcept;
+
+private:
+	std::unique_ptr<Printer> printer;
+
+	std::string buffer;
+};
+
+}  // namespace limes::serializing
@@ -14,13 +14,18 @@
 
 #pragma once
 
+#include <filesystem>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <memory>
+#include <stdexcept>
+#include <variant>
+#include "lserializing/lserializing_Compression.h"
 #include "lserializing/lserializing_Export.h"
 #include "lserializing/lserializing_Node.h"
 #include "lserializing/lserializing_Printer.h"
+#include "lserializing/lserializing_OutputSink.h"
 #include "lserializing/lserializing_Schema.h"
 
 /** @file
@@ -46,6 +51,49 @@ struct LSERIAL_EXPORT ParseError final : public std::runtime_error
 	text::utf8::LineAndColumn position;
 };
 
+/** The result of \c Format::tryParse() .
+
+	This holds either the \c Node that was parsed, or the \c ParseError describing why parsing
+	failed. Unlike \c Format::parse() , which throws the \c ParseError , this lets parse failures
+	be handled without any stack unwinding, which is much cheaper when failures are expected,
+	such as when probing which format some input is in.
+
+	@see Format::tryParse()
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT ParseResult final
+{
+public:
+	/** Creates a successful result holding the given %node. */
+	ParseResult (Node&& node) noexcept;	 // NOLINT
+
+	/** Creates a failed result holding the given error. */
+	ParseResult (ParseError&& error) noexcept;	// NOLINT
+
+	/** Returns true if parsing succeeded. */
+	[[nodiscard]] bool hasValue() const noexcept;
+
+	/** Returns true if parsing succeeded. */
+	explicit operator bool() const noexcept;
+
+	/** Returns the parsed %node.
+
+		@throws ParseError If parsing failed, the error is thrown.
+	 */
+	[[nodiscard]] Node&		  getNode();
+	[[nodiscard]] const Node& getNode() const;
+
+	/** Returns the error that caused parsing to fail.
+
+		@throws std::runtime_error An exception is thrown if parsing succeeded.
+	 */
+	[[nodiscard]] const ParseError& getError() const;
+
+private:
+	std::variant<Node, ParseError> result;
+};
+
 /** This class represents a serialization format.
 
 	You will usually get a Format object from the \c KnownFormats manager class. You should
@@ -88,10 +136,9 @@ class LSERIAL_EXPORT Format
 
 	/** This function should return true if the passed string looks like valid data for this format.
 
-		The default implementation just calls \c parse() , catches any exceptions, and returns \c false
-		if one is thrown, and \c true otherwise. Obviously this is far from ideal for performance,
-		so if you are implementing a custom format, you are highly encouraged to override this
-		method with something clever for your format.
+		The default implementation just calls \c tryParse() and returns whether it succeeded. This
+		builds and then throws away a whole tree of Nodes, so if you are implementing a custom format,
+		you are highly encouraged to override this method with something clever for your format.
 
 		@todo A better base class implementation for this?
 	 */
@@ -102,9 +149,40 @@ class LSERIAL_EXPORT Format
 	/** @name Parsing and validating */
 	///@{
 
-	/** This function parses the given string and returns a \c Node object populated with the data. */
+	/** This function parses the given string and returns a \c Node object populated with the data.
+
+		@throws ParseError An exception is thrown if the string can't be parsed.
+
+		@see tryParse()
+	 */
 	[[nodiscard]] virtual Node parse (std::string_view string) const = 0;
 
+	/** Parses the given string, reporting errors through the returned result instead of by throwing.
+
+		The default implementation calls \c parse() and catches any \c ParseError it throws, so custom
+		formats should override this if they can report errors without throwing.
+
+		@see parse()
+	 */
+	[[nodiscard]] virtual ParseResult tryParse (std::string_view string) const;
+
+	/** Parses the contents of a file.
+
+		The file is memory-mapped read-only and parsed in place where the platform supports it,
+		so its contents are never copied into an intermediate string. The mapping is released
+		before this function returns; the returned \c Node owns copies of all of its data.
+
+		If the file is compressed, which is detected from its first bytes, it is decompressed
+		into a single buffer that is parsed in place.
+
+		@throws std::system_error An exception is thrown if the file can't be opened or mapped.
+		@throws CompressionError An exception is thrown if the file is compressed but can't be decompressed.
+		@throws ParseError An exception is thrown if the file's contents can't be parsed.
+
+		@see KnownFormats::parseFile()
+	 */
+	[[nodiscard]] Node parseFile (const std::filesystem::path& path) const;
+
 	/** Creates a \c Schema object from some data.
 
 		Not all formats support schema, so this may return \c nullptr .
@@ -124,11 +202,36 @@ class LSERIAL_EXPORT Format
 
 	/** Serializes the data in the \c Node to a string in this format.
 
-		The default implementation calls \c createPrinter() and then calls the printer object's \c print()
-		method, but custom formats may override this method to bypass this logic.
+		The default implementation calls \c createPrinter() , measures the exact size of the output
+		with the printer's \c measure() method so that the string is only allocated once, and then
+		calls the printer's \c print() method. Custom formats may override this method to bypass
+		this logic.
 	 */
 	[[nodiscard]] virtual std::string serialize (const Node& node, bool shouldPrettyPrint = false) const noexcept;
 
+	/** Serializes the data in the \c Node into an output sink in this format.
+
+		The default implementation calls \c createPrinter() and then calls the printer object's \c print()
+		method with the sink, so the output is appended directly to the sink's destination.
+	 */
+	virtual void serialize (const Node& node, OutputSink& sink, bool shouldPrettyPrint = false) const;
+
+	/** Serializes the data in the \c Node into a file in this format.
+
+		The size of the output is measured first, and the file's space is preallocated where the
+		platform supports it.
+
+		If a compression type is given, the output is compressed as it is printed, so the
+		uncompressed text is never held in memory. In that case the size isn't measured.
+
+		@throws std::system_error An exception is thrown if the file can't be written.
+		@throws CompressionError An exception is thrown if the compression type isn't available.
+
+		@see FileSink, CompressingSink
+	 */
+	void serializeToFile (const Node& node, const std::filesystem::path& path, bool shouldPrettyPrint = false,
+						  CompressionType compression = CompressionType::None) const;
+
 	///@}
 
 	/** Converts a string in this format to another serialization format.
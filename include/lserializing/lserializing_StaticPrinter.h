@@ -0,0 +1,123 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include "lserializing/lserializing_Node.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include "lserializing/lserializing_Printer.h"
+
+/** @file
+	This file defines the serializing::StaticPrinter class template.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+/** A base class for printers whose traversal is resolved at compile time.
+
+	The default \c Printer::print() checks the node's type with a chain of \c isX() calls and
+	then makes a virtual call to print the value, plus virtual calls to the array and object
+	hooks. For trees with millions of small values, that dispatch costs more than printing
+	the values themselves.
+
+	A printer that inherits from \c StaticPrinter<Derived> implements the same private methods
+	as any other printer (\c printNull() , \c printNumber() , and so on), but \c print()
+	dispatches on the node's type once, with a switch, and calls the derived class's methods
+	directly. When \c printArray() and \c printObject() call \c print() for each child, that
+	call is also resolved statically, so traversing the tree makes no virtual calls at all.
+
+	The derived class must be \c final , and must befriend its base class so that the private
+	methods can be called. The \c arrayBegin() family of hooks are optional, and are only
+	called if the derived class declares them.
+
+	Because this class inherits from \c Printer , a static printer can still be returned from
+	\c Format::createPrinter() and used through the virtual interface; only the outermost call
+	to \c print() is virtual.
+
+	@code
+	class MyPrinter final : public StaticPrinter<MyPrinter>
+	{
+		friend class StaticPrinter<MyPrinter>;
+
+		void printNull (OutputSink& sink) final { sink.write ("null"); }
+
+		// ...
+	};
+	@endcode
+
+	@ingroup limes_serializing
+ */
+template <class Derived>
+class StaticPrinter : public Printer
+{
+public:
+	using Printer::print;
+
+	/** Serializes the \c Node into the output sink, dispatching on its type with a single switch. */
+	void print (const Node& node, OutputSink& sink) final
+	{
+		static_assert (std::is_final_v<Derived>,
+					   "Classes deriving from StaticPrinter must be final, so that their methods can be called directly");
+
+		auto& self = static_cast<Derived&> (*this);
+
+		node.visit ([&self, &sink]<typename Value> (const Value& value)
+					{
+						if constexpr (std::is_same_v<Value, std::nullptr_t>)
+						{
+							self.printNull (sink);
+						}
+						else if constexpr (std::is_same_v<Value, double>)
+						{
+							self.printNumber (value, sink);
+						}
+						else if constexpr (std::is_same_v<Value, std::string_view>)
+						{
+							self.printString (value, sink);
+						}
+						else if constexpr (std::is_same_v<Value, bool>)
+						{
+							self.printBoolean (value, sink);
+						}
+						else if constexpr (std::is_same_v<Value, Array>)
+						{
+							if constexpr (requires { self.arrayBegin(); })
+								self.arrayBegin();
+
+							self.printArray (value, sink);
+
+							if constexpr (requires { self.arrayEnd(); })
+								self.arrayEnd();
+						}
+						else
+						{
+							if constexpr (requires { self.objectBegin(); })
+								self.objectBegin();
+
+							self.printObject (value, sink);
+
+							if constexpr (requires { self.objectEnd(); })
+								self.objectEnd();
+						}
+					});
+	}
+};
+
+}  // namespace limes::serializing
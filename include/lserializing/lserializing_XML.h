@@ -0,0 +1,187 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "lserializing/lserializing_Export.h"
+#include "lserializing/lserializing_SerializingFormat.h"
+#include "lserializing/lserializing_Node.h"
+
+/** @file
+	This file defines the serializing::XMLFormat class.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+/** An attribute of an XML element, as passed to \c XMLHandler::startElement() .
+	@ingroup limes_serializing
+ */
+struct LSERIAL_EXPORT XMLAttribute final
+{
+	std::string_view name;
+
+	/** The attribute's value, with entities decoded and whitespace normalized. */
+	std::string_view value;
+};
+
+/** Receives the contents of an XML document as it is parsed.
+
+	This is a SAX-style interface: \c XMLFormat::parse(std::string_view, XMLHandler&) const calls
+	these functions in document order, without building any Nodes. The names, values and text
+	passed to them point into the input wherever the input can be used as it is, and into a
+	buffer of decoded text where it contains entities; either way, they are only valid until
+	the function returns.
+
+	Comments, processing instructions, the XML declaration and the document type declaration
+	are skipped.
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT XMLHandler
+{
+public:
+	virtual ~XMLHandler() = default;
+
+	/** Called for each start tag, and for each empty-element tag, which is followed immediately by a call to \c endElement() . */
+	virtual void startElement (std::string_view name, std::span<const XMLAttribute> attributes) = 0;
+
+	/** Called for each end tag. */
+	virtual void endElement (std::string_view name) = 0;
+
+	/** Called with character data and the contents of CDATA sections. The text of an element
+		may be split across several calls, for example around entities or comments.
+	 */
+	virtual void text (std::string_view text) = 0;
+};
+
+/** Options for the printers created by \c XMLFormat::createPrinter() .
+	@ingroup limes_serializing
+ */
+struct LSERIAL_EXPORT XMLPrinterOptions final
+{
+	/** If true, Object members named \c @name with scalar values are written as attributes, and
+		a member named \c \#text is written as the element's text, which is the inverse of how
+		the parser maps XML onto Nodes. If false, every member is written as a child element.
+	 */
+	bool mapAttributes { true };
+
+	/** If true, child elements are written on lines of their own, indented by two spaces per
+		level. Elements with text are never indented inside, because that would change the text.
+	 */
+	bool prettyPrint { false };
+
+	/** If true, the output starts with an XML declaration. */
+	bool writeDeclaration { true };
+
+	/** The name of the root element, used when the Node being printed isn't an Object with a
+		single member that can become the root element.
+	 */
+	std::string rootElementName { "root" };
+};
+
+/** The XML serialization format.
+
+	An instance of this class is registered with \c KnownFormats . This class is public so that
+	the XML-specific APIs it offers in addition to the \c Format interface are accessible.
+
+	The parser reads XML 1.0 in UTF-8. Elements and attributes are mapped onto Nodes like this:
+	- The document becomes an Object with one member, named after the root element, whose value
+	  is the root element's value.
+	- An element with no attributes and no child elements becomes a String holding its text, or
+	  Null if it has no text at all.
+	- Any other element becomes an Object. Each attribute is a String member named \c @name , and
+	  each child element is a member named after the element. If the element has text other
+	  than whitespace, it is in a member named \c \#text ; the text of mixed content is
+	  concatenated.
+	- A child element name that appears more than once becomes an Array of the elements' values,
+	  in document order.
+
+	Values are never converted to numbers or booleans, because XML doesn't say what type they
+	are. Namespace prefixes are kept as part of the names. Only the five predefined entities and
+	character references are decoded; entities declared in a DTD aren't supported.
+
+	The printer does the reverse, so that parsing its output gives back the same structure:
+	- An Object with a single member becomes the root element; any other Node is written as the
+	  content of a root element named by \c XMLPrinterOptions::rootElementName .
+	- Each member of an Object becomes a child element named after the key, and an Array becomes
+	  one element per item, all with the same name. An Array nested directly in another Array
+	  is written as an element with an \c item child per item, and an empty Array is omitted.
+	- Numbers and booleans are written as text, and Null as an empty element.
+	- Keys that aren't valid XML names have their invalid characters replaced with underscores.
+	- Control characters other than tab, line feed and carriage return can't be represented in
+	  XML 1.0, so they're written as U+FFFD, as is any invalid UTF-8.
+
+	The output is written to the sink as the Nodes are traversed, so printing needs no memory
+	beyond the sink's own.
+
+	@see formats::XML
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT XMLFormat final : public Format
+{
+public:
+	/** @name Information queries */
+	///@{
+	[[nodiscard]] std::string_view getName() const noexcept final;
+
+	[[nodiscard]] const std::vector<std::string_view>& getFileExtensions() const noexcept final;
+
+	bool supportsComments() const noexcept final;
+
+	/** Returns true if the string, after any whitespace, starts with markup. This doesn't
+		parse the document.
+	 */
+	[[nodiscard]] bool probablyMatchesString (std::string_view string) const noexcept final;
+	///@}
+
+	/** @name Parsing */
+	///@{
+
+	[[nodiscard]] Node parse (std::string_view string) const final;
+
+	/** Parses the given string, without throwing if it isn't well-formed XML. */
+	[[nodiscard]] ParseResult tryParse (std::string_view string) const final;
+
+	/** Parses the given string, passing its contents to a handler instead of building Nodes.
+
+		The document is checked for well-formedness as it is read, so the handler may have been
+		called for the start of the document before an error is found.
+
+		@throws ParseError An exception is thrown if the string isn't well-formed XML.
+	 */
+	void parse (std::string_view string, XMLHandler& handler) const;
+
+	///@}
+
+	/** @name Schema and printing */
+	///@{
+	[[nodiscard]] std::unique_ptr<Printer> createPrinter (bool shouldPrettyPrint) const noexcept final;
+
+	/** Creates a printer that writes XML using the given options. */
+	[[nodiscard]] std::unique_ptr<Printer> createPrinter (const XMLPrinterOptions& options) const;
+
+	[[nodiscard]] std::unique_ptr<Schema> createSchemaFrom (const Node& data) const noexcept final;
+	///@}
+};
+
+}  // namespace limes::serializing
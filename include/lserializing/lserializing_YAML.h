@@ -0,0 +1,167 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "lserializing/lserializing_Export.h"
+#include "lserializing/lserializing_SerializingFormat.h"
+#include "lserializing/lserializing_Node.h"
+
+/** @file
+	This file defines the serializing::YAMLFormat class.
+
+	@ingroup limes_serializing
+ */
+
+namespace limes::serializing
+{
+
+/** Limits enforced while parsing YAML.
+
+	@see YAMLFormat
+
+	@ingroup limes_serializing
+ */
+struct LSERIAL_EXPORT YAMLParserLimits final
+{
+	/** The maximum number of Nodes that the aliases in one document can create, in total. Each
+		alias counts every Node in the subtree it copies. Set this to the largest \c std::size_t
+		to remove the limit.
+	 */
+	std::size_t maxAliasNodes { 1000000 };
+};
+
+/** The YAML serialization format.
+
+	An instance of this class is registered with \c KnownFormats . This class is public so that
+	the YAML-specific APIs it offers in addition to the \c Format interface are accessible.
+
+	The parser reads YAML 1.2 in UTF-8: block and flow collections, plain, quoted, literal and
+	folded scalars, comments, and streams of several documents. Plain scalars are resolved with
+	the core schema, so \c null , \c ~ and an empty value are Null, \c true and \c false (in any of
+	their capitalizations) are Booleans, and decimal, octal (\c 0o ), hexadecimal (\c 0x ) and
+	floating-point numbers, \c .inf and \c .nan are Numbers. Quoted and block scalars are always
+	Strings. The \c !!str , \c !!int , \c !!float , \c !!bool and \c !!null tags are applied; other
+	tags are ignored.
+
+	Mapping keys must be scalars, and are used as written, so \c 1: and \c "1": are the same key.
+	Duplicate keys are an error. Merge keys ( \c <<: ) are supported: the members of the mapping, or
+	sequence of mappings, given as a merge key's value are added to the mapping unless it already
+	has members with the same keys.
+
+	Anchors are local to the document they're in. Aliases don't share the anchored subtree: a
+	Node has exactly one parent (see \c Node::getParent() ), so two places in a tree can't refer to
+	the same Node, and each alias is a deep copy of the node its anchor is on. Alias-heavy
+	documents therefore take as much memory as if every alias had been written out in full. So
+	that nested aliases can't expand a small document to an enormous tree, parsing fails if the
+	aliases in a document would create more than \c YAMLParserLimits::maxAliasNodes Nodes; a
+	format created with a higher limit accepts bigger expansions.
+
+	The printer writes block-style YAML, quoting strings only where they would otherwise be read
+	back as something else.
+
+	@see formats::YAML
+
+	@ingroup limes_serializing
+ */
+class LSERIAL_EXPORT YAMLFormat final : public Format
+{
+public:
+	/** Creates a format that parses with the default limits. This is the one registered with \c KnownFormats . */
+	YAMLFormat() = default;
+
+	/** Creates a format that parses with the given limits. */
+	explicit YAMLFormat (const YAMLParserLimits& limitsToUse) noexcept;
+
+	/** Returns the limits that this format parses with. */
+	[[nodiscard]] const YAMLParserLimits& getLimits() const noexcept;
+
+	/** @name Information queries */
+	///@{
+	[[nodiscard]] std::string_view getName() const noexcept final;
+
+	[[nodiscard]] const std::vector<std::string_view>& getFileExtensions() const noexcept final;
+
+	bool supportsComments() const noexcept final;
+
+	/** Returns true if the string starts with a YAML directive or document marker, or parses as
+		a block mapping or sequence. Almost any text is a valid YAML scalar, and JSON is valid
+		YAML too, so other documents are left for other formats to claim.
+	 */
+	[[nodiscard]] bool probablyMatchesString (std::string_view string) const noexcept final;
+	///@}
+
+	/** @name Parsing */
+	///@{
+
+	/** Parses a YAML stream. If the stream has one document, that document is returned; a stream
+		with no documents gives Null, and a stream with several gives an Array of the documents.
+
+		@see parseDocuments()
+	 */
+	[[nodiscard]] Node parse (std::string_view string) const final;
+
+	/** Parses a YAML stream without throwing if it isn't valid YAML.
+		@see parse()
+	 */
+	[[nodiscard]] ParseResult tryParse (std::string_view string) const final;
+
+	/** Parses a YAML stream, returning each of its documents.
+
+		@throws ParseError An exception is thrown if the stream isn't valid YAML.
+	 */
+	[[nodiscard]] std::vector<Node> parseDocuments (std::string_view string) const;
+
+	/** The type of function that receives each document from \c parseDocuments() . The document
+		is destroyed when the function returns, so the function may move from it.
+	 */
+	using DocumentCallback = std::function<void (Node& document)>;
+
+	/** Parses a YAML stream, passing each document to the callback as soon as it has been parsed.
+
+		Each document is destroyed once the callback returns, so a long stream can be processed
+		without holding all of its documents in memory at once. The callback is always called on
+		the calling thread, in the order of the documents in the stream.
+
+		If more than one thread is allowed, the stream is first split into sections of whole
+		documents with a quick scan for \c --- markers at the starts of lines. Up to \c numThreads
+		sections of at least 64 KB each are then parsed at once, and their documents are passed to
+		the callback before the next sections are parsed, so that memory use is bounded by the
+		size of those sections rather than the size of the stream. Streams too small to benefit
+		are parsed on the calling thread. The documents, and any error, are the same either way.
+
+		@param string The YAML stream
+		@param callback The function to call with each document
+		@param numThreads The maximum number of threads to use. If this is 0, the number of
+		hardware threads is used.
+
+		@throws ParseError An exception is thrown if the stream isn't valid YAML. The callback has
+		been called with each of the documents before the invalid one.
+	 */
+	void parseDocuments (std::string_view string, const DocumentCallback& callback, std::size_t numThreads = 1) const;
+
+	///@}
+
+	[[nodiscard]] std::unique_ptr<Printer> createPrinter (bool shouldPrettyPrint) const noexcept final;
+
+private:
+	YAMLParserLimits limits;
+};
+
+}  // namespace limes::serializing
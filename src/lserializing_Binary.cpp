@@ -0,0 +1,718 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "lserializing/lserializing_Binary.h"
+#include "lserializing/lserializing_KnownFormats.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include "lserializing_MappedFile.h"
+#include "lserializing_Varint.h"
+
+namespace limes::serializing
+{
+
+LSERIAL_NO_EXPORT static const KnownFormats::Register<BinaryFormat> binary_init;
+
+std::string_view BinaryFormat::getName() const noexcept
+{
+	return formats::Binary;
+}
+
+bool BinaryFormat::supportsComments() const noexcept
+{
+	return false;
+}
+
+const std::vector<std::string_view>& BinaryFormat::getFileExtensions() const noexcept
+{
+	struct ExtensionsHolder final
+	{
+		std::vector<std::string_view> xtns;
+
+		ExtensionsHolder()
+		{
+			xtns.emplace_back (".lsb");
+		}
+	};
+
+	static const ExtensionsHolder holder;
+
+	return holder.xtns;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// The layout of a document is:
+//	 header		  "LSBN", a version byte, and 3 zero bytes
+//	 records	  one per value, each starting with one of the tags below
+//	 root		  the 8-byte offset of the root value's record
+//
+// Offsets are 8 bytes, counted from the start of the header. String lengths and container sizes
+// are LEB128 varints. A container's children are always written before it, so a child's offset
+// is always less than its parent's; checking this when reading also rules out cycles.
+namespace binary
+{
+
+static constexpr std::string_view header { "LSBN\x01\0\0\0", 8 };
+
+static constexpr auto offsetSize = std::size_t { 8 };
+
+static constexpr auto minDocumentSize = header.size() + 1 + offsetSize;
+
+static constexpr auto maxDepth = std::size_t { 512 };
+
+enum Tag : unsigned char
+{
+	nullTag = 0,
+	falseTag,
+	trueTag,
+	numberTag,	  // followed by an 8-byte double
+	stringTag,	  // followed by the length, then the bytes
+	arrayTag,	  // followed by the size, then the offset of each element
+	objectTag	  // followed by the size, then the offsets of each name and value, sorted by name
+};
+
+[[noreturn]] static void throwMalformed (std::string_view message)
+{
+	throw ParseError { message, {} };
+}
+
+static inline std::uint64_t loadUInt64 (const char* data) noexcept
+{
+	std::uint64_t value { 0 };
+
+	for (auto i = 0UL; i < offsetSize; ++i)
+		value |= std::uint64_t { static_cast<unsigned char> (data[i]) } << (i * 8UL);
+
+	return value;
+}
+
+static inline void storeUInt64 (std::uint64_t value, char* data) noexcept
+{
+	for (auto i = 0UL; i < offsetSize; ++i)
+		data[i] = static_cast<char> (static_cast<unsigned char> (value >> (i * 8UL)));
+}
+
+}  // namespace binary
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+BinaryView::BinaryView (const char* documentToUse, std::size_t documentSizeToUse, std::uint64_t offsetToUse) noexcept
+	: document (documentToUse), documentSize (documentSizeToUse), offset (offsetToUse)
+{
+}
+
+unsigned char BinaryView::getTag() const noexcept
+{
+	// views are only ever created for offsets inside the document
+	return static_cast<unsigned char> (document[offset]);
+}
+
+BinaryView BinaryView::getChildAt (std::uint64_t childOffset) const
+{
+	if (childOffset >= offset)
+		binary::throwMalformed ("Binary document: a child must come before its parent");
+
+	return { document, documentSize, childOffset };
+}
+
+std::uint64_t BinaryView::readOffset (std::uint64_t position) const
+{
+	if (position > documentSize || documentSize - position < binary::offsetSize)
+		binary::throwMalformed ("Binary document: offset table is out of bounds");
+
+	return binary::loadUInt64 (document + position);
+}
+
+static std::uint64_t readVarint (const char* document, std::size_t documentSize, std::uint64_t& position)
+{
+	if (position > documentSize)
+		binary::throwMalformed ("Binary document: truncated length");
+
+	const auto* p = document + position;
+
+	std::uint64_t value;
+
+	const auto result = varint::read (p, document + documentSize, value);
+
+	if (result == varint::ReadResult::truncated)
+		binary::throwMalformed ("Binary document: truncated length");
+
+	if (result == varint::ReadResult::tooLong)
+		binary::throwMalformed ("Binary document: length is too long");
+
+	position = static_cast<std::uint64_t> (p - document);
+
+	return value;
+}
+
+std::uint64_t BinaryView::readCount (std::size_t entrySize, std::uint64_t& tableStart) const
+{
+	tableStart = offset + 1;
+
+	const auto count = readVarint (document, documentSize, tableStart);
+
+	if (count > (documentSize - tableStart) / entrySize)
+		binary::throwMalformed ("Binary document: container is out of bounds");
+
+	return count;
+}
+
+std::string_view BinaryView::readString (std::uint64_t stringOffset) const
+{
+	if (stringOffset >= documentSize || static_cast<unsigned char> (document[stringOffset]) != binary::stringTag)
+		binary::throwMalformed ("Binary document: expected a string");
+
+	auto position = stringOffset + 1;
+
+	const auto length = readVarint (document, documentSize, position);
+
+	if (length > documentSize - position)
+		binary::throwMalformed ("Binary document: string is out of bounds");
+
+	return { document + position, static_cast<std::size_t> (length) };
+}
+
+bool BinaryView::isNumber() const noexcept
+{
+	return getTag() == binary::numberTag;
+}
+
+bool BinaryView::isString() const noexcept
+{
+	return getTag() == binary::stringTag;
+}
+
+bool BinaryView::isBoolean() const noexcept
+{
+	const auto tag = getTag();
+
+	return tag == binary::falseTag || tag == binary::trueTag;
+}
+
+bool BinaryView::isArray() const noexcept
+{
+	return getTag() == binary::arrayTag;
+}
+
+bool BinaryView::isObject() const noexcept
+{
+	return getTag() == binary::objectTag;
+}
+
+bool BinaryView::isNull() const noexcept
+{
+	return getTag() == binary::nullTag;
+}
+
+ObjectType BinaryView::getType() const
+{
+	switch (getTag())
+	{
+		case (binary::nullTag) : return ObjectType::Null;
+		case (binary::falseTag) : [[fallthrough]];
+		case (binary::trueTag) : return ObjectType::Boolean;
+		case (binary::numberTag) : return ObjectType::Number;
+		case (binary::stringTag) : return ObjectType::String;
+		case (binary::arrayTag) : return ObjectType::Array;
+		case (binary::objectTag) : return ObjectType::Object;
+		default : binary::throwMalformed ("Binary document: unknown type tag");
+	}
+}
+
+std::string_view BinaryView::getTypeAsString() const
+{
+	switch (getType())
+	{
+		case (ObjectType::Null) : return "Null";
+		case (ObjectType::Object) : return "Object";
+		case (ObjectType::Array) : return "Array";
+		case (ObjectType::Boolean) : return "Boolean";
+		case (ObjectType::String) : return "String";
+		case (ObjectType::Number) : return "Number";
+		default : return "";  // unreachable
+	}
+}
+
+double BinaryView::getNumber() const
+{
+	if (! isNumber())
+		throw std::runtime_error { "Cannot call getNumber() on a value that is not a Number" };
+
+	return std::bit_cast<double> (readOffset (offset + 1));
+}
+
+std::string_view BinaryView::getString() const
+{
+	if (! isString())
+		throw std::runtime_error { "Cannot call getString() on a value that is not a String" };
+
+	return readString (offset);
+}
+
+bool BinaryView::getBoolean() const
+{
+	if (! isBoolean())
+		throw std::runtime_error { "Cannot call getBoolean() on a value that is not a Boolean" };
+
+	return getTag() == binary::trueTag;
+}
+
+std::size_t BinaryView::getNumChildren() const
+{
+	std::uint64_t tableStart { 0 };
+
+	if (isArray())
+		return static_cast<std::size_t> (readCount (binary::offsetSize, tableStart));
+
+	if (isObject())
+		return static_cast<std::size_t> (readCount (binary::offsetSize * 2, tableStart));
+
+	return 0UL;
+}
+
+bool BinaryView::findMember (std::string_view childName, std::uint64_t& valueOffset) const
+{
+	std::uint64_t tableStart { 0 };
+
+	auto first = std::uint64_t { 0 };
+	auto last  = readCount (binary::offsetSize * 2, tableStart);
+
+	// the names are sorted in the same order as an Object's keys, so this is a plain binary search
+	while (first < last)
+	{
+		const auto middle = first + (last - first) / 2;
+
+		const auto entry = tableStart + middle * binary::offsetSize * 2;
+
+		const auto name = readString (readOffset (entry));
+
+		if (name == childName)
+		{
+			valueOffset = readOffset (entry + binary::offsetSize);
+			return true;
+		}
+
+		if (name < childName)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	return false;
+}
+
+bool BinaryView::hasChildWithName (std::string_view childName) const
+{
+	std::uint64_t valueOffset { 0 };
+
+	return isObject() && findMember (childName, valueOffset);
+}
+
+BinaryView BinaryView::operator[] (std::string_view childName) const
+{
+	if (! isObject())
+		throw std::runtime_error { "Cannot call operator[string] on a value that is not an Object" };
+
+	std::uint64_t valueOffset { 0 };
+
+	if (! findMember (childName, valueOffset))
+		throw std::runtime_error { "Child node could not be found!" };
+
+	return getChildAt (valueOffset);
+}
+
+BinaryView BinaryView::operator[] (const char* childName) const
+{
+	return (*this)[std::string_view { childName }];
+}
+
+BinaryView BinaryView::operator[] (std::size_t idx) const
+{
+	const auto isObj = isObject();
+
+	if (! isObj && ! isArray())
+		throw std::runtime_error { "Cannot call operator[size_t] on a value that is not an Array or Object" };
+
+	const auto entrySize = isObj ? binary::offsetSize * 2 : binary::offsetSize;
+
+	std::uint64_t tableStart { 0 };
+
+	if (idx >= readCount (entrySize, tableStart))
+		throw std::out_of_range { "Array index out of range!" };
+
+	const auto valueOffset = isObj ? binary::offsetSize : 0UL;
+
+	return getChildAt (readOffset (tableStart + idx * entrySize + valueOffset));
+}
+
+std::string_view BinaryView::getChildName (std::size_t idx) const
+{
+	if (! isObject())
+		throw std::runtime_error { "Cannot call getChildName() on a value that is not an Object" };
+
+	std::uint64_t tableStart { 0 };
+
+	if (idx >= readCount (binary::offsetSize * 2, tableStart))
+		throw std::out_of_range { "Object index out of range!" };
+
+	return readString (readOffset (tableStart + idx * binary::offsetSize * 2));
+}
+
+Node BinaryView::toNode() const
+{
+	// every Node but the root is reached through an entry in an offset table, so a document that
+	// doesn't share containers can't expand to more Nodes than this; one that shares them could
+	// otherwise expand exponentially
+	auto nodesLeft = std::uint64_t { documentSize / binary::offsetSize + 1 };
+
+	return toNode (0, nodesLeft);
+}
+
+Node BinaryView::toNode (std::size_t depth, std::uint64_t& nodesLeft) const
+{
+	if (nodesLeft == 0)
+		binary::throwMalformed ("Binary document: shared records expand to too many values");
+
+	--nodesLeft;
+
+	const auto type = getType();
+
+	if ((type == ObjectType::Array || type == ObjectType::Object) && depth >= binary::maxDepth)
+		binary::throwMalformed ("Binary document: containers are nested too deeply");
+
+	switch (type)
+	{
+		case (ObjectType::Null) : return Node::createNull();
+		case (ObjectType::Boolean) : return Node::createBoolean (getBoolean());
+		case (ObjectType::Number) : return Node::createNumber (getNumber());
+		case (ObjectType::String) : return Node::createString (getString());
+
+		case (ObjectType::Array) :
+		{
+			std::uint64_t tableStart { 0 };
+
+			const auto count = readCount (binary::offsetSize, tableStart);
+
+			auto result = Node { ObjectType::Array };
+
+			auto& array = result.getArray();
+
+			array.reserve (static_cast<std::size_t> (count));
+
+			for (auto i = std::uint64_t { 0 }; i < count; ++i)
+				array.push_back (getChildAt (readOffset (tableStart + i * binary::offsetSize)).toNode (depth + 1, nodesLeft));
+
+			return result;
+		}
+
+		case (ObjectType::Object) :
+		{
+			std::uint64_t tableStart { 0 };
+
+			const auto count = readCount (binary::offsetSize * 2, tableStart);
+
+			auto result = Node { ObjectType::Object };
+
+			auto& obj = result.getObject();
+
+			for (auto i = std::uint64_t { 0 }; i < count; ++i)
+			{
+				const auto entry = tableStart + i * binary::offsetSize * 2;
+
+				// the names are already sorted, so each member is inserted at the end of the map
+				obj.emplace_hint (obj.end(), readString (readOffset (entry)),
+								  getChildAt (readOffset (entry + binary::offsetSize)).toNode (depth + 1, nodesLeft));
+			}
+
+			return result;
+		}
+
+		default : return {};  // unreachable
+	}
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+BinaryView BinaryFormat::createView (std::string_view data)
+{
+	if (data.size() < binary::minDocumentSize || ! data.starts_with (binary::header))
+		binary::throwMalformed ("Not a binary document");
+
+	// the root offset at the end isn't part of any record, so views can't see it
+	const auto recordsEnd = data.size() - binary::offsetSize;
+
+	const auto root = binary::loadUInt64 (data.data() + recordsEnd);
+
+	if (root < binary::header.size() || root >= recordsEnd)
+		binary::throwMalformed ("Binary document: root offset is out of bounds");
+
+	return { data.data(), recordsEnd, root };
+}
+
+bool BinaryFormat::probablyMatchesString (std::string_view string) const noexcept
+{
+	return string.size() >= binary::minDocumentSize && string.starts_with (binary::header);
+}
+
+Node BinaryFormat::parse (std::string_view string) const
+{
+	return createView (string).toNode();
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+BinaryFile::BinaryFile (const std::filesystem::path& path)
+	: file (std::make_unique<MappedFile> (path, MappedFile::AccessPattern::Random))
+{
+	// check the header now, so that a bad file is rejected when it's opened
+	[[maybe_unused]] const auto root = BinaryFormat::createView (file->getText());
+}
+
+BinaryFile::~BinaryFile() = default;
+
+BinaryFile::BinaryFile (BinaryFile&& other) noexcept = default;
+
+BinaryFile& BinaryFile::operator= (BinaryFile&& other) noexcept = default;
+
+BinaryView BinaryFile::getRoot() const
+{
+	return BinaryFormat::createView (getData());
+}
+
+std::string_view BinaryFile::getData() const noexcept
+{
+	if (file == nullptr)
+		return {};
+
+	return file->getText();
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// This overrides print() rather than using the base class's traversal, because each container
+// has to be written after all of its children, once their offsets are known.
+class LSERIAL_NO_EXPORT BinaryPrinter final : public Printer
+{
+public:
+	using Printer::print;
+
+	void print (const Node& node, OutputSink& sink) final
+	{
+		position = 0;
+
+		nullRecord	   = noRecord;
+		booleanRecords[0] = noRecord;
+		booleanRecords[1] = noRecord;
+
+		nameRecords.clear();
+		offsets.clear();
+
+		sink.write (binary::header);
+		position += binary::header.size();
+
+		const auto root = printValue (node, sink);
+
+		printOffset (root, sink);
+	}
+
+private:
+	static constexpr auto noRecord = std::uint64_t { 0 };
+
+	std::uint64_t printValue (const Node& node, OutputSink& sink)
+	{
+		// null and booleans are the same every time, so each is only written once
+		if (node.isNull())
+		{
+			if (nullRecord == noRecord)
+			{
+				printNull (sink);
+				nullRecord = lastRecord;
+			}
+
+			return nullRecord;
+		}
+
+		if (node.isBoolean())
+		{
+			auto& record = booleanRecords[node.getBoolean() ? 1 : 0];
+
+			if (record == noRecord)
+			{
+				printBoolean (node.getBoolean(), sink);
+				record = lastRecord;
+			}
+
+			return record;
+		}
+
+		if (node.isNumber())
+			printNumber (node.getNumber(), sink);
+		else if (node.isString())
+			printString (node.getString(), sink);
+		else if (node.isArray())
+			printArray (node.getArray(), sink);
+		else
+			printObject (node.getObject(), sink);
+
+		return lastRecord;
+	}
+
+	void beginRecord (binary::Tag tag, OutputSink& sink)
+	{
+		lastRecord = position;
+
+		sink.write (static_cast<char> (tag));
+		++position;
+	}
+
+	void printVarint (std::uint64_t value, OutputSink& sink)
+	{
+		char bytes[varint::maxSize];
+
+		const auto length = varint::store (value, bytes);
+
+		sink.write (std::string_view { bytes, length });
+		position += length;
+	}
+
+	void printOffset (std::uint64_t value, OutputSink& sink)
+	{
+		char bytes[binary::offsetSize];
+
+		binary::storeUInt64 (value, bytes);
+
+		sink.write (std::string_view { bytes, binary::offsetSize });
+		position += binary::offsetSize;
+	}
+
+	// writes the offsets pushed since the given mark as a table, then pops them
+	void printOffsetTable (std::size_t mark, OutputSink& sink)
+	{
+		const auto numOffsets = offsets.size() - mark;
+
+		if constexpr (std::endian::native == std::endian::little)
+		{
+			sink.write (std::string_view { reinterpret_cast<const char*> (offsets.data() + mark),
+										   numOffsets * binary::offsetSize });
+			position += numOffsets * binary::offsetSize;
+		}
+		else
+		{
+			for (auto i = mark; i < offsets.size(); ++i)
+				printOffset (offsets[i], sink);
+		}
+
+		offsets.resize (mark);
+	}
+
+	std::uint64_t printName (const std::string& name, OutputSink& sink)
+	{
+		const auto [iterator, isNew] = nameRecords.try_emplace (name, noRecord);
+
+		if (isNew)
+		{
+			printString (name, sink);
+			iterator->second = lastRecord;
+		}
+
+		return iterator->second;
+	}
+
+	void printNull (OutputSink& sink) final
+	{
+		beginRecord (binary::nullTag, sink);
+	}
+
+	void printNumber (double number, OutputSink& sink) final
+	{
+		beginRecord (binary::numberTag, sink);
+		printOffset (std::bit_cast<std::uint64_t> (number), sink);
+	}
+
+	void printString (std::string_view string, OutputSink& sink) final
+	{
+		beginRecord (binary::stringTag, sink);
+		printVarint (string.size(), sink);
+
+		sink.writeReferenced (string);
+
+		position += string.size();
+	}
+
+	void printBoolean (bool boolean, OutputSink& sink) final
+	{
+		beginRecord (boolean ? binary::trueTag : binary::falseTag, sink);
+	}
+
+	void printArray (const Array& array, OutputSink& sink) final
+	{
+		const auto mark = offsets.size();
+
+		for (const auto& element : array)
+			offsets.push_back (printValue (element, sink));
+
+		beginRecord (binary::arrayTag, sink);
+		printVarint (array.size(), sink);
+		printOffsetTable (mark, sink);
+	}
+
+	void printObject (const Object& object, OutputSink& sink) final
+	{
+		const auto mark = offsets.size();
+
+		// an Object is sorted by name, which is the order the lookups in BinaryView expect
+		for (const auto& [name, value] : object)
+		{
+			const auto nameRecord = printName (name, sink);
+
+			offsets.push_back (nameRecord);
+			offsets.push_back (printValue (value, sink));
+		}
+
+		beginRecord (binary::objectTag, sink);
+		printVarint (object.size(), sink);
+		printOffsetTable (mark, sink);
+	}
+
+	std::uint64_t position { 0 }, lastRecord { 0 };
+
+	// the header comes first, so no record can ever be at offset 0
+	std::uint64_t nullRecord { noRecord };
+
+	std::uint64_t booleanRecords[2] { noRecord, noRecord };
+
+	std::unordered_map<std::string_view, std::uint64_t> nameRecords;
+
+	// a stack of the offsets of the children of the containers currently being printed
+	std::vector<std::uint64_t> offsets;
+};
+
+std::unique_ptr<Printer> BinaryFormat::createPrinter ([[maybe_unused]] bool shouldPrettyPrint) const noexcept
+{
+	return std::make_unique<BinaryPrinter>();
+}
+
+}  // namespace limes::serializing
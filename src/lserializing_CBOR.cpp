@@ -0,0 +1,957 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "lserializing/lserializing_CBOR.h"
+#include "lserializing/lserializing_KnownFormats.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include "lserializing/lserializing_StaticPrinter.h"
+
+namespace limes::serializing
+{
+
+LSERIAL_NO_EXPORT static const KnownFormats::Register<CBORFormat> cbor_init;
+
+std::string_view CBORFormat::getName() const noexcept
+{
+	return formats::CBOR;
+}
+
+bool CBORFormat::supportsComments() const noexcept
+{
+	return false;
+}
+
+const std::vector<std::string_view>& CBORFormat::getFileExtensions() const noexcept
+{
+	struct ExtensionsHolder final
+	{
+		std::vector<std::string_view> xtns;
+
+		ExtensionsHolder()
+		{
+			xtns.emplace_back (".cbor");
+		}
+	};
+
+	static const ExtensionsHolder holder;
+
+	return holder.xtns;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// Each CBOR data item starts with a head: the top 3 bits of the first byte are the major type,
+// and the low 5 bits either hold a small argument directly, or say how many bytes of argument
+// follow. See RFC 8949 section 3.
+namespace cbor
+{
+
+enum MajorType : unsigned char
+{
+	unsignedInteger = 0,
+	negativeInteger,
+	byteString,
+	textString,
+	array,
+	map,
+	tag,
+	simpleOrFloat
+};
+
+static constexpr unsigned char falseByte = 0xF4, trueByte = 0xF5, nullByte = 0xF6,
+							   halfByte = 0xF9, singleByte = 0xFA, doubleByte = 0xFB, breakByte = 0xFF;
+
+static constexpr unsigned char oneByteArgument = 24, indefiniteLength = 31;
+
+static constexpr auto maxDepth = std::size_t { 512 };
+
+static constexpr auto selfDescribeTag = std::uint64_t { 55799 };
+
+// RFC 8746 typed arrays are tags 64 to 87 on a byte string. The low bits of the tag are
+// 0b0_f_s_e_ll: f is set for floats, s for signed integers, e for little-endian, and ll is
+// the log2 of the element size (for floats, of the element size divided by 2).
+static constexpr auto firstTypedArrayTag = std::uint64_t { 64 }, lastTypedArrayTag = std::uint64_t { 87 };
+
+static constexpr auto float64LittleEndianTag = std::uint64_t { 86 };
+
+static inline double halfToDouble (std::uint16_t half) noexcept
+{
+	const auto exponent = static_cast<int> ((half >> 10U) & 0x1FU);
+	const auto mantissa = static_cast<double> (half & 0x3FFU);
+
+	double value { 0. };
+
+	if (exponent == 0)
+		value = std::ldexp (mantissa, -24);
+	else if (exponent != 31)
+		value = std::ldexp (mantissa + 1024., exponent - 25);
+	else
+		value = mantissa == 0. ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+
+	return (half & 0x8000U) != 0 ? -value : value;
+}
+
+// returns true if the value can be represented exactly as a half-precision float
+static inline bool doubleToHalf (double value, std::uint16_t& half) noexcept
+{
+	const auto sign = static_cast<std::uint16_t> (std::signbit (value) ? 0x8000U : 0U);
+
+	if (std::isnan (value))
+	{
+		half = 0x7E00U;
+		return true;
+	}
+
+	const auto magnitude = std::fabs (value);
+
+	if (std::isinf (value) || magnitude == 0.)
+	{
+		half = sign | static_cast<std::uint16_t> (magnitude == 0. ? 0U : 0x7C00U);
+		return true;
+	}
+
+	// subnormal halves are multiples of 2^-24 below 2^-14
+	if (magnitude < 0x1p-14)
+	{
+		const auto scaled = magnitude * 0x1p24;
+
+		if (scaled != std::trunc (scaled))
+			return false;
+
+		half = sign | static_cast<std::uint16_t> (scaled);
+		return true;
+	}
+
+	if (magnitude > 65504.)
+		return false;
+
+	int exponent { 0 };
+
+	// magnitude = fraction * 2^exponent, with fraction in [0.5, 1), so the half's mantissa is the
+	// fraction scaled to 11 bits, including the implicit leading 1
+	const auto fraction = std::frexp (magnitude, &exponent) * 2048.;
+
+	if (fraction != std::trunc (fraction))
+		return false;
+
+	half = sign | static_cast<std::uint16_t> (((exponent + 14) << 10) | (static_cast<int> (fraction) - 1024));
+	return true;
+}
+
+}  // namespace cbor
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// Reports errors by recording them and returning false rather than by throwing, so that
+// CBORFormat::tryParse() can reject input without any stack unwinding.
+class LSERIAL_NO_EXPORT CBORParser final
+{
+public:
+	explicit CBORParser (std::string_view input)
+		: start (input.data()), current (input.data()), end (input.data() + input.size())
+	{
+	}
+
+	[[nodiscard]] inline bool parse (Node& result)
+	{
+		if (! parseValue (result))
+			return false;
+
+		if (current != end)
+			return fail ("Unexpected data after the end of the document", current);
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool parseNumberArray (std::vector<double>& numbers)
+	{
+		if (! parseNumbers (numbers))
+			return false;
+
+		if (current != end)
+			return fail ("Unexpected data after the end of the document", current);
+
+		return true;
+	}
+
+	[[nodiscard]] ParseError getError() const
+	{
+		auto message = std::string { errorMessage };
+
+		message += " at byte ";
+		message += std::to_string (errorPos - start);
+
+		return ParseError { message, {} };
+	}
+
+private:
+	struct Head final
+	{
+		cbor::MajorType majorType { cbor::unsignedInteger };
+
+		unsigned char additionalInfo { 0 };
+
+		std::uint64_t argument { 0 };
+
+		[[nodiscard]] bool isIndefinite() const noexcept
+		{
+			return additionalInfo == cbor::indefiniteLength;
+		}
+	};
+
+	[[nodiscard]] inline bool fail (const char* message, const char* position)
+	{
+		errorMessage = message;
+		errorPos	 = position;
+		return false;
+	}
+
+	[[nodiscard]] inline std::size_t getNumBytesLeft() const noexcept
+	{
+		return static_cast<std::size_t> (end - current);
+	}
+
+	[[nodiscard]] inline bool readHead (Head& head)
+	{
+		if (current == end)
+			return fail ("Unexpected end of data", end);
+
+		const auto* const headStart = current;
+
+		const auto initialByte = static_cast<unsigned char> (*current++);
+
+		head.majorType		= static_cast<cbor::MajorType> (initialByte >> 5U);
+		head.additionalInfo = initialByte & 0x1FU;
+
+		if (head.additionalInfo < cbor::oneByteArgument)
+		{
+			head.argument = head.additionalInfo;
+			return true;
+		}
+
+		if (head.isIndefinite())
+		{
+			if (head.majorType == cbor::unsignedInteger || head.majorType == cbor::negativeInteger || head.majorType == cbor::tag)
+				return fail ("Invalid indefinite length", headStart);
+
+			head.argument = 0;
+			return true;
+		}
+
+		if (head.additionalInfo > 27)
+			return fail ("Reserved additional information value", headStart);
+
+		const auto numBytes = std::size_t { 1 } << (head.additionalInfo - cbor::oneByteArgument);
+
+		if (getNumBytesLeft() < numBytes)
+			return fail ("Unexpected end of data", end);
+
+		head.argument = 0;
+
+		for (auto i = 0UL; i < numBytes; ++i)
+			head.argument = (head.argument << 8U) | static_cast<unsigned char> (*current++);
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool isAtBreak() const noexcept
+	{
+		return current != end && static_cast<unsigned char> (*current) == cbor::breakByte;
+	}
+
+	// reads the rest of a text or byte string whose head has been read. Indefinite-length
+	// strings are concatenated into the scratch buffer.
+	[[nodiscard]] inline bool readString (const Head& head, std::string_view& result)
+	{
+		if (! head.isIndefinite())
+		{
+			if (head.argument > getNumBytesLeft())
+				return fail ("String is longer than the remaining data", current);
+
+			result = std::string_view { current, static_cast<std::size_t> (head.argument) };
+			current += head.argument;
+			return true;
+		}
+
+		scratch.clear();
+
+		for (;;)
+		{
+			if (isAtBreak())
+			{
+				++current;
+				result = scratch;
+				return true;
+			}
+
+			const auto* const chunkStart = current;
+
+			Head chunk;
+
+			if (! readHead (chunk))
+				return false;
+
+			if (chunk.majorType != head.majorType || chunk.isIndefinite())
+				return fail ("Invalid chunk in an indefinite-length string", chunkStart);
+
+			if (chunk.argument > getNumBytesLeft())
+				return fail ("String is longer than the remaining data", current);
+
+			scratch.append (current, static_cast<std::size_t> (chunk.argument));
+			current += chunk.argument;
+		}
+	}
+
+	[[nodiscard]] inline bool enterContainer (const char* position)
+	{
+		if (++depth > cbor::maxDepth)
+			return fail ("Containers are nested too deeply", position);
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool parseArray (const Head& head, Node& result, const char* headStart)
+	{
+		if (! enterContainer (headStart))
+			return false;
+
+		result = Node { ObjectType::Array };
+
+		auto& array = result.getArray();
+
+		if (head.isIndefinite())
+		{
+			while (! isAtBreak())
+				if (! parseValue (array.emplace_back()))
+					return false;
+
+			++current;
+		}
+		else
+		{
+			// every element takes at least one byte, so this rejects absurd sizes before allocating
+			if (head.argument > getNumBytesLeft())
+				return fail ("Container is larger than the remaining data", current);
+
+			array.resize (static_cast<std::size_t> (head.argument));
+
+			for (auto& element : array)
+				if (! parseValue (element))
+					return false;
+		}
+
+		--depth;
+		return true;
+	}
+
+	[[nodiscard]] inline bool parseMember (Object& obj)
+	{
+		const auto* const namePos = current;
+
+		Head nameHead;
+
+		if (! readHead (nameHead))
+			return false;
+
+		if (nameHead.majorType != cbor::textString && nameHead.majorType != cbor::byteString)
+			return fail ("Map keys must be strings", namePos);
+
+		std::string_view name;
+
+		if (! readString (nameHead, name))
+			return false;
+
+		if (name.empty())
+			return fail ("Property names cannot be empty", namePos);
+
+		Node* value { nullptr };
+
+		// maps written by this library are in sorted order, so each member usually goes at the end
+		if (obj.empty() || obj.rbegin()->first < name)
+		{
+			value = &obj.emplace_hint (obj.end(), name, Node {})->second;
+		}
+		else
+		{
+			auto [iterator, inserted] = obj.try_emplace (std::string { name });
+
+			if (! inserted)
+				return fail ("Duplicate keys in same map", namePos);
+
+			value = &iterator->second;
+		}
+
+		return parseValue (*value);
+	}
+
+	[[nodiscard]] inline bool parseMap (const Head& head, Node& result, const char* headStart)
+	{
+		if (! enterContainer (headStart))
+			return false;
+
+		result = Node { ObjectType::Object };
+
+		auto& obj = result.getObject();
+
+		if (head.isIndefinite())
+		{
+			while (! isAtBreak())
+				if (! parseMember (obj))
+					return false;
+
+			++current;
+		}
+		else
+		{
+			if (head.argument > getNumBytesLeft())
+				return fail ("Container is larger than the remaining data", current);
+
+			for (auto i = std::uint64_t { 0 }; i < head.argument; ++i)
+				if (! parseMember (obj))
+					return false;
+		}
+
+		--depth;
+		return true;
+	}
+
+	// Decodes an RFC 8746 typed array into a container of doubles or Nodes, which is resized to
+	// fit first. makeElement turns each number into the container's element type.
+	template <typename Container, typename MakeElement>
+	[[nodiscard]] inline bool readTypedArray (std::uint64_t tagNumber, std::string_view payload,
+											  Container& container, MakeElement&& makeElement, const char* tagStart)
+	{
+		const auto bits			  = static_cast<unsigned> (tagNumber - cbor::firstTypedArrayTag);
+		const auto isFloat		  = (bits & 0x10U) != 0;
+		const auto isSigned		  = (bits & 0x08U) != 0;
+		const auto isLittleEndian = (bits & 0x04U) != 0;
+		const auto sizeLog2		  = bits & 0x03U;
+
+		const auto elementSize = isFloat ? (std::size_t { 2 } << sizeLog2) : (std::size_t { 1 } << sizeLog2);
+
+		// 0b0_1_1_x_xx is unassigned, 128-bit floats have no C++ equivalent, and the little-endian
+		// bit on a 1-byte signed type is reserved (on an unsigned one, it means "clamped", which
+		// doesn't change decoding)
+		if ((isFloat && isSigned) || (isFloat && elementSize == 16) || (isSigned && sizeLog2 == 0 && isLittleEndian))
+			return fail ("Unsupported typed array", tagStart);
+
+		if (payload.size() % elementSize != 0)
+			return fail ("Typed array size is not a multiple of its element size", tagStart);
+
+		const auto numElements = payload.size() / elementSize;
+
+		container.resize (numElements);
+
+		const auto* const data = payload.data();
+
+		if (isFloat && elementSize == 8 && isLittleEndian)
+		{
+			for (auto i = 0UL; i < numElements; ++i)
+			{
+				std::uint64_t bitsLE { 0 };
+
+				if constexpr (std::endian::native == std::endian::little)
+				{
+					std::memcpy (&bitsLE, data + i * 8, 8);
+				}
+				else
+				{
+					for (auto b = 0UL; b < 8UL; ++b)
+						bitsLE |= std::uint64_t { static_cast<unsigned char> (data[i * 8 + b]) } << (b * 8UL);
+				}
+
+				container[i] = makeElement (std::bit_cast<double> (bitsLE));
+			}
+
+			return true;
+		}
+
+		for (auto i = 0UL; i < numElements; ++i)
+		{
+			const auto* const element = data + i * elementSize;
+
+			std::uint64_t value { 0 };
+
+			for (auto b = 0UL; b < elementSize; ++b)
+			{
+				const auto byteIndex = isLittleEndian ? elementSize - 1 - b : b;
+				value				 = (value << 8U) | static_cast<unsigned char> (element[byteIndex]);
+			}
+
+			double number { 0. };
+
+			if (isFloat)
+			{
+				if (elementSize == 2)
+					number = cbor::halfToDouble (static_cast<std::uint16_t> (value));
+				else if (elementSize == 4)
+					number = static_cast<double> (std::bit_cast<float> (static_cast<std::uint32_t> (value)));
+				else
+					number = std::bit_cast<double> (value);
+			}
+			else if (isSigned)
+			{
+				const auto shift = 64UL - elementSize * 8UL;
+				number			 = static_cast<double> (static_cast<std::int64_t> (value << shift) >> shift);
+			}
+			else
+			{
+				number = static_cast<double> (value);
+			}
+
+			container[i] = makeElement (number);
+		}
+
+		return true;
+	}
+
+	// reads the byte string that must follow a typed array tag
+	[[nodiscard]] inline bool readTypedArrayPayload (std::string_view& payload)
+	{
+		const auto* const payloadStart = current;
+
+		Head payloadHead;
+
+		if (! readHead (payloadHead))
+			return false;
+
+		if (payloadHead.majorType != cbor::byteString)
+			return fail ("Typed arrays must hold a byte string", payloadStart);
+
+		return readString (payloadHead, payload);
+	}
+
+	[[nodiscard]] inline bool parseTag (const Head& head, Node& result, const char* headStart)
+	{
+		if (head.argument < cbor::firstTypedArrayTag || head.argument > cbor::lastTypedArrayTag)
+		{
+			// tags can be nested, so they count towards the depth limit
+			if (! enterContainer (headStart))
+				return false;
+
+			if (! parseValue (result))
+				return false;
+
+			--depth;
+			return true;
+		}
+
+		std::string_view payload;
+
+		if (! readTypedArrayPayload (payload))
+			return false;
+
+		result = Node { ObjectType::Array };
+
+		return readTypedArray (
+			head.argument, payload, result.getArray(), [] (double number)
+			{ return Node::createNumber (number); },
+			headStart);
+	}
+
+	[[nodiscard]] inline bool parseSimpleOrFloat (const Head& head, Node& result, const char* headStart)
+	{
+		switch (head.additionalInfo)
+		{
+			case (20) : result = Node::createBoolean (false); return true;
+			case (21) : result = Node::createBoolean (true); return true;
+			case (22) : [[fallthrough]];
+			case (23) : result = Node::createNull(); return true;
+			case (25) : result = Node::createNumber (cbor::halfToDouble (static_cast<std::uint16_t> (head.argument))); return true;
+
+			case (26) :
+				result = Node::createNumber (static_cast<double> (std::bit_cast<float> (static_cast<std::uint32_t> (head.argument))));
+				return true;
+
+			case (27) : result = Node::createNumber (std::bit_cast<double> (head.argument)); return true;
+			case (cbor::indefiniteLength) : return fail ("Unexpected break", headStart);
+			default : return fail ("Unsupported simple value", headStart);
+		}
+	}
+
+	[[nodiscard]] inline bool parseValue (Node& result)
+	{
+		const auto* const headStart = current;
+
+		Head head;
+
+		if (! readHead (head))
+			return false;
+
+		switch (head.majorType)
+		{
+			case (cbor::unsignedInteger) :
+				result = Node::createNumber (static_cast<double> (head.argument));
+				return true;
+
+			case (cbor::negativeInteger) :
+				result = Node::createNumber (-1. - static_cast<double> (head.argument));
+				return true;
+
+			case (cbor::byteString) : [[fallthrough]];
+			case (cbor::textString) :
+			{
+				std::string_view string;
+
+				if (! readString (head, string))
+					return false;
+
+				result = Node::createString (string);
+				return true;
+			}
+
+			case (cbor::array) : return parseArray (head, result, headStart);
+			case (cbor::map) : return parseMap (head, result, headStart);
+			case (cbor::tag) : return parseTag (head, result, headStart);
+			default : return parseSimpleOrFloat (head, result, headStart);
+		}
+	}
+
+	[[nodiscard]] inline bool parseNumbers (std::vector<double>& numbers)
+	{
+		const auto* const headStart = current;
+
+		Head head;
+
+		if (! readHead (head))
+			return false;
+
+		// skip any tags that aren't typed arrays, such as the self-describe tag
+		while (head.majorType == cbor::tag
+			   && (head.argument < cbor::firstTypedArrayTag || head.argument > cbor::lastTypedArrayTag))
+			if (! readHead (head))
+				return false;
+
+		if (head.majorType == cbor::tag)
+		{
+			std::string_view payload;
+
+			if (! readTypedArrayPayload (payload))
+				return false;
+
+			if (head.argument == cbor::float64LittleEndianTag && std::endian::native == std::endian::little
+				&& payload.size() % sizeof (double) == 0)
+			{
+				numbers.resize (payload.size() / sizeof (double));
+
+				if (! payload.empty())
+					std::memcpy (numbers.data(), payload.data(), payload.size());
+
+				return true;
+			}
+
+			return readTypedArray (
+				head.argument, payload, numbers, [] (double number)
+				{ return number; },
+				headStart);
+		}
+
+		if (head.majorType != cbor::array)
+			return fail ("Expected an array of numbers", headStart);
+
+		if (! head.isIndefinite())
+		{
+			if (head.argument > getNumBytesLeft())
+				return fail ("Container is larger than the remaining data", current);
+
+			numbers.reserve (static_cast<std::size_t> (head.argument));
+		}
+
+		for (auto i = std::uint64_t { 0 }; head.isIndefinite() || i < head.argument; ++i)
+		{
+			if (head.isIndefinite() && isAtBreak())
+			{
+				++current;
+				break;
+			}
+
+			const auto* const elementStart = current;
+
+			Node element;
+
+			if (! parseValue (element))
+				return false;
+
+			if (! element.isNumber())
+				return fail ("Expected an array of numbers", elementStart);
+
+			numbers.push_back (element.getNumber());
+		}
+
+		return true;
+	}
+
+	const char* const start;
+	const char*		  current;
+	const char* const end;
+
+	std::size_t depth { 0 };
+
+	std::string scratch;
+
+	const char* errorMessage { "" };
+	const char* errorPos { nullptr };
+};
+
+Node CBORFormat::parse (std::string_view string) const
+{
+	return tryParse (string).getNode();
+}
+
+ParseResult CBORFormat::tryParse (std::string_view string) const
+{
+	CBORParser p { string };
+
+	if (Node result; p.parse (result))
+		return result;
+
+	return p.getError();
+}
+
+std::vector<double> CBORFormat::parseNumberArray (std::string_view string) const
+{
+	CBORParser p { string };
+
+	std::vector<double> numbers;
+
+	if (! p.parseNumberArray (numbers))
+		throw p.getError();
+
+	return numbers;
+}
+
+bool CBORFormat::probablyMatchesString (std::string_view string) const noexcept
+{
+	if (string.starts_with ("\xD9\xD9\xF7"))
+		return true;
+
+	if (string.empty())
+		return false;
+
+	const auto firstByte = static_cast<unsigned char> (string.front());
+
+	const auto majorType	  = firstByte >> 5U;
+	const auto additionalInfo = firstByte & 0x1FU;
+
+	if (majorType != cbor::array && majorType != cbor::map)
+		return false;
+
+	// an empty container is the whole document
+	if (additionalInfo == 0)
+		return string.size() == 1;
+
+	std::size_t headSize { 1 };
+
+	if (additionalInfo >= cbor::oneByteArgument && additionalInfo <= 27)
+		headSize += std::size_t { 1 } << (additionalInfo - cbor::oneByteArgument);
+	else if (additionalInfo != cbor::indefiniteLength && additionalInfo > 23)
+		return false;
+
+	if (string.size() <= headSize)
+		return false;
+
+	const auto nextByte = static_cast<unsigned char> (string[headSize]);
+
+	if (majorType == cbor::map)
+		return (nextByte >> 5U) == cbor::textString || (nextByte >> 5U) == cbor::byteString;
+
+	const auto nextInfo = nextByte & 0x1FU;
+
+	return nextInfo < 28 && ! ((nextByte >> 5U) == cbor::simpleOrFloat && nextInfo < 20);
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+class LSERIAL_NO_EXPORT CBORPrinter final : public StaticPrinter<CBORPrinter>
+{
+	friend class StaticPrinter<CBORPrinter>;
+
+public:
+	explicit CBORPrinter (const CBORPrinterOptions& optionsToUse)
+		: options (optionsToUse)
+	{
+	}
+
+private:
+	static void writeHead (cbor::MajorType majorType, std::uint64_t argument, OutputSink& sink)
+	{
+		const auto typeBits = static_cast<unsigned char> (majorType << 5U);
+
+		if (argument < cbor::oneByteArgument)
+		{
+			sink.write (static_cast<char> (typeBits | static_cast<unsigned char> (argument)));
+			return;
+		}
+
+		std::size_t numBytes { 8 };
+
+		if (argument <= std::numeric_limits<std::uint8_t>::max())
+			numBytes = 1;
+		else if (argument <= std::numeric_limits<std::uint16_t>::max())
+			numBytes = 2;
+		else if (argument <= std::numeric_limits<std::uint32_t>::max())
+			numBytes = 4;
+
+		writeBigEndian (static_cast<unsigned char> (typeBits | (cbor::oneByteArgument + std::countr_zero (numBytes))),
+						argument, numBytes, sink);
+	}
+
+	// writes the initial byte followed by the value as a big-endian integer of the given size
+	static void writeBigEndian (unsigned char initialByte, std::uint64_t value, std::size_t numBytes, OutputSink& sink)
+	{
+		char bytes[9];
+
+		bytes[0] = static_cast<char> (initialByte);
+
+		for (auto i = 0UL; i < numBytes; ++i)
+			bytes[1 + i] = static_cast<char> (static_cast<unsigned char> (value >> ((numBytes - 1 - i) * 8UL)));
+
+		sink.write (std::string_view { bytes, numBytes + 1 });
+	}
+
+	void printNull (OutputSink& sink) final
+	{
+		sink.write (static_cast<char> (cbor::nullByte));
+	}
+
+	void printNumber (double number, OutputSink& sink) final
+	{
+		constexpr auto twoTo64 = 18446744073709551616.;
+
+		if (std::trunc (number) == number && number > -twoTo64 && number < twoTo64 && ! (number == 0. && std::signbit (number)))
+		{
+			if (number >= 0.)
+				writeHead (cbor::unsignedInteger, static_cast<std::uint64_t> (number), sink);
+			else
+				writeHead (cbor::negativeInteger, static_cast<std::uint64_t> (-number) - 1, sink);
+
+			return;
+		}
+
+		if (std::uint16_t half { 0 }; cbor::doubleToHalf (number, half))
+		{
+			writeBigEndian (cbor::halfByte, half, 2, sink);
+			return;
+		}
+
+		// converting a finite double that's out of float's range is undefined, so check that first
+		if (std::fabs (number) <= std::numeric_limits<float>::max()
+			&& static_cast<double> (static_cast<float> (number)) == number)
+		{
+			writeBigEndian (cbor::singleByte, std::bit_cast<std::uint32_t> (static_cast<float> (number)), 4, sink);
+			return;
+		}
+
+		writeBigEndian (cbor::doubleByte, std::bit_cast<std::uint64_t> (number), 8, sink);
+	}
+
+	void printString (std::string_view string, OutputSink& sink) final
+	{
+		writeHead (cbor::textString, string.size(), sink);
+
+		sink.writeReferenced (string);
+	}
+
+	void printBoolean (bool boolean, OutputSink& sink) final
+	{
+		sink.write (static_cast<char> (boolean ? cbor::trueByte : cbor::falseByte));
+	}
+
+	void printTypedArray (const Array& array, OutputSink& sink)
+	{
+		writeHead (cbor::tag, cbor::float64LittleEndianTag, sink);
+		writeHead (cbor::byteString, array.size() * sizeof (double), sink);
+
+		// the numbers are gathered into a small buffer, so that the sink is called once per block
+		constexpr auto numbersPerBlock = std::size_t { 512 };
+
+		char block[numbersPerBlock * sizeof (double)];
+
+		for (auto first = 0UL; first < array.size(); first += numbersPerBlock)
+		{
+			const auto numNumbers = std::min (numbersPerBlock, array.size() - first);
+
+			for (auto i = 0UL; i < numNumbers; ++i)
+			{
+				const auto bits = std::bit_cast<std::uint64_t> (array[first + i].getNumber());
+
+				if constexpr (std::endian::native == std::endian::little)
+				{
+					std::memcpy (block + i * sizeof (double), &bits, sizeof (double));
+				}
+				else
+				{
+					for (auto b = 0UL; b < sizeof (double); ++b)
+						block[i * sizeof (double) + b] = static_cast<char> (static_cast<unsigned char> (bits >> (b * 8UL)));
+				}
+			}
+
+			sink.write (std::string_view { block, numNumbers * sizeof (double) });
+		}
+	}
+
+	void printArray (const Array& array, OutputSink& sink) final
+	{
+		if (options.typedArrays && array.size() >= options.minTypedArraySize
+			&& std::all_of (array.begin(), array.end(), [] (const Node& element)
+							{ return element.isNumber(); }))
+		{
+			printTypedArray (array, sink);
+			return;
+		}
+
+		writeHead (cbor::array, array.size(), sink);
+
+		for (const auto& element : array)
+			print (element, sink);
+	}
+
+	void printObject (const Object& object, OutputSink& sink) final
+	{
+		writeHead (cbor::map, object.size(), sink);
+
+		for (const auto& [name, value] : object)
+		{
+			printString (name, sink);
+			print (value, sink);
+		}
+	}
+
+	const CBORPrinterOptions options;
+};
+
+std::unique_ptr<Printer> CBORFormat::createPrinter ([[maybe_unused]] bool shouldPrettyPrint) const noexcept
+{
+	return std::make_unique<CBORPrinter> (CBORPrinterOptions {});
+}
+
+std::unique_ptr<Printer> CBORFormat::createPrinter (const CBORPrinterOptions& options) const
+{
+	return std::make_unique<CBORPrinter> (options);
+}
+
+}  // namespace limes::serializing
@@ -0,0 +1,726 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "lserializing/lserializing_Columns.h"
+
+namespace limes::serializing
+{
+
+bool Column::isNull (std::size_t row) const noexcept
+{
+	if (type == ColumnType::Null)
+		return true;
+
+	if (validity.empty())
+		return false;
+
+	return ((validity[row / 8] >> (row % 8)) & 1) == 0;
+}
+
+bool Column::getBoolean (std::size_t row) const noexcept
+{
+	return ((booleans[row / 8] >> (row % 8)) & 1) != 0;
+}
+
+std::string_view Column::getString (std::size_t row) const noexcept
+{
+	const auto start = static_cast<std::size_t> (offsets[row]);
+
+	return { bytes.data() + start, static_cast<std::size_t> (offsets[row + 1]) - start };
+}
+
+const Column* ColumnTable::getColumn (std::string_view name) const noexcept
+{
+	for (const auto& column : columns)
+		if (column.name == name)
+			return &column;
+
+	return nullptr;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+namespace columns
+{
+
+// rows are split between threads in multiples of this, so that each thread's part of a bitmap starts on a byte boundary
+static constexpr auto rowAlignment = std::size_t { 64 };
+
+static constexpr auto minRowsPerThread = std::size_t { 16384 };
+
+static constexpr auto maxStringBytes = static_cast<std::size_t> (std::numeric_limits<std::int32_t>::max());
+
+[[nodiscard]] static inline std::size_t bytesForBits (std::size_t numBits) noexcept
+{
+	return (numBits + 7) / 8;
+}
+
+// sets bit 'index' of a bitmap that holds exactly 'index' bits, adding a byte when needed
+static inline void appendBit (ColumnBuffer<std::uint8_t>& bitmap, std::size_t index, bool value)
+{
+	if (index % 8 == 0)
+		bitmap.push_back (0);
+
+	const auto mask = static_cast<std::uint8_t> (1U << (index % 8));
+
+	if (value)
+		bitmap.back() |= mask;
+	else
+		bitmap.back() &= static_cast<std::uint8_t> (~mask);
+}
+
+[[nodiscard]] static inline bool isInt64 (double value) noexcept
+{
+	// integers beyond 2^53 can't all be represented as doubles, so a column that holds them is left as doubles
+	static constexpr auto maxExactInteger = 9007199254740992.;
+
+	return std::trunc (value) == value && std::abs (value) <= maxExactInteger && ! (value == 0. && std::signbit (value));
+}
+
+[[nodiscard]] static std::string_view getTypeName (ColumnType type) noexcept
+{
+	switch (type)
+	{
+		case (ColumnType::Boolean) : return "booleans";
+		case (ColumnType::Int64) :
+		case (ColumnType::Double) : return "numbers";
+		case (ColumnType::String) : return "strings";
+		default : return "nulls";
+	}
+}
+
+[[noreturn]] static void throwTypeConflict (const Column& column, std::string_view newType)
+{
+	throw std::runtime_error { "Field '" + column.name + "' holds both " + std::string { getTypeName (column.type) } + " and " + std::string { newType } };
+}
+
+// Gives a column of nulls the buffers of the given type, with a zeroed slot for each null. The buffers are sized for
+// the number of rows the column will end up with, so that appending doesn't reallocate them.
+static void setType (Column& column, ColumnType type, std::size_t numRows)
+{
+	const auto length = column.length;
+
+	if (length > 0 && column.validity.empty())
+	{
+		column.validity.reserve (bytesForBits (numRows));
+		column.validity.assign (bytesForBits (length), 0);
+	}
+
+	switch (type)
+	{
+		case (ColumnType::Boolean) :
+			column.booleans.reserve (bytesForBits (numRows));
+			column.booleans.assign (bytesForBits (length), 0);
+			break;
+
+		case (ColumnType::Int64) :
+			column.integers.reserve (numRows);
+			column.integers.assign (length, 0);
+			break;
+
+		case (ColumnType::Double) :
+			column.doubles.reserve (numRows);
+			column.doubles.assign (length, 0.);
+			break;
+
+		case (ColumnType::String) :
+			column.offsets.reserve (numRows + 1);
+			column.offsets.assign (length + 1, 0);
+			break;
+
+		default : break;
+	}
+
+	column.type = type;
+}
+
+static void promoteToDouble (Column& column)
+{
+	column.doubles.reserve (column.integers.capacity());
+	column.doubles.assign (column.integers.begin(), column.integers.end());
+
+	column.integers = {};
+
+	column.type = ColumnType::Double;
+}
+
+static void appendNull (Column& column)
+{
+	if (column.type != ColumnType::Null)
+	{
+		if (column.validity.empty())
+		{
+			column.validity.assign (bytesForBits (column.length), 0xFF);
+
+			// appendBit() relies on the bits past the end of the bitmap being unused, so clear them
+			if (column.length % 8 != 0)
+				column.validity.back() = static_cast<std::uint8_t> ((1U << (column.length % 8)) - 1);
+		}
+
+		appendBit (column.validity, column.length, false);
+
+		switch (column.type)
+		{
+			case (ColumnType::Boolean) : appendBit (column.booleans, column.length, false); break;
+			case (ColumnType::Int64) : column.integers.push_back (0); break;
+			case (ColumnType::Double) : column.doubles.push_back (0.); break;
+			case (ColumnType::String) : column.offsets.push_back (column.offsets.back()); break;
+			default : break;
+		}
+	}
+
+	++column.length;
+	++column.nullCount;
+}
+
+static void appendValue (Column& column, const Node& value, std::size_t numRows)
+{
+	if (value.isNull())
+	{
+		appendNull (column);
+		return;
+	}
+
+	value.visit ([&column, numRows] (const auto& data)
+				 {
+		using Type = std::decay_t<decltype (data)>;
+
+		if constexpr (std::is_same_v<Type, double>)
+		{
+			const auto integral = isInt64 (data);
+
+			if (column.type == ColumnType::Null)
+				setType (column, integral ? ColumnType::Int64 : ColumnType::Double, numRows);
+			else if (column.type == ColumnType::Int64 && ! integral)
+				promoteToDouble (column);
+
+			if (column.type == ColumnType::Int64)
+				column.integers.push_back (static_cast<std::int64_t> (data));
+			else if (column.type == ColumnType::Double)
+				column.doubles.push_back (data);
+			else
+				throwTypeConflict (column, "numbers");
+		}
+		else if constexpr (std::is_same_v<Type, bool>)
+		{
+			if (column.type == ColumnType::Null)
+				setType (column, ColumnType::Boolean, numRows);
+			else if (column.type != ColumnType::Boolean)
+				throwTypeConflict (column, "booleans");
+
+			appendBit (column.booleans, column.length, data);
+		}
+		else if constexpr (std::is_same_v<Type, std::string_view>)
+		{
+			if (column.type == ColumnType::Null)
+				setType (column, ColumnType::String, numRows);
+			else if (column.type != ColumnType::String)
+				throwTypeConflict (column, "strings");
+
+			if (data.size() > maxStringBytes - column.bytes.size())
+				throw std::runtime_error { "Field '" + column.name + "' holds more than 2^31 - 1 bytes of strings" };
+
+			column.bytes.insert (column.bytes.end(), data.begin(), data.end());
+			column.offsets.push_back (static_cast<std::int32_t> (column.bytes.size()));
+		}
+		else
+		{
+			throw std::runtime_error { "Field '" + column.name + "' holds an Array or Object, which can't be stored in a column" };
+		} });
+
+	if (! column.validity.empty())
+		appendBit (column.validity, column.length, true);
+
+	++column.length;
+}
+
+// Converts one range of rows. Each range is converted by its own builder, so the builders share nothing.
+class LSERIAL_NO_EXPORT ColumnBuilder final
+{
+public:
+	[[nodiscard]] ColumnTable build (const Array& rows, std::size_t begin, std::size_t end)
+	{
+		result.numRows = end - begin;
+
+		for (auto row = begin; row < end; ++row)
+			addRow (rows[row], row);
+
+		// Arrow's Null type has no buffers at all
+		for (auto& column : result.columns)
+			if (column.type == ColumnType::Null)
+				column.validity = {};
+
+		return std::move (result);
+	}
+
+private:
+	void addRow (const Node& row, std::size_t rowIndex)
+	{
+		if (! row.isObject())
+			throw std::runtime_error { "Row " + std::to_string (rowIndex) + " is not an Object" };
+
+		auto& columns = result.columns;
+
+		const auto numRowsBefore = numRowsAdded++;
+
+		std::size_t position = 0;
+
+		for (const auto& [key, value] : row.getObject())
+		{
+			// rows usually have the same keys, so the column is usually the one in the same position as the member
+			if (position >= columns.size() || columns[position].name != key)
+				position = findOrAddColumn (key, numRowsBefore);
+
+			appendValue (columns[position], value, result.numRows);
+
+			++position;
+		}
+
+		// a row that doesn't have every field leaves some columns one value short
+		if (row.getNumChildren() != columns.size())
+			for (auto& column : columns)
+				if (column.length == numRowsBefore)
+					appendNull (column);
+	}
+
+	[[nodiscard]] std::size_t findOrAddColumn (const std::string& key, std::size_t numRowsBefore)
+	{
+		auto& columns = result.columns;
+
+		const auto [iter, added] = indices.try_emplace (key, columns.size());
+
+		if (added)
+		{
+			auto& column = columns.emplace_back();
+
+			column.name = key;
+
+			// the rows before this one didn't have this field
+			column.length	 = numRowsBefore;
+			column.nullCount = numRowsBefore;
+		}
+
+		return iter->second;
+	}
+
+	ColumnTable result;
+
+	// the keys are views of the names in the input Nodes, which outlive the builder
+	std::unordered_map<std::string_view, std::size_t> indices;
+
+	std::size_t numRowsAdded { 0 };
+};
+
+[[nodiscard]] static ColumnType unifyTypes (const Column& column, ColumnType other)
+{
+	if (column.type == other || other == ColumnType::Null)
+		return column.type;
+
+	if (column.type == ColumnType::Null)
+		return other;
+
+	const auto isNumber = [] (ColumnType type)
+	{ return type == ColumnType::Int64 || type == ColumnType::Double; };
+
+	if (isNumber (column.type) && isNumber (other))
+		return ColumnType::Double;
+
+	throwTypeConflict (column, getTypeName (other));
+}
+
+// Appends one part's column (or, if it's nullptr, a run of nulls) to a column whose buffers are already sized for the
+// whole table. Every part but the last holds a multiple of rowAlignment rows, so bitmaps can be copied bytewise.
+static void appendPart (Column& dest, const Column* source, std::size_t rowOffset, std::size_t numRows)
+{
+	const auto firstByte = rowOffset / 8;
+	const auto numBytes	 = bytesForBits (numRows);
+
+	if (! dest.validity.empty())
+	{
+		auto* validity = dest.validity.data() + firstByte;
+
+		if (source == nullptr || source->type == ColumnType::Null)
+			std::memset (validity, 0, numBytes);
+		else if (source->validity.empty())
+			std::memset (validity, 0xFF, numBytes);
+		else
+			std::memcpy (validity, source->validity.data(), numBytes);
+	}
+
+	if (source == nullptr || source->type == ColumnType::Null)
+	{
+		if (dest.type == ColumnType::String)
+			std::fill_n (dest.offsets.begin() + static_cast<std::ptrdiff_t> (rowOffset) + 1, numRows,
+						 static_cast<std::int32_t> (dest.bytes.size()));
+
+		// the other buffers were zero-filled when they were sized
+		return;
+	}
+
+	switch (dest.type)
+	{
+		case (ColumnType::Boolean) :
+			std::memcpy (dest.booleans.data() + firstByte, source->booleans.data(), numBytes);
+			break;
+
+		case (ColumnType::Int64) :
+			std::copy (source->integers.begin(), source->integers.end(), dest.integers.begin() + static_cast<std::ptrdiff_t> (rowOffset));
+			break;
+
+		case (ColumnType::Double) :
+			if (source->type == ColumnType::Int64)
+				std::copy (source->integers.begin(), source->integers.end(), dest.doubles.begin() + static_cast<std::ptrdiff_t> (rowOffset));
+			else
+				std::copy (source->doubles.begin(), source->doubles.end(), dest.doubles.begin() + static_cast<std::ptrdiff_t> (rowOffset));
+			break;
+
+		case (ColumnType::String) :
+		{
+			if (source->bytes.size() > maxStringBytes - dest.bytes.size())
+				throw std::runtime_error { "Field '" + dest.name + "' holds more than 2^31 - 1 bytes of strings" };
+
+			const auto base = static_cast<std::int32_t> (dest.bytes.size());
+
+			std::transform (source->offsets.begin() + 1, source->offsets.end(),
+							dest.offsets.begin() + static_cast<std::ptrdiff_t> (rowOffset) + 1,
+							[base] (std::int32_t offset) { return offset + base; });
+
+			dest.bytes.insert (dest.bytes.end(), source->bytes.begin(), source->bytes.end());
+			break;
+		}
+
+		default : break;
+	}
+}
+
+[[nodiscard]] static ColumnTable concatenate (const std::vector<ColumnTable>& parts)
+{
+	ColumnTable result;
+
+	// the columns are ordered by where they first appear, and each one's type is settled before any data is copied
+	std::unordered_map<std::string_view, std::size_t> indices;
+
+	for (const auto& part : parts)
+	{
+		for (const auto& column : part.columns)
+		{
+			const auto [iter, added] = indices.try_emplace (column.name, result.columns.size());
+
+			if (added)
+			{
+				auto& newColumn = result.columns.emplace_back();
+
+				newColumn.name = column.name;
+			}
+
+			auto& dest = result.columns[iter->second];
+
+			dest.type = unifyTypes (dest, column.type);
+			dest.nullCount += column.nullCount;
+		}
+
+		result.numRows += part.numRows;
+	}
+
+	for (auto& dest : result.columns)
+	{
+		std::vector<const Column*> sources (parts.size(), nullptr);
+		std::size_t				   totalBytes = 0;
+
+		for (auto i = 0UL; i < parts.size(); ++i)
+		{
+			for (const auto& column : parts[i].columns)
+			{
+				if (column.name == dest.name)
+				{
+					sources[i] = &column;
+					totalBytes += column.bytes.size();
+					break;
+				}
+			}
+
+			// columns missing from a part are nulls for all of its rows
+			if (sources[i] == nullptr)
+				dest.nullCount += parts[i].numRows;
+		}
+
+		dest.length = result.numRows;
+
+		const auto numRows = dest.length;
+
+		switch (dest.type)
+		{
+			case (ColumnType::Boolean) : dest.booleans.assign (bytesForBits (numRows), 0); break;
+			case (ColumnType::Int64) : dest.integers.assign (numRows, 0); break;
+			case (ColumnType::Double) : dest.doubles.assign (numRows, 0.); break;
+			case (ColumnType::String) :
+				dest.offsets.assign (numRows + 1, 0);
+				dest.bytes.reserve (totalBytes);
+				break;
+			default :
+				dest.nullCount = numRows;
+				continue;
+		}
+
+		if (dest.nullCount > 0)
+			dest.validity.assign (bytesForBits (numRows), 0);
+
+		std::size_t rowOffset = 0;
+
+		for (auto i = 0UL; i < parts.size(); ++i)
+		{
+			appendPart (dest, sources[i], rowOffset, parts[i].numRows);
+			rowOffset += parts[i].numRows;
+		}
+	}
+
+	return result;
+}
+
+struct RowRange final
+{
+	std::size_t begin, end;
+};
+
+// Splits the rows into a range for each thread. Every range but the last is a multiple of rowAlignment rows long.
+[[nodiscard]] static std::vector<RowRange> splitRows (std::size_t numRows, std::size_t numThreads)
+{
+	if (numThreads == 0)
+		numThreads = std::thread::hardware_concurrency();
+
+	numThreads = std::max (std::min (numThreads, numRows / minRowsPerThread), std::size_t { 1 });
+
+	const auto rowsPerThread = (numRows + numThreads - 1) / numThreads;
+	const auto rowsPerRange	 = std::max ((rowsPerThread + rowAlignment - 1) / rowAlignment * rowAlignment, rowAlignment);
+
+	std::vector<RowRange> ranges;
+
+	for (std::size_t begin = 0; begin < numRows; begin += rowsPerRange)
+		ranges.push_back ({ begin, std::min (begin + rowsPerRange, numRows) });
+
+	if (ranges.empty())
+		ranges.push_back ({ 0, 0 });
+
+	return ranges;
+}
+
+// Calls work (idx) for each range, running all but the first on new threads
+template <typename Work>
+static void runInParallel (std::size_t numRanges, Work&& work)
+{
+	if (numRanges < 2)
+	{
+		work (0UL);
+		return;
+	}
+
+	std::vector<std::exception_ptr> errors (numRanges);
+
+	auto doRange = [&work, &errors] (std::size_t idx)
+	{
+		try
+		{
+			work (idx);
+		}
+		catch (...)
+		{
+			errors[idx] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	threads.reserve (numRanges - 1);
+
+	for (auto i = 1UL; i < numRanges; ++i)
+	{
+		try
+		{
+			threads.emplace_back (doRange, i);
+		}
+		catch (const std::system_error&)
+		{
+			// couldn't start a thread, so just do this range's work on this thread instead
+			doRange (i);
+		}
+	}
+
+	doRange (0);
+
+	for (auto& thread : threads)
+		thread.join();
+
+	// the ranges are in row order, so this rethrows the error from the earliest row
+	for (const auto& error : errors)
+		if (error != nullptr)
+			std::rethrow_exception (error);
+}
+
+static void checkColumn (const Column& column, std::size_t numRows)
+{
+	const auto fail = [&column] (std::string_view problem)
+	{
+		throw std::runtime_error { "Column '" + column.name + "' " + std::string { problem } };
+	};
+
+	if (column.length != numRows)
+		fail ("doesn't have a value for every row");
+
+	const auto numBytes = bytesForBits (numRows);
+
+	if (column.type != ColumnType::Null && ! column.validity.empty() && column.validity.size() < numBytes)
+		fail ("has a validity bitmap that is too short");
+
+	switch (column.type)
+	{
+		case (ColumnType::Boolean) :
+			if (column.booleans.size() < numBytes)
+				fail ("has a value bitmap that is too short");
+			break;
+
+		case (ColumnType::Int64) :
+			if (column.integers.size() != numRows)
+				fail ("doesn't have an integer for every row");
+			break;
+
+		case (ColumnType::Double) :
+			if (column.doubles.size() != numRows)
+				fail ("doesn't have a double for every row");
+			break;
+
+		case (ColumnType::String) :
+		{
+			if (column.offsets.size() != numRows + 1 || column.offsets.front() < 0)
+				fail ("doesn't have an offset for every row");
+
+			if (! std::is_sorted (column.offsets.begin(), column.offsets.end())
+				|| static_cast<std::size_t> (column.offsets.back()) > column.bytes.size())
+				fail ("has offsets outside of its bytes");
+
+			break;
+		}
+
+		default : break;
+	}
+}
+
+[[nodiscard]] static Node getValue (const Column& column, std::size_t row)
+{
+	if (column.isNull (row))
+		return {};
+
+	switch (column.type)
+	{
+		case (ColumnType::Boolean) : return Node::createBoolean (column.getBoolean (row));
+		case (ColumnType::Int64) : return Node::createNumber (static_cast<double> (column.integers[row]));
+		case (ColumnType::Double) : return Node::createNumber (column.doubles[row]);
+		case (ColumnType::String) : return Node::createString (column.getString (row));
+		default : return {};
+	}
+}
+
+}  // namespace columns
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+ColumnTable toColumns (const Node& array, std::size_t numThreads)
+{
+	if (! array.isArray())
+		throw std::runtime_error { "Only an Array of Objects can be converted to columns" };
+
+	const auto& rows = array.getArray();
+
+	const auto ranges = columns::splitRows (rows.size(), numThreads);
+
+	std::vector<ColumnTable> parts (ranges.size());
+
+	columns::runInParallel (ranges.size(),
+							[&rows, &ranges, &parts] (std::size_t idx)
+							{
+								columns::ColumnBuilder builder;
+
+								parts[idx] = builder.build (rows, ranges[idx].begin, ranges[idx].end);
+							});
+
+	if (parts.size() == 1)
+		return std::move (parts.front());
+
+	return columns::concatenate (parts);
+}
+
+Node fromColumns (const ColumnTable& table, std::size_t numThreads)
+{
+	const auto numRows = table.numRows;
+
+	// Object members are sorted by name, so the columns are visited in that order and every member goes at the end
+	std::vector<const Column*> sorted;
+
+	sorted.reserve (table.columns.size());
+
+	for (const auto& column : table.columns)
+	{
+		columns::checkColumn (column, numRows);
+		sorted.push_back (&column);
+	}
+
+	std::sort (sorted.begin(), sorted.end(),
+			   [] (const Column* a, const Column* b)
+			   { return a->name < b->name; });
+
+	const auto duplicate = std::adjacent_find (sorted.begin(), sorted.end(),
+											   [] (const Column* a, const Column* b)
+											   { return a->name == b->name; });
+
+	if (duplicate != sorted.end())
+		throw std::runtime_error { "There is more than one column named '" + (*duplicate)->name + "'" };
+
+	auto result = Node { ObjectType::Array };
+
+	auto& rows = result.getArray();
+
+	rows.resize (numRows, Node { ObjectType::Object });
+
+	const auto ranges = columns::splitRows (numRows, numThreads);
+
+	columns::runInParallel (ranges.size(),
+							[&rows, &ranges, &sorted] (std::size_t idx)
+							{
+								for (auto row = ranges[idx].begin; row < ranges[idx].end; ++row)
+								{
+									auto& obj = rows[row].getObject();
+
+									for (const auto* column : sorted)
+										obj.emplace_hint (obj.end(), column->name, columns::getValue (*column, row));
+								}
+							});
+
+	return result;
+}
+
+}  // namespace limes::serializing
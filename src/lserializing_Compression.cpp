@@ -0,0 +1,981 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "lserializing/lserializing_Compression.h"
+#include "lserializing/lserializing_OutputSink.h"
+
+#if LSERIAL_HAS_ZLIB
+#	include <zlib.h>
+#endif
+
+namespace limes::serializing
+{
+
+CompressionError::CompressionError (const std::string& message)
+	: std::runtime_error (message)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+namespace compression
+{
+
+static constexpr auto lz4Magic			= std::uint32_t { 0x184D2204 };
+static constexpr auto lz4SkippableMagic = std::uint32_t { 0x184D2A50 };	 // the low four bits can be anything
+static constexpr auto zstdMagic			= std::uint32_t { 0xFD2FB528 };
+
+// the size of the blocks that CompressingSink buffers, and that LZ4 frames are written with
+static constexpr auto blockSize = std::size_t { 262144 };
+
+[[nodiscard]] static inline std::uint32_t readLE32 (const char* data) noexcept
+{
+	const auto* bytes = reinterpret_cast<const unsigned char*> (data);
+
+	return static_cast<std::uint32_t> (bytes[0]) | (static_cast<std::uint32_t> (bytes[1]) << 8)
+		 | (static_cast<std::uint32_t> (bytes[2]) << 16) | (static_cast<std::uint32_t> (bytes[3]) << 24);
+}
+
+static inline void writeLE32 (OutputSink& sink, std::uint32_t value)
+{
+	const char bytes[4] = { static_cast<char> (value & 0xFF), static_cast<char> ((value >> 8) & 0xFF),
+							static_cast<char> ((value >> 16) & 0xFF), static_cast<char> (value >> 24) };
+
+	sink.write (std::string_view { bytes, 4 });
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// The xxHash32 checksum, which the LZ4 frame format uses for its header, block and content checksums
+class LSERIAL_NO_EXPORT XXHash32 final
+{
+public:
+	void update (std::string_view data) noexcept
+	{
+		totalLength += data.size();
+
+		if (numBuffered > 0)
+		{
+			const auto toCopy = std::min (data.size(), std::size_t { 16 } - numBuffered);
+
+			std::memcpy (buffer + numBuffered, data.data(), toCopy);
+
+			numBuffered += toCopy;
+			data.remove_prefix (toCopy);
+
+			if (numBuffered < 16)
+				return;
+
+			consumeStripe (buffer);
+			numBuffered = 0;
+		}
+
+		while (data.size() >= 16)
+		{
+			consumeStripe (data.data());
+			data.remove_prefix (16);
+		}
+
+		std::memcpy (buffer, data.data(), data.size());
+		numBuffered = data.size();
+	}
+
+	[[nodiscard]] std::uint32_t digest() const noexcept
+	{
+		auto hash = totalLength >= 16
+					  ? std::rotl (accumulators[0], 1) + std::rotl (accumulators[1], 7) + std::rotl (accumulators[2], 12) + std::rotl (accumulators[3], 18)
+					  : prime5;
+
+		hash += static_cast<std::uint32_t> (totalLength);
+
+		std::size_t pos = 0;
+
+		for (; pos + 4 <= numBuffered; pos += 4)
+			hash = std::rotl (hash + readLE32 (buffer + pos) * prime3, 17) * prime4;
+
+		for (; pos < numBuffered; ++pos)
+			hash = std::rotl (hash + static_cast<unsigned char> (buffer[pos]) * prime5, 11) * prime1;
+
+		hash ^= hash >> 15;
+		hash *= prime2;
+		hash ^= hash >> 13;
+		hash *= prime3;
+		hash ^= hash >> 16;
+
+		return hash;
+	}
+
+	[[nodiscard]] static std::uint32_t of (std::string_view data) noexcept
+	{
+		XXHash32 hash;
+		hash.update (data);
+		return hash.digest();
+	}
+
+private:
+	void consumeStripe (const char* data) noexcept
+	{
+		for (auto i = 0; i < 4; ++i)
+			accumulators[i] = std::rotl (accumulators[i] + readLE32 (data + i * 4) * prime2, 13) * prime1;
+	}
+
+	static constexpr std::uint32_t prime1 = 2654435761U, prime2 = 2246822519U, prime3 = 3266489917U,
+								   prime4 = 668265263U, prime5 = 374761393U;
+
+	std::uint32_t accumulators[4] = { prime1 + prime2, prime2, 0, 0U - prime1 };
+
+	std::uint64_t totalLength { 0 };
+
+	char		buffer[16] = {};
+	std::size_t numBuffered { 0 };
+};
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// The LZ4 block format: a series of sequences, each of which is a run of literal bytes followed by a copy of
+// earlier output. See https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+namespace lz4
+{
+
+static constexpr auto minMatch		   = std::size_t { 4 };
+static constexpr auto lastLiterals	   = std::size_t { 5 };	  // the last bytes of a block are always literals...
+static constexpr auto matchFindLimit   = std::size_t { 12 };  // ...and the last match starts at least this far from the end
+static constexpr auto maxOffset		   = std::size_t { 65535 };
+static constexpr auto hashLog		   = 14;
+static constexpr auto hashTableSize	   = std::size_t { 1 } << hashLog;
+static constexpr auto skipTrigger	   = 6;	 // how quickly the search speeds up through data that doesn't compress
+static constexpr auto decoderSlack	   = std::size_t { 16 };  // room for the decoder to copy 16 bytes at a time past the end
+
+[[nodiscard]] static constexpr std::size_t maxCompressedSize (std::size_t size) noexcept
+{
+	return size + size / 255 + 16;
+}
+
+[[nodiscard]] static inline std::uint32_t read32 (const unsigned char* data) noexcept
+{
+	std::uint32_t value;
+	std::memcpy (&value, data, sizeof (value));
+	return value;
+}
+
+[[nodiscard]] static inline std::uint32_t hash (const unsigned char* data) noexcept
+{
+	return (read32 (data) * 2654435761U) >> (32 - hashLog);
+}
+
+// returns the number of bytes that are the same at a and b, comparing no further than limit
+[[nodiscard]] static inline std::size_t countMatching (const unsigned char* a, const unsigned char* b, const unsigned char* limit) noexcept
+{
+	const auto* start = a;
+
+	if constexpr (std::endian::native == std::endian::little)
+	{
+		while (a + 8 <= limit)
+		{
+			std::uint64_t x, y;
+			std::memcpy (&x, a, 8);
+			std::memcpy (&y, b, 8);
+
+			if (const auto diff = x ^ y; diff != 0)
+				return static_cast<std::size_t> (a - start) + static_cast<std::size_t> (std::countr_zero (diff) / 8);
+
+			a += 8;
+			b += 8;
+		}
+	}
+
+	while (a < limit && *a == *b)
+	{
+		++a;
+		++b;
+	}
+
+	return static_cast<std::size_t> (a - start);
+}
+
+static inline unsigned char* writeLength (unsigned char* output, std::size_t length) noexcept
+{
+	for (; length >= 255; length -= 255)
+		*output++ = 255;
+
+	*output++ = static_cast<unsigned char> (length);
+
+	return output;
+}
+
+static inline unsigned char* writeSequence (unsigned char* output, const unsigned char* literals, std::size_t numLiterals,
+											std::size_t offset, std::size_t matchLength) noexcept
+{
+	auto* token = output++;
+
+	if (numLiterals >= 15)
+	{
+		*token = 15 << 4;
+		output = writeLength (output, numLiterals - 15);
+	}
+	else
+	{
+		*token = static_cast<unsigned char> (numLiterals << 4);
+	}
+
+	std::memcpy (output, literals, numLiterals);
+	output += numLiterals;
+
+	if (matchLength == 0)
+		return output;
+
+	*output++ = static_cast<unsigned char> (offset & 0xFF);
+	*output++ = static_cast<unsigned char> (offset >> 8);
+
+	matchLength -= minMatch;
+
+	if (matchLength >= 15)
+	{
+		*token |= 15;
+		output = writeLength (output, matchLength - 15);
+	}
+	else
+	{
+		*token |= static_cast<unsigned char> (matchLength);
+	}
+
+	return output;
+}
+
+// Compresses a block with a greedy hash-table match finder, as the reference LZ4 compressor does at its default
+// level. The output must have room for maxCompressedSize (size) bytes. Returns the compressed size.
+[[nodiscard]] static std::size_t compressBlock (const char* input, std::size_t size, char* output, std::uint32_t* hashTable) noexcept
+{
+	const auto* const start = reinterpret_cast<const unsigned char*> (input);
+	const auto* const end	= start + size;
+
+	auto* const outputStart = reinterpret_cast<unsigned char*> (output);
+
+	auto* op = outputStart;
+
+	const auto* anchor = start;
+
+	if (size >= matchFindLimit + 1)
+	{
+		const auto* const matchLimit = end - lastLiterals;
+		const auto* const searchEnd	 = end - matchFindLimit;
+
+		std::fill_n (hashTable, hashTableSize, 0U);
+
+		const auto* ip = start + 1;
+
+		while (ip < searchEnd)
+		{
+			// find a match, stepping further ahead the longer the search goes without finding one
+			const unsigned char* match = nullptr;
+
+			for (auto attempts = 1U << skipTrigger; ip < searchEnd; ++attempts)
+			{
+				const auto h = hash (ip);
+
+				match = start + hashTable[h];
+
+				hashTable[h] = static_cast<std::uint32_t> (ip - start);
+
+				if (match < ip && static_cast<std::size_t> (ip - match) <= maxOffset && read32 (match) == read32 (ip))
+					break;
+
+				match = nullptr;
+				ip += attempts >> skipTrigger;
+			}
+
+			if (match == nullptr)
+				break;
+
+			// extend the match backwards into the literals
+			while (ip > anchor && match > start && ip[-1] == match[-1])
+			{
+				--ip;
+				--match;
+			}
+
+			const auto matchLength = minMatch + countMatching (ip + minMatch, match + minMatch, matchLimit);
+
+			op = writeSequence (op, anchor, static_cast<std::size_t> (ip - anchor),
+								static_cast<std::size_t> (ip - match), matchLength);
+
+			ip += matchLength;
+			anchor = ip;
+
+			if (ip < searchEnd)
+				hashTable[hash (ip - 2)] = static_cast<std::uint32_t> (ip - 2 - start);
+		}
+	}
+
+	op = writeSequence (op, anchor, static_cast<std::size_t> (end - anchor), 0, 0);
+
+	return static_cast<std::size_t> (op - outputStart);
+}
+
+[[nodiscard]] static inline bool readLength (const unsigned char*& ip, const unsigned char* end, std::size_t& length) noexcept
+{
+	for (;;)
+	{
+		if (ip == end)
+			return false;
+
+		const auto byte = *ip++;
+
+		length += byte;
+
+		if (byte != 255)
+			return true;
+	}
+}
+
+// Decompresses a block into output, which may be preceded by historySize bytes of earlier output that matches can
+// refer to. The output must have decoderSlack bytes of space past capacity. Returns false if the block is corrupt.
+[[nodiscard]] static bool decompressBlock (const char* input, std::size_t size, char* output, std::size_t historySize,
+										   std::size_t capacity, std::size_t& outputSize) noexcept
+{
+	const auto* ip		  = reinterpret_cast<const unsigned char*> (input);
+	const auto* const end = ip + size;
+
+	auto* const outputStart = reinterpret_cast<unsigned char*> (output);
+	auto* const outputEnd	= outputStart + capacity;
+
+	auto* op = outputStart;
+
+	while (ip < end)
+	{
+		const auto token = *ip++;
+
+		auto numLiterals = static_cast<std::size_t> (token >> 4);
+
+		if (numLiterals == 15 && ! readLength (ip, end, numLiterals))
+			return false;
+
+		if (numLiterals > static_cast<std::size_t> (end - ip) || numLiterals > static_cast<std::size_t> (outputEnd - op))
+			return false;
+
+		// most runs of literals are short, and copying a fixed 16 bytes is much faster than a variable-length copy
+		if (numLiterals <= 16 && end - ip >= 16)
+			std::memcpy (op, ip, 16);
+		else
+			std::memcpy (op, ip, numLiterals);
+
+		ip += numLiterals;
+		op += numLiterals;
+
+		// the last sequence is only literals
+		if (ip == end)
+			break;
+
+		if (end - ip < 2)
+			return false;
+
+		const auto offset = static_cast<std::size_t> (ip[0]) | (static_cast<std::size_t> (ip[1]) << 8);
+
+		ip += 2;
+
+		if (offset == 0 || offset > static_cast<std::size_t> (op - outputStart) + historySize)
+			return false;
+
+		auto matchLength = static_cast<std::size_t> (token & 15);
+
+		if (matchLength == 15 && ! readLength (ip, end, matchLength))
+			return false;
+
+		matchLength += minMatch;
+
+		if (matchLength > static_cast<std::size_t> (outputEnd - op))
+			return false;
+
+		const auto* match = op - offset;
+
+		if (offset >= 8)
+		{
+			// each 8-byte chunk only reads bytes that have already been written, and the slack past the end of the
+			// output makes overrunning the match length safe
+			for (std::size_t i = 0; i < matchLength; i += 8)
+				std::memcpy (op + i, match + i, 8);
+
+			op += matchLength;
+		}
+		else
+		{
+			for (std::size_t i = 0; i < matchLength; ++i)
+				*op++ = match[i];
+		}
+	}
+
+	outputSize = static_cast<std::size_t> (op - outputStart);
+
+	return true;
+}
+
+}  // namespace lz4
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+enum class EncodeMode
+{
+	Block,	// a full block has been buffered
+	Flush,	// the output so far should be decodable
+	Finish	// the stream is ending
+};
+
+class LSERIAL_NO_EXPORT Encoder
+{
+public:
+	virtual ~Encoder() = default;
+
+	virtual void encode (std::string_view data, EncodeMode mode, OutputSink& destination) = 0;
+};
+
+// Writes an LZ4 frame with independent blocks and a content checksum
+class LSERIAL_NO_EXPORT LZ4Encoder final : public Encoder
+{
+public:
+	LZ4Encoder()
+		: output (std::make_unique<char[]> (lz4::maxCompressedSize (blockSize))),
+		  hashTable (std::make_unique<std::uint32_t[]> (lz4::hashTableSize))
+	{
+	}
+
+	void encode (std::string_view data, EncodeMode mode, OutputSink& destination) final
+	{
+		if (! wroteHeader)
+		{
+			writeHeader (destination);
+			wroteHeader = true;
+		}
+
+		if (! data.empty())
+		{
+			contentHash.update (data);
+
+			const auto compressedSize = lz4::compressBlock (data.data(), data.size(), output.get(), hashTable.get());
+
+			// blocks that don't compress are stored as they are, with the block size's high bit set
+			if (compressedSize >= data.size())
+			{
+				writeLE32 (destination, static_cast<std::uint32_t> (data.size()) | 0x80000000U);
+				destination.write (data);
+			}
+			else
+			{
+				writeLE32 (destination, static_cast<std::uint32_t> (compressedSize));
+				destination.write (std::string_view { output.get(), compressedSize });
+			}
+		}
+
+		if (mode == EncodeMode::Finish)
+		{
+			writeLE32 (destination, 0);
+			writeLE32 (destination, contentHash.digest());
+		}
+	}
+
+private:
+	static void writeHeader (OutputSink& destination)
+	{
+		// version 1, independent blocks, content checksum; 256 KB blocks
+		const char descriptor[2] = { 0x64, 0x50 };
+
+		writeLE32 (destination, lz4Magic);
+		destination.write (std::string_view { descriptor, 2 });
+		destination.write (static_cast<char> ((XXHash32::of ({ descriptor, 2 }) >> 8) & 0xFF));
+	}
+
+	std::unique_ptr<char[]>			 output;
+	std::unique_ptr<std::uint32_t[]> hashTable;
+
+	XXHash32 contentHash;
+
+	bool wroteHeader { false };
+};
+
+#if LSERIAL_HAS_ZLIB
+
+static constexpr auto zlibBufferSize = std::size_t { 65536 };
+
+// windowBits of 15 + 16 selects the gzip container rather than zlib's own
+static constexpr auto gzipWindowBits = 15 + 16;
+
+class LSERIAL_NO_EXPORT GzipEncoder final : public Encoder
+{
+public:
+	GzipEncoder()
+		: output (std::make_unique<unsigned char[]> (zlibBufferSize))
+	{
+		if (deflateInit2 (&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, gzipWindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			throw CompressionError { "Couldn't initialize zlib" };
+	}
+
+	~GzipEncoder() final
+	{
+		deflateEnd (&stream);
+	}
+
+	GzipEncoder (const GzipEncoder&)			= delete;
+	GzipEncoder& operator= (const GzipEncoder&) = delete;
+
+	void encode (std::string_view data, EncodeMode mode, OutputSink& destination) final
+	{
+		const auto flush = mode == EncodeMode::Finish ? Z_FINISH : (mode == EncodeMode::Flush ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+
+		// blocks are never bigger than blockSize, so this fits in zlib's 32-bit counts
+		stream.next_in	= reinterpret_cast<Bytef*> (const_cast<char*> (data.data()));
+		stream.avail_in = static_cast<uInt> (data.size());
+
+		int result;
+
+		do
+		{
+			stream.next_out	 = output.get();
+			stream.avail_out = static_cast<uInt> (zlibBufferSize);
+
+			result = deflate (&stream, flush);
+
+			if (result == Z_STREAM_ERROR)
+				throw CompressionError { "zlib failed to compress the data" };
+
+			const auto numBytes = zlibBufferSize - stream.avail_out;
+
+			if (numBytes > 0)
+				destination.write (std::string_view { reinterpret_cast<const char*> (output.get()), numBytes });
+		} while (stream.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+	}
+
+private:
+	z_stream stream {};
+
+	std::unique_ptr<unsigned char[]> output;
+};
+
+#endif
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// Decodes one LZ4 frame and returns its size
+[[nodiscard]] static std::size_t decodeLZ4Frame (std::string_view data, OutputSink& sink)
+{
+	const auto fail = [] (std::string_view problem)
+	{
+		throw CompressionError { "Invalid LZ4 frame: " + std::string { problem } };
+	};
+
+	if (data.size() < 7)
+		fail ("the header is truncated");
+
+	const auto flags	  = static_cast<unsigned char> (data[4]);
+	const auto blockFlags = static_cast<unsigned char> (data[5]);
+
+	if ((flags >> 6) != 1 || (flags & 0x02) != 0 || (blockFlags & 0x8F) != 0)
+		fail ("unsupported version or reserved bits set");
+
+	if ((flags & 0x01) != 0)
+		fail ("frames that need a dictionary aren't supported");
+
+	const auto independentBlocks = (flags & 0x20) != 0;
+	const auto hasBlockChecksums = (flags & 0x10) != 0;
+	const auto hasContentSize	 = (flags & 0x08) != 0;
+	const auto hasContentHash	 = (flags & 0x04) != 0;
+
+	const auto blockSizeID = (blockFlags >> 4) & 7;
+
+	if (blockSizeID < 4)
+		fail ("invalid maximum block size");
+
+	const auto maxBlockSize = std::size_t { 1 } << (2 * blockSizeID + 8);
+
+	const auto headerSize = std::size_t { hasContentSize ? 15U : 7U };
+
+	if (data.size() < headerSize)
+		fail ("the header is truncated");
+
+	if (static_cast<unsigned char> (data[headerSize - 1]) != ((XXHash32::of (data.substr (4, headerSize - 5)) >> 8) & 0xFF))
+		fail ("the header checksum doesn't match");
+
+	// linked blocks can refer back to the previous 64 KB of output, so that much is kept in front of each block
+	const auto historyCapacity = independentBlocks ? std::size_t { 0 } : lz4::maxOffset + 1;
+
+	std::vector<char> buffer (historyCapacity + maxBlockSize + lz4::decoderSlack);
+
+	std::size_t historySize = 0;
+
+	XXHash32 contentHash;
+
+	auto pos = headerSize;
+
+	for (;;)
+	{
+		if (data.size() - pos < 4)
+			fail ("the data is truncated");
+
+		const auto blockHeader = readLE32 (data.data() + pos);
+
+		pos += 4;
+
+		if (blockHeader == 0)
+			break;
+
+		const auto isStored		  = (blockHeader & 0x80000000U) != 0;
+		const auto compressedSize = static_cast<std::size_t> (blockHeader & 0x7FFFFFFFU);
+
+		if (compressedSize > maxBlockSize)
+			fail ("a block is bigger than the frame's maximum block size");
+
+		if (data.size() - pos < compressedSize + (hasBlockChecksums ? 4 : 0))
+			fail ("the data is truncated");
+
+		const auto block = data.substr (pos, compressedSize);
+
+		pos += compressedSize;
+
+		if (hasBlockChecksums)
+		{
+			if (XXHash32::of (block) != readLE32 (data.data() + pos))
+				fail ("a block checksum doesn't match");
+
+			pos += 4;
+		}
+
+		auto* const blockOutput = buffer.data() + historySize;
+
+		std::size_t outputSize = 0;
+
+		if (isStored)
+		{
+			std::memcpy (blockOutput, block.data(), compressedSize);
+			outputSize = compressedSize;
+		}
+		else if (! lz4::decompressBlock (block.data(), compressedSize, blockOutput, historySize, maxBlockSize, outputSize))
+		{
+			fail ("a block is corrupt");
+		}
+
+		const auto decoded = std::string_view { blockOutput, outputSize };
+
+		if (hasContentHash)
+			contentHash.update (decoded);
+
+		sink.write (decoded);
+
+		if (! independentBlocks)
+		{
+			const auto total = historySize + outputSize;
+
+			historySize = std::min (total, historyCapacity);
+
+			std::memmove (buffer.data(), buffer.data() + total - historySize, historySize);
+		}
+	}
+
+	if (hasContentHash)
+	{
+		if (data.size() - pos < 4)
+			fail ("the data is truncated");
+
+		if (contentHash.digest() != readLE32 (data.data() + pos))
+			fail ("the content checksum doesn't match");
+
+		pos += 4;
+	}
+
+	return pos;
+}
+
+#if LSERIAL_HAS_ZLIB
+
+// Decodes one gzip member and returns its size
+[[nodiscard]] static std::size_t decodeGzipMember (std::string_view data, OutputSink& sink)
+{
+	z_stream stream {};
+
+	if (inflateInit2 (&stream, gzipWindowBits) != Z_OK)
+		throw CompressionError { "Couldn't initialize zlib" };
+
+	struct Cleanup final
+	{
+		~Cleanup() { inflateEnd (&s); }
+
+		z_stream& s;
+	};
+
+	const Cleanup cleanup { stream };
+
+	const auto output = std::make_unique<unsigned char[]> (zlibBufferSize);
+
+	std::size_t consumed = 0;
+
+	for (;;)
+	{
+		// zlib's counts are 32-bit, so the input is fed in pieces
+		if (stream.avail_in == 0 && consumed < data.size())
+		{
+			const auto chunk = std::min (data.size() - consumed, static_cast<std::size_t> (UINT_MAX));
+
+			stream.next_in	= reinterpret_cast<Bytef*> (const_cast<char*> (data.data() + consumed));
+			stream.avail_in = static_cast<uInt> (chunk);
+
+			consumed += chunk;
+		}
+
+		stream.next_out	 = output.get();
+		stream.avail_out = static_cast<uInt> (zlibBufferSize);
+
+		const auto result = inflate (&stream, Z_NO_FLUSH);
+
+		const auto numBytes = zlibBufferSize - stream.avail_out;
+
+		if (numBytes > 0)
+			sink.write (std::string_view { reinterpret_cast<const char*> (output.get()), numBytes });
+
+		if (result == Z_STREAM_END)
+			return consumed - stream.avail_in;
+
+		if (result == Z_BUF_ERROR && stream.avail_in == 0 && consumed == data.size())
+			throw CompressionError { "Invalid gzip data: the data is truncated" };
+
+		if (result != Z_OK && result != Z_BUF_ERROR)
+			throw CompressionError { std::string { "Invalid gzip data: " } + (stream.msg != nullptr ? stream.msg : "zlib error") };
+	}
+}
+
+#endif
+
+}  // namespace compression
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+bool isCompressionAvailable (CompressionType type) noexcept
+{
+#if LSERIAL_HAS_ZLIB
+	static constexpr auto hasZlib = true;
+#else
+	static constexpr auto hasZlib = false;
+#endif
+
+	return type != CompressionType::Gzip || hasZlib;
+}
+
+CompressionType detectCompression (std::string_view data) noexcept
+{
+	if (data.size() >= 3 && data[0] == '\x1F' && data[1] == '\x8B' && data[2] == '\x08')
+		return CompressionType::Gzip;
+
+	if (data.size() >= 4)
+	{
+		const auto magic = compression::readLE32 (data.data());
+
+		if (magic == compression::lz4Magic || (magic & 0xFFFFFFF0U) == compression::lz4SkippableMagic)
+			return CompressionType::LZ4;
+	}
+
+	return CompressionType::None;
+}
+
+std::string_view getFileExtension (CompressionType type) noexcept
+{
+	switch (type)
+	{
+		case (CompressionType::Gzip) : return ".gz";
+		case (CompressionType::LZ4) : return ".lz4";
+		default : return {};
+	}
+}
+
+std::string compress (std::string_view data, CompressionType type)
+{
+	std::string result;
+
+	StringSink output { result };
+
+	CompressingSink sink { output, type };
+
+	sink.write (data);
+	sink.finish();
+
+	return result;
+}
+
+void decompress (std::string_view data, OutputSink& sink)
+{
+	if (data.size() >= 4 && compression::readLE32 (data.data()) == compression::zstdMagic)
+		throw CompressionError { "Zstandard compressed data isn't supported" };
+
+	const auto type = detectCompression (data);
+
+	if (type == CompressionType::None)
+		throw CompressionError { "The data isn't compressed in a known format" };
+
+	if (! isCompressionAvailable (type))
+		throw CompressionError { "This build of the library can't decompress gzip data, because it was built without zlib" };
+
+	// concatenated gzip members or LZ4 frames decompress to their concatenated contents
+	while (! data.empty())
+	{
+		if (detectCompression (data) != type)
+			throw CompressionError { "Unexpected data after the end of the compressed stream" };
+
+		if (type == CompressionType::LZ4)
+		{
+			if (const auto magic = compression::readLE32 (data.data()); magic != compression::lz4Magic)
+			{
+				// a skippable frame, which holds some other application's metadata
+				if (data.size() < 8 || data.size() - 8 < compression::readLE32 (data.data() + 4))
+					throw CompressionError { "Invalid LZ4 frame: the data is truncated" };
+
+				data.remove_prefix (8 + compression::readLE32 (data.data() + 4));
+				continue;
+			}
+
+			data.remove_prefix (compression::decodeLZ4Frame (data, sink));
+		}
+#if LSERIAL_HAS_ZLIB
+		else
+		{
+			data.remove_prefix (compression::decodeGzipMember (data, sink));
+		}
+#endif
+	}
+}
+
+std::string decompress (std::string_view data)
+{
+	std::string result;
+
+	StringSink sink { result };
+
+	// The formats record the size of their contents in places that make a good guess at the output's size. This is
+	// only a guess, so it's limited to what the format's best possible compression ratio allows.
+	switch (detectCompression (data))
+	{
+		case (CompressionType::Gzip) :
+			if (data.size() >= 18)
+				sink.reserve (std::min (static_cast<std::size_t> (compression::readLE32 (data.data() + data.size() - 4)), data.size() * 1032));
+			break;
+
+		case (CompressionType::LZ4) :
+			if (data.size() >= 15 && compression::readLE32 (data.data()) == compression::lz4Magic && (data[4] & 0x08) != 0)
+			{
+				const auto contentSize = static_cast<std::uint64_t> (compression::readLE32 (data.data() + 6))
+									   | (static_cast<std::uint64_t> (compression::readLE32 (data.data() + 10)) << 32);
+
+				sink.reserve (static_cast<std::size_t> (std::min (contentSize, static_cast<std::uint64_t> (data.size()) * 256)));
+			}
+			break;
+
+		default : break;
+	}
+
+	decompress (data, sink);
+
+	return result;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+CompressingSink::CompressingSink (OutputSink& destinationSink, CompressionType type)
+	: destination (destinationSink)
+{
+	switch (type)
+	{
+		case (CompressionType::LZ4) : encoder = std::make_unique<compression::LZ4Encoder>(); break;
+#if LSERIAL_HAS_ZLIB
+		case (CompressionType::Gzip) : encoder = std::make_unique<compression::GzipEncoder>(); break;
+#else
+		case (CompressionType::Gzip) :
+			throw CompressionError { "This build of the library can't write gzip data, because it was built without zlib" };
+#endif
+		default : throw CompressionError { "CompressingSink needs a compression type" };
+	}
+
+	buffer.reserve (compression::blockSize);
+}
+
+CompressingSink::~CompressingSink()
+{
+	try
+	{
+		finish();
+	}
+	catch (...)
+	{
+	}
+}
+
+void CompressingSink::write (std::string_view text)
+{
+	if (finished)
+		throw CompressionError { "CompressingSink::write() was called after finish()" };
+
+	while (buffer.size() + text.size() >= compression::blockSize)
+	{
+		const auto toCopy = compression::blockSize - buffer.size();
+
+		buffer.append (text.data(), toCopy);
+		text.remove_prefix (toCopy);
+
+		encoder->encode (buffer, compression::EncodeMode::Block, destination);
+		buffer.clear();
+	}
+
+	buffer.append (text);
+}
+
+void CompressingSink::write (char character)
+{
+	if (finished)
+		throw CompressionError { "CompressingSink::write() was called after finish()" };
+
+	buffer.push_back (character);
+
+	if (buffer.size() == compression::blockSize)
+	{
+		encoder->encode (buffer, compression::EncodeMode::Block, destination);
+		buffer.clear();
+	}
+}
+
+void CompressingSink::flush()
+{
+	if (! finished)
+	{
+		encoder->encode (buffer, compression::EncodeMode::Flush, destination);
+		buffer.clear();
+	}
+
+	destination.flush();
+}
+
+void CompressingSink::finish()
+{
+	if (finished)
+		return;
+
+	finished = true;
+
+	encoder->encode (buffer, compression::EncodeMode::Finish, destination);
+	buffer.clear();
+}
+
+}  // namespace limes::serializing
@@ -12,18 +12,108 @@
  * ======================================================================================
  */
 
+#include <filesystem>
+#include <string>
+#include <utility>
 #include "lserializing/lserializing_SerializingFormat.h"
+#include "lserializing/lserializing_Serializer.h"
+#include "lserializing_MappedFile.h"
 
 namespace limes::serializing
 {
 
-ParseError::ParseError (std::string_view& message, const text::utf8::LineAndColumn& lc)
-	: std::runtime_error (message.data()), position (lc) { }
+ParseError::ParseError (std::string_view message, const text::utf8::LineAndColumn& lc)
+	: std::runtime_error (std::string { message }), position (lc) { }
 
+ParseResult::ParseResult (Node&& node) noexcept
+	: result (std::move (node))
+{
+}
+
+ParseResult::ParseResult (ParseError&& error) noexcept
+	: result (std::move (error))
+{
+}
+
+bool ParseResult::hasValue() const noexcept
+{
+	return std::holds_alternative<Node> (result);
+}
+
+ParseResult::operator bool() const noexcept
+{
+	return hasValue();
+}
+
+Node& ParseResult::getNode()
+{
+	if (const auto* error = std::get_if<ParseError> (&result))
+		throw *error;
+
+	return std::get<Node> (result);
+}
+
+const Node& ParseResult::getNode() const
+{
+	if (const auto* error = std::get_if<ParseError> (&result))
+		throw *error;
+
+	return std::get<Node> (result);
+}
+
+const ParseError& ParseResult::getError() const
+{
+	if (! std::holds_alternative<ParseError> (result))
+		throw std::runtime_error { "getError(): parsing succeeded!" };
+
+	return std::get<ParseError> (result);
+}
 
 std::string Format::serialize (const Node& node, bool shouldPrettyPrint) const noexcept
 {
-	return createPrinter (shouldPrettyPrint)->print (node);
+	const auto printer = createPrinter (shouldPrettyPrint);
+
+	// measuring first means that the string is allocated once at its final size, rather than being
+	// grown (and briefly needing up to three times the output's size) as it's printed
+	std::string result;
+
+	StringSink sink { result };
+
+	sink.reserve (printer->measure (node));
+
+	printer->print (node, sink);
+
+	return result;
+}
+
+void Format::serialize (const Node& node, OutputSink& sink, bool shouldPrettyPrint) const
+{
+	createPrinter (shouldPrettyPrint)->print (node, sink);
+}
+
+void Format::serializeToFile (const Node& node, const std::filesystem::path& path, bool shouldPrettyPrint,
+							  CompressionType compression) const
+{
+	const auto printer = createPrinter (shouldPrettyPrint);
+
+	FileSink sink { path };
+
+	if (compression != CompressionType::None)
+	{
+		CompressingSink compressor { sink, compression };
+
+		printer->print (node, compressor);
+
+		compressor.finish();
+		sink.flush();
+		return;
+	}
+
+	sink.reserve (printer->measure (node));
+
+	printer->print (node, sink);
+
+	sink.flush();
 }
 
 std::string Format::convertTo (std::string_view string, const Format& otherFormat, bool shouldPrettyPrint) const noexcept
@@ -31,18 +121,41 @@ std::string Format::convertTo (std::string_view string, const Format& otherForma
 	return otherFormat.serialize (parse (string), shouldPrettyPrint);
 }
 
+ParseResult Format::tryParse (std::string_view string) const
+{
+	try
+	{
+		return parse (string);
+	}
+	catch (ParseError& error)
+	{
+		return std::move (error);
+	}
+}
+
+Node Format::parseFile (const std::filesystem::path& path) const
+{
+	const MappedFile file { path };
+
+	const auto text = file.getText();
+
+	if (detectCompression (text) != CompressionType::None)
+		return parse (decompress (text));
+
+	return parse (text);
+}
+
 bool Format::probablyMatchesString (std::string_view string) const noexcept
 {
 	try
 	{
-		[[maybe_unused]] const auto n = parse (string);
+		return tryParse (string).hasValue();
 	}
 	catch (...)
 	{
+		// exceptions other than ParseError, such as std::bad_alloc, still propagate out of tryParse()
 		return false;
 	}
-
-	return true;
 }
 
 std::unique_ptr<Schema> Format::createSchemaFrom (const Node& /*data*/) const noexcept
@@ -50,4 +163,13 @@ std::unique_ptr<Schema> Format::createSchemaFrom (const Node& /*data*/) const no
 	return nullptr;
 }
 
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// this is defined here rather than in lserializing_Serializer.cpp, because it's the only part of
+// Serializer that needs the Format class
+Serializer::Serializer (const Format& format, bool shouldPrettyPrint)
+	: printer (format.createPrinter (shouldPrettyPrint))
+{
+}
+
 }  // namespace limes::serializing
@@ -12,622 +12,2112 @@
  * ======================================================================================
  */
 
-#include <cctype>
 #include <cstdlib>
 #include <string_view>
 #include <string>
-#include <sstream>
+#include <charconv>
 #include <stdexcept>
 #include <cmath>
 #include <memory>
 #include <vector>
+#include <thread>
+#include <exception>
+#include <iterator>
+#include <algorithm>
+#include <system_error>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include <functional>
+#include "lserializing/lserializing_JSON.h"
 #include "lserializing/lserializing_SerializingFormat.h"
 #include "lserializing/lserializing_KnownFormats.h"
 #include "lserializing/lserializing_Node.h"
+#include "lserializing/lserializing_StaticPrinter.h"
+#include "lserializing/lserializing_ChunkedPrinter.h"
 #include "lserializing/lserializing_Export.h"
+#include "lserializing_SIMD.h"
+#include "lserializing_UTF8.h"
 
 namespace limes::serializing
 {
 
-class LSERIAL_NO_EXPORT JSONFormat final : public Format
+LSERIAL_NO_EXPORT static const KnownFormats::Register<JSONFormat, true> json_init;
+
+std::string_view JSONFormat::getName() const noexcept
+{
+	return formats::JSON;
+}
+
+bool JSONFormat::supportsComments() const noexcept
+{
+	return false;
+}
+
+const std::vector<std::string_view>& JSONFormat::getFileExtensions() const noexcept
+{
+	struct ExtensionsHolder final
+	{
+		std::vector<std::string_view> xtns;
+
+		ExtensionsHolder()
+		{
+			xtns.emplace_back (".json");
+		}
+	};
+
+	static const ExtensionsHolder holder;
+
+	return holder.xtns;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// Reports errors by recording them and returning false rather than by throwing, so that
+// JSONFormat::tryParse() can reject input without any stack unwinding.
+//
+// All of JSON's structural characters are ASCII, so the grammar is scanned a byte at a time.
+// UTF-8 only matters inside strings, where runs of text are copied in bulk and only validated
+// if they contain any non-ASCII bytes.
+class LSERIAL_NO_EXPORT JSONParser final
 {
 public:
-	[[nodiscard]] std::string_view getName() const noexcept final
+	explicit JSONParser (std::string_view inputText)
+		: JSONParser (inputText, inputText)
+	{
+	}
+
+	// parses only the given slice of the input text; error positions are still reported relative to the whole input
+	JSONParser (std::string_view inputText, std::string_view slice)
+		: source (inputText), current (slice.data()), end (slice.data() + slice.size())
+	{
+	}
+
+	[[nodiscard]] inline bool parse (Node& result)
+	{
+		skipWhitespace();
+
+		if (popIf ('['))
+		{
+			if (! parseArray (result))
+				return false;
+		}
+		else if (popIf ('{'))
+		{
+			if (! parseObject (result))
+				return false;
+		}
+		else
+		{
+			if (! isEOF())
+				return fail ("Expected an object or array");
+
+			result = Node::createNull();
+			return true;
+		}
+
+		skipWhitespace();
+
+		if (! isEOF())
+			return fail ("Unexpected data after the end of the document");
+
+		return true;
+	}
+
+	// parses the comma-separated elements of one slice of a top-level array, appending them to the given array
+	[[nodiscard]] inline bool parseArrayElements (Array& elements)
+	{
+		for (;;)
+		{
+			if (! parseValue (elements.emplace_back()))
+				return false;
+
+			skipWhitespace();
+
+			if (isEOF())
+				return true;
+
+			if (! popIf (','))
+				return fail ("Expected ',' or ']'");
+		}
+	}
+
+	[[nodiscard]] ParseError getError() const
+	{
+		const auto errorOffset = static_cast<std::size_t> (errorPos - source.data());
+
+		return ParseError { errorMessage,
+							text::utf8::LineAndColumn::find (text::utf8::Pointer { source },
+															 text::utf8::Pointer { source.substr (errorOffset) }) };
+	}
+
+private:
+	inline void skipWhitespace() noexcept
+	{
+		current = simd::skipJSONWhitespace (current, end);
+	}
+
+	inline bool popIf (char c) noexcept
+	{
+		if (current != end && *current == c)
+		{
+			++current;
+			return true;
+		}
+
+		return false;
+	}
+
+	inline bool popIf (std::string_view literal) noexcept
+	{
+		if (static_cast<std::size_t> (end - current) >= literal.size()
+			&& std::memcmp (current, literal.data(), literal.size()) == 0)
+		{
+			current += literal.size();
+			return true;
+		}
+
+		return false;
+	}
+
+	inline bool isEOF() const noexcept
+	{
+		return current == end;
+	}
+
+	[[nodiscard]] inline bool parseArray (Node& result)
+	{
+		const auto* const arrayStart = current;
+
+		result = Node { ObjectType::Array };
+
+		skipWhitespace();
+
+		if (popIf (']'))
+			return true;
+
+		auto& array = result.getArray();
+
+		for (;;)
+		{
+			skipWhitespace();
+
+			if (isEOF())
+				return fail ("Unexpected EOF in array declaration", arrayStart);
+
+			if (! parseValue (array.emplace_back()))
+				return false;
+
+			skipWhitespace();
+
+			if (popIf (','))
+				continue;
+
+			if (popIf (']'))
+				return true;
+
+			return fail ("Expected ',' or ']'");
+		}
+	}
+
+	[[nodiscard]] inline bool parseObject (Node& result)
+	{
+		const auto* const objectStart = current;
+
+		result = Node { ObjectType::Object };
+
+		skipWhitespace();
+
+		if (popIf ('}'))
+			return true;
+
+		auto& obj = result.getObject();
+
+		for (;;)
+		{
+			skipWhitespace();
+
+			if (isEOF())
+				return fail ("Unexpected EOF in object declaration", objectStart);
+
+			if (! popIf ('"'))
+				return fail ("Expected a name");
+
+			const auto* const namePos = current;
+
+			std::string name;
+
+			if (! parseString (name))
+				return false;
+
+			if (name.empty())
+				return fail ("Property names cannot be empty", namePos);
+
+			skipWhitespace();
+
+			if (! popIf (':'))
+				return fail ("Expected ':'");
+
+			if (obj.contains (name))
+				return fail ("Duplicate keys in same object", namePos);
+
+			if (! parseValue (obj[std::move (name)]))
+				return false;
+
+			skipWhitespace();
+
+			if (popIf (','))
+				continue;
+
+			if (popIf ('}'))
+				return true;
+
+			return fail ("Expected ',' or '}'");
+		}
+	}
+
+	[[nodiscard]] inline bool parseValue (Node& result)
+	{
+		skipWhitespace();
+
+		if (isEOF())
+			return fail ("Syntax error");
+
+		switch (*current)
+		{
+			case '[' : ++current; return parseArray (result);
+			case '{' : ++current; return parseObject (result);
+			case '"' :
+			{
+				++current;
+				result = Node { ObjectType::String };
+				return parseString (result.getString());
+			}
+			case '-' : [[fallthrough]];
+			case '0' : [[fallthrough]];
+			case '1' : [[fallthrough]];
+			case '2' : [[fallthrough]];
+			case '3' : [[fallthrough]];
+			case '4' : [[fallthrough]];
+			case '5' : [[fallthrough]];
+			case '6' : [[fallthrough]];
+			case '7' : [[fallthrough]];
+			case '8' : [[fallthrough]];
+			case '9' : return parseNumber (result);
+			default : break;
+		}
+
+		if (popIf ("null"))
+		{
+			result = Node::createNull();
+			return true;
+		}
+
+		if (popIf ("true"))
+		{
+			result = Node::createBoolean (true);
+			return true;
+		}
+
+		if (popIf ("false"))
+		{
+			result = Node::createBoolean (false);
+			return true;
+		}
+
+		return fail ("Syntax error");
+	}
+
+	inline std::size_t skipDigits() noexcept
+	{
+		const auto* const start = current;
+
+		while (current != end && *current >= '0' && *current <= '9')
+			++current;
+
+		return static_cast<std::size_t> (current - start);
+	}
+
+	[[nodiscard]] inline bool parseNumber (Node& result)
+	{
+		const auto* const start = current;
+
+		const auto negate = popIf ('-');
+
+		const auto* const digitsStart = current;
+		const auto		  numDigits	  = skipDigits();
+
+		if (numDigits == 0 || (numDigits > 1 && *digitsStart == '0'))
+			return fail ("Syntax error in number", start);
+
+		auto isInteger = true;
+
+		if (popIf ('.'))
+		{
+			isInteger = false;
+
+			if (skipDigits() == 0)
+				return fail ("Syntax error in number", start);
+		}
+
+		if (popIf ('e') || popIf ('E'))
+		{
+			isInteger = false;
+
+			if (! popIf ('+'))
+				popIf ('-');
+
+			if (skipDigits() == 0)
+				return fail ("Syntax error in number", start);
+		}
+
+		if (! isEOF() && ! simd::isJSONWhitespace (*current)
+			&& *current != ',' && *current != '}' && *current != ']')
+			return fail ("Syntax error in number", start);
+
+		// up to 15 digits always fit exactly in a double, so these can be accumulated directly
+		if (isInteger && numDigits <= 15)
+		{
+			std::int64_t value = 0;
+
+			for (const auto* p = digitsStart; p != current; ++p)
+				value = value * 10 + (*p - '0');
+
+			// the sign is applied to the double, so that -0 stays negative
+			const auto magnitude = static_cast<double> (value);
+
+			result = Node::createNumber (negate ? -magnitude : magnitude);
+			return true;
+		}
+
+		// strtod() needs a null-terminated string, and the input text isn't necessarily terminated after the number
+		const auto length = static_cast<std::size_t> (current - start);
+
+		char buffer[64];
+
+		std::string longNumber;
+
+		const char* numberText = buffer;
+
+		if (length < sizeof (buffer))
+		{
+			std::memcpy (buffer, start, length);
+			buffer[length] = 0;
+		}
+		else
+		{
+			longNumber.assign (start, length);
+			numberText = longNumber.c_str();
+		}
+
+		result = Node::createNumber (std::strtod (numberText, nullptr));
+		return true;
+	}
+
+	[[nodiscard]] inline bool parseString (std::string& result)
+	{
+		const auto* const stringStart = current;
+
+		for (;;)
+		{
+			const auto* const runStart = current;
+
+			auto sawNonASCII = false;
+
+			current = simd::findJSONStringSpecial (current, end, sawNonASCII);
+
+			if (sawNonASCII && ! utf8::isValid (runStart, current))
+				return fail ("Invalid UTF-8 in string constant", runStart);
+
+			result.append (runStart, current);
+
+			if (isEOF())
+				return fail ("Unexpected EOF in string constant", stringStart);
+
+			const auto c = *current++;
+
+			if (c == '"')
+				return true;
+
+			// raw control characters aren't allowed in strings
+			if (c != '\\')
+				return fail ("Unescaped control character in string constant", current - 1);
+
+			const auto* const escapeStart = current;
+
+			if (isEOF())
+				return fail ("Unexpected EOF in string constant", escapeStart);
+
+			switch (const auto escaped = *current++)
+			{
+				case '"' : [[fallthrough]];
+				case '\\' : [[fallthrough]];
+				case '/' : result += escaped; break;
+				case 'b' : result += '\b'; break;
+				case 'f' : result += '\f'; break;
+				case 'n' : result += '\n'; break;
+				case 'r' : result += '\r'; break;
+				case 't' : result += '\t'; break;
+				case 'u' :
+				{
+					std::uint32_t codepoint;
+
+					if (! parseUnicodeCharacterNumber (false, codepoint))
+						return false;
+
+					char utf8Bytes[4];
+
+					result.append (utf8Bytes, utf8::encode (utf8Bytes, codepoint));
+
+					break;
+				}
+				default : return fail ("Invalid escape sequence in string constant", escapeStart - 1);
+			}
+		}
+	}
+
+	[[nodiscard]] inline bool parseUnicodeCharacterNumber (bool isLowSurrogate, std::uint32_t& result)
+	{
+		result = 0;
+
+		for (auto i = 4; --i >= 0;)
+		{
+			if (isEOF())
+				return fail ("Syntax error in unicode character");
+
+			const auto digit = *current;
+
+			std::uint32_t value;
+
+			if (digit >= '0' && digit <= '9')
+				value = static_cast<std::uint32_t> (digit - '0');
+			else if (digit >= 'a' && digit <= 'f')
+				value = static_cast<std::uint32_t> (10 + (digit - 'a'));
+			else if (digit >= 'A' && digit <= 'F')
+				value = static_cast<std::uint32_t> (10 + (digit - 'A'));
+			else
+				return fail ("Syntax error in unicode character");
+
+			++current;
+
+			result = (result << 4) + value;
+		}
+
+		if (isLowSurrogate != utf8::isLowSurrogate (result))
+			return fail (isLowSurrogate ? "Expected a unicode low surrogate codepoint" : "Unexpected unicode low surrogate codepoint");
+
+		if (utf8::isHighSurrogate (result))
+		{
+			std::uint32_t lowSurrogate = 0;
+
+			if (isLowSurrogate || ! popIf ("\\u"))
+				return fail ("Expected a unicode low surrogate codepoint");
+
+			if (! parseUnicodeCharacterNumber (true, lowSurrogate))
+				return false;
+
+			result = utf8::combineSurrogates (result, lowSurrogate);
+		}
+
+		return true;
+	}
+
+	// records the error and returns false, so that callers can write "return fail (...);"
+	[[nodiscard]] inline bool fail (std::string_view message)
 	{
-		return formats::JSON;
+		return fail (message, current);
 	}
 
-	bool supportsComments() const noexcept final
+	[[nodiscard]] inline bool fail (std::string_view message, const char* position)
 	{
+		errorMessage = message;
+		errorPos	 = position;
 		return false;
 	}
 
-	const std::vector<std::string_view>& getFileExtensions() const noexcept final
-	{
-		struct ExtensionsHolder final
+	std::string_view source;
+
+	const char*		  current;
+	const char* const end;
+
+	std::string_view errorMessage;
+	const char*		 errorPos { nullptr };
+};
+
+Node JSONFormat::parse (std::string_view string) const
+{
+	return tryParse (string).getNode();
+}
+
+ParseResult JSONFormat::tryParse (std::string_view string) const
+{
+	JSONParser p { string };
+
+	if (Node result; p.parse (result))
+		return result;
+
+	return p.getError();
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// below this many bytes of input per thread, the cost of starting the threads outweighs the gains
+static constexpr auto minBytesPerParserThread = std::size_t { 64 } * 1024;
+
+// Splits the body of a top-level array (the text following the opening '[') into at most numSlices
+// slices of roughly equal size, each containing one or more whole elements. Only strings and bracket
+// nesting are tracked, so nothing is validated here -- the elements in each slice are parsed properly
+// afterwards. Returns false if the closing ']' couldn't be found, in which case the caller should fall
+// back to a sequential parse, which will report the error properly.
+static inline bool splitTopLevelArray (std::string_view body, std::size_t numSlices, std::vector<std::string_view>& slices)
+{
+	const auto* const end = body.data() + body.size();
+
+	const auto targetSliceSize = body.size() / numSlices;
+
+	const auto* sliceStart = body.data();
+
+	std::size_t depth = 0;
+
+	for (const auto* p = body.data(); p < end; ++p)
+	{
+		switch (*p)
+		{
+			case '"' :
+			{
+				for (++p;; ++p)
+				{
+					if (p >= end)
+						return false;
+
+					if (*p == '\\')
+					{
+						++p;
+						continue;
+					}
+
+					if (*p == '"')
+						break;
+				}
+
+				break;
+			}
+
+			case '[' : [[fallthrough]];
+			case '{' :
+			{
+				++depth;
+				break;
+			}
+
+			case ']' : [[fallthrough]];
+			case '}' :
+			{
+				if (depth == 0)
+				{
+					if (*p != ']')
+						return false;
+
+					slices.emplace_back (sliceStart, static_cast<std::size_t> (p - sliceStart));
+					return true;
+				}
+
+				--depth;
+				break;
+			}
+
+			case ',' :
+			{
+				if (depth == 0
+					&& static_cast<std::size_t> (p - sliceStart) >= targetSliceSize
+					&& slices.size() + 1 < numSlices)
+				{
+					slices.emplace_back (sliceStart, static_cast<std::size_t> (p - sliceStart));
+					sliceStart = p + 1;
+				}
+
+				break;
+			}
+
+			default : break;
+		}
+	}
+
+	return false;
+}
+
+Node JSONFormat::parseParallel (std::string_view string, std::size_t numThreads) const
+{
+	if (numThreads == 0)
+		numThreads = std::thread::hardware_concurrency();
+
+	numThreads = std::min (numThreads, string.size() / minBytesPerParserThread);
+
+	if (numThreads < 2)
+		return parse (string);
+
+	const auto arrayStart = std::find_if_not (string.begin(), string.end(), simd::isJSONWhitespace);
+
+	if (arrayStart == string.end() || *arrayStart != '[')
+		return parse (string);
+
+	const auto body = string.substr (static_cast<std::size_t> (std::distance (string.begin(), arrayStart)) + 1);
+
+	std::vector<std::string_view> slices;
+
+	slices.reserve (numThreads);
+
+	if (! splitTopLevelArray (body, numThreads, slices) || slices.size() < 2)
+		return parse (string);
+
+	// anything but whitespace after the closing ']' is an error, which parse() will report
+	const auto afterArray = static_cast<std::size_t> (slices.back().data() + slices.back().size() + 1 - string.data());
+
+	if (std::find_if_not (string.begin() + afterArray, string.end(), simd::isJSONWhitespace) != string.end())
+		return parse (string);
+
+	std::vector<Array>				results (slices.size());
+	std::vector<std::exception_ptr> errors (slices.size());
+
+	auto parseSlice = [&string, &slices, &results, &errors] (std::size_t idx)
+	{
+		try
+		{
+			JSONParser p { string, slices[idx] };
+
+			if (! p.parseArrayElements (results[idx]))
+				errors[idx] = std::make_exception_ptr (p.getError());
+		}
+		catch (...)
+		{
+			errors[idx] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	threads.reserve (slices.size() - 1);
+
+	for (auto i = 1UL; i < slices.size(); ++i)
+	{
+		try
+		{
+			threads.emplace_back (parseSlice, i);
+		}
+		catch (const std::system_error&)
+		{
+			// couldn't start a thread, so just do this slice's work on this thread instead
+			parseSlice (i);
+		}
+	}
+
+	parseSlice (0);
+
+	for (auto& thread : threads)
+		thread.join();
+
+	// the slices are in input order, so this rethrows the error closest to the start of the input
+	for (const auto& error : errors)
+		if (error != nullptr)
+			std::rethrow_exception (error);
+
+	std::size_t totalSize = 0;
+
+	for (const auto& slice : results)
+		totalSize += slice.size();  // cppcheck-suppress useStlAlgorithm
+
+	auto result = Node { ObjectType::Array };
+
+	auto& array = result.getArray();
+
+	array = std::move (results[0]);
+
+	array.reserve (totalSize);
+
+	for (auto i = 1UL; i < results.size(); ++i)
+		array.insert (array.end(),
+					  std::make_move_iterator (results[i].begin()),
+					  std::make_move_iterator (results[i].end()));
+
+	return result;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// Checks the JSON grammar without building any Nodes. Nesting is tracked iteratively with a stack
+// of bits (1 for an object, 0 for an array), so there is no recursion, and nothing is allocated for
+// it unless the document is nested more deeply than the inline bit stack. The keys of each open object
+// are kept as hashes and views into the input, and are checked for duplicates when the object closes.
+class LSERIAL_NO_EXPORT JSONValidator final
+{
+public:
+	JSONValidator (std::string_view inputText, const JSONValidationLimits& validationLimits) noexcept
+		: start (inputText.data()), p (inputText.data()), end (inputText.data() + inputText.size()), limits (validationLimits)
+	{
+	}
+
+	[[nodiscard]] bool validate() noexcept
+	{
+		if (static_cast<std::size_t> (end - p) > limits.maxSize)
+			return false;
+
+		try
+		{
+			return scanDocument();
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+
+private:
+	static constexpr std::size_t numInlineBits = 512;
+
+	// a key of an open object, which is either in the input or, if it contained escapes, decoded into keyStorage
+	struct Key final
+	{
+		std::size_t hash, offset, size;
+		bool		isDecoded;
+	};
+
+	[[nodiscard]] bool scanDocument()
+	{
+		skipWhitespace();
+
+		if (p == end || (*p != '[' && *p != '{'))
+			return false;
+
+		for (;;)
+		{
+			// a value is expected here
+			skipWhitespace();
+
+			if (p == end)
+				return false;
+
+			if (const auto c = *p; c == '[' || c == '{')
+			{
+				const auto isObject = c == '{';
+
+				if (! push (isObject))
+					return false;
+
+				++p;
+
+				skipWhitespace();
+
+				if (p != end && *p == (isObject ? '}' : ']'))
+				{
+					++p;
+					--depth;
+				}
+				else
+				{
+					if (isObject)
+					{
+						openObjects.push_back ({ keys.size(), keyStorage.size() });
+
+						if (! scanKey())
+							return false;
+					}
+
+					continue;
+				}
+			}
+			else if (! scanScalar())
+			{
+				return false;
+			}
+
+			// a value has just ended, so close any containers that end here and then find the start of the next value
+			for (;;)
+			{
+				skipWhitespace();
+
+				if (depth == 0)
+					return p == end;
+
+				if (p == end)
+					return false;
+
+				const auto inObject = isObjectAtTop();
+
+				if (*p == ',')
+				{
+					++p;
+
+					if (inObject && ! scanKey())
+						return false;
+
+					break;
+				}
+
+				if (*p != (inObject ? '}' : ']'))
+					return false;
+
+				if (inObject && ! closeObject())
+					return false;
+
+				++p;
+				--depth;
+			}
+		}
+	}
+
+	[[nodiscard]] inline bool push (bool isObject)
+	{
+		if (depth >= limits.maxDepth)
+			return false;
+
+		// the heap part of the stack grows a word at a time, as the document gets deeper
+		if (depth >= numInlineBits && (depth - numInlineBits) / 64 == heapBits.size())
+			heapBits.push_back (0);
+
+		auto& word = wordFor (depth);
+
+		const auto mask = std::uint64_t { 1 } << (depth % 64);
+
+		word = isObject ? (word | mask) : (word & ~mask);
+
+		++depth;
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool isObjectAtTop() noexcept
+	{
+		return ((wordFor (depth - 1) >> ((depth - 1) % 64)) & 1) != 0;
+	}
+
+	[[nodiscard]] inline std::uint64_t& wordFor (std::size_t level) noexcept
+	{
+		if (level < numInlineBits)
+			return inlineBits[level / 64];
+
+		return heapBits[(level - numInlineBits) / 64];
+	}
+
+	inline void skipWhitespace() noexcept
+	{
+		p = simd::skipJSONWhitespace (p, end);
+	}
+
+	// expects the next token to be a non-empty string followed by a ':', and records it as a key of the innermost object
+	[[nodiscard]] inline bool scanKey()
+	{
+		skipWhitespace();
+
+		if (p == end || *p != '"')
+			return false;
+
+		const auto* const keyStart = p;
+
+		sawEscape = false;
+
+		if (! scanString())
+			return false;
+
+		// escapes can't produce an empty string, so only "" is empty
+		if (p - keyStart == 2)
+			return false;
+
+		if (sawEscape)
+		{
+			// the escapes need to be decoded, because different escapes can spell the same key
+			const auto offset = keyStorage.size();
+
+			p = keyStart;
+
+			if (! scanString (&keyStorage))
+				return false;
+
+			const auto size = keyStorage.size() - offset;
+
+			keys.push_back ({ std::hash<std::string_view> {}(std::string_view { keyStorage.data() + offset, size }),
+							  offset, size, true });
+		}
+		else
+		{
+			const auto key = std::string_view { keyStart + 1, static_cast<std::size_t> (p - keyStart - 2) };
+
+			keys.push_back ({ std::hash<std::string_view> {}(key), static_cast<std::size_t> (key.data() - start), key.size(), false });
+		}
+
+		skipWhitespace();
+
+		if (p == end || *p != ':')
+			return false;
+
+		++p;
+		return true;
+	}
+
+	[[nodiscard]] std::string_view keyText (const Key& key) const noexcept
+	{
+		return { (key.isDecoded ? keyStorage.data() : start) + key.offset, key.size };
+	}
+
+	// checks that the innermost object's keys are unique, and then forgets them
+	[[nodiscard]] bool closeObject()
+	{
+		const auto [firstKey, storageSize] = openObjects.back();
+
+		openObjects.pop_back();
+
+		const auto begin = keys.begin() + static_cast<std::ptrdiff_t> (firstKey);
+
+		std::sort (begin, keys.end(), [] (const Key& a, const Key& b) { return a.hash < b.hash; });
+
+		for (auto it = begin; it != keys.end(); ++it)
+			for (auto other = std::next (it); other != keys.end() && other->hash == it->hash; ++other)
+				if (keyText (*it) == keyText (*other))
+					return false;
+
+		keys.erase (begin, keys.end());
+		keyStorage.resize (storageSize);
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool scanScalar() noexcept
+	{
+		switch (*p)
+		{
+			case '"' : return scanString();
+			case 't' : return scanLiteral ("true");
+			case 'f' : return scanLiteral ("false");
+			case 'n' : return scanLiteral ("null");
+			default : return scanNumber();
+		}
+	}
+
+	[[nodiscard]] inline bool scanLiteral (std::string_view literal) noexcept
+	{
+		if (static_cast<std::size_t> (end - p) < literal.size()
+			|| std::memcmp (p, literal.data(), literal.size()) != 0)
+			return false;
+
+		p += literal.size();
+		return true;
+	}
+
+	[[nodiscard]] inline bool scanDigits() noexcept
+	{
+		const auto* const start = p;
+
+		while (p != end && *p >= '0' && *p <= '9')
+			++p;
+
+		return p != start;
+	}
+
+	[[nodiscard]] inline bool scanNumber() noexcept
+	{
+		if (*p == '-')
+			++p;
+
+		if (p == end)
+			return false;
+
+		// no leading zeroes are allowed
+		if (*p == '0')
+			++p;
+		else if (! scanDigits())
+			return false;
+
+		if (p != end && *p == '.')
+		{
+			++p;
+
+			if (! scanDigits())
+				return false;
+		}
+
+		if (p != end && (*p == 'e' || *p == 'E'))
+		{
+			++p;
+
+			if (p != end && (*p == '+' || *p == '-'))
+				++p;
+
+			if (! scanDigits())
+				return false;
+		}
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool scanHexEscape (std::uint32_t& result) noexcept
+	{
+		if (end - p < 4)
+			return false;
+
+		result = 0;
+
+		for (auto i = 0; i < 4; ++i, ++p)
+		{
+			const auto c = *p;
+
+			result <<= 4;
+
+			if (c >= '0' && c <= '9')
+				result |= static_cast<std::uint32_t> (c - '0');
+			else if (c >= 'a' && c <= 'f')
+				result |= static_cast<std::uint32_t> (c - 'a' + 10);
+			else if (c >= 'A' && c <= 'F')
+				result |= static_cast<std::uint32_t> (c - 'A' + 10);
+			else
+				return false;
+		}
+
+		return true;
+	}
+
+	// expects p to point to the opening quote. If decoded isn't null, the string's decoded text is appended to it
+	[[nodiscard]] inline bool scanString (std::string* decoded = nullptr)
+	{
+		const auto* runStart = ++p;
+
+		for (;;)
+		{
+			auto sawNonASCII = false;
+
+			p = simd::findJSONStringSpecial (p, end, sawNonASCII);
+
+			if (p == end)
+				return false;
+
+			// the UTF-8 is only decoded for runs of text that contain non-ASCII characters
+			if (sawNonASCII && ! utf8::isValid (runStart, p))
+				return false;
+
+			if (decoded != nullptr)
+				decoded->append (runStart, p);
+
+			if (*p == '"')
+			{
+				++p;
+				return true;
+			}
+
+			// raw control characters aren't allowed in strings
+			if (*p != '\\')
+				return false;
+
+			if (++p == end)
+				return false;
+
+			sawEscape = true;
+
+			auto escaped = *p++;
+
+			switch (escaped)
+			{
+				case 'b' : escaped = '\b'; break;
+				case 'f' : escaped = '\f'; break;
+				case 'n' : escaped = '\n'; break;
+				case 'r' : escaped = '\r'; break;
+				case 't' : escaped = '\t'; break;
+				case '"' :
+				case '\\' :
+				case '/' : break;
+
+				case 'u' :
+				{
+					std::uint32_t codepoint;
+
+					if (! scanHexEscape (codepoint) || utf8::isLowSurrogate (codepoint))
+						return false;
+
+					if (utf8::isHighSurrogate (codepoint))
+					{
+						if (end - p < 2 || p[0] != '\\' || p[1] != 'u')
+							return false;
+
+						p += 2;
+
+						std::uint32_t lowSurrogate;
+
+						if (! scanHexEscape (lowSurrogate) || ! utf8::isLowSurrogate (lowSurrogate))
+							return false;
+
+						codepoint = utf8::combineSurrogates (codepoint, lowSurrogate);
+					}
+
+					if (decoded != nullptr)
+					{
+						char utf8Bytes[4];
+
+						decoded->append (utf8Bytes, utf8::encode (utf8Bytes, codepoint));
+					}
+
+					runStart = p;
+					continue;
+				}
+
+				default : return false;
+			}
+
+			if (decoded != nullptr)
+				decoded->push_back (escaped);
+
+			runStart = p;
+		}
+	}
+
+	const char* const		   start;
+	const char*				   p;
+	const char* const		   end;
+	const JSONValidationLimits& limits;
+
+	std::size_t				   depth { 0 };
+	std::uint64_t			   inlineBits[numInlineBits / 64] {};
+	std::vector<std::uint64_t> heapBits;
+
+	// for each open object that has keys, the index of its first key and the size of keyStorage when it opened
+	std::vector<std::pair<std::size_t, std::size_t>> openObjects;
+
+	std::vector<Key> keys;
+	std::string		 keyStorage;
+
+	bool sawEscape { false };
+};
+
+bool JSONFormat::validate (std::string_view string, const JSONValidationLimits& limits) const noexcept
+{
+	JSONValidator v { string, limits };
+
+	return v.validate();
+}
+
+bool JSONFormat::probablyMatchesString (std::string_view string) const noexcept
+{
+	return validate (string);
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// Returns a codepoint's position in UTF-16 code unit order, which canonical JSON uses for sorting keys.
+// Codepoints from U+E000 to U+FFFF are single code units that sort after every surrogate pair, so they
+// are moved above the supplementary planes; everything else keeps its codepoint order.
+static constexpr std::uint32_t utf16SortKey (std::uint32_t codepoint) noexcept
+{
+	if (codepoint < 0xE000)
+		return codepoint;
+
+	if (codepoint < 0x10000)
+		return codepoint + 0x100000;
+
+	return codepoint - 0x2000;
+}
+
+static bool isLessInUTF16Order (std::string_view lhs, std::string_view rhs) noexcept
+{
+	const auto* l			   = lhs.data();
+	const auto* r			   = rhs.data();
+	const auto* const lhsEnd = l + lhs.size();
+	const auto* const rhsEnd = r + rhs.size();
+
+	while (l != lhsEnd && r != rhsEnd)
+	{
+		const auto lhsKey = utf16SortKey (utf8::decode (l, lhsEnd));
+		const auto rhsKey = utf16SortKey (utf8::decode (r, rhsEnd));
+
+		if (lhsKey != rhsKey)
+			return lhsKey < rhsKey;
+	}
+
+	return l == lhsEnd && r != rhsEnd;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+class LSERIAL_NO_EXPORT JSONPrinter final : public StaticPrinter<JSONPrinter>
+{
+	friend class StaticPrinter<JSONPrinter>;
+
+public:
+	explicit JSONPrinter (const JSONPrinterOptions& printerOptions) noexcept
+		: options (printerOptions)
+	{
+	}
+
+	// Prints a run of array elements or object members, separated by commas, without the
+	// enclosing brackets. JSONFormat::serializeParallel() uses this to print each thread's
+	// share of a container.
+	template <typename Iterator>
+	void printElements (Iterator first, Iterator last, OutputSink& sink)
+	{
+		for (auto element = first; element != last; ++element)
+		{
+			if (element != first)
+				sink.write (getSeparator());
+
+			printElement (*element, sink);
+		}
+	}
+
+	// Writes the escaped contents of a string, without the quotes. The chunked printer uses this
+	// to print long strings a piece at a time.
+	void printStringContents (std::string_view string, OutputSink& sink)
+	{
+		if (options.escapeNonASCII && ! options.canonical)
+			writeEscapedASCII (string, sink);
+		else
+			writeEscapedUTF8 (string, sink);
+	}
+
+	[[nodiscard]] bool isCanonical() const noexcept
+	{
+		return options.canonical;
+	}
+
+	[[nodiscard]] std::string_view getSeparator() const noexcept
+	{
+		return options.canonical ? "," : ", ";
+	}
+
+	[[nodiscard]] std::string_view getOpeningBracket (bool isArray) const noexcept
+	{
+		if (options.canonical)
+			return isArray ? "[" : "{";
+
+		return isArray ? "[ " : "{ ";
+	}
+
+	[[nodiscard]] std::string_view getClosingBracket (bool isArray) const noexcept
+	{
+		if (options.canonical)
+			return isArray ? "]" : "}";
+
+		return isArray ? " ]" : " }";
+	}
+
+	// std::map sorts the keys by their UTF-8 bytes, which matches UTF-16 order unless some keys
+	// contain characters from U+E000 upwards
+	[[nodiscard]] static bool keysAreInUTF16Order (const Object& object) noexcept
+	{
+		const auto needsChecking = std::any_of (object.begin(), object.end(), [] (const auto& member)
+												{ return std::any_of (member.first.begin(), member.first.end(), [] (char c)
+																	  { return static_cast<unsigned char> (c) >= 0xEE; }); });
+
+		if (! needsChecking)
+			return true;
+
+		return std::is_sorted (object.begin(), object.end(), [] (const auto& lhs, const auto& rhs)
+							   { return isLessInUTF16Order (lhs.first, rhs.first); });
+	}
+
+private:
+	void printNull (OutputSink& sink) final
+	{
+		sink.write ("null");
+	}
+
+	void printNumber (double number, OutputSink& sink) final
+	{
+		if (options.canonical)
+		{
+			writeCanonicalNumber (number, sink);
+			return;
+		}
+
+		if (std::isfinite (number))
+		{
+			// the shortest representation that reads back as the same double
+			char buffer[32];
+
+			const auto result = std::to_chars (std::begin (buffer), std::end (buffer), number);
+
+			sink.write (std::string_view { buffer, static_cast<std::size_t> (result.ptr - buffer) });
+			return;
+		}
+
+		if (std::isnan (number))
+			sink.write ("\"NaN\"");
+		else if (number >= 0)
+			sink.write ("\"Infinity\"");
+		else
+			sink.write ("\"-Infinity\"");
+	}
+
+	void printString (std::string_view string, OutputSink& sink) final
+	{
+		sink.write ('"');
+		printStringContents (string, sink);
+		sink.write ('"');
+	}
+
+	void printBoolean (bool boolean, OutputSink& sink) final
+	{
+		if (boolean)
+			sink.write ("true");
+		else
+			sink.write ("false");
+	}
+
+	void printArray (const Array& array, OutputSink& sink) final
+	{
+		if (array.empty())
+		{
+			sink.write ("[]");
+			return;
+		}
+
+		sink.write (getOpeningBracket (true));
+		printElements (array.begin(), array.end(), sink);
+		sink.write (getClosingBracket (true));
+	}
+
+	void printObject (const Object& object, OutputSink& sink) final
+	{
+		if (object.empty())
+		{
+			sink.write ("{}");
+			return;
+		}
+
+		sink.write (getOpeningBracket (false));
+
+		if (options.canonical && ! keysAreInUTF16Order (object))
+		{
+			std::vector<const Object::value_type*> members;
+
+			members.reserve (object.size());
+
+			for (const auto& member : object)
+				members.push_back (&member);
+
+			std::sort (members.begin(), members.end(), [] (const auto* lhs, const auto* rhs)
+					   { return isLessInUTF16Order (lhs->first, rhs->first); });
+
+			printElements (members.begin(), members.end(), sink);
+		}
+		else
+		{
+			printElements (object.begin(), object.end(), sink);
+		}
+
+		sink.write (getClosingBracket (false));
+	}
+
+	void printElement (const Node& element, OutputSink& sink)
+	{
+		print (element, sink);
+	}
+
+	void printElement (const Object::value_type& member, OutputSink& sink)
+	{
+		printString (member.first, sink);
+		sink.write (':');
+		print (member.second, sink);
+	}
+
+	void printElement (const Object::value_type* member, OutputSink& sink)
+	{
+		printElement (*member, sink);
+	}
+
+	// Writes the number as ECMAScript's Number.prototype.toString() would, which is what RFC 8785
+	// requires: the shortest digits that round-trip, in plain notation for decimal exponents from
+	// -6 to 20, and in exponential notation (with an explicit sign and no leading zeros) otherwise.
+	static void writeCanonicalNumber (double number, OutputSink& sink)
+	{
+		if (! std::isfinite (number))
+			throw std::runtime_error { "Canonical JSON can't represent NaN or infinite numbers" };
+
+		// this also catches -0, which is written as 0
+		if (number == 0)
+		{
+			sink.write ('0');
+			return;
+		}
+
+		// scientific notation gives the shortest digits as d.ddde[+-]xx
+		char scientific[32];
+
+		const auto* const scientificEnd = std::to_chars (std::begin (scientific), std::end (scientific),
+														 number, std::chars_format::scientific)
+											  .ptr;
+
+		const auto* p = scientific;
+
+		char output[48];
+		auto numChars = 0UL;
+
+		if (*p == '-')
+		{
+			output[numChars++] = '-';
+			++p;
+		}
+
+		char digits[20];
+		auto numDigits = 0;
+
+		for (; *p != 'e'; ++p)
+			if (*p != '.')
+				digits[numDigits++] = *p;
+
+		++p;
+
+		const auto exponentIsNegative = *p++ == '-';
+
+		auto exponent = 0;
+
+		std::from_chars (p, scientificEnd, exponent);
+
+		if (exponentIsNegative)
+			exponent = -exponent;
+
+		// the position of the decimal point relative to the start of the digits
+		const auto pointPosition = exponent + 1;
+
+		auto append = [&output, &numChars] (const char* chars, int count)
+		{
+			std::memcpy (output + numChars, chars, static_cast<std::size_t> (count));
+			numChars += static_cast<std::size_t> (count);
+		};
+
+		auto appendZeros = [&output, &numChars] (int count)
+		{
+			std::memset (output + numChars, '0', static_cast<std::size_t> (count));
+			numChars += static_cast<std::size_t> (count);
+		};
+
+		if (numDigits <= pointPosition && pointPosition <= 21)
+		{
+			append (digits, numDigits);
+			appendZeros (pointPosition - numDigits);
+		}
+		else if (0 < pointPosition && pointPosition <= 21)
+		{
+			append (digits, pointPosition);
+			output[numChars++] = '.';
+			append (digits + pointPosition, numDigits - pointPosition);
+		}
+		else if (-6 < pointPosition && pointPosition <= 0)
+		{
+			append ("0.", 2);
+			appendZeros (-pointPosition);
+			append (digits, numDigits);
+		}
+		else
 		{
-			std::vector<std::string_view> xtns;
+			output[numChars++] = digits[0];
 
-			ExtensionsHolder()
+			if (numDigits > 1)
 			{
-				xtns.emplace_back (".json");
+				output[numChars++] = '.';
+				append (digits + 1, numDigits - 1);
 			}
-		};
-
-		static const ExtensionsHolder holder;
 
-		return holder.xtns;
-	}
+			output[numChars++] = 'e';
+			output[numChars++] = exponent < 0 ? '-' : '+';
 
-	[[nodiscard]] Node parse (std::string_view string) const final;
+			numChars = static_cast<std::size_t> (std::to_chars (output + numChars, std::end (output),
+																exponent < 0 ? -exponent : exponent)
+													 .ptr
+												 - output);
+		}
 
-	[[nodiscard]] std::unique_ptr<Printer> createPrinter (bool shouldPrettyPrint) const noexcept final;
+		sink.write (std::string_view { output, numChars });
+	}
 
-	[[nodiscard]] std::unique_ptr<Schema> createSchemaFrom (const Node& data) const noexcept final;
-};
+	// writes a \uXXXX escape into out, and returns the number of characters written
+	static std::size_t writeUnicodeEscape (char* out, std::uint32_t codepoint) noexcept
+	{
+		auto hexDigit = [] (auto value) -> char
+		{ return "0123456789abcdef"[value & 15]; };
 
-LSERIAL_NO_EXPORT static const KnownFormats::Register<JSONFormat, true> json_init;
+		out[0] = '\\';
+		out[1] = 'u';
+		out[2] = hexDigit (codepoint >> 12);
+		out[3] = hexDigit (codepoint >> 8);
+		out[4] = hexDigit (codepoint >> 4);
+		out[5] = hexDigit (codepoint);
 
-/*-----------------------------------------------------------------------------------------------------------------------*/
+		return 6;
+	}
 
-Node JSONFormat::parse (std::string_view string) const
-{
-	struct Parser final
+	// writes the escape sequence for a quote, backslash or control character into out, and
+	// returns the number of characters written
+	static std::size_t writeASCIIEscape (char* out, char c) noexcept
 	{
-	public:
-		explicit Parser (std::string_view inputText)
-			: source (inputText), current (inputText)
+		auto shortEscape = [out] (char escaped)
 		{
-		}
+			out[0] = '\\';
+			out[1] = escaped;
+			return std::size_t { 2 };
+		};
 
-		inline Node parse()
+		switch (c)
 		{
-			skipWhitespace();
-
-			if (popIf ('['))
-				return parseArray();
-
-			if (popIf ('{'))
-				return parseObject();
+			case '\"' : return shortEscape ('"');
+			case '\\' : return shortEscape ('\\');
+			case '\n' : return shortEscape ('n');
+			case '\r' : return shortEscape ('r');
+			case '\t' : return shortEscape ('t');
+			case '\b' : return shortEscape ('b');
+			case '\f' : return shortEscape ('f');
+			default : return writeUnicodeEscape (out, static_cast<unsigned char> (c));
+		}
+	}
 
-			if (! isEOF())
-				throwError ("Expected an object or array");
+	static void writeRun (const char* start, const char* end, OutputSink& sink)
+	{
+		if (end != start)
+			sink.write (std::string_view { start, static_cast<std::size_t> (end - start) });
+	}
 
-			return Node::createNull();
-		}
+	// Writes a run of text taken directly from the Node being printed, which the sink may reference
+	// instead of copying; see OutputSink::writeReferenced().
+	static void writeStringRun (const char* start, const char* end, OutputSink& sink)
+	{
+		if (end != start)
+			sink.writeReferenced (std::string_view { start, static_cast<std::size_t> (end - start) });
+	}
 
-	private:
-		inline void skipWhitespace()
+	// Escaped characters tend to come in clusters (runs of non-ASCII text, or CRLF pairs), so
+	// consecutive escapes are collected here and written to the sink together.
+	class EscapeBuffer final
+	{
+	public:
+		explicit EscapeBuffer (OutputSink& outputSink) noexcept
+			: sink (outputSink)
 		{
-			for (auto p = current;
-				 std::isspace (static_cast<unsigned char> (p.popFirstChar()));
-				 current = p)
-				;
 		}
 
-		inline bool popIf (char c)
-		{
-			return current.skipIfStartsWith (c);
-		}
+		EscapeBuffer (const EscapeBuffer&)			  = delete;
+		EscapeBuffer& operator= (const EscapeBuffer&) = delete;
 
-		inline bool popIf (const char* c)
+		// returns space for at least 12 more characters, the length of a surrogate pair
+		[[nodiscard]] char* reserve()
 		{
-			return current.skipIfStartsWith (c);
+			if (used + 12 > sizeof (buffer))
+				flush();
+
+			return buffer + used;
 		}
 
-		inline std::uint32_t pop()
+		void commit (std::size_t numChars) noexcept
 		{
-			return current.popFirstChar();
+			used += numChars;
 		}
 
-		inline bool isEOF()
+		void flush()
 		{
-			return current.empty();
+			writeRun (buffer, buffer + used, sink);
+			used = 0;
 		}
 
-		inline Node parseArray()
-		{
-			const auto arrayStart = current;
+	private:
+		OutputSink& sink;
+		char		buffer[128];
+		std::size_t used { 0 };
+	};
 
-			auto result = Node { ObjectType::Array };
+	// clean runs of printable ASCII are found 16 bytes at a time and copied through in bulk;
+	// everything else is escaped, with non-ASCII characters written as \u escapes (using
+	// surrogate pairs above U+FFFF)
+	static void writeEscapedASCII (std::string_view string, OutputSink& sink)
+	{
+		const auto* p		  = string.data();
+		const auto* const end = p + string.size();
 
-			skipWhitespace();
+		EscapeBuffer escapes { sink };
 
-			if (popIf (']'))
-				return result;
+		for (;;)
+		{
+			const auto* const runStart = p;
 
-			for (;;)
+			p = simd::findJSONEscapeASCII (p, end);
+
+			if (p != runStart)
 			{
-				skipWhitespace();
+				escapes.flush();
+				writeStringRun (runStart, p, sink);
+			}
 
-				if (isEOF())
-					throwError ("Unexpected EOF in array declaration", arrayStart);
+			if (p == end)
+			{
+				escapes.flush();
+				return;
+			}
 
-				result.getArray().push_back (parseValue());
+			auto* const out = escapes.reserve();
 
-				skipWhitespace();
+			if (static_cast<unsigned char> (*p) < 0x80)
+			{
+				escapes.commit (writeASCIIEscape (out, *p++));
+				continue;
+			}
 
-				if (popIf (','))
-					continue;
+			const auto codepoint = utf8::decode (p, end);
 
-				if (popIf (']'))
-					break;
+			if (codepoint >= 0x10000)
+			{
+				const auto offset = codepoint - 0x10000;
 
-				throwError ("Expected ',' or ']'");
+				const auto numChars = writeUnicodeEscape (out, 0xD800 + (offset >> 10));
+				escapes.commit (numChars + writeUnicodeEscape (out + numChars, 0xDC00 + (offset & 0x3FF)));
+			}
+			else
+			{
+				escapes.commit (writeUnicodeEscape (out, codepoint));
 			}
-
-			return result;
 		}
+	}
 
-		inline Node parseObject()
-		{
-			const auto objectStart = current;
+	// UTF-8 is copied through unchanged, so only quotes, backslashes and control characters
+	// need escaping. Runs containing non-ASCII bytes are validated before they're copied.
+	static void writeEscapedUTF8 (std::string_view string, OutputSink& sink)
+	{
+		const auto* p		  = string.data();
+		const auto* const end = p + string.size();
 
-			auto result = Node { ObjectType::Object };
+		EscapeBuffer escapes { sink };
 
-			skipWhitespace();
+		for (;;)
+		{
+			const auto* const runStart = p;
 
-			if (popIf ('}'))
-				return result;
+			auto sawNonASCII = false;
 
-			for (;;)
+			p = simd::findJSONStringSpecial (p, end, sawNonASCII);
+
+			if (p != runStart)
 			{
-				skipWhitespace();
+				escapes.flush();
 
-				if (isEOF())
-					throwError ("Unexpected EOF in object declaration", objectStart);
+				if (sawNonASCII && ! utf8::isValid (runStart, p))
+					writeWithReplacementCharacters (runStart, p, sink);
+				else
+					writeStringRun (runStart, p, sink);
+			}
 
-				if (! popIf ('"'))
-					throwError ("Expected a name");
+			if (p == end)
+			{
+				escapes.flush();
+				return;
+			}
 
-				const auto errorPos = current;
-				const auto name		= parseString();
+			escapes.commit (writeASCIIEscape (escapes.reserve(), *p++));
+		}
+	}
 
-				if (name.empty())
-					throwError ("Property names cannot be empty", errorPos);
+	static void writeWithReplacementCharacters (const char* p, const char* end, OutputSink& sink)
+	{
+		while (p != end)
+		{
+			const auto* const charStart = p;
 
-				skipWhitespace();
+			if (utf8::decode (p, end) == 0xFFFD && ! utf8::isValid (charStart, p))
+				sink.write ("\xEF\xBF\xBD");
+			else
+				writeRun (charStart, p, sink);
+		}
+	}
 
-				if (! popIf (':'))
-					throwError ("Expected ':'");
+	const JSONPrinterOptions options;
+};
 
-				auto& obj = result.getObject();
+std::unique_ptr<Printer> JSONFormat::createPrinter ([[maybe_unused]] bool shouldPrettyPrint) const noexcept
+{
+	return std::make_unique<JSONPrinter> (JSONPrinterOptions {});
+}
 
-				if (obj.contains (name))
-					throwError ("Duplicate keys in same object", errorPos);
+std::unique_ptr<Printer> JSONFormat::createPrinter (const JSONPrinterOptions& options) const
+{
+	return std::make_unique<JSONPrinter> (options);
+}
 
-				obj.emplace (std::make_pair (name, parseValue()));
+/*-----------------------------------------------------------------------------------------------------------------------*/
 
-				skipWhitespace();
+// below this many children per thread, the cost of starting the threads outweighs the gains
+static constexpr auto minChildrenPerPrinterThread = std::size_t { 1024 };
 
-				if (popIf (','))
-					continue;
+// Divides the container's children into numSlices contiguous ranges with equal numbers of children,
+// prints each range into its own string on its own thread, and then writes the strings to the sink
+// in order, between the container's brackets.
+template <typename Container>
+static void printContainerInParallel (const Container& container, std::size_t numSlices,
+									  const JSONPrinterOptions& options, OutputSink& sink)
+{
+	constexpr auto isArray = std::is_same_v<Container, Array>;
 
-				if (popIf ('}'))
-					break;
+	const JSONPrinter formatting { options };
 
-				throwError ("Expected ',' or '}'");
-			}
+	const auto open		 = formatting.getOpeningBracket (isArray);
+	const auto close	 = formatting.getClosingBracket (isArray);
+	const auto separator = formatting.getSeparator();
 
-			return result;
-		}
+	std::vector<typename Container::const_iterator> bounds;
 
-		inline Node parseValue()
-		{
-			skipWhitespace();
+	bounds.reserve (numSlices + 1);
 
-			auto startPos = current;
+	const auto sliceSize = container.size() / numSlices;
+	const auto remainder = container.size() % numSlices;
 
-			switch (pop())
-			{
-				case '[' : return parseArray();
-				case '{' : return parseObject();
-				case '"' : return Node::createString (parseString());
-				case '-' :
-				{
-					skipWhitespace();
-					return parseNumber (true);
-				}
-				case '0' : [[fallthrough]];
-				case '1' : [[fallthrough]];
-				case '2' : [[fallthrough]];
-				case '3' : [[fallthrough]];
-				case '4' : [[fallthrough]];
-				case '5' : [[fallthrough]];
-				case '6' : [[fallthrough]];
-				case '7' : [[fallthrough]];
-				case '8' : [[fallthrough]];
-				case '9' :
-				{
-					current = startPos;
-					return parseNumber (false);
-				}
-				default : break;
-			}
+	auto element = container.begin();
 
-			current = startPos;
+	for (auto i = 0UL; i < numSlices; ++i)
+	{
+		bounds.push_back (element);
+		std::advance (element, static_cast<std::ptrdiff_t> (sliceSize + (i < remainder ? 1 : 0)));
+	}
 
-			if (popIf ("null"))
-				return Node::createNull();
+	bounds.push_back (container.end());
 
-			if (popIf ("true"))
-				return Node::createBoolean (true);
+	std::vector<std::string>		outputs (numSlices);
+	std::vector<std::exception_ptr> errors (numSlices);
 
-			if (popIf ("false"))
-				return Node::createBoolean (false);
+	auto printSlice = [&options, &bounds, &outputs, &errors] (std::size_t idx)
+	{
+		try
+		{
+			JSONPrinter printer { options };
+			StringSink	sliceSink { outputs[idx] };
 
-			throwError ("Syntax error");
+			printer.printElements (bounds[idx], bounds[idx + 1], sliceSink);
+		}
+		catch (...)
+		{
+			errors[idx] = std::current_exception();
 		}
+	};
 
-		inline Node parseNumber (bool negate)
+	std::vector<std::thread> threads;
+
+	threads.reserve (numSlices - 1);
+
+	for (auto i = 1UL; i < numSlices; ++i)
+	{
+		try
+		{
+			threads.emplace_back (printSlice, i);
+		}
+		catch (const std::system_error&)
 		{
-			auto startPos = current;
-			bool hadDot = false, hadExponent = false;
+			// couldn't start a thread, so just do this slice's work on this thread instead
+			printSlice (i);
+		}
+	}
 
-			for (;;)
-			{
-				const auto lastPos = current;
-				const auto c	   = pop();
+	printSlice (0);
 
-				if (c >= '0' && c <= '9')
-					continue;
+	for (auto& thread : threads)
+		thread.join();
 
-				if (c == '.' && ! hadDot)
-				{
-					hadDot = true;
-					continue;
-				}
+	for (const auto& error : errors)
+		if (error != nullptr)
+			std::rethrow_exception (error);
 
-				if (! hadExponent && (c == 'e' || c == 'E'))
-				{
-					hadDot		= true;
-					hadExponent = true;
-					continue;
-				}
+	auto totalSize = open.size() + close.size() + (numSlices - 1) * separator.size();
 
-				if (std::isspace (static_cast<int> (c)) != 0
-					|| c == ',' || c == '}' || c == ']' || c == 0)
-				{
-					current					= lastPos;
-					char* endOfParsedNumber = nullptr;
+	for (const auto& output : outputs)
+		totalSize += output.size();  // cppcheck-suppress useStlAlgorithm
 
-					if (! (hadDot || hadExponent))
-					{
-						const auto v = std::strtoll (startPos.data(), &endOfParsedNumber, 10);
+	sink.reserve (totalSize);
 
-						if (endOfParsedNumber == lastPos.data()
-							&& v != std::numeric_limits<decltype (v)>::max()
-							&& v != std::numeric_limits<decltype (v)>::min())
-							return Node::createNumber (static_cast<double> (negate ? -v : v));
-					}
+	sink.write (open);
 
-					if (endOfParsedNumber == lastPos.data())
-					{
-						const auto v = std::strtod (startPos.data(), &endOfParsedNumber);
+	for (auto i = 0UL; i < numSlices; ++i)
+	{
+		if (i > 0)
+			sink.write (separator);
 
-						return Node::createNumber (negate ? -v : v);
-					}
-				}
+		sink.write (outputs[i]);
 
-				throwError ("Syntax error in number", lastPos);
-			}
-		}
+		// free each slice's memory as soon as it has been copied
+		std::string {}.swap (outputs[i]);
+	}
 
-		inline std::string parseString()
-		{
-			std::stringstream s;
+	sink.write (close);
+}
 
-			for (;;)
-			{
-				auto c = pop();
+void JSONFormat::serializeParallel (const Node& node, OutputSink& sink, std::size_t numThreads, const JSONPrinterOptions& options) const
+{
+	if (numThreads == 0)
+		numThreads = std::thread::hardware_concurrency();
 
-				if (c == '"')
-					break;
+	const auto numChildren = node.isArray() || node.isObject() ? node.getNumChildren() : 0;
 
-				if (c == '\\')
-				{
-					const auto errorPos = current;
+	const auto numSlices = std::min (numThreads, numChildren / minChildrenPerPrinterThread);
 
-					c = pop();
+	// canonical output may need the keys in a different order than the map's, so that case isn't split up
+	if (numSlices < 2 || (options.canonical && node.isObject() && ! JSONPrinter::keysAreInUTF16Order (node.getObject())))
+	{
+		JSONPrinter { options }.print (node, sink);
+		return;
+	}
 
-					switch (c)
-					{
-						case 'a' : c = '\a'; break;
-						case 'b' : c = '\b'; break;
-						case 'f' : c = '\f'; break;
-						case 'n' : c = '\n'; break;
-						case 'r' : c = '\r'; break;
-						case 't' : c = '\t'; break;
-						case 'u' : c = parseUnicodeCharacterNumber (false); break;
-						case 0 : throwError ("Unexpected EOF in string constant", errorPos);
-						default : break;
-					}
-				}
+	if (node.isArray())
+		printContainerInParallel (node.getArray(), numSlices, options, sink);
+	else
+		printContainerInParallel (node.getObject(), numSlices, options, sink);
+}
+
+std::string JSONFormat::serializeParallel (const Node& node, std::size_t numThreads, const JSONPrinterOptions& options) const
+{
+	StringSink sink;
 
-				char utf8Bytes[8];
+	serializeParallel (node, sink, numThreads, options);
 
-				const auto numBytes = text::utf8::fromUnicode (utf8Bytes, c);
+	return std::move (sink.getString());
+}
 
-				for (std::uint32_t i = 0; i < numBytes; ++i)
-					s << utf8Bytes[i];
-			}
+/*-----------------------------------------------------------------------------------------------------------------------*/
 
-			return s.str();
-		}
+// Prints a tree of Nodes as a series of small steps -- a piece of punctuation, a scalar, or a slice of
+// a string -- with an explicit stack instead of recursion, so that printing can stop after any step and
+// carry on later. Each step's output is bounded, so the output that doesn't fit in the caller's buffer
+// (the spill) is never more than a few kilobytes.
+class LSERIAL_NO_EXPORT JSONChunkedPrinter final : public ChunkedPrinter
+{
+public:
+	JSONChunkedPrinter (const Node& rootNode, const JSONPrinterOptions& printerOptions)
+		: printer (printerOptions), pendingValue (&rootNode)
+	{
+	}
+
+	std::size_t read (char* buffer, std::size_t maxBytes) final
+	{
+		std::size_t numWritten = 0;
 
-		inline std::uint32_t parseUnicodeCharacterNumber (bool isLowSurrogate)
+		if (spillPosition < spill.size())
 		{
-			std::uint32_t result = 0;
+			numWritten = std::min (maxBytes, spill.size() - spillPosition);
 
-			for (auto i = 4; --i >= 0;)
-			{
-				const auto errorPos = current;
+			std::memcpy (buffer, spill.data() + spillPosition, numWritten);
 
-				auto digit = pop();
+			spillPosition += numWritten;
 
-				if (digit >= '0' && digit <= '9')
-					digit -= '0';
-				else if (digit >= 'a' && digit <= 'f')
-					digit = 10 + (digit - 'a');
-				else if (digit >= 'A' && digit <= 'F')
-					digit = 10 + (digit - 'A');
-				else
-					throwError ("Syntax error in unicode character", errorPos);
+			if (spillPosition < spill.size())
+				return numWritten;
+		}
 
-				result = (result << 4) + digit;
-			}
+		// clear() keeps the capacity, so the spill is only allocated once
+		spill.clear();
+		spillPosition = 0;
 
-			if (isLowSurrogate && ! text::utf8::isLowSurrogate (result))
-				throwError ("Expected a unicode low surrogate codepoint");
+		ChunkSink sink { buffer, numWritten, maxBytes, spill };
 
-			if (text::utf8::isHighSurrogate (result))
-			{
-				if (! isLowSurrogate && popIf ("\\u"))
-					return text::utf8::SurrogatePair::combineParts (result, parseUnicodeCharacterNumber (true));
+		while (sink.hasRoom() && ! finished)
+			step (sink);
 
-				throwError ("Expected a unicode low surrogate codepoint");
-			}
+		return sink.getNumWritten();
+	}
 
-			return result;
-		}
+	bool isFinished() const noexcept final
+	{
+		return finished && spillPosition == spill.size();
+	}
 
-		[[noreturn]] inline void throwError (std::string_view message)
+private:
+	// writes into the caller's buffer, and appends whatever doesn't fit to the spill
+	class ChunkSink final : public OutputSink
+	{
+	public:
+		ChunkSink (char* bufferToUse, std::size_t numAlreadyWritten, std::size_t bufferSize, std::string& spillToUse) noexcept
+			: buffer (bufferToUse), numWritten (numAlreadyWritten), capacity (bufferSize), spill (spillToUse)
 		{
-			throwError (message, current);
 		}
 
-		[[noreturn]] inline void throwError (std::string_view message, text::utf8::Pointer errorPos)
+		void write (std::string_view text) final
 		{
-			throw ParseError { message, text::utf8::LineAndColumn::find (source, errorPos) };
-		}
+			const auto numToCopy = std::min (text.size(), capacity - numWritten);
 
-		text::utf8::Pointer source, current;
-	};
+			std::memcpy (buffer + numWritten, text.data(), numToCopy);
 
-	Parser p { string };
+			numWritten += numToCopy;
 
-	return p.parse();
-}
+			spill.append (text.substr (numToCopy));
+		}
 
-/*-----------------------------------------------------------------------------------------------------------------------*/
+		void write (char character) final
+		{
+			if (numWritten < capacity)
+				buffer[numWritten++] = character;
+			else
+				spill.push_back (character);
+		}
 
-static constexpr auto QUOTE_CHAR = '\'';
+		[[nodiscard]] bool hasRoom() const noexcept
+		{
+			return numWritten < capacity;
+		}
 
-static inline std::string quoteString (std::string_view input)
-{
-	std::string copy { input };
+		[[nodiscard]] std::size_t getNumWritten() const noexcept
+		{
+			return numWritten;
+		}
 
-	if (! copy.starts_with (QUOTE_CHAR))
-		copy.insert (0, std::string { QUOTE_CHAR });
+	private:
+		char*			  buffer;
+		std::size_t		  numWritten;
+		const std::size_t capacity;
+		std::string&	  spill;
+	};
 
-	if (! copy.ends_with (QUOTE_CHAR))
-		copy += QUOTE_CHAR;
+	// the escaped form of a string can be up to 6 times longer than the string itself
+	static constexpr std::size_t stringSliceSize = 4096;
 
-	return copy;
-}
+	struct Frame final
+	{
+		const Node* container;
 
-static inline std::string unquoteString (std::string_view input)
-{
-	std::string copy { input };
+		std::size_t numPrinted { 0 };
 
-	auto dropFirstChars = [&copy] (size_t numChars)
-	{
-		copy = copy.substr (numChars, copy.length());
-	};
+		Object::const_iterator nextMember {};
 
-	if (copy.starts_with ("\\\""))
-		dropFirstChars (2);
-	else if (copy.starts_with ('"'))
-		dropFirstChars (1);
-	else if (copy.starts_with ("\\\'"))
-		dropFirstChars (2);
-	else if (copy.starts_with ('\''))
-		dropFirstChars (1);
+		// only used for canonical output when the map's order isn't UTF-16 order
+		std::vector<const Object::value_type*> sortedMembers {};
+	};
 
-	auto dropLastChars = [&copy] (size_t numChars)
+	void step (OutputSink& sink)
 	{
-		for (auto i = 0UL; i < numChars; ++i)
+		if (inString)
 		{
-			if (copy.empty())
-				return;
-
-			copy.pop_back();
+			printStringSlice (sink);
+			return;
 		}
-	};
 
-	if (copy.ends_with ("\\\""))
-		dropLastChars (2);
-	else if (copy.ends_with ('"'))
-		dropLastChars (1);
-	else if (copy.ends_with ("\\\'"))
-		dropLastChars (2);
-	else if (copy.ends_with ('\''))
-		dropLastChars (1);
-
-	return copy;
-}
+		if (pendingValue != nullptr)
+		{
+			const auto* const value = std::exchange (pendingValue, nullptr);
 
-static inline std::string joinStrings (const std::vector<std::string>& strings, std::string_view glue)
-{
-	if (strings.size() == 1)
-		return strings[0];
+			beginValue (*value, sink);
+			return;
+		}
 
-	std::stringstream stream;
+		if (stack.empty())
+		{
+			finished = true;
+			return;
+		}
 
-	for (auto i = 0UL; i < strings.size(); ++i)
-	{
-		const auto& string = strings[i];
+		auto& frame = stack.back();
 
-		stream << string;
+		const auto isArray = frame.container->isArray();
 
-		if ((i + 1 < strings.size()) && (! string.ends_with (glue)))
-			stream << glue;
-	}
+		if (frame.numPrinted == frame.container->getNumChildren())
+		{
+			sink.write (printer.getClosingBracket (isArray));
+			stack.pop_back();
+			return;
+		}
 
-	return stream.str();
-}
+		if (frame.numPrinted > 0)
+			sink.write (printer.getSeparator());
 
-std::unique_ptr<Printer> JSONFormat::createPrinter ([[maybe_unused]] bool shouldPrettyPrint) const noexcept
-{
-	class JSONPrinter final : public Printer
-	{
-	public:
-	private:
-		std::string printNull() final
+		if (isArray)
 		{
-			return "null";
+			pendingValue = &frame.container->getArray()[frame.numPrinted++];
+			return;
 		}
 
-		std::string printNumber (double number) final
-		{
-			if (std::isfinite (number))
-				return unquoteString (std::to_string (number));
+		const auto& member = frame.sortedMembers.empty() ? *frame.nextMember++ : *frame.sortedMembers[frame.numPrinted];
 
-			if (std::isnan (number))
-				return "\"NaN\"";
+		++frame.numPrinted;
 
-			if (number >= 0)
-				return "\"Infinity\"";
+		// the key is printed first, and then the value
+		beginString (member.first, sink);
+		isKey		 = true;
+		pendingValue = &member.second;
+	}
 
-			return "\"-Infinity\"";
+	void beginValue (const Node& value, OutputSink& sink)
+	{
+		if (value.isString())
+		{
+			beginString (value.getString(), sink);
+			return;
 		}
 
-		std::string printString (std::string_view string) final
+		if (! (value.isArray() || value.isObject()) || value.getNumChildren() == 0)
 		{
-			std::stringstream stream;
-
-			stream << '"';
+			printer.print (value, sink);
+			return;
+		}
 
-			text::utf8::Pointer text { string };
+		const auto isArray = value.isArray();
 
-			auto writeUnicode = [&stream] (auto digit)
-			{
-				auto hexDigit = [] (auto value) -> char
-				{ return "0123456789abcdef"[value & 15]; };
+		sink.write (printer.getOpeningBracket (isArray));
 
-				stream << "\\u" << hexDigit (digit >> 12) << hexDigit (digit >> 8) << hexDigit (digit >> 4) << hexDigit (digit);
-			};
+		auto& frame = stack.emplace_back (Frame { &value });
 
-			while (! text.empty())
-			{
-				const auto c = *text;
+		if (isArray)
+			return;
 
-				switch (c)
-				{
-					case 0 : break;
-
-					case '\"' : stream << "\\\""; break;
-					case '\\' : stream << "\\\\"; break;
-					case '\n' : stream << "\\n"; break;
-					case '\r' : stream << "\\r"; break;
-					case '\t' : stream << "\\t"; break;
-					case '\a' : stream << "\\a"; break;
-					case '\b' : stream << "\\b"; break;
-					case '\f' : stream << "\\f"; break;
-
-					default :
-					{
-						if (c > 31 && c < 127)
-						{
-							stream << static_cast<char> (c);
-							break;
-						}
+		const auto& object = value.getObject();
 
-						if (c >= 0x10000)
-						{
-							const auto pair = text::utf8::SurrogatePair::fromFullCodepoint (c);
+		frame.nextMember = object.begin();
 
-							writeUnicode (pair.high);
-							writeUnicode (pair.low);
+		if (printer.isCanonical() && ! JSONPrinter::keysAreInUTF16Order (object))
+		{
+			frame.sortedMembers.reserve (object.size());
 
-							break;
-						}
+			for (const auto& member : object)
+				frame.sortedMembers.push_back (&member);
 
-						writeUnicode (c);
-						break;
-					}
-				}
+			std::sort (frame.sortedMembers.begin(), frame.sortedMembers.end(), [] (const auto* lhs, const auto* rhs)
+					   { return isLessInUTF16Order (lhs->first, rhs->first); });
+		}
+	}
 
-				++text;
-			}
+	void beginString (std::string_view string, OutputSink& sink)
+	{
+		sink.write ('"');
 
-			stream << '"';
+		inString		= true;
+		isKey			= false;
+		remainingString = string;
+	}
 
-			return stream.str();
-		}
+	void printStringSlice (OutputSink& sink)
+	{
+		auto sliceSize = std::min (remainingString.size(), stringSliceSize);
 
-		std::string printBoolean (bool boolean) final
-		{
-			if (boolean)
-				return "true";
+		// don't split a UTF-8 sequence between slices, so that it's escaped (or validated) in one piece
+		if (sliceSize < remainingString.size())
+			for (auto i = 0; i < 3 && (static_cast<unsigned char> (remainingString[sliceSize]) & 0xC0) == 0x80; ++i)
+				--sliceSize;
 
-			return "false";
-		}
+		printer.printStringContents (remainingString.substr (0, sliceSize), sink);
 
-		std::string printArray (const Array& array) final
-		{
-			std::vector<std::string> strings;
+		remainingString.remove_prefix (sliceSize);
 
-			for (const auto& element : array)
-				strings.emplace_back (print (element));	 // cppcheck-suppress useStlAlgorithm
+		if (! remainingString.empty())
+			return;
 
-			return "[ " + joinStrings (strings, ", ") + " ]";
-		}
+		sink.write ('"');
 
-		std::string printObject (const Object& object) final
-		{
-			std::vector<std::string> strings;
+		if (isKey)
+			sink.write (':');
 
-			for (const auto& element : object)
-			{
-				auto str = quoteString (element.first);
-				str += ':';
-				str += print (element.second);
+		inString = false;
+	}
 
-				strings.emplace_back (str);
-			}
+	JSONPrinter printer;
 
-			return "{ " + joinStrings (strings, ", ") + " }";
-		}
+	std::vector<Frame> stack;
 
-		void arrayBegin() final
-		{
-		}
+	const Node* pendingValue;
 
-		void arrayEnd() final
-		{
-		}
+	std::string_view remainingString;
 
-		void objectBegin() final
-		{
-		}
+	bool inString { false }, isKey { false }, finished { false };
 
-		void objectEnd() final
-		{
-		}
-	};
+	std::string spill;
+	std::size_t spillPosition { 0 };
+};
 
-	return std::make_unique<JSONPrinter>();
+std::unique_ptr<ChunkedPrinter> JSONFormat::createChunkedPrinter (const Node& node, const JSONPrinterOptions& options) const
+{
+	return std::make_unique<JSONChunkedPrinter> (node, options);
 }
 
 /*-----------------------------------------------------------------------------------------------------------------------*/
@@ -13,8 +13,10 @@
  */
 
 #include <algorithm>
+#include <filesystem>
 #include "lserializing/lserializing_KnownFormats.h"
 #include "lserializing/lserializing_SerializingFormat.h"
+#include "lserializing_MappedFile.h"
 
 namespace limes::serializing
 {
@@ -99,6 +101,28 @@ Node KnownFormats::parse (std::string_view string) const
 	throw FormatNotFoundError { "Unknown format" };
 }
 
+Node KnownFormats::parseFile (const std::filesystem::path& path) const
+{
+	auto extension = path.extension();
+
+	// for a compressed file such as data.json.gz, the format comes from the extension before the compression's
+	for (const auto type : { CompressionType::Gzip, CompressionType::LZ4 })
+		if (extension == getFileExtension (type))
+			extension = path.stem().extension();
+
+	if (auto* f = getFormatForFileExtension (extension.string()))
+		return f->parseFile (path);
+
+	const MappedFile file { path };
+
+	const auto text = file.getText();
+
+	if (detectCompression (text) != CompressionType::None)
+		return parse (decompress (text));
+
+	return parse (text);
+}
+
 void KnownFormats::deserialize (SerializableData& data, std::string_view string) const noexcept
 {
 	data.deserialize (parse (string));
@@ -0,0 +1,156 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include <cerrno>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include "lserializing_MappedFile.h"
+
+#if LSERIAL_HAS_MMAP
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#else
+#	include <fstream>
+#	include <iterator>
+#endif
+
+namespace limes::serializing
+{
+
+[[noreturn]] static void throwFileError (int errorCode, std::string_view action, const std::filesystem::path& path)
+{
+	throw std::system_error { errorCode, std::generic_category(),
+							  std::string { action } + " " + path.string() };
+}
+
+#if LSERIAL_HAS_MMAP
+
+MappedFile::MappedFile (const std::filesystem::path& path, AccessPattern pattern)
+{
+	const auto fd = ::open (path.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0)
+		throwFileError (errno, "Could not open", path);
+
+	struct stat info;
+
+	if (::fstat (fd, &info) != 0)
+	{
+		const auto error = errno;
+		::close (fd);
+		throwFileError (error, "Could not stat", path);
+	}
+
+	size = static_cast<std::size_t> (info.st_size);
+
+	// mapping 0 bytes is an error, and an empty file doesn't need a mapping anyway
+	if (size > 0)
+	{
+		auto* const mapping = ::mmap (nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (mapping == MAP_FAILED)
+		{
+			const auto error = errno;
+			::close (fd);
+			throwFileError (error, "Could not map", path);
+		}
+
+		// this is only a hint, so failure isn't an error
+		::madvise (mapping, size, pattern == AccessPattern::Random ? MADV_RANDOM : MADV_SEQUENTIAL);
+
+		data = static_cast<const char*> (mapping);
+	}
+
+	// the mapping stays valid after the descriptor is closed
+	::close (fd);
+}
+
+void MappedFile::unmap() noexcept
+{
+	if (data != nullptr)
+		::munmap (const_cast<char*> (data), size);
+
+	data = nullptr;
+	size = 0;
+}
+
+#else
+
+MappedFile::MappedFile (const std::filesystem::path& path, AccessPattern /*pattern*/)
+{
+	std::ifstream stream { path, std::ios::binary };
+
+	if (! stream)
+		throwFileError (ENOENT, "Could not open", path);
+
+	buffer.assign (std::istreambuf_iterator<char> { stream }, std::istreambuf_iterator<char> {});
+
+	if (stream.bad())
+		throwFileError (EIO, "Could not read", path);
+
+	data = buffer.data();
+	size = buffer.size();
+}
+
+void MappedFile::unmap() noexcept
+{
+	buffer.clear();
+
+	data = nullptr;
+	size = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+	unmap();
+}
+
+MappedFile::MappedFile (MappedFile&& other) noexcept
+{
+	*this = std::move (other);
+}
+
+MappedFile& MappedFile::operator= (MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		unmap();
+
+#if LSERIAL_HAS_MMAP
+		data = std::exchange (other.data, nullptr);
+#else
+		buffer	   = std::move (other.buffer);
+		data	   = buffer.data();
+		other.data = nullptr;
+#endif
+
+		size = std::exchange (other.size, 0);
+	}
+
+	return *this;
+}
+
+std::string_view MappedFile::getText() const noexcept
+{
+	return { data, size };
+}
+
+}  // namespace limes::serializing
@@ -0,0 +1,76 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include "lserializing/lserializing_Export.h"
+
+// Internal read-only view of a file's contents. This header is private to the library.
+
+#if defined(__unix__) || defined(__APPLE__)
+#	define LSERIAL_HAS_MMAP 1
+#else
+#	define LSERIAL_HAS_MMAP 0
+#endif
+
+namespace limes::serializing
+{
+
+/** Maps a whole file into memory, read-only, for the lifetime of this object.
+
+	On POSIX systems the file is mapped with \c mmap() and the kernel is advised how it will be
+	read, so parsing straight from the mapping avoids copying the file into a string. On other
+	platforms the file is read into an internal buffer instead.
+
+	@throws std::system_error if the file can't be opened or mapped.
+ */
+class LSERIAL_NO_EXPORT MappedFile final
+{
+public:
+	/** How the mapping will be read. This only changes the hint given to the kernel. */
+	enum class AccessPattern
+	{
+		Sequential,	 ///< Read once from start to end, as when parsing text; pages are read ahead.
+		Random		 ///< Read in place at scattered offsets, as with a binary document.
+	};
+
+	explicit MappedFile (const std::filesystem::path& path, AccessPattern pattern = AccessPattern::Sequential);
+
+	~MappedFile();
+
+	MappedFile (const MappedFile&)			  = delete;
+	MappedFile& operator= (const MappedFile&) = delete;
+
+	MappedFile (MappedFile&& other) noexcept;
+	MappedFile& operator= (MappedFile&& other) noexcept;
+
+	/** Returns the contents of the file. The view is valid for as long as this object exists. */
+	[[nodiscard]] std::string_view getText() const noexcept;
+
+private:
+	void unmap() noexcept;
+
+	const char* data { nullptr };
+	std::size_t size { 0 };
+
+#if ! LSERIAL_HAS_MMAP
+	std::string buffer;
+#endif
+};
+
+}  // namespace limes::serializing
@@ -0,0 +1,626 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "lserializing/lserializing_MessagePack.h"
+#include "lserializing/lserializing_KnownFormats.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include "lserializing/lserializing_StaticPrinter.h"
+
+namespace limes::serializing
+{
+
+LSERIAL_NO_EXPORT static const KnownFormats::Register<MessagePackFormat> msgpack_init;
+
+std::string_view MessagePackFormat::getName() const noexcept
+{
+	return formats::MessagePack;
+}
+
+bool MessagePackFormat::supportsComments() const noexcept
+{
+	return false;
+}
+
+const std::vector<std::string_view>& MessagePackFormat::getFileExtensions() const noexcept
+{
+	struct ExtensionsHolder final
+	{
+		std::vector<std::string_view> xtns;
+
+		ExtensionsHolder()
+		{
+			xtns.emplace_back (".msgpack");
+		}
+	};
+
+	static const ExtensionsHolder holder;
+
+	return holder.xtns;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// The type bytes used by this implementation; see https://github.com/msgpack/msgpack/blob/master/spec.md
+namespace msgpack
+{
+
+static constexpr unsigned char fixMap = 0x80, fixArray = 0x90, fixStr = 0xA0,
+							   nil = 0xC0, falseByte = 0xC2, trueByte = 0xC3,
+							   bin8 = 0xC4, bin16 = 0xC5, bin32 = 0xC6,
+							   float32 = 0xCA, float64 = 0xCB,
+							   uint8 = 0xCC, uint16 = 0xCD, uint32 = 0xCE, uint64 = 0xCF,
+							   int8 = 0xD0, int16 = 0xD1, int32 = 0xD2, int64 = 0xD3,
+							   str8 = 0xD9, str16 = 0xDA, str32 = 0xDB,
+							   array16 = 0xDC, array32 = 0xDD,
+							   map16 = 0xDE, map32 = 0xDF;
+
+static constexpr auto maxDepth = std::size_t { 512 };
+
+}  // namespace msgpack
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// Reports errors by recording them and returning false rather than by throwing, so that
+// MessagePackFormat::tryParse() can reject input without any stack unwinding.
+class LSERIAL_NO_EXPORT MessagePackParser final
+{
+public:
+	explicit MessagePackParser (std::string_view input)
+		: start (input.data()), current (input.data()), end (input.data() + input.size())
+	{
+	}
+
+	[[nodiscard]] inline bool parse (Node& result)
+	{
+		if (! parseValue (result))
+			return false;
+
+		if (current != end)
+			return fail ("Unexpected data after the end of the document", current);
+
+		return true;
+	}
+
+	[[nodiscard]] ParseError getError() const
+	{
+		auto message = std::string { errorMessage };
+
+		message += " at byte ";
+		message += std::to_string (errorPos - start);
+
+		return ParseError { message, {} };
+	}
+
+private:
+	[[nodiscard]] inline bool fail (const char* message, const char* position)
+	{
+		errorMessage = message;
+		errorPos	 = position;
+		return false;
+	}
+
+	[[nodiscard]] inline std::size_t getNumBytesLeft() const noexcept
+	{
+		return static_cast<std::size_t> (end - current);
+	}
+
+	// reads a big-endian unsigned integer of the given size
+	[[nodiscard]] inline bool readUnsigned (std::size_t numBytes, std::uint64_t& value)
+	{
+		if (getNumBytesLeft() < numBytes)
+			return fail ("Unexpected end of data", end);
+
+		value = 0;
+
+		for (auto i = 0UL; i < numBytes; ++i)
+			value = (value << 8U) | static_cast<unsigned char> (*current++);
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool readSigned (std::size_t numBytes, Node& result)
+	{
+		std::uint64_t value { 0 };
+
+		if (! readUnsigned (numBytes, value))
+			return false;
+
+		// sign-extend from the value's own width
+		const auto shift = 64UL - numBytes * 8UL;
+
+		result = Node::createNumber (static_cast<double> (static_cast<std::int64_t> (value << shift) >> shift));
+		return true;
+	}
+
+	[[nodiscard]] inline bool readPayload (std::size_t numLengthBytes, std::string_view& payload)
+	{
+		std::uint64_t length { 0 };
+
+		if (! readUnsigned (numLengthBytes, length))
+			return false;
+
+		if (length > getNumBytesLeft())
+			return fail ("String is longer than the remaining data", current);
+
+		payload = std::string_view { current, static_cast<std::size_t> (length) };
+		current += length;
+		return true;
+	}
+
+	[[nodiscard]] inline bool readContainerSize (std::size_t numSizeBytes, std::size_t& size)
+	{
+		std::uint64_t value { 0 };
+
+		if (! readUnsigned (numSizeBytes, value))
+			return false;
+
+		// every element takes at least one byte, so this rejects absurd sizes before allocating
+		if (value > getNumBytesLeft())
+			return fail ("Container is larger than the remaining data", current);
+
+		size = static_cast<std::size_t> (value);
+		return true;
+	}
+
+	// reads the header of a str or bin value, then its payload
+	[[nodiscard]] inline bool readString (unsigned char typeByte, std::string_view& payload)
+	{
+		if ((typeByte & 0xE0U) == msgpack::fixStr)
+		{
+			const auto length = static_cast<std::size_t> (typeByte & 0x1FU);
+
+			if (length > getNumBytesLeft())
+				return fail ("String is longer than the remaining data", current);
+
+			payload = std::string_view { current, length };
+			current += length;
+			return true;
+		}
+
+		switch (typeByte)
+		{
+			case (msgpack::str8) : [[fallthrough]];
+			case (msgpack::bin8) : return readPayload (1, payload);
+			case (msgpack::str16) : [[fallthrough]];
+			case (msgpack::bin16) : return readPayload (2, payload);
+			case (msgpack::str32) : [[fallthrough]];
+			case (msgpack::bin32) : return readPayload (4, payload);
+			default : return fail ("Map keys must be strings", current - 1);
+		}
+	}
+
+	[[nodiscard]] inline bool parseArray (Node& result, std::size_t size)
+	{
+		if (++depth > msgpack::maxDepth)
+			return fail ("Containers are nested too deeply", current - 1);
+
+		result = Node { ObjectType::Array };
+
+		auto& array = result.getArray();
+
+		array.resize (size);
+
+		for (auto& element : array)
+			if (! parseValue (element))
+				return false;
+
+		--depth;
+		return true;
+	}
+
+	[[nodiscard]] inline bool parseObject (Node& result, std::size_t size)
+	{
+		if (++depth > msgpack::maxDepth)
+			return fail ("Containers are nested too deeply", current - 1);
+
+		result = Node { ObjectType::Object };
+
+		auto& obj = result.getObject();
+
+		for (auto i = 0UL; i < size; ++i)
+		{
+			if (current == end)
+				return fail ("Unexpected end of data", end);
+
+			const auto* const namePos = current;
+
+			std::string_view name;
+
+			if (! readString (static_cast<unsigned char> (*current++), name))
+				return false;
+
+			if (name.empty())
+				return fail ("Property names cannot be empty", namePos);
+
+			Node* value { nullptr };
+
+			// maps written by this library are in sorted order, so each member usually goes at the end
+			if (obj.empty() || obj.rbegin()->first < name)
+			{
+				value = &obj.emplace_hint (obj.end(), name, Node {})->second;
+			}
+			else
+			{
+				auto [iterator, inserted] = obj.try_emplace (std::string { name });
+
+				if (! inserted)
+					return fail ("Duplicate keys in same map", namePos);
+
+				value = &iterator->second;
+			}
+
+			if (! parseValue (*value))
+				return false;
+		}
+
+		--depth;
+		return true;
+	}
+
+	[[nodiscard]] inline bool parseValue (Node& result)
+	{
+		if (current == end)
+			return fail ("Unexpected end of data", end);
+
+		const auto* const valueStart = current;
+
+		const auto typeByte = static_cast<unsigned char> (*current++);
+
+		if (typeByte < 0x80U)
+		{
+			result = Node::createNumber (static_cast<double> (typeByte));
+			return true;
+		}
+
+		if (typeByte >= 0xE0U)
+		{
+			result = Node::createNumber (static_cast<double> (static_cast<int> (typeByte) - 256));
+			return true;
+		}
+
+		if ((typeByte & 0xE0U) == msgpack::fixStr)
+		{
+			std::string_view payload;
+
+			if (! readString (typeByte, payload))
+				return false;
+
+			result = Node::createString (payload);
+			return true;
+		}
+
+		if ((typeByte & 0xF0U) == msgpack::fixMap)
+			return parseObject (result, typeByte & 0x0FU);
+
+		if ((typeByte & 0xF0U) == msgpack::fixArray)
+		{
+			const auto size = static_cast<std::size_t> (typeByte & 0x0FU);
+
+			if (size > getNumBytesLeft())
+				return fail ("Container is larger than the remaining data", current);
+
+			return parseArray (result, size);
+		}
+
+		std::uint64_t value { 0 };
+		std::size_t	  size { 0 };
+
+		switch (typeByte)
+		{
+			case (msgpack::nil) : result = Node::createNull(); return true;
+			case (msgpack::falseByte) : result = Node::createBoolean (false); return true;
+			case (msgpack::trueByte) : result = Node::createBoolean (true); return true;
+
+			case (msgpack::float32) :
+				if (! readUnsigned (4, value))
+					return false;
+
+				result = Node::createNumber (static_cast<double> (std::bit_cast<float> (static_cast<std::uint32_t> (value))));
+				return true;
+
+			case (msgpack::float64) :
+				if (! readUnsigned (8, value))
+					return false;
+
+				result = Node::createNumber (std::bit_cast<double> (value));
+				return true;
+
+			case (msgpack::uint8) : [[fallthrough]];
+			case (msgpack::uint16) : [[fallthrough]];
+			case (msgpack::uint32) : [[fallthrough]];
+			case (msgpack::uint64) :
+				if (! readUnsigned (std::size_t { 1 } << (typeByte - msgpack::uint8), value))
+					return false;
+
+				result = Node::createNumber (static_cast<double> (value));
+				return true;
+
+			case (msgpack::int8) : [[fallthrough]];
+			case (msgpack::int16) : [[fallthrough]];
+			case (msgpack::int32) : [[fallthrough]];
+			case (msgpack::int64) : return readSigned (std::size_t { 1 } << (typeByte - msgpack::int8), result);
+
+			case (msgpack::str8) : [[fallthrough]];
+			case (msgpack::str16) : [[fallthrough]];
+			case (msgpack::str32) : [[fallthrough]];
+			case (msgpack::bin8) : [[fallthrough]];
+			case (msgpack::bin16) : [[fallthrough]];
+			case (msgpack::bin32) :
+			{
+				std::string_view payload;
+
+				if (! readString (typeByte, payload))
+					return false;
+
+				result = Node::createString (payload);
+				return true;
+			}
+
+			case (msgpack::array16) : return readContainerSize (2, size) && parseArray (result, size);
+			case (msgpack::array32) : return readContainerSize (4, size) && parseArray (result, size);
+			case (msgpack::map16) : return readContainerSize (2, size) && parseObject (result, size);
+			case (msgpack::map32) : return readContainerSize (4, size) && parseObject (result, size);
+
+			case (0xC1) : return fail ("Invalid type byte", valueStart);
+
+			default : return fail ("Extension types are not supported", valueStart);
+		}
+	}
+
+	const char* const start;
+	const char*		  current;
+	const char* const end;
+
+	std::size_t depth { 0 };
+
+	const char* errorMessage { "" };
+	const char* errorPos { nullptr };
+};
+
+Node MessagePackFormat::parse (std::string_view string) const
+{
+	return tryParse (string).getNode();
+}
+
+ParseResult MessagePackFormat::tryParse (std::string_view string) const
+{
+	MessagePackParser p { string };
+
+	if (Node result; p.parse (result))
+		return result;
+
+	return p.getError();
+}
+
+bool MessagePackFormat::probablyMatchesString (std::string_view string) const noexcept
+{
+	if (string.empty())
+		return false;
+
+	const auto firstByte = static_cast<unsigned char> (string.front());
+
+	auto isStringHeader = [] (unsigned char typeByte)
+	{
+		return (typeByte & 0xE0U) == msgpack::fixStr
+			|| typeByte == msgpack::str8 || typeByte == msgpack::str16 || typeByte == msgpack::str32;
+	};
+
+	std::size_t headerSize { 0 };
+	bool		isMap { false };
+
+	if ((firstByte & 0xF0U) == msgpack::fixMap || (firstByte & 0xF0U) == msgpack::fixArray)
+	{
+		headerSize = 1;
+		isMap	   = (firstByte & 0xF0U) == msgpack::fixMap;
+
+		// an empty container is the whole document
+		if ((firstByte & 0x0FU) == 0)
+			return string.size() == 1;
+	}
+	else if (firstByte == msgpack::array16 || firstByte == msgpack::map16)
+	{
+		headerSize = 3;
+		isMap	   = firstByte == msgpack::map16;
+	}
+	else if (firstByte == msgpack::array32 || firstByte == msgpack::map32)
+	{
+		headerSize = 5;
+		isMap	   = firstByte == msgpack::map32;
+	}
+	else
+	{
+		return false;
+	}
+
+	if (string.size() <= headerSize)
+		return false;
+
+	const auto nextByte = static_cast<unsigned char> (string[headerSize]);
+
+	if (isMap)
+		return isStringHeader (nextByte);
+
+	return nextByte != 0xC1U && (nextByte < 0xC7U || nextByte > 0xC9U) && (nextByte < 0xD4U || nextByte > 0xD8U);
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+class LSERIAL_NO_EXPORT MessagePackPrinter final : public StaticPrinter<MessagePackPrinter>
+{
+	friend class StaticPrinter<MessagePackPrinter>;
+
+private:
+	// writes the type byte followed by the value as a big-endian integer of the given size
+	static void writeTyped (unsigned char typeByte, std::uint64_t value, std::size_t numBytes, OutputSink& sink)
+	{
+		char bytes[9];
+
+		bytes[0] = static_cast<char> (typeByte);
+
+		for (auto i = 0UL; i < numBytes; ++i)
+			bytes[1 + i] = static_cast<char> (static_cast<unsigned char> (value >> ((numBytes - 1 - i) * 8UL)));
+
+		sink.write (std::string_view { bytes, numBytes + 1 });
+	}
+
+	// writes the smallest header for a string, array or map of the given size
+	static void writeSizeHeader (std::size_t size, unsigned char fixType, std::size_t maxFixSize,
+								 unsigned char type8, unsigned char type16, unsigned char type32, OutputSink& sink)
+	{
+		if (size <= maxFixSize)
+			sink.write (static_cast<char> (fixType | static_cast<unsigned char> (size)));
+		else if (type8 != 0 && size <= std::numeric_limits<std::uint8_t>::max())
+			writeTyped (type8, size, 1, sink);
+		else if (size <= std::numeric_limits<std::uint16_t>::max())
+			writeTyped (type16, size, 2, sink);
+		else if (size <= std::numeric_limits<std::uint32_t>::max())
+			writeTyped (type32, size, 4, sink);
+		else
+			throw std::runtime_error { "MessagePack can't represent strings or containers with more than 2^32 - 1 elements" };
+	}
+
+	void printNull (OutputSink& sink) final
+	{
+		sink.write (static_cast<char> (msgpack::nil));
+	}
+
+	void printNumber (double number, OutputSink& sink) final
+	{
+		constexpr auto twoTo63 = 9223372036854775808.;
+
+		// -0 has to stay a float, because it's not equal to the integer 0
+		const auto isIntegral = number >= -twoTo63 && number < twoTo63 * 2. && std::trunc (number) == number
+							 && ! (number == 0. && std::signbit (number));
+
+		if (isIntegral && number >= 0.)
+		{
+			const auto value = static_cast<std::uint64_t> (number);
+
+			if (value < 0x80U)
+				sink.write (static_cast<char> (value));
+			else if (value <= std::numeric_limits<std::uint8_t>::max())
+				writeTyped (msgpack::uint8, value, 1, sink);
+			else if (value <= std::numeric_limits<std::uint16_t>::max())
+				writeTyped (msgpack::uint16, value, 2, sink);
+			else if (value <= std::numeric_limits<std::uint32_t>::max())
+				writeTyped (msgpack::uint32, value, 4, sink);
+			else
+				writeTyped (msgpack::uint64, value, 8, sink);
+
+			return;
+		}
+
+		if (isIntegral)
+		{
+			const auto value	= static_cast<std::int64_t> (number);
+			const auto asBits = static_cast<std::uint64_t> (value);
+
+			if (value >= -32)
+				sink.write (static_cast<char> (static_cast<unsigned char> (asBits)));
+			else if (value >= std::numeric_limits<std::int8_t>::min())
+				writeTyped (msgpack::int8, asBits, 1, sink);
+			else if (value >= std::numeric_limits<std::int16_t>::min())
+				writeTyped (msgpack::int16, asBits, 2, sink);
+			else if (value >= std::numeric_limits<std::int32_t>::min())
+				writeTyped (msgpack::int32, asBits, 4, sink);
+			else
+				writeTyped (msgpack::int64, asBits, 8, sink);
+
+			return;
+		}
+
+		// converting a finite double that's out of float's range is undefined, so check that first
+		if (std::isinf (number)
+			|| (std::fabs (number) <= std::numeric_limits<float>::max()
+				&& static_cast<double> (static_cast<float> (number)) == number))
+		{
+			writeTyped (msgpack::float32, std::bit_cast<std::uint32_t> (static_cast<float> (number)), 4, sink);
+			return;
+		}
+
+		writeTyped (msgpack::float64, std::bit_cast<std::uint64_t> (number), 8, sink);
+	}
+
+	void printString (std::string_view string, OutputSink& sink) final
+	{
+		writeSizeHeader (string.size(), msgpack::fixStr, 31, msgpack::str8, msgpack::str16, msgpack::str32, sink);
+
+		sink.writeReferenced (string);
+	}
+
+	void printBoolean (bool boolean, OutputSink& sink) final
+	{
+		sink.write (static_cast<char> (boolean ? msgpack::trueByte : msgpack::falseByte));
+	}
+
+	void printArray (const Array& array, OutputSink& sink) final
+	{
+		writeSizeHeader (array.size(), msgpack::fixArray, 15, 0, msgpack::array16, msgpack::array32, sink);
+
+		for (const auto& element : array)
+			print (element, sink);
+	}
+
+	void printObject (const Object& object, OutputSink& sink) final
+	{
+		writeSizeHeader (object.size(), msgpack::fixMap, 15, 0, msgpack::map16, msgpack::map32, sink);
+
+		for (const auto& [name, value] : object)
+		{
+			printString (name, sink);
+			print (value, sink);
+		}
+	}
+};
+
+std::string MessagePackFormat::serialize (const Node& node, bool shouldPrettyPrint) const noexcept
+{
+	const auto printer = createPrinter (shouldPrettyPrint);
+
+	std::string result;
+
+	StringSink sink { result };
+
+	try
+	{
+		sink.reserve (printer->measure (node));
+
+		printer->print (node, sink);
+	}
+	catch (...)
+	{
+		// a string or container is too large to encode, which can't be reported from here
+		return {};
+	}
+
+	return result;
+}
+
+std::unique_ptr<Printer> MessagePackFormat::createPrinter ([[maybe_unused]] bool shouldPrettyPrint) const noexcept
+{
+	return std::make_unique<MessagePackPrinter>();
+}
+
+}  // namespace limes::serializing
@@ -0,0 +1,416 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <ostream>
+#include "lserializing/lserializing_OutputSink.h"
+
+#if defined(_WIN32)
+#	include <io.h>
+#	include <fcntl.h>
+#	include <sys/stat.h>
+#else
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/uio.h>
+#	include <climits>
+#endif
+
+#if defined(_WIN32)
+// Windows has no writev(), but WritevSink still stores its segments in this form
+struct iovec
+{
+	void*		iov_base;
+	std::size_t iov_len;
+};
+#endif
+
+namespace limes::serializing
+{
+
+void OutputSink::write (char character)
+{
+	write (std::string_view { &character, 1 });
+}
+
+void OutputSink::writeReferenced (std::string_view text)
+{
+	write (text);
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+StringSink::StringSink (std::string& stringToAppendTo) noexcept
+	: string (stringToAppendTo)
+{
+}
+
+void StringSink::write (std::string_view text)
+{
+	string.append (text);
+}
+
+void StringSink::write (char character)
+{
+	string.push_back (character);
+}
+
+void StringSink::reserve (std::size_t numBytes)
+{
+	string.reserve (string.size() + numBytes);
+}
+
+std::string& StringSink::getString() noexcept
+{
+	return string;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+StreamSink::StreamSink (std::ostream& streamToWriteTo) noexcept
+	: stream (streamToWriteTo)
+{
+}
+
+void StreamSink::write (std::string_view text)
+{
+	stream.write (text.data(), static_cast<std::streamsize> (text.size()));
+}
+
+void StreamSink::write (char character)
+{
+	stream.put (character);
+}
+
+void StreamSink::flush()
+{
+	stream.flush();
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+void CountingSink::write (std::string_view text)
+{
+	numBytes += text.size();
+}
+
+void CountingSink::write (char)
+{
+	++numBytes;
+}
+
+std::size_t CountingSink::getNumBytesWritten() const noexcept
+{
+	return numBytes;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+#if defined(_WIN32)
+static int openFileForWriting (const std::filesystem::path& path) noexcept
+{
+	int fd = -1;
+	_wsopen_s (&fd, path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _SH_DENYWR, _S_IREAD | _S_IWRITE);
+	return fd;
+}
+
+static long long writeToFileDescriptor (int fd, const char* data, std::size_t size) noexcept
+{
+	return _write (fd, data, static_cast<unsigned> (std::min<std::size_t> (size, 1U << 30)));
+}
+
+static void closeFileDescriptor (int fd) noexcept
+{
+	_close (fd);
+}
+#else
+static int openFileForWriting (const std::filesystem::path& path) noexcept
+{
+	return ::open (path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+}
+
+static long long writeToFileDescriptor (int fd, const char* data, std::size_t size) noexcept
+{
+	return ::write (fd, data, size);
+}
+
+static void closeFileDescriptor (int fd) noexcept
+{
+	::close (fd);
+}
+#endif
+
+FileSink::FileSink (const std::filesystem::path& path)
+	: fileDescriptor (openFileForWriting (path)), buffer (new char[bufferSize])
+{
+	if (fileDescriptor < 0)
+		throw std::system_error { errno, std::generic_category(), "Could not open " + path.string() };
+}
+
+FileSink::~FileSink()
+{
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+	}
+
+	closeFileDescriptor (fileDescriptor);
+}
+
+void FileSink::write (std::string_view text)
+{
+	if (numBuffered + text.size() > bufferSize)
+	{
+		flush();
+
+		// big writes skip the buffer
+		if (text.size() >= bufferSize)
+		{
+			writeToFile (text.data(), text.size());
+			return;
+		}
+	}
+
+	std::memcpy (buffer.get() + numBuffered, text.data(), text.size());
+	numBuffered += text.size();
+}
+
+void FileSink::write (char character)
+{
+	if (numBuffered == bufferSize)
+		flush();
+
+	buffer[numBuffered++] = character;
+}
+
+void FileSink::flush()
+{
+	if (numBuffered == 0)
+		return;
+
+	// reset first, so that a failed write isn't retried by the destructor
+	const auto numBytes = numBuffered;
+	numBuffered			= 0;
+
+	writeToFile (buffer.get(), numBytes);
+}
+
+void FileSink::reserve ([[maybe_unused]] std::size_t numBytes)
+{
+#if defined(__linux__)
+	// The file's size is left alone, so if fewer bytes end up being written, the file isn't padded.
+	// This is only an optimization, so failure (for example, on a filesystem that doesn't support
+	// it) isn't an error.
+	::fallocate (fileDescriptor, FALLOC_FL_KEEP_SIZE,
+				 static_cast<off_t> (fileOffset + numBuffered), static_cast<off_t> (numBytes));
+#endif
+}
+
+void FileSink::writeToFile (const char* data, std::size_t size)
+{
+	while (size > 0)
+	{
+		const auto numWritten = writeToFileDescriptor (fileDescriptor, data, size);
+
+		if (numWritten < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			throw std::system_error { errno, std::generic_category(), "Could not write to file" };
+		}
+
+		data += numWritten;
+		size -= static_cast<std::size_t> (numWritten);
+		fileOffset += static_cast<std::size_t> (numWritten);
+	}
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// below this size, copying text is cheaper than giving it its own segment
+static constexpr std::size_t minReferencedSize = 512;
+
+#if defined(_WIN32)
+static constexpr std::size_t maxSegments = 1024;
+#elif defined(IOV_MAX)
+static constexpr std::size_t maxSegments = IOV_MAX;
+#else
+static constexpr std::size_t maxSegments = 1024;
+#endif
+
+WritevSink::WritevSink (int fileDescriptorToWriteTo)
+	: fileDescriptor (fileDescriptorToWriteTo), buffer (new char[bufferSize])
+{
+	segments.reserve (maxSegments);
+}
+
+WritevSink::~WritevSink()
+{
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+	}
+}
+
+void WritevSink::write (std::string_view text)
+{
+	if (numBuffered + text.size() > bufferSize)
+	{
+		flush();
+
+		// text that won't fit in the buffer is written straight from the caller's memory
+		if (text.size() >= bufferSize)
+		{
+			addSegment (text.data(), text.size());
+			flush();
+			return;
+		}
+	}
+
+	std::memcpy (buffer.get() + numBuffered, text.data(), text.size());
+
+	addSegment (buffer.get() + numBuffered, text.size());
+
+	numBuffered += text.size();
+}
+
+void WritevSink::write (char character)
+{
+	write (std::string_view { &character, 1 });
+}
+
+void WritevSink::writeReferenced (std::string_view text)
+{
+	if (text.size() < minReferencedSize)
+	{
+		write (text);
+		return;
+	}
+
+	addSegment (text.data(), text.size());
+}
+
+void WritevSink::flush()
+{
+	// reset first, so that a failed write isn't retried by the destructor
+	numBuffered = 0;
+
+	writeSegments();
+}
+
+void WritevSink::addSegment (const char* data, std::size_t size)
+{
+	if (size == 0)
+		return;
+
+	// consecutive writes into the buffer extend the same segment
+	if (! segments.empty())
+	{
+		auto& last = segments.back();
+
+		if (static_cast<const char*> (last.iov_base) + last.iov_len == data)
+		{
+			last.iov_len += size;
+			return;
+		}
+	}
+
+	if (segments.size() == maxSegments)
+	{
+		// the new segment may point into the buffer, so only the segments can be written here, and
+		// the buffer's contents must stay where they are
+		writeSegments();
+	}
+
+	segments.push_back ({ const_cast<char*> (data), size });  // NOLINT
+}
+
+void WritevSink::writeSegments()
+{
+	auto throwError = []
+	{ throw std::system_error { errno, std::generic_category(), "Could not write to file descriptor" }; };
+
+#if defined(_WIN32)
+	for (const auto& segment : segments)
+	{
+		const auto* data = static_cast<const char*> (segment.iov_base);
+		auto		size = segment.iov_len;
+
+		while (size > 0)
+		{
+			const auto numWritten = writeToFileDescriptor (fileDescriptor, data, size);
+
+			if (numWritten < 0)
+			{
+				segments.clear();
+				throwError();
+			}
+
+			data += numWritten;
+			size -= static_cast<std::size_t> (numWritten);
+		}
+	}
+#else
+	// a partial write adjusts the segments in place, but they're cleared afterwards anyway
+	auto* next		  = segments.data();
+	auto* const last  = next + segments.size();
+
+	while (next != last)
+	{
+		const auto numWritten = ::writev (fileDescriptor, next, static_cast<int> (last - next));
+
+		if (numWritten < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			segments.clear();
+			throwError();
+		}
+
+		// skip past everything that was written, which may end partway through a segment
+		auto remaining = static_cast<std::size_t> (numWritten);
+
+		while (next != last && remaining >= next->iov_len)
+		{
+			remaining -= next->iov_len;
+			++next;
+		}
+
+		if (next != last)
+		{
+			next->iov_base = static_cast<char*> (next->iov_base) + remaining;
+			next->iov_len -= remaining;
+		}
+	}
+#endif
+
+	segments.clear();
+}
+
+}  // namespace limes::serializing
@@ -0,0 +1,672 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "lserializing/lserializing_Packed.h"
+#include "lserializing/lserializing_KnownFormats.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include "lserializing_Varint.h"
+
+namespace limes::serializing
+{
+
+LSERIAL_NO_EXPORT static const KnownFormats::Register<PackedFormat> packed_init;
+
+PackedFormat::PackedFormat (const PackedParserLimits& limitsToUse) noexcept
+	: limits (limitsToUse)
+{
+}
+
+const PackedParserLimits& PackedFormat::getLimits() const noexcept
+{
+	return limits;
+}
+
+std::string_view PackedFormat::getName() const noexcept
+{
+	return formats::Packed;
+}
+
+bool PackedFormat::supportsComments() const noexcept
+{
+	return false;
+}
+
+const std::vector<std::string_view>& PackedFormat::getFileExtensions() const noexcept
+{
+	struct ExtensionsHolder final
+	{
+		std::vector<std::string_view> xtns;
+
+		ExtensionsHolder()
+		{
+			xtns.emplace_back (".lspk");
+		}
+	};
+
+	static const ExtensionsHolder holder;
+
+	return holder.xtns;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// The layout is the header followed by one value. Each value starts with a tag byte. A table is
+// a varint row count followed by each row's values in the order of its shape's keys; a shape is
+// a varint key count followed by the keys, in sorted order. All lengths and counts are varints.
+namespace packed
+{
+
+static constexpr auto header = std::string_view { "LSPK\x01", 5 };
+
+enum Tag : unsigned char
+{
+	nullTag = 0,
+	falseTag,
+	trueTag,
+	integerTag,	 // a zigzag-encoded varint
+	doubleTag,	 // 8 bytes, little-endian
+	stringTag,
+	arrayTag,
+	objectTag,
+	newShapeTableTag,  // a shape, which gets the next number, followed by a table
+	tableTag		   // the varint number of a shape that's already been written, followed by a table
+};
+
+static constexpr auto maxDepth = std::size_t { 512 };
+
+// integers beyond this can't all be represented by a double
+static constexpr auto maxInteger = 9007199254740992.;
+
+}  // namespace packed
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// Reports errors by recording them and returning false rather than by throwing, so that
+// PackedFormat::tryParse() can reject input without any stack unwinding.
+class LSERIAL_NO_EXPORT PackedParser final
+{
+public:
+	PackedParser (std::string_view input, const PackedParserLimits& parserLimits)
+		: limits (parserLimits), start (input.data()), current (input.data()), end (input.data() + input.size())
+	{
+	}
+
+	[[nodiscard]] inline bool parse (Node& result)
+	{
+		if (! std::string_view { start, static_cast<std::size_t> (end - start) }.starts_with (packed::header))
+			return fail ("Not a packed document", start);
+
+		current += packed::header.size();
+
+		if (! parseValue (result))
+			return false;
+
+		if (current != end)
+			return fail ("Unexpected data after the end of the document", current);
+
+		return true;
+	}
+
+	[[nodiscard]] ParseError getError() const
+	{
+		auto message = std::string { errorMessage };
+
+		message += " at byte ";
+		message += std::to_string (errorPos - start);
+
+		return ParseError { message, {} };
+	}
+
+private:
+	using Shape = std::vector<std::string>;
+
+	[[nodiscard]] inline bool fail (const char* message, const char* position)
+	{
+		errorMessage = message;
+		errorPos	 = position;
+		return false;
+	}
+
+	[[nodiscard]] inline std::size_t getNumBytesLeft() const noexcept
+	{
+		return static_cast<std::size_t> (end - current);
+	}
+
+	[[nodiscard]] inline bool readVarint (std::uint64_t& value)
+	{
+		switch (varint::read (current, end, value))
+		{
+			case (varint::ReadResult::ok) : return true;
+			case (varint::ReadResult::truncated) : return fail ("Unexpected end of data", end);
+			default : return fail ("Varint is too long", current);
+		}
+	}
+
+	// reads a count of things that each take at least minBytesEach bytes, so that absurd
+	// counts are rejected before anything is allocated for them
+	[[nodiscard]] inline bool readCount (std::size_t& count, std::size_t minBytesEach)
+	{
+		const auto* const countStart = current;
+
+		std::uint64_t value { 0 };
+
+		if (! readVarint (value))
+			return false;
+
+		if (value > getNumBytesLeft() / minBytesEach)
+			return fail ("Count is larger than the remaining data", countStart);
+
+		count = static_cast<std::size_t> (value);
+		return true;
+	}
+
+	[[nodiscard]] inline bool readString (std::string_view& string)
+	{
+		std::size_t length { 0 };
+
+		if (! readCount (length, 1))
+			return false;
+
+		string = std::string_view { current, length };
+		current += length;
+		return true;
+	}
+
+	[[nodiscard]] inline bool enterContainer (const char* position)
+	{
+		if (++depth > packed::maxDepth)
+			return fail ("Containers are nested too deeply", position);
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool parseArray (Node& result)
+	{
+		std::size_t size { 0 };
+
+		if (! readCount (size, 1))
+			return false;
+
+		result = Node { ObjectType::Array };
+
+		auto& array = result.getArray();
+
+		array.resize (size);
+
+		for (auto& element : array)
+			if (! parseValue (element))
+				return false;
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool parseObject (Node& result)
+	{
+		std::size_t size { 0 };
+
+		// each member takes at least a name length and a value
+		if (! readCount (size, 2))
+			return false;
+
+		result = Node { ObjectType::Object };
+
+		auto& obj = result.getObject();
+
+		for (auto i = 0UL; i < size; ++i)
+		{
+			const auto* const namePos = current;
+
+			std::string_view name;
+
+			if (! readString (name))
+				return false;
+
+			if (name.empty())
+				return fail ("Property names cannot be empty", namePos);
+
+			Node* value { nullptr };
+
+			// objects are written in sorted order, so each member usually goes at the end
+			if (obj.empty() || obj.rbegin()->first < name)
+			{
+				value = &obj.emplace_hint (obj.end(), name, Node {})->second;
+			}
+			else
+			{
+				auto [iterator, inserted] = obj.try_emplace (std::string { name });
+
+				if (! inserted)
+					return fail ("Duplicate keys in same object", namePos);
+
+				value = &iterator->second;
+			}
+
+			if (! parseValue (*value))
+				return false;
+		}
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool parseShape()
+	{
+		std::size_t numKeys { 0 };
+
+		if (! readCount (numKeys, 1))
+			return false;
+
+		if (numKeys == 0)
+			return fail ("A shape must have at least one key", current);
+
+		auto& shape = shapes.emplace_back();
+
+		shape.reserve (numKeys);
+
+		for (auto i = 0UL; i < numKeys; ++i)
+		{
+			const auto* const keyPos = current;
+
+			std::string_view key;
+
+			if (! readString (key))
+				return false;
+
+			// the rows are built by appending members in this order, so it must be the order an Object keeps
+			if (key.empty() || (! shape.empty() && key <= shape.back()))
+				return fail ("A shape's keys must be non-empty, unique and sorted", keyPos);
+
+			shape.emplace_back (key);
+		}
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool parseTable (const Shape& shape, Node& result)
+	{
+		std::size_t numRows { 0 };
+
+		const auto* const countPos = current;
+
+		// each row has a value for each key, and each value takes at least one byte
+		if (! readCount (numRows, shape.size()))
+			return false;
+
+		// the row count is bounded by the data, but each row copies every key, so the keys are too
+		auto shapeKeyBytes = std::size_t { 0 };
+
+		for (const auto& key : shape)
+			shapeKeyBytes += key.size();
+
+		if (numRows > (limits.maxTableKeyBytes - numKeyBytes) / shapeKeyBytes)
+			return fail ("Tables copy too many bytes of keys", countPos);
+
+		numKeyBytes += numRows * shapeKeyBytes;
+
+		result = Node { ObjectType::Array };
+
+		auto& rows = result.getArray();
+
+		rows.resize (numRows);
+
+		for (auto& row : rows)
+		{
+			row = Node { ObjectType::Object };
+
+			auto& obj = row.getObject();
+
+			for (const auto& key : shape)
+				if (! parseValue (obj.emplace_hint (obj.end(), key, Node {})->second))
+					return false;
+		}
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool parseValue (Node& result)
+	{
+		if (current == end)
+			return fail ("Unexpected end of data", end);
+
+		const auto* const tagPos = current;
+
+		switch (static_cast<unsigned char> (*current++))
+		{
+			case (packed::nullTag) : result = Node::createNull(); return true;
+			case (packed::falseTag) : result = Node::createBoolean (false); return true;
+			case (packed::trueTag) : result = Node::createBoolean (true); return true;
+
+			case (packed::integerTag) :
+			{
+				std::uint64_t zigzag { 0 };
+
+				if (! readVarint (zigzag))
+					return false;
+
+				result = Node::createNumber (static_cast<double> (static_cast<std::int64_t> ((zigzag >> 1U) ^ (0U - (zigzag & 1U)))));
+				return true;
+			}
+
+			case (packed::doubleTag) :
+			{
+				if (getNumBytesLeft() < 8)
+					return fail ("Unexpected end of data", end);
+
+				std::uint64_t bits { 0 };
+
+				for (auto i = 8; i > 0; --i)
+					bits = (bits << 8U) | static_cast<unsigned char> (current[i - 1]);
+
+				current += 8;
+
+				result = Node::createNumber (std::bit_cast<double> (bits));
+				return true;
+			}
+
+			case (packed::stringTag) :
+			{
+				std::string_view string;
+
+				if (! readString (string))
+					return false;
+
+				result = Node::createString (string);
+				return true;
+			}
+
+			default : break;
+		}
+
+		if (! enterContainer (tagPos))
+			return false;
+
+		switch (static_cast<unsigned char> (*tagPos))
+		{
+			case (packed::arrayTag) :
+				if (! parseArray (result))
+					return false;
+
+				break;
+
+			case (packed::objectTag) :
+				if (! parseObject (result))
+					return false;
+
+				break;
+
+			case (packed::newShapeTableTag) :
+				// shapes is a deque, so this reference stays valid while nested tables add more shapes
+				if (! parseShape() || ! parseTable (shapes.back(), result))
+					return false;
+
+				break;
+
+			case (packed::tableTag) :
+			{
+				const auto* const numberPos = current;
+
+				std::uint64_t shapeNumber { 0 };
+
+				if (! readVarint (shapeNumber))
+					return false;
+
+				if (shapeNumber >= shapes.size())
+					return fail ("Table refers to a shape that hasn't been defined", numberPos);
+
+				if (! parseTable (shapes[static_cast<std::size_t> (shapeNumber)], result))
+					return false;
+
+				break;
+			}
+
+			default : return fail ("Unknown tag", tagPos);
+		}
+
+		--depth;
+		return true;
+	}
+
+	const PackedParserLimits& limits;
+
+	const char* const start;
+	const char*		  current;
+	const char* const end;
+
+	std::size_t depth { 0 };
+
+	std::deque<Shape> shapes;
+
+	// the bytes of keys copied into table rows so far
+	std::size_t numKeyBytes { 0 };
+
+	const char* errorMessage { "" };
+	const char* errorPos { nullptr };
+};
+
+Node PackedFormat::parse (std::string_view string) const
+{
+	return tryParse (string).getNode();
+}
+
+ParseResult PackedFormat::tryParse (std::string_view string) const
+{
+	PackedParser p { string, limits };
+
+	if (Node result; p.parse (result))
+		return result;
+
+	return p.getError();
+}
+
+bool PackedFormat::probablyMatchesString (std::string_view string) const noexcept
+{
+	return string.starts_with (packed::header);
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// This overrides print() rather than using the base class's traversal, because the shapes that
+// have been written are numbered from the start of each document.
+class LSERIAL_NO_EXPORT PackedPrinter final : public Printer
+{
+public:
+	using Printer::print;
+
+	void print (const Node& node, OutputSink& sink) final
+	{
+		shapes.clear();
+
+		sink.write (packed::header);
+
+		printValue (node, sink);
+	}
+
+private:
+	static void printTagAndVarint (packed::Tag tag, std::uint64_t value, OutputSink& sink)
+	{
+		char bytes[1 + varint::maxSize];
+
+		bytes[0] = static_cast<char> (tag);
+
+		sink.write (std::string_view { bytes, 1 + varint::store (value, bytes + 1) });
+	}
+
+	static void printVarint (std::uint64_t value, OutputSink& sink)
+	{
+		char bytes[varint::maxSize];
+
+		sink.write (std::string_view { bytes, varint::store (value, bytes) });
+	}
+
+	static void printStringContent (std::string_view string, OutputSink& sink)
+	{
+		printVarint (string.size(), sink);
+
+		sink.writeReferenced (string);
+	}
+
+	void printValue (const Node& node, OutputSink& sink)
+	{
+		if (node.isNull())
+			printNull (sink);
+		else if (node.isBoolean())
+			printBoolean (node.getBoolean(), sink);
+		else if (node.isNumber())
+			printNumber (node.getNumber(), sink);
+		else if (node.isString())
+			printString (node.getString(), sink);
+		else if (node.isArray())
+			printArray (node.getArray(), sink);
+		else
+			printObject (node.getObject(), sink);
+	}
+
+	void printNull (OutputSink& sink) final
+	{
+		sink.write (static_cast<char> (packed::nullTag));
+	}
+
+	void printBoolean (bool boolean, OutputSink& sink) final
+	{
+		sink.write (static_cast<char> (boolean ? packed::trueTag : packed::falseTag));
+	}
+
+	void printNumber (double number, OutputSink& sink) final
+	{
+		if (std::trunc (number) == number && std::fabs (number) <= packed::maxInteger && ! (number == 0. && std::signbit (number)))
+		{
+			const auto integer = static_cast<std::int64_t> (number);
+
+			printTagAndVarint (packed::integerTag, (static_cast<std::uint64_t> (integer) << 1U) ^ static_cast<std::uint64_t> (integer >> 63), sink);
+			return;
+		}
+
+		const auto bits = std::bit_cast<std::uint64_t> (number);
+
+		char bytes[9];
+
+		bytes[0] = static_cast<char> (packed::doubleTag);
+
+		for (auto i = 0UL; i < 8UL; ++i)
+			bytes[1 + i] = static_cast<char> (static_cast<unsigned char> (bits >> (i * 8UL)));
+
+		sink.write (std::string_view { bytes, 9 });
+	}
+
+	void printString (std::string_view string, OutputSink& sink) final
+	{
+		sink.write (static_cast<char> (packed::stringTag));
+		printStringContent (string, sink);
+	}
+
+	[[nodiscard]] static bool isTable (const Array& array)
+	{
+		if (array.size() < 2 || ! array.front().isObject() || array.front().getObject().empty())
+			return false;
+
+		const auto& first = array.front().getObject();
+
+		return std::all_of (array.begin() + 1, array.end(), [&first] (const Node& element)
+							{
+								if (! element.isObject())
+									return false;
+
+								const auto& obj = element.getObject();
+
+								return obj.size() == first.size()
+									&& std::equal (obj.begin(), obj.end(), first.begin(), [] (const auto& a, const auto& b)
+												   { return a.first == b.first; });
+							});
+	}
+
+	void printTable (const Array& rows, OutputSink& sink)
+	{
+		const auto& first = rows.front().getObject();
+
+		// the shape's encoding identifies it, so it's used as the key for finding shapes that have already been written
+		std::string shape;
+
+		char bytes[varint::maxSize];
+
+		shape.append (bytes, varint::store (first.size(), bytes));
+
+		for (const auto& [key, value] : first)
+		{
+			shape.append (bytes, varint::store (key.size(), bytes));
+			shape += key;
+		}
+
+		const auto [iterator, isNew] = shapes.try_emplace (std::move (shape), shapes.size());
+
+		if (isNew)
+		{
+			sink.write (static_cast<char> (packed::newShapeTableTag));
+			sink.write (iterator->first);
+		}
+		else
+		{
+			printTagAndVarint (packed::tableTag, iterator->second, sink);
+		}
+
+		printVarint (rows.size(), sink);
+
+		for (const auto& row : rows)
+			for (const auto& [key, value] : row.getObject())
+				printValue (value, sink);
+	}
+
+	void printArray (const Array& array, OutputSink& sink) final
+	{
+		if (isTable (array))
+		{
+			printTable (array, sink);
+			return;
+		}
+
+		printTagAndVarint (packed::arrayTag, array.size(), sink);
+
+		for (const auto& element : array)
+			printValue (element, sink);
+	}
+
+	void printObject (const Object& object, OutputSink& sink) final
+	{
+		printTagAndVarint (packed::objectTag, object.size(), sink);
+
+		for (const auto& [name, value] : object)
+		{
+			printStringContent (name, sink);
+			printValue (value, sink);
+		}
+	}
+
+	std::unordered_map<std::string, std::size_t> shapes;
+};
+
+std::unique_ptr<Printer> PackedFormat::createPrinter ([[maybe_unused]] bool shouldPrettyPrint) const noexcept
+{
+	return std::make_unique<PackedPrinter>();
+}
+
+}  // namespace limes::serializing
@@ -12,45 +12,64 @@
  * ======================================================================================
  */
 
-#include <sstream>
+#include <cstddef>
+#include <string>
+#include <utility>
 #include "lserializing/lserializing_Printer.h"
 #include "lserializing/lserializing_Node.h"
+#include "lserializing/lserializing_OutputSink.h"
 
 namespace limes::serializing
 {
 
-std::string Printer::print (const Node& node)
+void Printer::print (const Node& node, OutputSink& sink)
 {
 	if (node.isNull())
-		return printNull();
+		return printNull (sink);
 
 	if (node.isNumber())
-		return printNumber (node.getNumber());
+		return printNumber (node.getNumber(), sink);
 
 	if (node.isString())
-		return printString (node.getString());
+		return printString (node.getString(), sink);
 
 	if (node.isBoolean())
-		return printBoolean (node.getBoolean());
+		return printBoolean (node.getBoolean(), sink);
 
 	if (node.isArray())
 	{
 		arrayBegin();
 
-		const auto str = printArray (node.getArray());
+		printArray (node.getArray(), sink);
 
 		arrayEnd();
 
-		return str;
+		return;
 	}
 
 	objectBegin();
 
-	const auto str = printObject (node.getObject());
+	printObject (node.getObject(), sink);
 
 	objectEnd();
+}
+
+std::string Printer::print (const Node& node)
+{
+	StringSink sink;
+
+	print (node, sink);
+
+	return std::move (sink.getString());
+}
+
+std::size_t Printer::measure (const Node& node)
+{
+	CountingSink sink;
+
+	print (node, sink);
 
-	return str;
+	return sink.getNumBytesWritten();
 }
 
 }  // namespace limes::serializing
@@ -0,0 +1,1111 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "lserializing/lserializing_Protobuf.h"
+#include "lserializing/lserializing_KnownFormats.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include "lserializing_Varint.h"
+
+namespace limes::serializing
+{
+
+ProtobufDescriptorError::ProtobufDescriptorError (const std::string& message)
+	: std::runtime_error (message)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// The compiled form of a descriptor. See https://protobuf.dev/programming-guides/encoding/ for
+// the wire format.
+namespace protobuf
+{
+
+enum class FieldType : unsigned char
+{
+	Double,
+	Float,
+	Int32,
+	Int64,
+	UInt32,
+	UInt64,
+	SInt32,
+	SInt64,
+	Fixed32,
+	Fixed64,
+	SFixed32,
+	SFixed64,
+	Bool,
+	String,
+	Bytes,
+	Message
+};
+
+enum WireType : unsigned char
+{
+	varint = 0,
+	i64,
+	len,
+	startGroup,
+	endGroup,
+	i32
+};
+
+static constexpr auto maxFieldNumber = std::uint64_t { (1U << 29U) - 1U };
+
+// field numbers up to this are looked up in a table indexed by number; larger ones are found
+// by binary search
+static constexpr auto maxTableFieldNumber = std::uint32_t { 1024 };
+
+static constexpr auto maxDepth = std::size_t { 100 };
+
+static constexpr std::pair<std::string_view, FieldType> typeNames[] = {
+	{ "double", FieldType::Double },
+	{ "float", FieldType::Float },
+	{ "int32", FieldType::Int32 },
+	{ "int64", FieldType::Int64 },
+	{ "uint32", FieldType::UInt32 },
+	{ "uint64", FieldType::UInt64 },
+	{ "sint32", FieldType::SInt32 },
+	{ "sint64", FieldType::SInt64 },
+	{ "fixed32", FieldType::Fixed32 },
+	{ "fixed64", FieldType::Fixed64 },
+	{ "sfixed32", FieldType::SFixed32 },
+	{ "sfixed64", FieldType::SFixed64 },
+	{ "bool", FieldType::Bool },
+	{ "enum", FieldType::Int32 },
+	{ "string", FieldType::String },
+	{ "bytes", FieldType::Bytes },
+	{ "message", FieldType::Message }
+};
+
+[[nodiscard]] static constexpr WireType getWireType (FieldType type) noexcept
+{
+	switch (type)
+	{
+		case (FieldType::Double) : [[fallthrough]];
+		case (FieldType::Fixed64) : [[fallthrough]];
+		case (FieldType::SFixed64) : return i64;
+		case (FieldType::Float) : [[fallthrough]];
+		case (FieldType::Fixed32) : [[fallthrough]];
+		case (FieldType::SFixed32) : return i32;
+		case (FieldType::String) : [[fallthrough]];
+		case (FieldType::Bytes) : [[fallthrough]];
+		case (FieldType::Message) : return len;
+		default : return varint;
+	}
+}
+
+[[nodiscard]] static constexpr bool isPackable (FieldType type) noexcept
+{
+	return getWireType (type) != len;
+}
+
+struct Field final
+{
+	std::string name;
+
+	std::uint32_t number { 0 };
+
+	FieldType type { FieldType::Int32 };
+
+	WireType wireType { varint };
+
+	bool repeated { false }, packed { false };
+
+	// for message fields, the index of the field's message type in Descriptor::messages
+	std::size_t message { 0 };
+};
+
+struct Message final
+{
+	std::string name;
+
+	// sorted by number
+	std::vector<Field> fields;
+
+	// fieldIndices[number] is 1 + the index in fields of the field with that number, or 0
+	std::vector<std::uint32_t> fieldIndices;
+
+	// the indices in fields of the fields, sorted by name, which is the order of an Object's members
+	std::vector<std::uint32_t> fieldsByName;
+
+	[[nodiscard]] const Field* findField (std::uint32_t number) const noexcept
+	{
+		if (number < fieldIndices.size())
+		{
+			const auto index = fieldIndices[number];
+
+			return index == 0 ? nullptr : &fields[index - 1];
+		}
+
+		const auto field = std::lower_bound (fields.begin(), fields.end(), number,
+											 [] (const Field& f, std::uint32_t n)
+											 { return f.number < n; });
+
+		if (field == fields.end() || field->number != number)
+			return nullptr;
+
+		return &(*field);
+	}
+};
+
+struct Descriptor final
+{
+	std::vector<Message> messages;
+
+	std::size_t root { 0 };
+};
+
+[[noreturn]] static void throwDescriptorError (const std::string& message)
+{
+	throw ProtobufDescriptorError { "Protobuf descriptor: " + message };
+}
+
+[[nodiscard]] static const Node& getProperty (const Object& properties, const std::string& name, bool (Node::*check)() const,
+											  const std::string& where)
+{
+	const auto property = properties.find (name);
+
+	if (property == properties.end() || ! (property->second.*check)())
+		throwDescriptorError (where + " needs a valid \"" + name + "\" property");
+
+	return property->second;
+}
+
+[[nodiscard]] static bool getFlag (const Object& properties, const std::string& name, bool defaultValue, const std::string& where)
+{
+	if (! properties.contains (name))
+		return defaultValue;
+
+	return getProperty (properties, name, &Node::isBoolean, where).getBoolean();
+}
+
+static void compileField (Field& field, const Object& properties, const Object& messages, const std::string& where)
+{
+	const auto number = getProperty (properties, "number", &Node::isNumber, where).getNumber();
+
+	if (number < 1. || number > static_cast<double> (maxFieldNumber) || std::trunc (number) != number)
+		throwDescriptorError (where + " has an invalid number");
+
+	field.number = static_cast<std::uint32_t> (number);
+
+	const auto typeName = getProperty (properties, "type", &Node::isString, where).getString();
+
+	const auto type = std::find_if (std::begin (typeNames), std::end (typeNames),
+									[&typeName] (const auto& pair)
+									{ return pair.first == typeName; });
+
+	if (type == std::end (typeNames))
+		throwDescriptorError (where + " has an unknown type '" + std::string { typeName } + "'");
+
+	field.type	   = type->second;
+	field.wireType = getWireType (field.type);
+	field.repeated = getFlag (properties, "repeated", false, where);
+	field.packed   = field.repeated && isPackable (field.type) && getFlag (properties, "packed", true, where);
+
+	if (field.type != FieldType::Message)
+		return;
+
+	const auto messageName = std::string { getProperty (properties, "message", &Node::isString, where).getString() };
+
+	const auto message = messages.find (messageName);
+
+	if (message == messages.end())
+		throwDescriptorError (where + " refers to an unknown message '" + messageName + "'");
+
+	// an Object is sorted by name, so each message's index is its position in the Object
+	field.message = static_cast<std::size_t> (std::distance (messages.begin(), message));
+}
+
+[[nodiscard]] static std::shared_ptr<const Descriptor> compileDescriptor (const Node& node)
+{
+	if (! node.isObject())
+		throwDescriptorError ("must be an Object");
+
+	const auto& properties = node.getObject();
+
+	const auto& messages = getProperty (properties, "messages", &Node::isObject, "the descriptor").getObject();
+
+	auto descriptor = std::make_shared<Descriptor>();
+
+	descriptor->messages.reserve (messages.size());
+
+	for (const auto& [messageName, fields] : messages)
+	{
+		if (! fields.isObject())
+			throwDescriptorError ("message '" + messageName + "' must be an Object");
+
+		auto& message = descriptor->messages.emplace_back();
+
+		message.name = messageName;
+
+		for (const auto& [fieldName, field] : fields.getObject())
+		{
+			const auto where = "field '" + messageName + "." + fieldName + "'";
+
+			if (! field.isObject())
+				throwDescriptorError (where + " must be an Object");
+
+			auto& compiled = message.fields.emplace_back();
+
+			compiled.name = fieldName;
+
+			compileField (compiled, field.getObject(), messages, where);
+		}
+
+		std::sort (message.fields.begin(), message.fields.end(),
+				   [] (const Field& a, const Field& b)
+				   { return a.number < b.number; });
+
+		const auto duplicate = std::adjacent_find (message.fields.begin(), message.fields.end(),
+												   [] (const Field& a, const Field& b)
+												   { return a.number == b.number; });
+
+		if (duplicate != message.fields.end())
+			throwDescriptorError ("message '" + messageName + "' has two fields numbered " + std::to_string (duplicate->number));
+
+		message.fieldsByName.resize (message.fields.size());
+
+		for (auto i = 0UL; i < message.fields.size(); ++i)
+			message.fieldsByName[i] = static_cast<std::uint32_t> (i);
+
+		std::sort (message.fieldsByName.begin(), message.fieldsByName.end(),
+				   [&message] (std::uint32_t a, std::uint32_t b)
+				   { return message.fields[a].name < message.fields[b].name; });
+
+		if (message.fields.empty())
+			continue;
+
+		message.fieldIndices.resize (std::min (message.fields.back().number, maxTableFieldNumber) + 1);
+
+		for (auto i = 0UL; i < message.fields.size() && message.fields[i].number < message.fieldIndices.size(); ++i)
+			message.fieldIndices[message.fields[i].number] = static_cast<std::uint32_t> (i + 1);
+	}
+
+	const auto rootName = std::string { getProperty (properties, "root", &Node::isString, "the descriptor").getString() };
+
+	const auto root = messages.find (rootName);
+
+	if (root == messages.end())
+		throwDescriptorError ("the root message '" + rootName + "' isn't defined");
+
+	descriptor->root = static_cast<std::size_t> (std::distance (messages.begin(), root));
+
+	return descriptor;
+}
+
+[[nodiscard]] static inline std::uint64_t loadLittleEndian (const char* data, std::size_t numBytes) noexcept
+{
+	std::uint64_t value { 0 };
+
+	for (auto i = numBytes; i > 0; --i)
+		value = (value << 8U) | static_cast<unsigned char> (data[i - 1]);
+
+	return value;
+}
+
+}  // namespace protobuf
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+ProtobufFormat::ProtobufFormat (const Node& descriptorNode)
+	: descriptor (protobuf::compileDescriptor (descriptorNode))
+{
+}
+
+std::string_view ProtobufFormat::getName() const noexcept
+{
+	return formats::Protobuf;
+}
+
+bool ProtobufFormat::supportsComments() const noexcept
+{
+	return false;
+}
+
+const std::vector<std::string_view>& ProtobufFormat::getFileExtensions() const noexcept
+{
+	struct ExtensionsHolder final
+	{
+		std::vector<std::string_view> xtns;
+
+		ExtensionsHolder()
+		{
+			xtns.emplace_back (".pb");
+			xtns.emplace_back (".binpb");
+		}
+	};
+
+	static const ExtensionsHolder holder;
+
+	return holder.xtns;
+}
+
+bool ProtobufFormat::probablyMatchesString ([[maybe_unused]] std::string_view string) const noexcept
+{
+	return false;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// Reports errors by recording them and returning false rather than by throwing, so that
+// ProtobufFormat::tryParse() can reject input without any stack unwinding.
+class LSERIAL_NO_EXPORT ProtobufParser final
+{
+public:
+	ProtobufParser (const protobuf::Descriptor& descriptorToUse, std::string_view input)
+		: descriptor (descriptorToUse), start (input.data()), current (input.data()), end (input.data() + input.size())
+	{
+	}
+
+	[[nodiscard]] inline bool parse (Node& result)
+	{
+		result = Node { ObjectType::Object };
+
+		return parseMessage (descriptor.messages[descriptor.root], end, result.getObject());
+	}
+
+	[[nodiscard]] ParseError getError() const
+	{
+		auto message = std::string { errorMessage };
+
+		message += " at byte ";
+		message += std::to_string (errorPos - start);
+
+		return ParseError { message, {} };
+	}
+
+private:
+	using FieldType = protobuf::FieldType;
+
+	[[nodiscard]] inline bool fail (const char* message, const char* position)
+	{
+		errorMessage = message;
+		errorPos	 = position;
+		return false;
+	}
+
+	[[nodiscard]] inline bool readVarint (std::uint64_t& value, const char* limit)
+	{
+		switch (varint::read (current, limit, value))
+		{
+			case (varint::ReadResult::ok) : return true;
+			case (varint::ReadResult::truncated) : return fail ("Unexpected end of data", current);
+			default : return fail ("Varint is too long", current);
+		}
+	}
+
+	[[nodiscard]] inline bool readFixed (std::uint64_t& value, std::size_t numBytes, const char* limit)
+	{
+		if (static_cast<std::size_t> (limit - current) < numBytes)
+			return fail ("Unexpected end of data", limit);
+
+		value = protobuf::loadLittleEndian (current, numBytes);
+		current += numBytes;
+		return true;
+	}
+
+	[[nodiscard]] inline bool readLength (const char*& payloadEnd, const char* limit)
+	{
+		std::uint64_t length { 0 };
+
+		if (! readVarint (length, limit))
+			return false;
+
+		if (length > static_cast<std::uint64_t> (limit - current))
+			return fail ("Length is longer than the remaining data", current);
+
+		payloadEnd = current + length;
+		return true;
+	}
+
+	[[nodiscard]] inline bool skipField (protobuf::WireType wireType, const char* limit, const char* fieldStart)
+	{
+		std::uint64_t value { 0 };
+
+		switch (wireType)
+		{
+			case (protobuf::varint) : return readVarint (value, limit);
+			case (protobuf::i64) : return readFixed (value, 8, limit);
+			case (protobuf::i32) : return readFixed (value, 4, limit);
+
+			case (protobuf::len) :
+			{
+				const char* payloadEnd { nullptr };
+
+				if (! readLength (payloadEnd, limit))
+					return false;
+
+				current = payloadEnd;
+				return true;
+			}
+
+			case (protobuf::startGroup) : [[fallthrough]];
+			case (protobuf::endGroup) : return fail ("Groups are not supported", fieldStart);
+			default : return fail ("Invalid wire type", fieldStart);
+		}
+	}
+
+	[[nodiscard]] static inline Node makeVarintNode (FieldType type, std::uint64_t value)
+	{
+		switch (type)
+		{
+			case (FieldType::Bool) : return Node::createBoolean (value != 0);
+
+			// negative int32s are sign-extended to 64 bits, so only the low 32 bits are meaningful
+			case (FieldType::Int32) :
+				return Node::createNumber (static_cast<double> (static_cast<std::int32_t> (static_cast<std::uint32_t> (value))));
+
+			case (FieldType::Int64) : return Node::createNumber (static_cast<double> (static_cast<std::int64_t> (value)));
+			case (FieldType::UInt32) : return Node::createNumber (static_cast<double> (static_cast<std::uint32_t> (value)));
+
+			case (FieldType::SInt32) :
+			{
+				const auto zigzag = static_cast<std::uint32_t> (value);
+				return Node::createNumber (static_cast<double> (static_cast<std::int32_t> ((zigzag >> 1U) ^ (0U - (zigzag & 1U)))));
+			}
+
+			case (FieldType::SInt64) :
+				return Node::createNumber (static_cast<double> (static_cast<std::int64_t> ((value >> 1U) ^ (0U - (value & 1U)))));
+
+			default : return Node::createNumber (static_cast<double> (value));
+		}
+	}
+
+	[[nodiscard]] static inline Node makeFixedNode (FieldType type, std::uint64_t value)
+	{
+		switch (type)
+		{
+			case (FieldType::Fixed32) : return Node::createNumber (static_cast<double> (static_cast<std::uint32_t> (value)));
+			case (FieldType::SFixed32) : return Node::createNumber (static_cast<double> (static_cast<std::int32_t> (static_cast<std::uint32_t> (value))));
+			case (FieldType::Float) : return Node::createNumber (static_cast<double> (std::bit_cast<float> (static_cast<std::uint32_t> (value))));
+			case (FieldType::SFixed64) : return Node::createNumber (static_cast<double> (static_cast<std::int64_t> (value)));
+			case (FieldType::Double) : return Node::createNumber (std::bit_cast<double> (value));
+			default : return Node::createNumber (static_cast<double> (value));
+		}
+	}
+
+	// reads one value of the field, whose wire type has already been checked
+	[[nodiscard]] inline bool parseValue (const protobuf::Field& field, const char* limit, Node& result, const char* fieldStart)
+	{
+		std::uint64_t value { 0 };
+
+		switch (field.wireType)
+		{
+			case (protobuf::varint) :
+				if (! readVarint (value, limit))
+					return false;
+
+				result = makeVarintNode (field.type, value);
+				return true;
+
+			case (protobuf::i64) : [[fallthrough]];
+			case (protobuf::i32) :
+				if (! readFixed (value, field.wireType == protobuf::i64 ? 8 : 4, limit))
+					return false;
+
+				result = makeFixedNode (field.type, value);
+				return true;
+
+			default : break;
+		}
+
+		const char* payloadEnd { nullptr };
+
+		if (! readLength (payloadEnd, limit))
+			return false;
+
+		if (field.type != FieldType::Message)
+		{
+			result	= Node::createString (std::string_view { current, static_cast<std::size_t> (payloadEnd - current) });
+			current = payloadEnd;
+			return true;
+		}
+
+		if (++depth > protobuf::maxDepth)
+			return fail ("Messages are nested too deeply", fieldStart);
+
+		// a singular message field that appears more than once is merged, as protobuf does
+		if (! result.isObject())
+			result = Node { ObjectType::Object };
+
+		if (! parseMessage (descriptor.messages[field.message], payloadEnd, result.getObject()))
+			return false;
+
+		--depth;
+		return true;
+	}
+
+	// reads all the values in a packed repeated field at once
+	[[nodiscard]] inline bool parsePacked (const protobuf::Field& field, const char* limit, Array& array, const char* fieldStart)
+	{
+		const char* payloadEnd { nullptr };
+
+		if (! readLength (payloadEnd, limit))
+			return false;
+
+		const auto payloadSize = static_cast<std::size_t> (payloadEnd - current);
+		const auto first	   = array.size();
+
+		if (field.wireType == protobuf::varint)
+		{
+			// each varint ends with the only one of its bytes that has the top bit clear
+			const auto numValues = static_cast<std::size_t> (std::count_if (current, payloadEnd, [] (char c)
+																			  { return (static_cast<unsigned char> (c) & 0x80U) == 0; }));
+
+			if (payloadSize > 0 && (static_cast<unsigned char> (payloadEnd[-1]) & 0x80U) != 0)
+				return fail ("Unexpected end of data", payloadEnd);
+
+			array.resize (first + numValues);
+
+			for (auto i = first; i < array.size(); ++i)
+			{
+				std::uint64_t value { 0 };
+
+				if (! readVarint (value, payloadEnd))
+					return false;
+
+				array[i] = makeVarintNode (field.type, value);
+			}
+
+			return true;
+		}
+
+		const auto elementSize = field.wireType == protobuf::i64 ? std::size_t { 8 } : std::size_t { 4 };
+
+		if (payloadSize % elementSize != 0)
+			return fail ("Packed field's length is not a multiple of its element size", fieldStart);
+
+		array.resize (first + payloadSize / elementSize);
+
+		for (auto i = first; i < array.size(); ++i, current += elementSize)
+			array[i] = makeFixedNode (field.type, protobuf::loadLittleEndian (current, elementSize));
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool parseMessage (const protobuf::Message& message, const char* limit, Object& obj)
+	{
+		while (current < limit)
+		{
+			const auto* const fieldStart = current;
+
+			std::uint64_t key { 0 };
+
+			if (! readVarint (key, limit))
+				return false;
+
+			const auto number	= key >> 3U;
+			const auto wireType = static_cast<protobuf::WireType> (key & 7U);
+
+			if (number == 0 || number > protobuf::maxFieldNumber)
+				return fail ("Invalid field number", fieldStart);
+
+			const auto* const field = message.findField (static_cast<std::uint32_t> (number));
+
+			if (field == nullptr)
+			{
+				if (! skipField (wireType, limit, fieldStart))
+					return false;
+
+				continue;
+			}
+
+			auto& value = obj[field->name];
+
+			if (! field->repeated)
+			{
+				if (wireType != field->wireType)
+					return fail ("Wrong wire type for field", fieldStart);
+
+				if (! parseValue (*field, limit, value, fieldStart))
+					return false;
+
+				continue;
+			}
+
+			if (! value.isArray())
+				value = Node { ObjectType::Array };
+
+			// parsers must accept both packed and unpacked encodings of repeated numeric fields
+			if (wireType == protobuf::len && protobuf::isPackable (field->type))
+			{
+				if (! parsePacked (*field, limit, value.getArray(), fieldStart))
+					return false;
+
+				continue;
+			}
+
+			if (wireType != field->wireType)
+				return fail ("Wrong wire type for field", fieldStart);
+
+			if (! parseValue (*field, limit, value.getArray().emplace_back(), fieldStart))
+				return false;
+		}
+
+		return true;
+	}
+
+	const protobuf::Descriptor& descriptor;
+
+	const char* const start;
+	const char*		  current;
+	const char* const end;
+
+	std::size_t depth { 0 };
+
+	const char* errorMessage { "" };
+	const char* errorPos { nullptr };
+};
+
+Node ProtobufFormat::parse (std::string_view string) const
+{
+	return tryParse (string).getNode();
+}
+
+ParseResult ProtobufFormat::tryParse (std::string_view string) const
+{
+	ProtobufParser p { *descriptor, string };
+
+	if (Node result; p.parse (result))
+		return result;
+
+	return p.getError();
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+// This overrides print() rather than using the base class's traversal, because the fields are
+// driven by the descriptor, and because each embedded message and packed field is prefixed by
+// its length. The first pass measures all of the lengths and matches each message's members to
+// its fields, checking that the Node fits the descriptor before anything is written; it stores
+// both in the order the second pass needs them.
+class LSERIAL_NO_EXPORT ProtobufPrinter final : public Printer
+{
+public:
+	using Printer::print;
+
+	explicit ProtobufPrinter (std::shared_ptr<const protobuf::Descriptor> descriptorToUse)
+		: descriptor (std::move (descriptorToUse))
+	{
+	}
+
+	void print (const Node& node, OutputSink& sink) final
+	{
+		const auto& message = descriptor->messages[descriptor->root];
+
+		if (! node.isObject())
+			throw std::runtime_error { "Protobuf message '" + message.name + "' must be an Object" };
+
+		sizes.clear();
+		members.clear();
+
+		sink.reserve (measureMessage (message, node.getObject()));
+
+		nextSize   = 0;
+		nextMember = 0;
+
+		printMessage (message, sink);
+	}
+
+private:
+	using FieldType = protobuf::FieldType;
+
+	[[noreturn]] static void throwFieldError (const protobuf::Message& message, const protobuf::Field& field, const char* expected)
+	{
+		throw std::runtime_error { "Protobuf field '" + message.name + "." + field.name + "' must be " + expected };
+	}
+
+	[[nodiscard]] static double getInteger (const protobuf::Message& message, const protobuf::Field& field, const Node& node,
+											double min, double maxExclusive)
+	{
+		if (node.isNumber())
+			if (const auto number = node.getNumber(); std::trunc (number) == number && number >= min && number < maxExclusive)
+				return number;
+
+		throwFieldError (message, field, "an integer within the range of its type");
+	}
+
+	[[nodiscard]] static std::uint64_t toVarint (const protobuf::Message& message, const protobuf::Field& field, const Node& node)
+	{
+		constexpr auto twoTo31 = 2147483648., twoTo32 = 4294967296., twoTo63 = 9223372036854775808., twoTo64 = 18446744073709551616.;
+
+		switch (field.type)
+		{
+			case (FieldType::Bool) :
+				if (! node.isBoolean())
+					throwFieldError (message, field, "a Boolean");
+
+				return node.getBoolean() ? 1 : 0;
+
+			case (FieldType::Int32) :
+				return static_cast<std::uint64_t> (static_cast<std::int64_t> (getInteger (message, field, node, -twoTo31, twoTo31)));
+
+			case (FieldType::Int64) :
+				return static_cast<std::uint64_t> (static_cast<std::int64_t> (getInteger (message, field, node, -twoTo63, twoTo63)));
+
+			case (FieldType::UInt32) : return static_cast<std::uint64_t> (getInteger (message, field, node, 0., twoTo32));
+
+			case (FieldType::SInt32) :
+			{
+				const auto value = static_cast<std::int32_t> (getInteger (message, field, node, -twoTo31, twoTo31));
+				return (static_cast<std::uint32_t> (value) << 1U) ^ static_cast<std::uint32_t> (value >> 31);
+			}
+
+			case (FieldType::SInt64) :
+			{
+				const auto value = static_cast<std::int64_t> (getInteger (message, field, node, -twoTo63, twoTo63));
+				return (static_cast<std::uint64_t> (value) << 1U) ^ static_cast<std::uint64_t> (value >> 63);
+			}
+
+			default : return static_cast<std::uint64_t> (getInteger (message, field, node, 0., twoTo64));
+		}
+	}
+
+	[[nodiscard]] static std::uint64_t toFixed (const protobuf::Message& message, const protobuf::Field& field, const Node& node)
+	{
+		constexpr auto twoTo31 = 2147483648., twoTo32 = 4294967296., twoTo63 = 9223372036854775808., twoTo64 = 18446744073709551616.;
+
+		switch (field.type)
+		{
+			case (FieldType::Fixed32) : return static_cast<std::uint64_t> (getInteger (message, field, node, 0., twoTo32));
+
+			case (FieldType::SFixed32) :
+				return static_cast<std::uint32_t> (static_cast<std::int32_t> (getInteger (message, field, node, -twoTo31, twoTo31)));
+
+			case (FieldType::Fixed64) : return static_cast<std::uint64_t> (getInteger (message, field, node, 0., twoTo64));
+
+			case (FieldType::SFixed64) :
+				return static_cast<std::uint64_t> (static_cast<std::int64_t> (getInteger (message, field, node, -twoTo63, twoTo63)));
+
+			default : break;
+		}
+
+		if (! node.isNumber())
+			throwFieldError (message, field, "a Number");
+
+		const auto number = node.getNumber();
+
+		if (field.type == FieldType::Double)
+			return std::bit_cast<std::uint64_t> (number);
+
+		// converting a finite double that's out of float's range is undefined
+		if (std::isfinite (number) && std::fabs (number) > static_cast<double> (std::numeric_limits<float>::max()))
+			throwFieldError (message, field, "within the range of a float");
+
+		return std::bit_cast<std::uint32_t> (static_cast<float> (number));
+	}
+
+	[[nodiscard]] static std::uint64_t makeKey (std::uint32_t number, protobuf::WireType wireType) noexcept
+	{
+		return (std::uint64_t { number } << 3U) | wireType;
+	}
+
+	std::size_t measureMessage (const protobuf::Message& message, const Object& obj)
+	{
+		const auto slot = sizes.size();
+
+		sizes.push_back (0);
+
+		// members[firstMember + i] is the value of fields[i], or nullptr if it isn't written.
+		// Both the members and fieldsByName are sorted by name, so they're matched in one pass.
+		const auto firstMember = members.size();
+
+		members.resize (firstMember + message.fields.size(), nullptr);
+
+		auto fieldByName = message.fieldsByName.begin();
+
+		for (const auto& [name, value] : obj)
+		{
+			while (fieldByName != message.fieldsByName.end() && message.fields[*fieldByName].name < name)
+				++fieldByName;
+
+			if (fieldByName == message.fieldsByName.end() || message.fields[*fieldByName].name != name)
+				throw std::runtime_error { "'" + name + "' is not a field of Protobuf message '" + message.name + "'" };
+
+			if (! value.isNull())
+				members[firstMember + *fieldByName] = &value;
+		}
+
+		std::size_t size { 0 };
+
+		for (auto i = 0UL; i < message.fields.size(); ++i)
+			if (const auto* const value = members[firstMember + i])
+				size += measureField (message, message.fields[i], *value);
+
+		sizes[slot] = size;
+
+		return size;
+	}
+
+	std::size_t measureField (const protobuf::Message& message, const protobuf::Field& field, const Node& value)
+	{
+		if (! field.repeated)
+			return varint::getSize (makeKey (field.number, field.wireType)) + measureValue (message, field, value);
+
+		if (! value.isArray())
+			throwFieldError (message, field, "an Array");
+
+		const auto& array = value.getArray();
+
+		if (array.empty())
+			return 0;
+
+		if (field.packed)
+		{
+			const auto slot = sizes.size();
+
+			sizes.push_back (0);
+
+			std::size_t payloadSize { 0 };
+
+			for (const auto& element : array)
+				payloadSize += measureValue (message, field, element);
+
+			sizes[slot] = payloadSize;
+
+			return varint::getSize (makeKey (field.number, protobuf::len)) + varint::getSize (payloadSize) + payloadSize;
+		}
+
+		const auto keySize = varint::getSize (makeKey (field.number, field.wireType));
+
+		std::size_t size { 0 };
+
+		for (const auto& element : array)
+			size += keySize + measureValue (message, field, element);
+
+		return size;
+	}
+
+	std::size_t measureValue (const protobuf::Message& message, const protobuf::Field& field, const Node& node)
+	{
+		switch (field.wireType)
+		{
+			case (protobuf::varint) : return varint::getSize (toVarint (message, field, node));
+
+			case (protobuf::i64) : [[fallthrough]];
+			case (protobuf::i32) :
+			{
+				// this only checks the value, so that printing can't fail partway through
+				[[maybe_unused]] const auto bits = toFixed (message, field, node);
+
+				return field.wireType == protobuf::i64 ? 8 : 4;
+			}
+
+			default : break;
+		}
+
+		if (field.type == FieldType::Message)
+		{
+			if (! node.isObject())
+				throwFieldError (message, field, "an Object");
+
+			const auto size = measureMessage (descriptor->messages[field.message], node.getObject());
+
+			return varint::getSize (size) + size;
+		}
+
+		if (! node.isString())
+			throwFieldError (message, field, "a String");
+
+		return varint::getSize (node.getString().size()) + node.getString().size();
+	}
+
+	static void printVarint (std::uint64_t value, OutputSink& sink)
+	{
+		char bytes[varint::maxSize];
+
+		sink.write (std::string_view { bytes, varint::store (value, bytes) });
+	}
+
+	void printMessage (const protobuf::Message& message, OutputSink& sink)
+	{
+		// skip this message's own size, which its parent has already written
+		++nextSize;
+
+		const auto firstMember = nextMember;
+
+		nextMember += message.fields.size();
+
+		for (auto i = 0UL; i < message.fields.size(); ++i)
+		{
+			const auto* const value = members[firstMember + i];
+
+			if (value == nullptr)
+				continue;
+
+			const auto& field = message.fields[i];
+
+			if (! field.repeated)
+			{
+				printVarint (makeKey (field.number, field.wireType), sink);
+				printValue (message, field, *value, sink);
+				continue;
+			}
+
+			const auto& array = value->getArray();
+
+			if (array.empty())
+				continue;
+
+			if (field.packed)
+			{
+				printPacked (message, field, array, sink);
+				continue;
+			}
+
+			for (const auto& element : array)
+			{
+				printVarint (makeKey (field.number, field.wireType), sink);
+				printValue (message, field, element, sink);
+			}
+		}
+	}
+
+	// the values are gathered into a small buffer, so that the sink is called once per block
+	void printPacked (const protobuf::Message& message, const protobuf::Field& field, const Array& array, OutputSink& sink)
+	{
+		printVarint (makeKey (field.number, protobuf::len), sink);
+		printVarint (sizes[nextSize++], sink);
+
+		constexpr auto blockSize = std::size_t { 4096 };
+
+		char block[blockSize];
+
+		std::size_t used { 0 };
+
+		for (const auto& element : array)
+		{
+			if (blockSize - used < varint::maxSize)
+			{
+				sink.write (std::string_view { block, used });
+				used = 0;
+			}
+
+			if (field.wireType == protobuf::varint)
+			{
+				used += varint::store (toVarint (message, field, element), block + used);
+				continue;
+			}
+
+			const auto numBytes = field.wireType == protobuf::i64 ? 8UL : 4UL;
+			const auto value	= toFixed (message, field, element);
+
+			for (auto i = 0UL; i < numBytes; ++i)
+				block[used++] = static_cast<char> (static_cast<unsigned char> (value >> (i * 8UL)));
+		}
+
+		sink.write (std::string_view { block, used });
+	}
+
+	void printValue (const protobuf::Message& message, const protobuf::Field& field, const Node& node, OutputSink& sink)
+	{
+		switch (field.wireType)
+		{
+			case (protobuf::varint) : printVarint (toVarint (message, field, node), sink); return;
+
+			case (protobuf::i64) : [[fallthrough]];
+			case (protobuf::i32) :
+			{
+				const auto numBytes = field.wireType == protobuf::i64 ? 8UL : 4UL;
+				const auto value	= toFixed (message, field, node);
+
+				char bytes[8];
+
+				for (auto i = 0UL; i < numBytes; ++i)
+					bytes[i] = static_cast<char> (static_cast<unsigned char> (value >> (i * 8UL)));
+
+				sink.write (std::string_view { bytes, numBytes });
+				return;
+			}
+
+			default : break;
+		}
+
+		if (field.type == FieldType::Message)
+		{
+			printVarint (sizes[nextSize], sink);
+			printMessage (descriptor->messages[field.message], sink);
+			return;
+		}
+
+		const auto& string = node.getString();
+
+		printVarint (string.size(), sink);
+
+		sink.writeReferenced (string);
+	}
+
+	// print() is overridden, so the base class never calls these
+	void printNull (OutputSink&) final { }
+
+	void printNumber (double, OutputSink&) final { }
+
+	void printString (std::string_view, OutputSink&) final { }
+
+	void printBoolean (bool, OutputSink&) final { }
+
+	void printArray (const Array&, OutputSink&) final { }
+
+	void printObject (const Object&, OutputSink&) final { }
+
+	const std::shared_ptr<const protobuf::Descriptor> descriptor;
+
+	std::vector<std::size_t> sizes;
+
+	std::vector<const Node*> members;
+
+	std::size_t nextSize { 0 }, nextMember { 0 };
+};
+
+std::string ProtobufFormat::serialize (const Node& node, bool shouldPrettyPrint) const noexcept
+{
+	// the printer measures its output before writing any of it, and reserves that much space
+	// in the sink, so a separate measuring pass isn't needed
+	std::string result;
+
+	StringSink sink { result };
+
+	try
+	{
+		createPrinter (shouldPrettyPrint)->print (node, sink);
+	}
+	catch (...)
+	{
+		// the Node doesn't fit the descriptor, which can't be reported from here
+		return {};
+	}
+
+	return result;
+}
+
+std::unique_ptr<Printer> ProtobufFormat::createPrinter ([[maybe_unused]] bool shouldPrettyPrint) const noexcept
+{
+	return std::make_unique<ProtobufPrinter> (descriptor);
+}
+
+}  // namespace limes::serializing
@@ -0,0 +1,210 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include "lserializing/lserializing_SHA256Sink.h"
+
+namespace limes::serializing
+{
+
+// The compression function from FIPS 180-4, section 6.2.2.
+
+static constexpr std::array<std::uint32_t, 64> roundConstants {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static constexpr std::array<std::uint32_t, 8> initialState {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static void compress (std::array<std::uint32_t, 8>& state, const std::uint8_t* block) noexcept
+{
+	std::array<std::uint32_t, 64> w;
+
+	for (auto i = 0UL; i < 16; ++i)
+		w[i] = (std::uint32_t { block[i * 4] } << 24) | (std::uint32_t { block[i * 4 + 1] } << 16)
+			 | (std::uint32_t { block[i * 4 + 2] } << 8) | std::uint32_t { block[i * 4 + 3] };
+
+	for (auto i = 16UL; i < 64; ++i)
+	{
+		const auto s0 = std::rotr (w[i - 15], 7) ^ std::rotr (w[i - 15], 18) ^ (w[i - 15] >> 3);
+		const auto s1 = std::rotr (w[i - 2], 17) ^ std::rotr (w[i - 2], 19) ^ (w[i - 2] >> 10);
+
+		w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+	}
+
+	auto a = state[0], b = state[1], c = state[2], d = state[3];
+	auto e = state[4], f = state[5], g = state[6], h = state[7];
+
+	for (auto i = 0UL; i < 64; ++i)
+	{
+		const auto s1	  = std::rotr (e, 6) ^ std::rotr (e, 11) ^ std::rotr (e, 25);
+		const auto choice = (e & f) ^ (~e & g);
+		const auto temp1  = h + s1 + choice + roundConstants[i] + w[i];
+		const auto s0	  = std::rotr (a, 2) ^ std::rotr (a, 13) ^ std::rotr (a, 22);
+		const auto major  = (a & b) ^ (a & c) ^ (b & c);
+		const auto temp2  = s0 + major;
+
+		h = g;
+		g = f;
+		f = e;
+		e = d + temp1;
+		d = c;
+		c = b;
+		b = a;
+		a = temp1 + temp2;
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
+}
+
+SHA256Sink::SHA256Sink() noexcept
+	: state (initialState)
+{
+}
+
+void SHA256Sink::write (std::string_view text)
+{
+	const auto* data = reinterpret_cast<const std::uint8_t*> (text.data());
+	auto		size = text.size();
+
+	totalLength += size;
+
+	// printers mostly write short pieces, which just get added to the block
+	if (numBuffered + size < block.size())
+	{
+		std::memcpy (block.data() + numBuffered, data, size);
+		numBuffered += size;
+		return;
+	}
+
+	if (numBuffered > 0)
+	{
+		const auto numToCopy = std::min (size, block.size() - numBuffered);
+
+		std::memcpy (block.data() + numBuffered, data, numToCopy);
+
+		numBuffered += numToCopy;
+		data += numToCopy;
+		size -= numToCopy;
+
+		if (numBuffered < block.size())
+			return;
+
+		compress (state, block.data());
+		numBuffered = 0;
+	}
+
+	// whole blocks are hashed straight from the input
+	for (; size >= block.size(); data += block.size(), size -= block.size())
+		compress (state, data);
+
+	std::memcpy (block.data(), data, size);
+	numBuffered = size;
+}
+
+void SHA256Sink::write (char character)
+{
+	++totalLength;
+
+	block[numBuffered++] = static_cast<std::uint8_t> (character);
+
+	if (numBuffered == block.size())
+	{
+		compress (state, block.data());
+		numBuffered = 0;
+	}
+}
+
+SHA256Sink::Digest SHA256Sink::getDigest() const noexcept
+{
+	// the padding is applied to copies, so that more data can still be written afterwards
+	auto finalState = state;
+
+	std::array<std::uint8_t, 128> padding {};
+
+	std::memcpy (padding.data(), block.data(), numBuffered);
+
+	padding[numBuffered] = 0x80;
+
+	// the padded message ends with its length in bits, which must fit in the same block as the 0x80 byte
+	const auto paddedSize = numBuffered + 9 <= 64 ? 64UL : 128UL;
+
+	const auto numBits = totalLength * 8;
+
+	for (auto i = 0UL; i < 8; ++i)
+		padding[paddedSize - 1 - i] = static_cast<std::uint8_t> (numBits >> (i * 8));
+
+	compress (finalState, padding.data());
+
+	if (paddedSize == 128)
+		compress (finalState, padding.data() + 64);
+
+	Digest digest;
+
+	for (auto i = 0UL; i < finalState.size(); ++i)
+	{
+		digest[i * 4]	  = static_cast<std::uint8_t> (finalState[i] >> 24);
+		digest[i * 4 + 1] = static_cast<std::uint8_t> (finalState[i] >> 16);
+		digest[i * 4 + 2] = static_cast<std::uint8_t> (finalState[i] >> 8);
+		digest[i * 4 + 3] = static_cast<std::uint8_t> (finalState[i]);
+	}
+
+	return digest;
+}
+
+std::string SHA256Sink::getHexDigest() const
+{
+	std::string hex;
+
+	hex.reserve (64);
+
+	for (const auto byte : getDigest())
+	{
+		hex.push_back ("0123456789abcdef"[byte >> 4]);
+		hex.push_back ("0123456789abcdef"[byte & 15]);
+	}
+
+	return hex;
+}
+
+void SHA256Sink::reset() noexcept
+{
+	state		= initialState;
+	numBuffered = 0;
+	totalLength = 0;
+}
+
+}  // namespace limes::serializing
@@ -0,0 +1,297 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+// Internal helpers for scanning text 16 bytes at a time. Each function has a portable scalar
+// path, and an SSE2 path that is used whenever the compiler targets x86-64 (where SSE2 is
+// always available) or 32-bit x86 with SSE2 enabled. This header is private to the library.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define LSERIAL_HAS_SSE2 1
+#	include <emmintrin.h>
+#else
+#	define LSERIAL_HAS_SSE2 0
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#	define LSERIAL_HAS_SSSE3 1
+#	include <tmmintrin.h>
+#else
+#	define LSERIAL_HAS_SSSE3 0
+#endif
+
+namespace limes::serializing::simd
+{
+
+/** Returns true for the four whitespace characters allowed between JSON tokens. */
+[[nodiscard]] constexpr bool isJSONWhitespace (char c) noexcept
+{
+	return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+/** Returns a pointer to the first character in [p, end) that isn't JSON whitespace, or end. */
+[[nodiscard]] inline const char* skipJSONWhitespace (const char* p, const char* end) noexcept
+{
+	// most runs of whitespace are a single space or newline, so check a couple of bytes before vectorizing
+	for (auto i = 0; i < 2; ++i, ++p)
+		if (p == end || ! isJSONWhitespace (*p))
+			return p;
+
+#if LSERIAL_HAS_SSE2
+	const auto space   = _mm_set1_epi8 (' ');
+	const auto newline = _mm_set1_epi8 ('\n');
+	const auto cr	   = _mm_set1_epi8 ('\r');
+	const auto tab	   = _mm_set1_epi8 ('\t');
+
+	for (; end - p >= 16; p += 16)
+	{
+		const auto chunk = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p));
+
+		const auto isSpace = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (chunk, space), _mm_cmpeq_epi8 (chunk, newline)),
+										   _mm_or_si128 (_mm_cmpeq_epi8 (chunk, cr), _mm_cmpeq_epi8 (chunk, tab)));
+
+		const auto mask = static_cast<unsigned> (_mm_movemask_epi8 (isSpace)) ^ 0xFFFFU;
+
+		if (mask != 0)
+			return p + std::countr_zero (mask);
+	}
+#endif
+
+	while (p != end && isJSONWhitespace (*p))
+		++p;
+
+	return p;
+}
+
+/** Returns a pointer to the first '"', '\\' or control character (below 0x20) in [p, end), or end.
+
+	If any byte at or above 0x80 is passed over, \c sawNonASCII is set to true. Bytes after the
+	returned position may also have been inspected, so this is only a hint that the text up to
+	the returned position needs UTF-8 validation.
+ */
+[[nodiscard]] inline const char* findJSONStringSpecial (const char* p, const char* end, bool& sawNonASCII) noexcept
+{
+#if LSERIAL_HAS_SSE2
+	const auto quote	 = _mm_set1_epi8 ('"');
+	const auto backslash = _mm_set1_epi8 ('\\');
+	const auto maxCtrl	 = _mm_set1_epi8 (0x1F);
+	const auto zero		 = _mm_setzero_si128();
+
+	auto highBits = _mm_setzero_si128();
+
+	for (; end - p >= 16; p += 16)
+	{
+		const auto chunk = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p));
+
+		highBits = _mm_or_si128 (highBits, chunk);
+
+		// saturating subtraction leaves zero for any byte <= 0x1F
+		const auto isControl = _mm_cmpeq_epi8 (_mm_subs_epu8 (chunk, maxCtrl), zero);
+
+		const auto special = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (chunk, quote), _mm_cmpeq_epi8 (chunk, backslash)),
+										   isControl);
+
+		if (const auto mask = static_cast<unsigned> (_mm_movemask_epi8 (special)); mask != 0)
+		{
+			sawNonASCII = sawNonASCII || _mm_movemask_epi8 (highBits) != 0;
+			return p + std::countr_zero (mask);
+		}
+	}
+
+	sawNonASCII = sawNonASCII || _mm_movemask_epi8 (highBits) != 0;
+#endif
+
+	for (; p != end; ++p)
+	{
+		const auto c = static_cast<unsigned char> (*p);
+
+		if (c == '"' || c == '\\' || c < 0x20)
+			return p;
+
+		if (c >= 0x80)
+			sawNonASCII = true;
+	}
+
+	return p;
+}
+
+/** Returns a pointer to the first character in [p, end) that a JSON printer can't copy through
+	unchanged when writing ASCII-only output: '"', '\\', a control character (below 0x20), DEL
+	(0x7F), or any byte of a non-ASCII character. Returns end if there is no such character.
+ */
+[[nodiscard]] inline const char* findJSONEscapeASCII (const char* p, const char* end) noexcept
+{
+#if LSERIAL_HAS_SSE2
+	const auto quote	 = _mm_set1_epi8 ('"');
+	const auto backslash = _mm_set1_epi8 ('\\');
+	const auto del		 = _mm_set1_epi8 (0x7F);
+	const auto space	 = _mm_set1_epi8 (0x20);
+
+	for (; end - p >= 16; p += 16)
+	{
+		const auto chunk = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p));
+
+		// as signed bytes, everything at or above 0x80 is negative, so one comparison finds
+		// both the control characters and the non-ASCII bytes
+		const auto belowSpace = _mm_cmplt_epi8 (chunk, space);
+
+		const auto special = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (chunk, quote), _mm_cmpeq_epi8 (chunk, backslash)),
+										   _mm_or_si128 (_mm_cmpeq_epi8 (chunk, del), belowSpace));
+
+		if (const auto mask = static_cast<unsigned> (_mm_movemask_epi8 (special)); mask != 0)
+			return p + std::countr_zero (mask);
+	}
+#endif
+
+	for (; p != end; ++p)
+	{
+		const auto c = static_cast<unsigned char> (*p);
+
+		if (c == '"' || c == '\\' || c < 0x20 || c >= 0x7F)
+			return p;
+	}
+
+	return p;
+}
+
+/** Returns a pointer to the first '<', '&' or '\r' in [p, end), or end. These are the characters
+	in XML character data that end a run of text or mean that it can't be used as it is.
+ */
+[[nodiscard]] inline const char* findXMLTextSpecial (const char* p, const char* end) noexcept
+{
+#if LSERIAL_HAS_SSE2
+	const auto lessThan	 = _mm_set1_epi8 ('<');
+	const auto ampersand = _mm_set1_epi8 ('&');
+	const auto cr		 = _mm_set1_epi8 ('\r');
+
+	for (; end - p >= 16; p += 16)
+	{
+		const auto chunk = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p));
+
+		const auto special = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (chunk, lessThan), _mm_cmpeq_epi8 (chunk, ampersand)),
+										   _mm_cmpeq_epi8 (chunk, cr));
+
+		if (const auto mask = static_cast<unsigned> (_mm_movemask_epi8 (special)); mask != 0)
+			return p + std::countr_zero (mask);
+	}
+#endif
+
+	for (; p != end; ++p)
+		if (*p == '<' || *p == '&' || *p == '\r')
+			return p;
+
+	return p;
+}
+
+/** Returns a pointer to the first occurrence of the quote character, '<', '&' or a control
+	character (below 0x20) in [p, end), or end. These are the characters in an XML attribute value
+	that end it or mean that it can't be used as it is.
+ */
+[[nodiscard]] inline const char* findXMLAttributeSpecial (const char* p, const char* end, char quote) noexcept
+{
+#if LSERIAL_HAS_SSE2
+	const auto quoteChar = _mm_set1_epi8 (quote);
+	const auto lessThan	 = _mm_set1_epi8 ('<');
+	const auto ampersand = _mm_set1_epi8 ('&');
+	const auto maxCtrl	 = _mm_set1_epi8 (0x1F);
+	const auto zero		 = _mm_setzero_si128();
+
+	for (; end - p >= 16; p += 16)
+	{
+		const auto chunk = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p));
+
+		// saturating subtraction leaves zero for any byte <= 0x1F
+		const auto isControl = _mm_cmpeq_epi8 (_mm_subs_epu8 (chunk, maxCtrl), zero);
+
+		const auto special = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (chunk, quoteChar), _mm_cmpeq_epi8 (chunk, lessThan)),
+										   _mm_or_si128 (_mm_cmpeq_epi8 (chunk, ampersand), isControl));
+
+		if (const auto mask = static_cast<unsigned> (_mm_movemask_epi8 (special)); mask != 0)
+			return p + std::countr_zero (mask);
+	}
+#endif
+
+	for (; p != end; ++p)
+	{
+		const auto c = static_cast<unsigned char> (*p);
+
+		if (c == static_cast<unsigned char> (quote) || c == '<' || c == '&' || c < 0x20)
+			return p;
+	}
+
+	return p;
+}
+
+/** Returns a pointer to the first '&', '<', '>', '"' or control character (below 0x20) in [p, end),
+	or end. These are the characters that an XML printer may need to escape, in text or in
+	attribute values.
+
+	If any byte at or above 0x80 is passed over, \c sawNonASCII is set to true, as in
+	\c findJSONStringSpecial() .
+ */
+[[nodiscard]] inline const char* findXMLEscape (const char* p, const char* end, bool& sawNonASCII) noexcept
+{
+#if LSERIAL_HAS_SSE2
+	const auto ampersand   = _mm_set1_epi8 ('&');
+	const auto lessThan	   = _mm_set1_epi8 ('<');
+	const auto greaterThan = _mm_set1_epi8 ('>');
+	const auto quote	   = _mm_set1_epi8 ('"');
+	const auto maxCtrl	   = _mm_set1_epi8 (0x1F);
+	const auto zero		   = _mm_setzero_si128();
+
+	auto highBits = _mm_setzero_si128();
+
+	for (; end - p >= 16; p += 16)
+	{
+		const auto chunk = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p));
+
+		highBits = _mm_or_si128 (highBits, chunk);
+
+		// saturating subtraction leaves zero for any byte <= 0x1F
+		const auto isControl = _mm_cmpeq_epi8 (_mm_subs_epu8 (chunk, maxCtrl), zero);
+
+		const auto special = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (chunk, ampersand), _mm_cmpeq_epi8 (chunk, lessThan)),
+										   _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (chunk, greaterThan), _mm_cmpeq_epi8 (chunk, quote)),
+														 isControl));
+
+		if (const auto mask = static_cast<unsigned> (_mm_movemask_epi8 (special)); mask != 0)
+		{
+			sawNonASCII = sawNonASCII || _mm_movemask_epi8 (highBits) != 0;
+			return p + std::countr_zero (mask);
+		}
+	}
+
+	sawNonASCII = sawNonASCII || _mm_movemask_epi8 (highBits) != 0;
+#endif
+
+	for (; p != end; ++p)
+	{
+		const auto c = static_cast<unsigned char> (*p);
+
+		if (c == '&' || c == '<' || c == '>' || c == '"' || c < 0x20)
+			return p;
+
+		if (c >= 0x80)
+			sawNonASCII = true;
+	}
+
+	return p;
+}
+
+}  // namespace limes::serializing::simd
@@ -0,0 +1,64 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "lserializing/lserializing_Serializer.h"
+#include "lserializing/lserializing_Printer.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include "lserializing/lserializing_Node.h"
+
+namespace limes::serializing
+{
+
+Serializer::Serializer (std::unique_ptr<Printer> printerToUse) noexcept
+	: printer (std::move (printerToUse))
+{
+}
+
+std::string_view Serializer::serialize (const Node& node)
+{
+	// clear() keeps the capacity, so the buffer stops allocating once it has grown to fit
+	buffer.clear();
+
+	serializeInto (node, buffer);
+
+	return buffer;
+}
+
+void Serializer::serializeInto (const Node& node, std::string& output)
+{
+	StringSink sink { output };
+
+	printer->print (node, sink);
+}
+
+void Serializer::serialize (const Node& node, OutputSink& sink)
+{
+	printer->print (node, sink);
+}
+
+void Serializer::releaseBuffer() noexcept
+{
+	std::string {}.swap (buffer);
+}
+
+Printer& Serializer::getPrinter() const noexcept
+{
+	return *printer;
+}
+
+}  // namespace limes::serializing
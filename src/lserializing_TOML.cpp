@@ -16,6 +16,7 @@
 #include "lserializing/lserializing_SerializingFormat.h"
 #include "lserializing/lserializing_KnownFormats.h"
 #include "lserializing/lserializing_Node.h"
+#include "lserializing/lserializing_StaticPrinter.h"
 #include "lserializing/lserializing_Export.h"
 
 namespace limes::serializing
@@ -69,38 +70,34 @@ Node TOMLFormat::parse (std::string_view /*string*/) const
 
 std::unique_ptr<Printer> TOMLFormat::createPrinter ([[maybe_unused]] bool shouldPrettyPrint) const noexcept
 {
-	class TOMLPrinter final : public Printer
+	class TOMLPrinter final : public StaticPrinter<TOMLPrinter>
 	{
+		friend class StaticPrinter<TOMLPrinter>;
+
 	public:
 	private:
-		std::string printNull() final
+		void printNull (OutputSink& /*sink*/) final
 		{
-			return {};
 		}
 
-		std::string printNumber (double /*number*/) final
+		void printNumber (double /*number*/, OutputSink& /*sink*/) final
 		{
-			return {};
 		}
 
-		std::string printString (std::string_view /*string*/) final
+		void printString (std::string_view /*string*/, OutputSink& /*sink*/) final
 		{
-			return {};
 		}
 
-		std::string printBoolean (bool /*boolean*/) final
+		void printBoolean (bool /*boolean*/, OutputSink& /*sink*/) final
 		{
-			return {};
 		}
 
-		std::string printArray (const Array& /*array*/) final
+		void printArray (const Array& /*array*/, OutputSink& /*sink*/) final
 		{
-			return {};
 		}
 
-		std::string printObject (const Object& /*object*/) final
+		void printObject (const Object& /*object*/, OutputSink& /*sink*/) final
 		{
-			return {};
 		}
 
 		void arrayBegin() final
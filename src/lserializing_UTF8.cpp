@@ -0,0 +1,248 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include "lserializing_UTF8.h"
+#include "lserializing_SIMD.h"
+
+// When SSSE3 isn't enabled for the whole build, GCC and Clang can still compile the SSSE3
+// validator as a separate function, which is only called if the CPU supports it.
+#if LSERIAL_HAS_SSSE3
+#	define LSERIAL_UTF8_SSSE3			  1
+#	define LSERIAL_UTF8_SSSE3_DISPATCH	  0
+#	define LSERIAL_UTF8_SSSE3_FUNCTION
+#elif LSERIAL_HAS_SSE2 && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#	include <tmmintrin.h>
+#	define LSERIAL_UTF8_SSSE3			  1
+#	define LSERIAL_UTF8_SSSE3_DISPATCH	  1
+#	define LSERIAL_UTF8_SSSE3_FUNCTION __attribute__ ((target ("ssse3")))
+#else
+#	define LSERIAL_UTF8_SSSE3			  0
+#	define LSERIAL_UTF8_SSSE3_DISPATCH	  0
+#endif
+
+namespace limes::serializing::utf8
+{
+
+#if LSERIAL_UTF8_SSSE3
+
+static constexpr char toChar (unsigned value) noexcept
+{
+	return static_cast<char> (static_cast<unsigned char> (value));
+}
+
+// This is the "lookup" algorithm from Keiser & Lemire, "Validating UTF-8 In Less Than One
+// Instruction Per Byte" (2021). Each byte is classified by looking up the high and low nibbles
+// of the previous byte and the high nibble of the current byte in three small tables; ANDing
+// the results leaves a nonzero value only for byte pairs that can't appear in valid UTF-8.
+// The positions that must be the 3rd or 4th byte of a sequence are checked separately.
+LSERIAL_UTF8_SSSE3_FUNCTION static bool isValidSSSE3 (const unsigned char* p, const unsigned char* end) noexcept
+{
+	constexpr unsigned tooShort = 1U << 0U, tooLong = 1U << 1U, overlong3 = 1U << 2U, tooLarge = 1U << 3U,
+					   surrogate = 1U << 4U, overlong2 = 1U << 5U, tooLarge1000 = 1U << 6U, overlong4 = 1U << 6U,
+					   twoConts = 1U << 7U;
+
+	constexpr auto carry = tooShort | tooLong | twoConts;
+
+	const auto byte1HighTable = _mm_setr_epi8 (
+		// 0___ (ASCII)
+		toChar (tooLong), toChar (tooLong), toChar (tooLong), toChar (tooLong),
+		toChar (tooLong), toChar (tooLong), toChar (tooLong), toChar (tooLong),
+		// 10__ (continuation)
+		toChar (twoConts), toChar (twoConts), toChar (twoConts), toChar (twoConts),
+		// 1100 (2 byte lead)
+		toChar (tooShort | overlong2),
+		// 1101 (2 byte lead)
+		toChar (tooShort),
+		// 1110 (3 byte lead)
+		toChar (tooShort | overlong3 | surrogate),
+		// 1111 (4 byte lead)
+		toChar (tooShort | tooLarge | tooLarge1000 | overlong4));
+
+	const auto byte1LowTable = _mm_setr_epi8 (
+		toChar (carry | overlong3 | overlong2 | overlong4),
+		toChar (carry | overlong2),
+		toChar (carry),
+		toChar (carry),
+		toChar (carry | tooLarge),
+		toChar (carry | tooLarge | tooLarge1000),
+		toChar (carry | tooLarge | tooLarge1000),
+		toChar (carry | tooLarge | tooLarge1000),
+		toChar (carry | tooLarge | tooLarge1000),
+		toChar (carry | tooLarge | tooLarge1000),
+		toChar (carry | tooLarge | tooLarge1000),
+		toChar (carry | tooLarge | tooLarge1000),
+		toChar (carry | tooLarge | tooLarge1000),
+		toChar (carry | tooLarge | tooLarge1000 | surrogate),
+		toChar (carry | tooLarge | tooLarge1000),
+		toChar (carry | tooLarge | tooLarge1000));
+
+	const auto byte2HighTable = _mm_setr_epi8 (
+		// 0___ (ASCII)
+		toChar (tooShort), toChar (tooShort), toChar (tooShort), toChar (tooShort),
+		toChar (tooShort), toChar (tooShort), toChar (tooShort), toChar (tooShort),
+		// 1000
+		toChar (tooLong | overlong2 | twoConts | overlong3 | tooLarge1000 | overlong4),
+		// 1001
+		toChar (tooLong | overlong2 | twoConts | overlong3 | tooLarge),
+		// 101_
+		toChar (tooLong | overlong2 | twoConts | surrogate | tooLarge),
+		toChar (tooLong | overlong2 | twoConts | surrogate | tooLarge),
+		// 11__
+		toChar (tooShort), toChar (tooShort), toChar (tooShort), toChar (tooShort));
+
+	// a block ending in one of these lead bytes must be followed by continuation bytes
+	const auto incompleteThreshold = _mm_setr_epi8 (toChar (0xFF), toChar (0xFF), toChar (0xFF), toChar (0xFF),
+													toChar (0xFF), toChar (0xFF), toChar (0xFF), toChar (0xFF),
+													toChar (0xFF), toChar (0xFF), toChar (0xFF), toChar (0xFF),
+													toChar (0xFF), toChar (0xEF), toChar (0xDF), toChar (0xBF));
+
+	const auto lowNibbleMask = _mm_set1_epi8 (0x0F);
+	const auto highBit		 = _mm_set1_epi8 (toChar (0x80));
+	const auto thirdByteMin	 = _mm_set1_epi8 (toChar (0xE0 - 0x80));
+	const auto fourthByteMin = _mm_set1_epi8 (toChar (0xF0 - 0x80));
+
+	auto error			= _mm_setzero_si128();
+	auto prevInput		= _mm_setzero_si128();
+	auto prevIncomplete = _mm_setzero_si128();
+
+	// the last partial block is padded with ASCII zeros, which also catches a truncated final sequence
+	alignas (16) unsigned char tail[16] = {};
+
+	while (p != end)
+	{
+		__m128i input;
+
+		if (end - p >= 16)
+		{
+			input = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p));
+			p += 16;
+		}
+		else
+		{
+			std::memcpy (tail, p, static_cast<std::size_t> (end - p));
+			input = _mm_load_si128 (reinterpret_cast<const __m128i*> (tail));
+			p	  = end;
+		}
+
+		if (_mm_movemask_epi8 (input) == 0)
+		{
+			// an all-ASCII block is only an error if the previous block ended mid-sequence
+			error = _mm_or_si128 (error, prevIncomplete);
+		}
+		else
+		{
+			const auto prev1 = _mm_alignr_epi8 (input, prevInput, 15);
+
+			const auto prev1HighNibbles = _mm_and_si128 (_mm_srli_epi16 (prev1, 4), lowNibbleMask);
+			const auto inputHighNibbles = _mm_and_si128 (_mm_srli_epi16 (input, 4), lowNibbleMask);
+
+			const auto specialCases = _mm_and_si128 (_mm_and_si128 (_mm_shuffle_epi8 (byte1HighTable, prev1HighNibbles),
+																	 _mm_shuffle_epi8 (byte1LowTable, _mm_and_si128 (prev1, lowNibbleMask))),
+													 _mm_shuffle_epi8 (byte2HighTable, inputHighNibbles));
+
+			const auto prev2 = _mm_alignr_epi8 (input, prevInput, 14);
+			const auto prev3 = _mm_alignr_epi8 (input, prevInput, 13);
+
+			const auto mustBe23Continuation = _mm_and_si128 (_mm_or_si128 (_mm_subs_epu8 (prev2, thirdByteMin),
+																		   _mm_subs_epu8 (prev3, fourthByteMin)),
+															 highBit);
+
+			error = _mm_or_si128 (error, _mm_xor_si128 (mustBe23Continuation, specialCases));
+
+			prevIncomplete = _mm_subs_epu8 (input, incompleteThreshold);
+		}
+
+		prevInput = input;
+	}
+
+	error = _mm_or_si128 (error, prevIncomplete);
+
+	return _mm_movemask_epi8 (_mm_cmpeq_epi8 (error, _mm_setzero_si128())) == 0xFFFF;
+}
+
+#endif
+
+#if LSERIAL_UTF8_SSSE3_DISPATCH
+static bool cpuHasSSSE3() noexcept
+{
+	static const bool result = []
+	{
+		__builtin_cpu_init();
+		return __builtin_cpu_supports ("ssse3") != 0;
+	}();
+
+	return result;
+}
+#endif
+
+bool isValid (const char* begin, const char* end) noexcept
+{
+	const auto* p		   = reinterpret_cast<const unsigned char*> (begin);
+	const auto* const last = reinterpret_cast<const unsigned char*> (end);
+
+#if LSERIAL_UTF8_SSSE3
+#	if LSERIAL_UTF8_SSSE3_DISPATCH
+	if (cpuHasSSSE3())
+#	endif
+		return isValidSSSE3 (p, last);
+#endif
+
+#if ! LSERIAL_HAS_SSSE3
+	while (p < last)
+	{
+		// skip runs of ASCII a block at a time
+	#if LSERIAL_HAS_SSE2
+		if (last - p >= 16
+			&& _mm_movemask_epi8 (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (p))) == 0)
+		{
+			p += 16;
+			continue;
+		}
+	#else
+		if (last - p >= 8)
+		{
+			std::uint64_t word;
+
+			std::memcpy (&word, p, sizeof (word));
+
+			if ((word & 0x8080808080808080ULL) == 0)
+			{
+				p += 8;
+				continue;
+			}
+		}
+	#endif
+
+		if (*p < 0x80)
+		{
+			++p;
+			continue;
+		}
+
+		const auto length = validSequenceLength (p, last);
+
+		if (length == 0)
+			return false;
+
+		p += length;
+	}
+
+	return true;
+#endif
+}
+
+}  // namespace limes::serializing::utf8
@@ -0,0 +1,154 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "lserializing/lserializing_Export.h"
+
+// Internal UTF-8 helpers that work directly on bytes. This header is private to the library.
+
+namespace limes::serializing::utf8
+{
+
+/** Returns true if [begin, end) is entirely valid UTF-8, as defined by RFC 3629.
+
+	Overlong encodings, surrogate codepoints and codepoints above U+10FFFF are all rejected.
+	All-ASCII blocks are skipped 16 bytes at a time, and when SSSE3 is available, multibyte
+	sequences are validated with a vectorized lookup-table algorithm as well.
+ */
+[[nodiscard]] LSERIAL_NO_EXPORT bool isValid (const char* begin, const char* end) noexcept;
+
+[[nodiscard]] inline bool isValid (std::string_view text) noexcept
+{
+	return isValid (text.data(), text.data() + text.size());
+}
+
+/** Returns the length of the valid multibyte sequence starting at p, or 0 if it is invalid. */
+[[nodiscard]] inline std::ptrdiff_t validSequenceLength (const unsigned char* p, const unsigned char* end) noexcept
+{
+	const auto lead		 = p[0];
+	const auto available = end - p;
+
+	auto isContinuation = [] (unsigned char c)
+	{ return (c & 0xC0) == 0x80; };
+
+	if (lead >= 0xC2 && lead <= 0xDF)
+		return (available >= 2 && isContinuation (p[1])) ? 2 : 0;
+
+	// the second byte's range is narrower for some lead bytes, to exclude overlong encodings,
+	// surrogates, and codepoints above U+10FFFF
+	if (lead >= 0xE0 && lead <= 0xEF)
+	{
+		if (available < 3)
+			return 0;
+
+		const auto lo = lead == 0xE0 ? 0xA0 : 0x80;
+		const auto hi = lead == 0xED ? 0x9F : 0xBF;
+
+		return (p[1] >= lo && p[1] <= hi && isContinuation (p[2])) ? 3 : 0;
+	}
+
+	if (lead >= 0xF0 && lead <= 0xF4)
+	{
+		if (available < 4)
+			return 0;
+
+		const auto lo = lead == 0xF0 ? 0x90 : 0x80;
+		const auto hi = lead == 0xF4 ? 0x8F : 0xBF;
+
+		return (p[1] >= lo && p[1] <= hi && isContinuation (p[2]) && isContinuation (p[3])) ? 4 : 0;
+	}
+
+	return 0;
+}
+
+/** Decodes the codepoint starting at p, and advances p past it.
+
+	An invalid or truncated sequence decodes as U+FFFD, and only its first byte is consumed.
+ */
+[[nodiscard]] inline std::uint32_t decode (const char*& p, const char* end) noexcept
+{
+	const auto* const bytes = reinterpret_cast<const unsigned char*> (p);
+
+	if (bytes[0] < 0x80)
+	{
+		++p;
+		return bytes[0];
+	}
+
+	const auto length = validSequenceLength (bytes, reinterpret_cast<const unsigned char*> (end));
+
+	p += length == 0 ? 1 : length;
+
+	switch (length)
+	{
+		case 2 : return ((bytes[0] & 0x1FU) << 6) | (bytes[1] & 0x3FU);
+		case 3 : return ((bytes[0] & 0x0FU) << 12) | ((bytes[1] & 0x3FU) << 6) | (bytes[2] & 0x3FU);
+		case 4 : return ((bytes[0] & 0x07U) << 18) | ((bytes[1] & 0x3FU) << 12) | ((bytes[2] & 0x3FU) << 6) | (bytes[3] & 0x3FU);
+		default : return 0xFFFD;
+	}
+}
+
+[[nodiscard]] constexpr bool isHighSurrogate (std::uint32_t codepoint) noexcept
+{
+	return codepoint >= 0xD800 && codepoint <= 0xDBFF;
+}
+
+[[nodiscard]] constexpr bool isLowSurrogate (std::uint32_t codepoint) noexcept
+{
+	return codepoint >= 0xDC00 && codepoint <= 0xDFFF;
+}
+
+[[nodiscard]] constexpr std::uint32_t combineSurrogates (std::uint32_t high, std::uint32_t low) noexcept
+{
+	return 0x10000 + ((high - 0xD800) << 10) + (low - 0xDC00);
+}
+
+/** Writes the UTF-8 encoding of the codepoint to out, which must have room for 4 bytes.
+	Returns the number of bytes written.
+ */
+inline std::size_t encode (char* out, std::uint32_t codepoint) noexcept
+{
+	if (codepoint < 0x80)
+	{
+		out[0] = static_cast<char> (codepoint);
+		return 1;
+	}
+
+	if (codepoint < 0x800)
+	{
+		out[0] = static_cast<char> (0xC0 | (codepoint >> 6));
+		out[1] = static_cast<char> (0x80 | (codepoint & 0x3F));
+		return 2;
+	}
+
+	if (codepoint < 0x10000)
+	{
+		out[0] = static_cast<char> (0xE0 | (codepoint >> 12));
+		out[1] = static_cast<char> (0x80 | ((codepoint >> 6) & 0x3F));
+		out[2] = static_cast<char> (0x80 | (codepoint & 0x3F));
+		return 3;
+	}
+
+	out[0] = static_cast<char> (0xF0 | (codepoint >> 18));
+	out[1] = static_cast<char> (0x80 | ((codepoint >> 12) & 0x3F));
+	out[2] = static_cast<char> (0x80 | ((codepoint >> 6) & 0x3F));
+	out[3] = static_cast<char> (0x80 | (codepoint & 0x3F));
+	return 4;
+}
+
+}  // namespace limes::serializing::utf8
@@ -0,0 +1,82 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Internal helpers for LEB128 varints, which the binary formats use for lengths, counts and
+// integers. This header is private to the library.
+
+namespace limes::serializing::varint
+{
+
+/** The largest number of bytes that a 64-bit value can take as a varint. */
+static constexpr std::size_t maxSize = 10;
+
+/** Returns the number of bytes that the value takes as a varint. */
+[[nodiscard]] inline std::size_t getSize (std::uint64_t value) noexcept
+{
+	return std::max (std::size_t { 1 }, (static_cast<std::size_t> (std::bit_width (value)) + 6) / 7);
+}
+
+/** Writes the value as a varint to dest, which must have room for \c maxSize bytes, and returns the number of bytes written. */
+inline std::size_t store (std::uint64_t value, char* dest) noexcept
+{
+	std::size_t length { 0 };
+
+	while (value >= 0x80U)
+	{
+		dest[length++] = static_cast<char> (static_cast<unsigned char> (value | 0x80U));
+		value >>= 7U;
+	}
+
+	dest[length++] = static_cast<char> (static_cast<unsigned char> (value));
+
+	return length;
+}
+
+/** The outcome of reading a varint. */
+enum class ReadResult
+{
+	ok,
+	truncated,	// the data ended before the varint did
+	tooLong		// the varint didn't end within maxSize bytes
+};
+
+/** Reads a varint from [p, end), and moves p past the bytes that were read. */
+[[nodiscard]] inline ReadResult read (const char*& p, const char* end, std::uint64_t& value) noexcept
+{
+	value = 0;
+
+	for (auto shift = 0U; shift < 64U; shift += 7U)
+	{
+		if (p == end)
+			return ReadResult::truncated;
+
+		const auto byte = static_cast<unsigned char> (*p++);
+
+		value |= std::uint64_t { byte & 0x7FU } << shift;
+
+		if ((byte & 0x80U) == 0)
+			return ReadResult::ok;
+	}
+
+	return ReadResult::tooLong;
+}
+
+}  // namespace limes::serializing::varint
@@ -12,228 +12,1226 @@
  * ======================================================================================
  */
 
-#include <string_view>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "lserializing/lserializing_XML.h"
 #include "lserializing/lserializing_SerializingFormat.h"
 #include "lserializing/lserializing_KnownFormats.h"
 #include "lserializing/lserializing_Node.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include "lserializing/lserializing_Printer.h"
 #include "lserializing/lserializing_Export.h"
+#include "lserializing_SIMD.h"
+#include "lserializing_UTF8.h"
 
 namespace limes::serializing
 {
 
-class LSERIAL_NO_EXPORT XMLFormat final : public Format
+LSERIAL_NO_EXPORT static const KnownFormats::Register<XMLFormat> xml_init;
+
+std::string_view XMLFormat::getName() const noexcept
+{
+	return formats::XML;
+}
+
+bool XMLFormat::supportsComments() const noexcept
+{
+	return true;
+}
+
+const std::vector<std::string_view>& XMLFormat::getFileExtensions() const noexcept
+{
+	struct ExtensionsHolder final
+	{
+		std::vector<std::string_view> xtns;
+
+		ExtensionsHolder()
+		{
+			xtns.emplace_back (".xml");
+		}
+	};
+
+	static const ExtensionsHolder holder;
+
+	return holder.xtns;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+namespace xml
+{
+
+[[nodiscard]] static constexpr bool isWhitespace (char c) noexcept
+{
+	return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+[[nodiscard]] static bool isAllWhitespace (std::string_view text) noexcept
+{
+	for (const auto c : text)
+		if (! isWhitespace (c))
+			return false;
+
+	return true;
+}
+
+// bit 0: can start a name; bit 1: can continue a name. Every byte of a non-ASCII character counts
+// as a name character; the input's UTF-8 is validated separately.
+static constexpr auto nameCharTable = []
+{
+	std::array<unsigned char, 256> table {};
+
+	for (auto c = 'a'; c <= 'z'; ++c)
+		table[static_cast<unsigned char> (c)] = 3;
+
+	for (auto c = 'A'; c <= 'Z'; ++c)
+		table[static_cast<unsigned char> (c)] = 3;
+
+	for (auto c = '0'; c <= '9'; ++c)
+		table[static_cast<unsigned char> (c)] = 2;
+
+	table['_'] = 3;
+	table[':'] = 3;
+	table['-'] = 2;
+	table['.'] = 2;
+
+	for (auto c = 0x80; c < 0x100; ++c)
+		table[static_cast<std::size_t> (c)] = 3;
+
+	return table;
+}();
+
+// Checks the XML grammar and passes the document's contents to a handler. This is a template so that building Nodes
+// doesn't go through virtual calls.
+//
+// Reports errors by recording them and returning false rather than by throwing, so that XMLFormat::tryParse() can
+// reject input without any stack unwinding.
+template <typename Handler>
+class LSERIAL_NO_EXPORT XMLParser final
 {
 public:
-	[[nodiscard]] std::string_view getName() const noexcept final
+	XMLParser (std::string_view inputText, Handler& handlerToUse)
+		: source (inputText), current (inputText.data()), end (inputText.data() + inputText.size()), handler (handlerToUse)
+	{
+	}
+
+	[[nodiscard]] bool parse()
+	{
+		if (! utf8::isValid (source))
+			return fail ("The document isn't valid UTF-8", current);
+
+		// a byte order mark
+		popIf ("\xEF\xBB\xBF");
+
+		if (! skipMisc())
+			return false;
+
+		if (isEOF() || *current != '<')
+			return fail ("Expected the root element");
+
+		if (! parseElements())
+			return false;
+
+		if (! skipMisc())
+			return false;
+
+		if (! isEOF())
+			return fail ("Unexpected content after the root element");
+
+		return true;
+	}
+
+	[[nodiscard]] ParseError getError() const
+	{
+		const auto errorOffset = static_cast<std::size_t> (errorPos - source.data());
+
+		return ParseError { errorMessage,
+							text::utf8::LineAndColumn::find (text::utf8::Pointer { source },
+															 text::utf8::Pointer { source.substr (errorOffset) }) };
+	}
+
+private:
+	// this is far deeper than any real document, and keeps destroying the resulting Nodes from overflowing the stack
+	static constexpr auto maxDepth = std::size_t { 512 };
+
+	inline bool fail (std::string_view message, const char* position = nullptr) noexcept
+	{
+		errorMessage = message;
+		errorPos	 = position == nullptr ? current : position;
+		return false;
+	}
+
+	[[nodiscard]] inline bool isEOF() const noexcept
 	{
-		return formats::XML;
+		return current == end;
 	}
 
-	bool supportsComments() const noexcept final
+	[[nodiscard]] inline bool startsWith (std::string_view literal) const noexcept
 	{
+		return static_cast<std::size_t> (end - current) >= literal.size()
+			&& std::memcmp (current, literal.data(), literal.size()) == 0;
+	}
+
+	inline bool popIf (std::string_view literal) noexcept
+	{
+		if (! startsWith (literal))
+			return false;
+
+		current += literal.size();
+		return true;
+	}
+
+	inline bool skipWhitespace() noexcept
+	{
+		const auto* const start = current;
+
+		while (current != end && isWhitespace (*current))
+			++current;
+
+		return current != start;
+	}
+
+	// moves past the next occurrence of the terminator
+	[[nodiscard]] inline bool skipPast (std::string_view terminator, std::string_view construct, const char* start)
+	{
+		const auto pos = std::string_view { current, static_cast<std::size_t> (end - current) }.find (terminator);
+
+		if (pos == std::string_view::npos)
+			return fail ("Unterminated " + std::string { construct }, start);
+
+		current += pos + terminator.size();
 		return true;
 	}
 
-	const std::vector<std::string_view>& getFileExtensions() const noexcept final
+	[[nodiscard]] inline std::string_view readName() noexcept
 	{
-		struct ExtensionsHolder final
+		const auto* const start = current;
+
+		if (current == end || (nameCharTable[static_cast<unsigned char> (*current)] & 1) == 0)
+			return {};
+
+		++current;
+
+		while (current != end && (nameCharTable[static_cast<unsigned char> (*current)] & 2) != 0)
+			++current;
+
+		return { start, static_cast<std::size_t> (current - start) };
+	}
+
+	// skips the whitespace, comments, processing instructions and document type declaration that may come before or
+	// after the root element
+	[[nodiscard]] bool skipMisc()
+	{
+		for (;;)
 		{
-			std::vector<std::string_view> xtns;
+			skipWhitespace();
+
+			const auto* const start = current;
 
-			ExtensionsHolder()
+			if (popIf ("<!--"))
 			{
-				xtns.emplace_back (".xml");
+				if (! skipPast ("-->", "comment", start))
+					return false;
 			}
-		};
+			else if (popIf ("<?"))
+			{
+				if (! skipPast ("?>", "processing instruction", start))
+					return false;
+			}
+			else if (popIf ("<!DOCTYPE"))
+			{
+				if (! skipDoctype (start))
+					return false;
+			}
+			else
+			{
+				return true;
+			}
+		}
+	}
+
+	// the document type declaration may have an internal subset in brackets, and quoted strings that contain '>'
+	[[nodiscard]] bool skipDoctype (const char* start)
+	{
+		auto inSubset = false;
+
+		for (; current != end; ++current)
+		{
+			const auto c = *current;
+
+			if (c == '"' || c == '\'')
+			{
+				const auto* const closing = static_cast<const char*> (std::memchr (current + 1, c, static_cast<std::size_t> (end - current - 1)));
+
+				if (closing == nullptr)
+					break;
+
+				current = closing;
+			}
+			else if (c == '[')
+			{
+				inSubset = true;
+			}
+			else if (c == ']')
+			{
+				inSubset = false;
+			}
+			else if (c == '>' && ! inSubset)
+			{
+				++current;
+				return true;
+			}
+		}
+
+		return fail ("Unterminated document type declaration", start);
+	}
+
+	// Parses the root element and everything in it. Nesting is tracked with a stack of open element names rather than
+	// by recursion.
+	[[nodiscard]] bool parseElements()
+	{
+		std::vector<std::string_view> openElements;
+
+		do
+		{
+			if (isEOF())
+				return fail ("Unexpected end of input inside the element <" + std::string { openElements.back() } + ">");
+
+			if (*current != '<')
+			{
+				if (! parseText())
+					return false;
+
+				continue;
+			}
+
+			const auto* const start = current;
+
+			if (popIf ("</"))
+			{
+				if (openElements.empty())
+					return fail ("Expected the root element", start);
+
+				const auto name = readName();
+
+				skipWhitespace();
+
+				if (name.empty() || ! popIf (">"))
+					return fail ("Malformed end tag", start);
+
+				if (name != openElements.back())
+					return fail ("The end tag </" + std::string { name } + "> doesn't match the start tag <"
+									 + std::string { openElements.back() } + ">",
+								 start);
+
+				handler.endElement (name);
+				openElements.pop_back();
+			}
+			else if (popIf ("<!--"))
+			{
+				if (openElements.empty())
+					return fail ("Expected the root element", start);
+
+				if (! skipPast ("-->", "comment", start))
+					return false;
+			}
+			else if (popIf ("<![CDATA["))
+			{
+				if (openElements.empty())
+					return fail ("Expected the root element", start);
+
+				const auto pos = std::string_view { current, static_cast<std::size_t> (end - current) }.find ("]]>");
+
+				if (pos == std::string_view::npos)
+					return fail ("Unterminated CDATA section", start);
+
+				if (pos > 0)
+					handler.text ({ current, pos });
+
+				current += pos + 3;
+			}
+			else if (popIf ("<?"))
+			{
+				if (openElements.empty())
+					return fail ("Expected the root element", start);
+
+				if (! skipPast ("?>", "processing instruction", start))
+					return false;
+			}
+			else
+			{
+				++current;
+
+				bool isEmptyElement = false;
+
+				const auto name = parseStartTag (isEmptyElement, start);
+
+				if (name.empty())
+					return false;
+
+				if (isEmptyElement)
+				{
+					handler.endElement (name);
+				}
+				else
+				{
+					if (openElements.size() == maxDepth)
+						return fail ("The elements are nested too deeply", start);
+
+					openElements.push_back (name);
+				}
+			}
+		} while (! openElements.empty());
+
+		return true;
+	}
+
+	// parses the rest of a start tag after the '<', and returns the element's name, or an empty view on failure
+	[[nodiscard]] std::string_view parseStartTag (bool& isEmptyElement, const char* start)
+	{
+		const auto name = readName();
+
+		if (name.empty())
+		{
+			fail ("Expected an element name", start);
+			return {};
+		}
+
+		attributes.clear();
+
+		std::size_t numDecoded = 0;
+
+		for (;;)
+		{
+			const auto hadWhitespace = skipWhitespace();
+
+			if (popIf (">"))
+				break;
+
+			if (popIf ("/>"))
+			{
+				isEmptyElement = true;
+				break;
+			}
+
+			if (isEOF())
+			{
+				fail ("Unterminated start tag", start);
+				return {};
+			}
+
+			const auto* const attributeStart = current;
+
+			const auto attributeName = readName();
+
+			if (attributeName.empty() || ! hadWhitespace)
+			{
+				fail ("Expected an attribute name, '>' or '/>'");
+				return {};
+			}
+
+			skipWhitespace();
+
+			if (! popIf ("="))
+			{
+				fail ("Expected '=' after the attribute name");
+				return {};
+			}
+
+			skipWhitespace();
+
+			if (isEOF() || (*current != '"' && *current != '\''))
+			{
+				fail ("Expected a quoted attribute value");
+				return {};
+			}
+
+			const auto quote = *current++;
+
+			const auto* const valueStart = current;
+
+			current = simd::findXMLAttributeSpecial (current, end, quote);
+
+			std::string_view value { valueStart, static_cast<std::size_t> (current - valueStart) };
+
+			// values with entities or whitespace characters other than spaces are decoded into a buffer of their own
+			if (current != end && *current != quote)
+			{
+				if (decodedValues.size() == numDecoded)
+					decodedValues.emplace_back();
+
+				auto& decoded = decodedValues[numDecoded++];
+
+				decoded.assign (value);
+
+				if (! decodeAttributeValue (quote, decoded))
+					return {};
+
+				value = decoded;
+			}
+
+			if (! popIf (std::string_view { &quote, 1 }))
+			{
+				fail ("Unterminated attribute value", attributeStart);
+				return {};
+			}
+
+			for (const auto& attribute : attributes)
+			{
+				if (attribute.name == attributeName)
+				{
+					fail ("Duplicate attribute '" + std::string { attributeName } + "'", attributeStart);
+					return {};
+				}
+			}
+
+			attributes.push_back ({ attributeName, value });
+		}
+
+		handler.startElement (name, std::span<const XMLAttribute> { attributes });
+
+		return name;
+	}
+
+	// continues decoding an attribute value from the first character that can't be copied as it is
+	[[nodiscard]] bool decodeAttributeValue (char quote, std::string& output)
+	{
+		while (current != end && *current != quote)
+		{
+			const auto c = *current;
+
+			if (c == '<')
+				return fail ("'<' isn't allowed in attribute values");
+
+			if (c == '&')
+			{
+				if (! decodeReference (output))
+					return false;
+			}
+			else if (c == '\r' || c == '\n' || c == '\t')
+			{
+				// line breaks are normalized to '\n', and then all whitespace characters to spaces
+				if (c == '\r' && current + 1 != end && current[1] == '\n')
+					++current;
+
+				output += ' ';
+				++current;
+			}
+			else if (static_cast<unsigned char> (c) < 0x20)
+			{
+				return fail ("Control characters aren't allowed in XML");
+			}
+			else
+			{
+				output += c;
+				++current;
+			}
+
+			const auto* const runStart = current;
+
+			current = simd::findXMLAttributeSpecial (current, end, quote);
+
+			output.append (runStart, current);
+		}
+
+		return true;
+	}
+
+	// character data, which is passed to the handler as it is unless it has references or carriage returns
+	[[nodiscard]] bool parseText()
+	{
+		const auto* const start = current;
+
+		current = simd::findXMLTextSpecial (current, end);
+
+		if (current == end || *current == '<')
+		{
+			handler.text ({ start, static_cast<std::size_t> (current - start) });
+			return true;
+		}
+
+		textBuffer.assign (start, current);
+
+		while (current != end && *current != '<')
+		{
+			if (*current == '&')
+			{
+				if (! decodeReference (textBuffer))
+					return false;
+			}
+			else
+			{
+				// a carriage return, which is normalized to a line feed, along with any line feed following it
+				textBuffer += '\n';
+
+				if (++current != end && *current == '\n')
+					++current;
+			}
+
+			const auto* const runStart = current;
+
+			current = simd::findXMLTextSpecial (current, end);
+
+			textBuffer.append (runStart, current);
+		}
+
+		handler.text (textBuffer);
+		return true;
+	}
+
+	// decodes the entity or character reference at the current position, which is a '&'
+	[[nodiscard]] bool decodeReference (std::string& output)
+	{
+		const auto* const start = current;
+
+		// the longest reference is a character reference with leading zeros, but none is longer than this in practice
+		static constexpr auto maxReferenceLength = std::size_t { 32 };
+
+		const auto remaining = std::string_view { current, static_cast<std::size_t> (end - current) }.substr (0, maxReferenceLength);
+
+		const auto semicolon = remaining.find (';');
+
+		if (semicolon == std::string_view::npos)
+			return fail ("Unterminated entity reference", start);
 
-		static const ExtensionsHolder holder;
+		const auto reference = remaining.substr (1, semicolon - 1);
 
-		return holder.xtns;
+		current += semicolon + 1;
+
+		if (reference == "lt")
+			output += '<';
+		else if (reference == "gt")
+			output += '>';
+		else if (reference == "amp")
+			output += '&';
+		else if (reference == "quot")
+			output += '"';
+		else if (reference == "apos")
+			output += '\'';
+		else if (reference.starts_with ('#'))
+			return decodeCharacterReference (reference.substr (1), output, start);
+		else
+			return fail ("Unknown entity '&" + std::string { reference } + ";'", start);
+
+		return true;
 	}
 
-	[[nodiscard]] Node parse (std::string_view string) const final;
+	[[nodiscard]] bool decodeCharacterReference (std::string_view digits, std::string& output, const char* start)
+	{
+		auto base = 10U;
+
+		if (digits.starts_with ('x'))
+		{
+			base = 16;
+			digits.remove_prefix (1);
+		}
+
+		if (digits.empty())
+			return fail ("Malformed character reference", start);
+
+		std::uint32_t codepoint = 0;
+
+		for (const auto c : digits)
+		{
+			auto digit = 16U;
+
+			if (c >= '0' && c <= '9')
+				digit = static_cast<unsigned> (c - '0');
+			else if (c >= 'a' && c <= 'f')
+				digit = static_cast<unsigned> (c - 'a' + 10);
+			else if (c >= 'A' && c <= 'F')
+				digit = static_cast<unsigned> (c - 'A' + 10);
+
+			if (digit >= base)
+				return fail ("Malformed character reference", start);
+
+			codepoint = codepoint * base + digit;
+
+			if (codepoint > 0x10FFFF)
+				return fail ("Character reference out of range", start);
+		}
+
+		const auto isAllowed = codepoint == 0x9 || codepoint == 0xA || codepoint == 0xD
+							|| (codepoint >= 0x20 && ! utf8::isHighSurrogate (codepoint) && ! utf8::isLowSurrogate (codepoint)
+								&& codepoint != 0xFFFE && codepoint != 0xFFFF);
+
+		if (! isAllowed)
+			return fail ("Character reference to a character that isn't allowed in XML", start);
+
+		char utf8Bytes[4];
+
+		output.append (utf8Bytes, utf8::encode (utf8Bytes, codepoint));
+
+		return true;
+	}
 
-	[[nodiscard]] std::unique_ptr<Printer> createPrinter (bool shouldPrettyPrint) const noexcept final;
+	const std::string_view source;
+	const char*			   current;
+	const char* const	   end;
 
-	[[nodiscard]] std::unique_ptr<Schema> createSchemaFrom (const Node& data) const noexcept final;
+	Handler& handler;
+
+	std::vector<XMLAttribute> attributes;
+
+	// a deque, so that adding a buffer doesn't move the ones that attribute values point into
+	std::deque<std::string> decodedValues;
+
+	std::string textBuffer;
+
+	std::string errorMessage;
+	const char* errorPos { nullptr };
 };
 
-LSERIAL_NO_EXPORT static const KnownFormats::Register<XMLFormat> xml_init;
+// Builds Nodes from the parser's events, as described in the XMLFormat class documentation
+class LSERIAL_NO_EXPORT NodeBuilder final
+{
+public:
+	void startElement (std::string_view name, std::span<const XMLAttribute> attributes)
+	{
+		// the frames are reused, so that their text buffers keep their capacity
+		if (depth == frames.size())
+			frames.emplace_back();
 
-/*-----------------------------------------------------------------------------------------------------------------------*/
+		auto& frame = frames[depth++];
+
+		frame.name = name;
+		frame.text.clear();
+
+		if (attributes.empty())
+		{
+			frame.value = Node {};
+			return;
+		}
+
+		frame.value = Node { ObjectType::Object };
+
+		auto& object = frame.value.getObject();
+
+		for (const auto& attribute : attributes)
+			object.try_emplace ("@" + std::string { attribute.name }, Node::createString (attribute.value));
+	}
+
+	void endElement (std::string_view)
+	{
+		auto& frame = frames[--depth];
+
+		if (frame.value.isObject())
+		{
+			if (! isAllWhitespace (frame.text))
+				frame.value.getObject().try_emplace ("#text", Node::createString (frame.text));
+		}
+		else if (! frame.text.empty())
+		{
+			frame.value = Node::createString (frame.text);
+		}
+
+		auto& parent = depth == 0 ? result : frames[depth - 1].value;
+
+		if (! parent.isObject())
+			parent = Node { ObjectType::Object };
+
+		auto& siblings = parent.getObject();
+
+		const auto [iter, added] = siblings.try_emplace (std::string { frame.name });
+
+		if (added)
+		{
+			iter->second = std::move (frame.value);
+			return;
+		}
+
+		// a repeated element, so its value joins the values of the earlier ones in an array
+		if (! iter->second.isArray())
+		{
+			auto first = std::move (iter->second);
+
+			iter->second = Node { ObjectType::Array };
+			iter->second.getArray().push_back (std::move (first));
+		}
+
+		iter->second.getArray().push_back (std::move (frame.value));
+	}
+
+	void text (std::string_view text)
+	{
+		auto& frame = frames[depth - 1];
+
+		// the whitespace between child elements is never kept, so don't bother buffering it
+		if (frame.value.isObject() && frame.text.empty() && isAllWhitespace (text))
+			return;
+
+		frame.text.append (text);
+	}
+
+	Node result { ObjectType::Object };
+
+private:
+	struct Frame final
+	{
+		std::string_view name;
+		Node			 value;
+		std::string		 text;
+	};
 
-Node XMLFormat::parse (std::string_view /*string*/) const
+	std::vector<Frame> frames;
+	std::size_t		   depth { 0 };
+};
+
+// Passes the parser's events on to a user's handler
+class LSERIAL_NO_EXPORT HandlerAdapter final
 {
-	return {};
-
-	//	struct Parser final
-	//	{
-	//	public:
-	//		explicit Parser (const std::string_view& xmlText)
-	//			: source (xmlText), current (xmlText)
-	//		{
-	//		}
-	//
-	//		inline Node parse()
-	//		{
-	//			skipCommentsAndWhitespace();
-	//
-	//			// skip the XML declaration
-	//
-	//			return Node::createNull();
-	//		}
-	//
-	//	private:
-	//		inline void skipCommentsAndWhitespace()
-	//		{
-	//			// whitespace
-	//			for (auto p = current;
-	//				 std::isspace (static_cast<unsigned char> (p.popFirstChar()));
-	//				 current = p)
-	//				;
-	//
-	//			// comments
-	//			if (current.startsWith ("<!--"))
-	//			{
-	//				current = current.find ("-->");
-	//				current += 3;
-	//			}
-	//		}
-	//
-	//		// finds the closing tag, advances the current pointer
-	//		// to the end of the closing tag, and returns all text
-	//		// between the opening and closing tags
-	//		inline std::string_view getTextBetweenTags()
-	//		{
-	//			skipCommentsAndWhitespace();
-	//
-	//			if (! current.skipIfStartsWith ('<'))
-	//			{
-	//				// throw error
-	//			}
-	//
-	//			const auto* tagNameStart = current.data();
-	//
-	//			current = current.find ('>');
-	//			--current;
-	//
-	//			const std::string_view tagName { tagNameStart, current.data() };
-	//
-	//			current += 2;
-	//
-	//			const auto* contentStart = current.data();
-	//
-	//			std::stringstream stream;
-	//
-	//			stream << "</" << tagName << '>';
-	//
-	//			const auto endTag = stream.str();
-	//
-	//			current = current.find (endTag);
-	//			--current;
-	//
-	//			std::string_view tagContent { contentStart, current.data() };
-	//
-	//			current += endTag.length();
-	//
-	//			return tagContent;
-	//		}
-	//
-	//		inline Node parseArray()
-	//		{
-	//		}
-	//
-	//		inline Node parseObject()
-	//		{
-	//		}
-	//
-	//		inline Node parseValue()
-	//		{
-	//		}
-	//
-	//		text::utf8::Pointer source, current;
-	//	};
-	//
-	//	Parser p { string };
-	//
-	//	return p.parse();
+public:
+	explicit HandlerAdapter (XMLHandler& handlerToUse) noexcept
+		: handler (handlerToUse)
+	{
+	}
+
+	void startElement (std::string_view name, std::span<const XMLAttribute> attributes)
+	{
+		handler.startElement (name, attributes);
+	}
+
+	void endElement (std::string_view name)
+	{
+		handler.endElement (name);
+	}
+
+	void text (std::string_view text)
+	{
+		if (! text.empty())
+			handler.text (text);
+	}
+
+private:
+	XMLHandler& handler;
+};
+
+}  // namespace xml
+
+Node XMLFormat::parse (std::string_view string) const
+{
+	return tryParse (string).getNode();
 }
 
-/*-----------------------------------------------------------------------------------------------------------------------*/
+ParseResult XMLFormat::tryParse (std::string_view string) const
+{
+	xml::NodeBuilder builder;
+
+	xml::XMLParser p { string, builder };
+
+	if (! p.parse())
+		return p.getError();
 
-static inline std::string quoteString (std::string_view input)
+	return std::move (builder.result);
+}
+
+void XMLFormat::parse (std::string_view string, XMLHandler& handler) const
 {
-	std::string copy { input };
+	xml::HandlerAdapter adapter { handler };
 
-	static constexpr auto QUOTE_CHAR = '\'';
+	xml::XMLParser p { string, adapter };
 
-	if (! copy.starts_with (QUOTE_CHAR))
-		copy.insert (0, std::string { QUOTE_CHAR });
+	if (! p.parse())
+		throw p.getError();
+}
 
-	if (! copy.ends_with (QUOTE_CHAR))
-		copy += QUOTE_CHAR;
+bool XMLFormat::probablyMatchesString (std::string_view string) const noexcept
+{
+	if (string.starts_with ("\xEF\xBB\xBF"))
+		string.remove_prefix (3);
 
-	return copy;
+	while (! string.empty() && xml::isWhitespace (string.front()))
+		string.remove_prefix (1);
+
+	if (string.size() < 2 || string[0] != '<')
+		return false;
+
+	return string[1] == '?' || string[1] == '!' || (xml::nameCharTable[static_cast<unsigned char> (string[1])] & 1) != 0;
 }
 
-std::unique_ptr<Printer> XMLFormat::createPrinter ([[maybe_unused]] bool shouldPrettyPrint) const noexcept
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+namespace xml
+{
+
+// Writes Nodes as XML, as described in the XMLFormat class documentation. This overrides print()
+// rather than deriving from StaticPrinter, because an element's name comes from its parent.
+class LSERIAL_NO_EXPORT XMLPrinter final : public Printer
 {
-	class XMLPrinter final : public Printer
+public:
+	explicit XMLPrinter (const XMLPrinterOptions& printerOptions)
+		: options (printerOptions)
 	{
-	public:
-	private:
-		std::string printNull() final
+	}
+
+	using Printer::print;
+
+	void print (const Node& node, OutputSink& sink) final
+	{
+		if (options.writeDeclaration)
+			sink.write (options.prettyPrint ? "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" : "<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
+
+		depth		= 0;
+		isIndenting = true;
+		isAtStart	= true;
+
+		if (node.isObject())
 		{
-			return "";
+			const auto& object = node.getObject();
+
+			if (object.size() == 1)
+			{
+				const auto& [name, value] = *object.begin();
+
+				if (! value.isArray() && ! (options.mapAttributes && (name.starts_with ('@') || name == textKey)))
+				{
+					writeElement (name, value, sink);
+					endDocument (sink);
+					return;
+				}
+			}
 		}
 
-		std::string printNumber (double number) final
+		writeElement (options.rootElementName, node, sink);
+		endDocument (sink);
+	}
+
+private:
+	static constexpr auto textKey = "#text";
+
+	// the content of an element, which is written between its tags
+
+	void printNull (OutputSink&) final
+	{
+	}
+
+	void printNumber (double number, OutputSink& sink) final
+	{
+		if (std::isfinite (number))
 		{
-			return quoteString (std::to_string (number));
+			char buffer[32];
+
+			const auto result = std::to_chars (std::begin (buffer), std::end (buffer), number);
+
+			sink.write (std::string_view { buffer, static_cast<std::size_t> (result.ptr - buffer) });
+			return;
 		}
 
-		std::string printString (std::string_view string) final
+		// the spellings used by XML Schema
+		if (std::isnan (number))
+			sink.write ("NaN");
+		else if (number >= 0)
+			sink.write ("INF");
+		else
+			sink.write ("-INF");
+	}
+
+	void printString (std::string_view string, OutputSink& sink) final
+	{
+		writeEscaped (string, false, sink);
+	}
+
+	void printBoolean (bool boolean, OutputSink& sink) final
+	{
+		if (boolean)
+			sink.write ("true");
+		else
+			sink.write ("false");
+	}
+
+	// an array nested directly in another array, which has no name of its own for its items
+	void printArray (const Array& array, OutputSink& sink) final
+	{
+		++depth;
+
+		// each item is its own element, so that an array among the items isn't flattened into its siblings
+		for (const auto& item : array)
+			writeElement ("item", item, sink);
+
+		--depth;
+
+		writeLineBreak (sink);
+	}
+
+	void printObject (const Object& object, OutputSink& sink) final
+	{
+		auto text = options.mapAttributes ? object.find (textKey) : object.end();
+
+		if (text != object.end() && isScalar (text->second))
+			Printer::print (text->second, sink);
+		else
+			text = object.end();
+
+		// indenting the children of an element that has text would change its text
+		const auto shouldIndent = text == object.end();
+
+		const auto wasIndenting = std::exchange (isIndenting, shouldIndent);
+
+		++depth;
+
+		for (auto member = object.begin(); member != object.end(); ++member)
+			if (member != text && ! isAttribute (*member))
+				writeMember (member->first, member->second, sink);
+
+		--depth;
+
+		writeLineBreak (sink);
+
+		isIndenting = wasIndenting;
+	}
+
+	// the elements themselves
+
+	void writeMember (std::string_view name, const Node& value, OutputSink& sink)
+	{
+		if (! value.isArray())
 		{
-			return quoteString (string);
+			writeElement (name, value, sink);
+			return;
 		}
 
-		std::string printBoolean (bool boolean) final
+		for (const auto& item : value.getArray())
+			writeElement (name, item, sink);
+	}
+
+	void writeElement (std::string_view name, const Node& value, OutputSink& sink)
+	{
+		writeLineBreak (sink);
+
+		std::string replacementName;
+
+		const auto elementName = getValidName (name, replacementName);
+
+		// the name may be a repaired copy that only lives as long as this function, so it's copied
+		sink.write ('<');
+		sink.write (elementName);
+
+		auto hasContent = true;
+
+		if (value.isObject())
 		{
-			if (boolean)
-				return "true";
+			const auto& object = value.getObject();
 
-			return "false";
-		}
+			auto numAttributes = std::size_t { 0 };
+
+			// the keys starting with '@' sort next to each other, so the attributes are found without looking at every member
+			if (options.mapAttributes)
+			{
+				for (auto member = object.lower_bound ("@"); member != object.end() && member->first.starts_with ('@'); ++member)
+				{
+					if (isAttribute (*member))
+					{
+						writeAttribute (std::string_view { member->first }.substr (1), member->second, sink);
+						++numAttributes;
+					}
+				}
+			}
 
-		std::string printArray (const Array& /*array*/) final
+			hasContent = numAttributes < object.size();
+		}
+		else if (value.isArray())
 		{
-			return {};
+			hasContent = ! value.getArray().empty();
+		}
+		else
+		{
+			hasContent = ! value.isNull();
 		}
 
-		std::string printObject (const Object& /*object*/) final
+		if (! hasContent)
 		{
-			return {};
+			sink.write ("/>");
+			return;
 		}
 
-		void arrayBegin() final
+		sink.write ('>');
+
+		Printer::print (value, sink);
+
+		sink.write ("</");
+		sink.write (elementName);
+		sink.write ('>');
+	}
+
+	void writeAttribute (std::string_view name, const Node& value, OutputSink& sink)
+	{
+		std::string replacementName;
+
+		sink.write (' ');
+		sink.write (getValidName (name, replacementName));
+		sink.write ("=\"");
+
+		if (value.isString())
+			writeEscaped (value.getString(), true, sink);
+		else
+			Printer::print (value, sink);
+
+		sink.write ('"');
+	}
+
+	// members named "@name" are written as attributes, unless their values are arrays or objects
+	[[nodiscard]] bool isAttribute (const Object::value_type& member) const noexcept
+	{
+		return options.mapAttributes && member.first.size() > 1 && member.first.front() == '@' && isScalar (member.second);
+	}
+
+	[[nodiscard]] static bool isScalar (const Node& node) noexcept
+	{
+		return ! node.isArray() && ! node.isObject();
+	}
+
+	void writeLineBreak (OutputSink& sink)
+	{
+		if (std::exchange (isAtStart, false) || ! options.prettyPrint || ! isIndenting)
+			return;
+
+		static constexpr std::string_view spaces { "                                                                " };
+
+		sink.write ('\n');
+
+		for (auto numSpaces = depth * 2; numSpaces > 0;)
 		{
+			const auto numToWrite = std::min (numSpaces, spaces.size());
+
+			sink.write (spaces.substr (0, numToWrite));
+			numSpaces -= numToWrite;
 		}
+	}
+
+	void endDocument (OutputSink& sink)
+	{
+		if (options.prettyPrint)
+			sink.write ('\n');
+	}
+
+	// Returns the name if it's a valid XML name, or else a copy of it in the replacement string with
+	// underscores in place of the invalid characters
+	[[nodiscard]] static std::string_view getValidName (std::string_view name, std::string& replacement)
+	{
+		if (isValidName (name))
+			return name;
+
+		const auto isValidUTF8 = utf8::isValid (name);
+
+		replacement = name;
+
+		for (auto& c : replacement)
+			if (nameCharTable[static_cast<unsigned char> (c)] == 0 || (! isValidUTF8 && static_cast<unsigned char> (c) >= 0x80))
+				c = '_';
+
+		// names can't start with digits, '-' or '.'
+		if (replacement.empty() || (nameCharTable[static_cast<unsigned char> (replacement.front())] & 1) == 0)
+			replacement.insert (replacement.begin(), '_');
+
+		return replacement;
+	}
+
+	[[nodiscard]] static bool isValidName (std::string_view name) noexcept
+	{
+		if (name.empty() || (nameCharTable[static_cast<unsigned char> (name.front())] & 1) == 0)
+			return false;
+
+		auto isASCII = true;
 
-		void arrayEnd() final
+		for (const auto c : name)
 		{
+			const auto byte = static_cast<unsigned char> (c);
+
+			if ((nameCharTable[byte] & 2) == 0)
+				return false;
+
+			isASCII = isASCII && byte < 0x80;
 		}
 
-		void objectBegin() final
+		return isASCII || utf8::isValid (name);
+	}
+
+	// Clean runs of text are found 16 bytes at a time and referenced or copied through in bulk.
+	// Attribute values also escape quotes and whitespace other than spaces, which the parser would
+	// otherwise normalize away.
+	static void writeEscaped (std::string_view string, bool isAttributeValue, OutputSink& sink)
+	{
+		const auto* p		  = string.data();
+		const auto* const end = p + string.size();
+
+		for (;;)
 		{
+			const auto* const runStart = p;
+
+			auto sawNonASCII = false;
+
+			p = simd::findXMLEscape (p, end, sawNonASCII);
+
+			if (p != runStart)
+			{
+				if (sawNonASCII && ! utf8::isValid (runStart, p))
+					writeWithReplacementCharacters (runStart, p, sink);
+				else
+					sink.writeReferenced (std::string_view { runStart, static_cast<std::size_t> (p - runStart) });
+			}
+
+			if (p == end)
+				return;
+
+			switch (const auto c = *p++)
+			{
+				case '&' : sink.write ("&amp;"); break;
+				case '<' : sink.write ("&lt;"); break;
+				case '>' : sink.write ("&gt;"); break;
+				case '\r' : sink.write ("&#13;"); break;
+				case '"' : isAttributeValue ? sink.write ("&quot;") : sink.write (c); break;
+				case '\n' : isAttributeValue ? sink.write ("&#10;") : sink.write (c); break;
+				case '\t' : isAttributeValue ? sink.write ("&#9;") : sink.write (c); break;
+				default : sink.write ("\xEF\xBF\xBD");
+			}
 		}
+	}
 
-		void objectEnd() final
+	static void writeWithReplacementCharacters (const char* p, const char* end, OutputSink& sink)
+	{
+		while (p != end)
 		{
+			const auto* const charStart = p;
+
+			if (utf8::decode (p, end) == 0xFFFD && ! utf8::isValid (charStart, p))
+				sink.write ("\xEF\xBF\xBD");
+			else
+				sink.write (std::string_view { charStart, static_cast<std::size_t> (p - charStart) });
 		}
-	};
+	}
+
+	const XMLPrinterOptions options;
+
+	std::size_t depth { 0 };
+	bool		isIndenting { true }, isAtStart { true };
+};
 
-	return std::make_unique<XMLPrinter>();
+}  // namespace xml
+
+std::unique_ptr<Printer> XMLFormat::createPrinter (bool shouldPrettyPrint) const noexcept
+{
+	XMLPrinterOptions options;
+
+	options.prettyPrint = shouldPrettyPrint;
+
+	return std::make_unique<xml::XMLPrinter> (options);
+}
+
+std::unique_ptr<Printer> XMLFormat::createPrinter (const XMLPrinterOptions& options) const
+{
+	return std::make_unique<xml::XMLPrinter> (options);
 }
 
 /*-----------------------------------------------------------------------------------------------------------------------*/
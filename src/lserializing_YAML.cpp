@@ -12,116 +12,2236 @@
  * ======================================================================================
  */
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <limits>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "lserializing/lserializing_YAML.h"
 #include "lserializing/lserializing_SerializingFormat.h"
 #include "lserializing/lserializing_KnownFormats.h"
 #include "lserializing/lserializing_Node.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include "lserializing/lserializing_Printer.h"
 #include "lserializing/lserializing_Export.h"
+#include "lserializing_UTF8.h"
 
 namespace limes::serializing
 {
 
-class LSERIAL_NO_EXPORT YAMLFormat final : public Format
+LSERIAL_NO_EXPORT static const KnownFormats::Register<YAMLFormat> yaml_init;
+
+YAMLFormat::YAMLFormat (const YAMLParserLimits& limitsToUse) noexcept
+	: limits (limitsToUse)
+{
+}
+
+const YAMLParserLimits& YAMLFormat::getLimits() const noexcept
+{
+	return limits;
+}
+
+std::string_view YAMLFormat::getName() const noexcept
+{
+	return formats::YAML;
+}
+
+bool YAMLFormat::supportsComments() const noexcept
+{
+	return true;
+}
+
+const std::vector<std::string_view>& YAMLFormat::getFileExtensions() const noexcept
+{
+	struct ExtensionsHolder final
+	{
+		std::vector<std::string_view> xtns;
+
+		ExtensionsHolder()
+		{
+			xtns.emplace_back (".yaml");
+			xtns.emplace_back (".yml");
+		}
+	};
+
+	static const ExtensionsHolder holder;
+
+	return holder.xtns;
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+namespace yaml
+{
+
+[[nodiscard]] static constexpr bool isBreak (char c) noexcept
+{
+	return c == '\n' || c == '\r';
+}
+
+[[nodiscard]] static constexpr bool isBlank (char c) noexcept
+{
+	return c == ' ' || c == '\t';
+}
+
+[[nodiscard]] static constexpr bool isFlowIndicator (char c) noexcept
+{
+	return c == ',' || c == '[' || c == ']' || c == '{' || c == '}';
+}
+
+// the characters that can't start a plain scalar, unless (for '-', '?' and ':') a non-blank character follows
+[[nodiscard]] static constexpr bool isIndicator (char c) noexcept
+{
+	switch (c)
+	{
+		case '-' :
+		case '?' :
+		case ':' :
+		case ',' :
+		case '[' :
+		case ']' :
+		case '{' :
+		case '}' :
+		case '#' :
+		case '&' :
+		case '*' :
+		case '!' :
+		case '|' :
+		case '>' :
+		case '\'' :
+		case '"' :
+		case '%' :
+		case '@' :
+		case '`' : return true;
+		default : return false;
+	}
+}
+
+[[nodiscard]] static bool isDigits (std::string_view text, bool (*isDigit) (char)) noexcept
+{
+	return ! text.empty() && std::all_of (text.begin(), text.end(), isDigit);
+}
+
+[[nodiscard]] static bool isDecimalDigit (char c) noexcept
+{
+	return c >= '0' && c <= '9';
+}
+
+// Converts a plain scalar to a number if it matches one of the core schema's number forms
+[[nodiscard]] static bool parseNumber (std::string_view text, double& number) noexcept
+{
+	if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'o'))
+	{
+		const auto base	  = text[1] == 'x' ? 16 : 8;
+		const auto digits = text.substr (2);
+
+		std::uint64_t value = 0;
+
+		const auto result = std::from_chars (digits.data(), digits.data() + digits.size(), value, base);
+
+		if (result.ec != std::errc {} || result.ptr != digits.data() + digits.size())
+			return false;
+
+		number = static_cast<double> (value);
+		return true;
+	}
+
+	auto unsignedText = text;
+
+	if (unsignedText.starts_with ('-') || unsignedText.starts_with ('+'))
+		unsignedText.remove_prefix (1);
+
+	if (unsignedText == ".inf" || unsignedText == ".Inf" || unsignedText == ".INF")
+	{
+		number = text.front() == '-' ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+		return true;
+	}
+
+	if (text == ".nan" || text == ".NaN" || text == ".NAN")
+	{
+		number = std::numeric_limits<double>::quiet_NaN();
+		return true;
+	}
+
+	// [-+]? ( \. [0-9]+ | [0-9]+ ( \. [0-9]* )? ) ( [eE] [-+]? [0-9]+ )?
+	auto rest = unsignedText;
+
+	const auto mantissaDigits = std::min (rest.find_first_not_of ("0123456789"), rest.size());
+
+	rest.remove_prefix (mantissaDigits);
+
+	auto fractionDigits = std::size_t { 0 };
+
+	if (rest.starts_with ('.'))
+	{
+		rest.remove_prefix (1);
+		fractionDigits = std::min (rest.find_first_not_of ("0123456789"), rest.size());
+		rest.remove_prefix (fractionDigits);
+	}
+
+	if (mantissaDigits == 0 && fractionDigits == 0)
+		return false;
+
+	if (rest.starts_with ('e') || rest.starts_with ('E'))
+	{
+		rest.remove_prefix (1);
+
+		if (rest.starts_with ('-') || rest.starts_with ('+'))
+			rest.remove_prefix (1);
+
+		if (! isDigits (rest, isDecimalDigit))
+			return false;
+
+		rest = {};
+	}
+
+	if (! rest.empty())
+		return false;
+
+	// std::from_chars doesn't accept a leading '+'
+	const auto digits = text.front() == '+' ? text.substr (1) : text;
+
+	const auto result = std::from_chars (digits.data(), digits.data() + digits.size(), number);
+
+	// out-of-range values saturate, as they do in JSON
+	if (result.ec == std::errc::result_out_of_range)
+		number = digits.front() == '-' ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+
+	return true;
+}
+
+[[nodiscard]] static bool isNull (std::string_view text) noexcept
+{
+	return text.empty() || text == "~" || text == "null" || text == "Null" || text == "NULL";
+}
+
+[[nodiscard]] static bool parseBoolean (std::string_view text, bool& value) noexcept
+{
+	if (text == "true" || text == "True" || text == "TRUE")
+	{
+		value = true;
+		return true;
+	}
+
+	if (text == "false" || text == "False" || text == "FALSE")
+	{
+		value = false;
+		return true;
+	}
+
+	return false;
+}
+
+// Resolves a plain scalar with the core schema
+[[nodiscard]] static Node resolvePlainScalar (std::string_view text)
+{
+	if (text.empty())
+		return {};
+
+	switch (text.front())
+	{
+		case '~' :
+		case 'n' :
+		case 'N' :
+			if (isNull (text))
+				return {};
+
+			break;
+
+		case 't' :
+		case 'T' :
+		case 'f' :
+		case 'F' :
+			if (bool value; parseBoolean (text, value))
+				return Node::createBoolean (value);
+
+			break;
+
+		case '-' :
+		case '+' :
+		case '.' :
+		case '0' :
+		case '1' :
+		case '2' :
+		case '3' :
+		case '4' :
+		case '5' :
+		case '6' :
+		case '7' :
+		case '8' :
+		case '9' :
+			if (double number; parseNumber (text, number))
+				return Node::createNumber (number);
+
+			break;
+
+		default : break;
+	}
+
+	return Node::createString (text);
+}
+
+[[nodiscard]] static std::size_t countNodes (const Node& node)
+{
+	auto count = std::size_t { 1 };
+
+	if (node.isArray())
+		for (const auto& child : node.getArray())
+			count += countNodes (child);
+	else if (node.isObject())
+		for (const auto& member : node.getObject())
+			count += countNodes (member.second);
+
+	return count;
+}
+
+// Parses a YAML stream one document at a time.
+//
+// This is a recursive descent parser working directly on the characters, with block structure
+// tracked through the column that each node starts at. Like the JSON parser, it reports errors by
+// recording them and returning false rather than by throwing.
+class LSERIAL_NO_EXPORT YAMLParser final
 {
 public:
-	[[nodiscard]] std::string_view getName() const noexcept final
+	YAMLParser (std::string_view inputText, const YAMLParserLimits& parserLimits)
+		: YAMLParser (inputText, inputText, parserLimits)
+	{
+	}
+
+	// Parses part of a stream, which must start at the beginning of a line. The whole stream is
+	// used to work out the line and column of errors.
+	YAMLParser (std::string_view inputText, std::string_view section, const YAMLParserLimits& parserLimits)
+		: limits (parserLimits), source (inputText), input (section), current (section.data()), end (section.data() + section.size()), lineStart (current)
+	{
+		// a byte order mark
+		if (section.data() == inputText.data() && section.starts_with ("\xEF\xBB\xBF"))
+		{
+			current += 3;
+			lineStart = current;
+		}
+	}
+
+	// Moves to the start of the next document, skipping comments, directives and document end
+	// markers. Sets foundDocument to false at the end of the stream.
+	[[nodiscard]] bool findNextDocument (bool& foundDocument)
+	{
+		if (! validated)
+		{
+			if (! utf8::isValid (input))
+				return fail ("The stream isn't valid UTF-8", input.data());
+
+			validated = true;
+		}
+
+		for (;;)
+		{
+			if (! skipToContent (true))
+				return false;
+
+			if (isEOF())
+			{
+				foundDocument = false;
+				return true;
+			}
+
+			if (getColumn() == 0 && *current == '%')
+			{
+				while (current != end && ! isBreak (*current))
+					++current;
+
+				continue;
+			}
+
+			if (isDocumentEnd())
+			{
+				current += 3;
+
+				if (! endLine())
+					return false;
+
+				continue;
+			}
+
+			foundDocument = true;
+			return true;
+		}
+	}
+
+	// Parses the document that starts at the current position, leaving the position at the start
+	// of whatever follows it
+	[[nodiscard]] bool parseDocument (Node& result)
+	{
+		if (isDocumentStart())
+			current += 3;
+
+		// anchors are local to their document
+		depth		  = 0;
+		numAliasNodes = 0;
+
+		anchors.clear();
+
+		if (! parseBlockNode (-1, Context::Document, result))
+			return false;
+
+		if (isEOF() || isDocumentStart())
+			return true;
+
+		if (isDocumentEnd())
+		{
+			current += 3;
+			return endLine();
+		}
+
+		return fail ("Unexpected content after the end of the document");
+	}
+
+	// Parses every document in the stream, passing each one to the callback once it's complete.
+	// The callback may move from the document.
+	template <typename Callback>
+	[[nodiscard]] bool parseStream (Callback&& onDocument)
+	{
+		for (;;)
+		{
+			auto foundDocument = false;
+
+			if (! findNextDocument (foundDocument))
+				return false;
+
+			if (! foundDocument)
+				return true;
+
+			Node document;
+
+			if (! parseDocument (document))
+				return false;
+
+			onDocument (document);
+		}
+	}
+
+	// parses every document in the stream, adding them to the vector
+	[[nodiscard]] bool parseStream (std::vector<Node>& documents)
+	{
+		return parseStream ([&documents] (Node& document)
+							{ documents.push_back (std::move (document)); });
+	}
+
+	[[nodiscard]] ParseError getError() const
+	{
+		const auto errorOffset = static_cast<std::size_t> (errorPos - source.data());
+
+		return ParseError { errorMessage,
+							text::utf8::LineAndColumn::find (text::utf8::Pointer { source },
+															 text::utf8::Pointer { source.substr (errorOffset) }) };
+	}
+
+private:
+	enum class Context
+	{
+		Document,
+		MappingValue,
+		SequenceEntry
+	};
+
+	// the anchor and tag that can precede a node
+	struct Properties final
+	{
+		std::string_view anchor, tag;
+
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return anchor.empty() && tag.empty();
+		}
+	};
+
+	// a scalar, before it's resolved to a Node or used as a key
+	struct Scalar final
+	{
+		std::string_view text;
+		bool			 isPlain { true };
+		const char*		 start { nullptr };
+	};
+
+	struct AnchoredNode final
+	{
+		Node		node;
+		std::size_t numNodes { 0 };
+	};
+
+	// this is far deeper than any real document, and keeps destroying the resulting Nodes from overflowing the stack
+	static constexpr auto maxDepth = std::size_t { 512 };
+
+	inline bool fail (std::string_view message, const char* position = nullptr) noexcept
+	{
+		errorMessage = message;
+		errorPos	 = position == nullptr ? current : position;
+		return false;
+	}
+
+	[[nodiscard]] inline bool isEOF() const noexcept
+	{
+		return current == end;
+	}
+
+	[[nodiscard]] inline std::ptrdiff_t getColumn() const noexcept
+	{
+		return current - lineStart;
+	}
+
+	[[nodiscard]] inline bool isBlankOrEnd (const char* p) const noexcept
+	{
+		return p == end || isBlank (*p) || isBreak (*p);
+	}
+
+	[[nodiscard]] inline bool isAtLineEnd() const noexcept
+	{
+		return current == end || isBreak (*current) || *current == '#';
+	}
+
+	[[nodiscard]] inline bool isSequenceEntry() const noexcept
+	{
+		return *current == '-' && isBlankOrEnd (current + 1);
+	}
+
+	[[nodiscard]] inline bool isMarker (char c) const noexcept
+	{
+		return current == lineStart && end - current >= 3 && current[0] == c && current[1] == c && current[2] == c
+			&& isBlankOrEnd (current + 3);
+	}
+
+	[[nodiscard]] inline bool isDocumentStart() const noexcept
+	{
+		return isMarker ('-');
+	}
+
+	[[nodiscard]] inline bool isDocumentEnd() const noexcept
+	{
+		return isMarker ('.');
+	}
+
+	inline void skipBlanks() noexcept
+	{
+		while (current != end && isBlank (*current))
+			++current;
+	}
+
+	inline void consumeBreak() noexcept
+	{
+		if (*current == '\r' && current + 1 != end && current[1] == '\n')
+			++current;
+
+		lineStart = ++current;
+	}
+
+	inline void skipComment() noexcept
+	{
+		while (current != end && ! isBreak (*current))
+			++current;
+	}
+
+	// Skips blanks, comments and line breaks, stopping at the first character of the next line
+	// with content. In block context, that line's indentation mustn't contain tabs.
+	[[nodiscard]] bool skipToContent (bool isBlockContext)
+	{
+		for (;;)
+		{
+			skipBlanks();
+
+			if (current != end && *current == '#')
+				skipComment();
+
+			if (current == end)
+				return true;
+
+			if (! isBreak (*current))
+				break;
+
+			consumeBreak();
+		}
+
+		if (isBlockContext && std::memchr (lineStart, '\t', static_cast<std::size_t> (current - lineStart)) != nullptr
+			&& std::all_of (lineStart, current, isBlank))
+			return fail ("Tabs can't be used for indentation");
+
+		return true;
+	}
+
+	// Finishes the line that a node ended on, which may only have a comment left on it, and moves
+	// to the next line with content
+	[[nodiscard]] bool endLine()
+	{
+		skipBlanks();
+
+		if (! isAtLineEnd())
+			return fail ("Unexpected characters after the value");
+
+		return skipToContent (true);
+	}
+
+	/*-------------------------------------------------------------------------------------------------------------------*/
+
+	// Parses a node in block context. The indent is the column of the collection that the node is
+	// in, which the node's own lines must be indented further than. On success, the position is at
+	// the start of the next line with content.
+	[[nodiscard]] bool parseBlockNode (std::ptrdiff_t indent, Context context, Node& result)
+	{
+		if (depth == maxDepth)
+			return fail ("The document is nested too deeply");
+
+		++depth;
+
+		skipBlanks();
+
+		Properties properties;
+
+		if (! parseProperties (properties, false))
+			return false;
+
+		auto succeeded = true;
+
+		if (isAtLineEnd())
+		{
+			// the node is on the following lines, or is empty
+			if (! skipToContent (true))
+				return false;
+
+			const auto column = getColumn();
+
+			if (isEOF() || isDocumentStart() || isDocumentEnd())
+				succeeded = applyProperties (properties, result);
+			else if (isSequenceEntry() && (column > indent || (column == indent && context == Context::MappingValue)))
+				succeeded = parseBlockSequence (column, result) && applyProperties (properties, result);
+			else if (column > indent)
+				succeeded = parseBlockContent (indent, true, properties, false, result);
+			else
+				succeeded = applyProperties (properties, result);
+		}
+		else if (isSequenceEntry())
+		{
+			if (context == Context::MappingValue)
+				return fail ("A block sequence can't start on the same line as its key");
+
+			succeeded = parseBlockSequence (getColumn(), result) && applyProperties (properties, result);
+		}
+		else
+		{
+			succeeded = parseBlockContent (indent, context != Context::MappingValue, properties, true, result);
+		}
+
+		--depth;
+		return succeeded;
+	}
+
+	// Parses a node that starts at the current position and isn't a block sequence: a block
+	// mapping, a block scalar, a flow collection, an alias or a scalar
+	[[nodiscard]] bool parseBlockContent (std::ptrdiff_t indent, bool canBeMapping, const Properties& properties,
+										  bool propertiesAreOnSameLine, Node& result)
+	{
+		const auto c = *current;
+
+		if (c == '|' || c == '>')
+			return parseBlockScalar (indent, result) && applyProperties (properties, result) && skipToContent (true);
+
+		if (c == '[' || c == '{')
+		{
+			if (! parseFlowCollection (result) || ! applyProperties (properties, result))
+				return false;
+
+			skipBlanks();
+
+			if (current != end && *current == ':')
+				return fail ("Flow collections can't be used as mapping keys");
+
+			return endLine();
+		}
+
+		if (c == '*')
+		{
+			if (! properties.empty())
+				return fail ("An alias can't have an anchor or tag");
+
+			if (! parseAlias (result))
+				return false;
+
+			skipBlanks();
+
+			if (current != end && *current == ':')
+				return fail ("Aliases can't be used as mapping keys");
+
+			return endLine();
+		}
+
+		if (c == '?' && isBlankOrEnd (current + 1))
+			return fail ("Explicit mapping keys aren't supported");
+
+		const auto column	  = getColumn();
+		const auto* const row = lineStart;
+
+		Scalar scalar;
+
+		if (! parseScalar (false, scalar))
+			return false;
+
+		skipBlanks();
+
+		if (current != end && *current == ':' && isBlankOrEnd (current + 1))
+		{
+			if (! canBeMapping)
+				return fail ("A mapping can't start on the same line as its key", scalar.start);
+
+			if (lineStart != row)
+				return fail ("Mapping keys must be on a single line", scalar.start);
+
+			// an anchor on the same line as the first key is the key's anchor, rather than the mapping's
+			if (propertiesAreOnSameLine)
+			{
+				if (! properties.anchor.empty())
+					anchorNode (properties.anchor, Node::createString (scalar.text));
+
+				return parseBlockMapping (column, scalar, result);
+			}
+
+			return parseBlockMapping (column, scalar, result) && applyProperties (properties, result);
+		}
+
+		if (scalar.isPlain && ! continuePlainScalar (indent, false, scalar))
+			return false;
+
+		return resolveScalar (scalar, properties, result) && endLine();
+	}
+
+	[[nodiscard]] bool parseBlockMapping (std::ptrdiff_t column, Scalar key, Node& result)
+	{
+		result = Node { ObjectType::Object };
+
+		auto& object = result.getObject();
+
+		std::vector<Node> merges;
+
+		for (;;)
+		{
+			// skip the ':'
+			++current;
+
+			const auto isMerge = key.isPlain && key.text == "<<";
+
+			if (isMerge)
+			{
+				if (! parseBlockNode (column, Context::MappingValue, merges.emplace_back()))
+					return false;
+			}
+			else
+			{
+				const auto [member, added] = object.try_emplace (std::string { key.text });
+
+				if (! added)
+					return fail ("Duplicate mapping key '" + member->first + "'", key.start);
+
+				if (! parseBlockNode (column, Context::MappingValue, member->second))
+					return false;
+			}
+
+			if (isEOF() || isDocumentStart() || isDocumentEnd() || getColumn() < column)
+				break;
+
+			if (getColumn() > column)
+				return fail ("Bad indentation of a mapping entry");
+
+			if (! parseBlockKey (key))
+				return false;
+		}
+
+		return applyMerges (merges, object);
+	}
+
+	// parses a key at the start of a line in a block mapping, along with its ':'
+	[[nodiscard]] bool parseBlockKey (Scalar& key)
+	{
+		const auto c = *current;
+
+		if (isSequenceEntry())
+			return fail ("Expected a mapping key, not a sequence entry");
+
+		if (c == '?' && isBlankOrEnd (current + 1))
+			return fail ("Explicit mapping keys aren't supported");
+
+		if (c == '*' || c == '[' || c == '{')
+			return fail ("Mapping keys must be scalars");
+
+		Properties properties;
+
+		if (! parseProperties (properties, false))
+			return false;
+
+		const auto* const row = lineStart;
+
+		if (! parseScalar (false, key))
+			return false;
+
+		if (lineStart != row)
+			return fail ("Mapping keys must be on a single line", key.start);
+
+		skipBlanks();
+
+		if (current == end || *current != ':' || ! isBlankOrEnd (current + 1))
+			return fail ("Expected ':' after the mapping key");
+
+		if (! properties.anchor.empty())
+			anchorNode (properties.anchor, Node::createString (key.text));
+
+		return true;
+	}
+
+	[[nodiscard]] bool parseBlockSequence (std::ptrdiff_t column, Node& result)
+	{
+		result = Node { ObjectType::Array };
+
+		auto& array = result.getArray();
+
+		for (;;)
+		{
+			// skip the '-'
+			++current;
+
+			if (! parseBlockNode (column, Context::SequenceEntry, array.emplace_back()))
+				return false;
+
+			if (isEOF() || isDocumentStart() || isDocumentEnd() || getColumn() < column)
+				return true;
+
+			if (getColumn() > column)
+				return fail ("Bad indentation of a sequence entry");
+
+			// a sequence that is a mapping's value can be at the same column as the mapping's keys
+			if (! isSequenceEntry())
+				return true;
+		}
+	}
+
+	// Parses a literal or folded block scalar. On success, the position is at the start of the
+	// first line after the scalar.
+	[[nodiscard]] bool parseBlockScalar (std::ptrdiff_t indent, Node& result)
+	{
+		const auto isFolded = *current++ == '>';
+
+		enum class Chomping
+		{
+			Clip,
+			Strip,
+			Keep
+		};
+
+		auto chomping = Chomping::Clip;
+
+		auto contentIndent = std::ptrdiff_t { -1 };
+
+		for (auto i = 0; i < 2 && current != end; ++i)
+		{
+			if (*current == '-' || *current == '+')
+				chomping = *current++ == '-' ? Chomping::Strip : Chomping::Keep;
+			else if (*current >= '1' && *current <= '9')
+				contentIndent = std::max (indent, std::ptrdiff_t { 0 }) + (*current++ - '0');
+		}
+
+		skipBlanks();
+
+		if (current != end && *current == '#')
+			skipComment();
+
+		if (current != end && ! isBreak (*current))
+			return fail ("Unexpected characters after the block scalar's header");
+
+		if (current != end)
+			consumeBreak();
+
+		std::string text;
+
+		auto numEmptyLines		   = std::size_t { 0 };
+		auto hasContent			   = false;
+		auto lastLineHasBreak	   = false;
+		auto lastLineMoreIndented = false;
+
+		while (current != end)
+		{
+			const auto* const lineBegin = current;
+
+			while (current != end && *current == ' ' && (contentIndent < 0 || current - lineBegin < contentIndent))
+				++current;
+
+			const auto numSpaces = current - lineBegin;
+
+			if (current != end && ! isBreak (*current))
+			{
+				if (contentIndent < 0)
+				{
+					// the first line with content sets the indentation
+					if (numSpaces <= indent)
+					{
+						current = lineBegin;
+						break;
+					}
+
+					contentIndent = numSpaces;
+				}
+				else if (numSpaces < contentIndent)
+				{
+					current = lineBegin;
+					break;
+				}
+
+				if (numSpaces == 0 && (isDocumentStart() || isDocumentEnd()))
+				{
+					current = lineBegin;
+					break;
+				}
+
+				const auto* const contentStart = current;
+
+				while (current != end && ! isBreak (*current))
+					++current;
+
+				const auto moreIndented = isBlank (*contentStart);
+
+				if (hasContent)
+				{
+					if (isFolded && ! moreIndented && ! lastLineMoreIndented)
+					{
+						if (numEmptyLines == 0)
+							text += ' ';
+						else
+							text.append (numEmptyLines, '\n');
+					}
+					else
+					{
+						text.append (numEmptyLines + 1, '\n');
+					}
+				}
+				else
+				{
+					text.append (numEmptyLines, '\n');
+				}
+
+				text.append (contentStart, current);
+
+				hasContent			 = true;
+				lastLineMoreIndented = moreIndented;
+				numEmptyLines		 = 0;
+				lastLineHasBreak	 = current != end;
+			}
+			else if (current != end)
+			{
+				// an empty line, or one with only indentation on it
+				++numEmptyLines;
+			}
+
+			if (current == end)
+				break;
+
+			consumeBreak();
+		}
+
+		lineStart = current;
+
+		switch (chomping)
+		{
+			case Chomping::Strip : break;
+			case Chomping::Clip :
+				if (hasContent && lastLineHasBreak)
+					text += '\n';
+
+				break;
+			case Chomping::Keep : text.append (numEmptyLines + (lastLineHasBreak ? 1 : 0), '\n'); break;
+		}
+
+		result = Node::createString (text);
+		return true;
+	}
+
+	/*-------------------------------------------------------------------------------------------------------------------*/
+
+	// skips whitespace, line breaks and comments between the tokens of a flow collection
+	inline void skipFlowSpace()
+	{
+		for (;;)
+		{
+			skipBlanks();
+
+			if (current == end)
+				return;
+
+			if (*current == '#')
+				skipComment();
+			else if (isBreak (*current))
+				consumeBreak();
+			else
+				return;
+		}
+	}
+
+	[[nodiscard]] bool parseFlowCollection (Node& result)
+	{
+		if (depth == maxDepth)
+			return fail ("The document is nested too deeply");
+
+		++depth;
+
+		const auto succeeded = *current == '[' ? parseFlowSequence (result) : parseFlowMapping (result);
+
+		--depth;
+		return succeeded;
+	}
+
+	[[nodiscard]] bool parseFlowNode (Node& result)
+	{
+		Properties properties;
+
+		return parseFlowProperties (properties) && parseFlowNodeContent (properties, result);
+	}
+
+	[[nodiscard]] bool parseFlowProperties (Properties& properties)
+	{
+		if (! parseProperties (properties, true))
+			return false;
+
+		skipFlowSpace();
+
+		if (current == end)
+			return fail ("Unexpected end of input inside a flow collection");
+
+		return true;
+	}
+
+	// returns false for the characters that start a flow node that isn't a scalar, or end an empty one
+	[[nodiscard]] static bool isFlowScalarStart (char c) noexcept
+	{
+		return c != '[' && c != '{' && c != '*' && c != ',' && c != ']' && c != '}';
+	}
+
+	[[nodiscard]] bool parseFlowNodeContent (const Properties& properties, Node& result)
+	{
+		const auto c = *current;
+
+		if (c == '[' || c == '{')
+			return parseFlowCollection (result) && applyProperties (properties, result);
+
+		if (c == '*')
+			return properties.empty() ? parseAlias (result) : fail ("An alias can't have an anchor or tag");
+
+		// a node with only properties, or nothing at all
+		if (! isFlowScalarStart (c) || (c == ':' && ! properties.empty()))
+			return applyProperties (properties, result);
+
+		Scalar scalar;
+
+		return parseScalar (true, scalar) && continuePlainScalar (-1, true, scalar) && resolveScalar (scalar, properties, result);
+	}
+
+	[[nodiscard]] bool parseFlowSequence (Node& result)
+	{
+		const auto* const start = current++;
+
+		result = Node { ObjectType::Array };
+
+		auto& array = result.getArray();
+
+		for (;;)
+		{
+			skipFlowSpace();
+
+			if (current == end)
+				return fail ("Unterminated flow sequence", start);
+
+			if (*current == ']')
+			{
+				++current;
+				return true;
+			}
+
+			if (! parseFlowSequenceEntry (array.emplace_back()))
+				return false;
+
+			skipFlowSpace();
+
+			if (current != end && *current == ',')
+				++current;
+			else if (current == end || *current != ']')
+				return fail ("Expected ',' or ']'");
+		}
+	}
+
+	// parses an entry of a flow sequence, which can be a single key/value pair; that is a mapping with one member
+	[[nodiscard]] bool parseFlowSequenceEntry (Node& result)
+	{
+		Properties properties;
+
+		if (! parseFlowProperties (properties))
+			return false;
+
+		const auto* const entryStart = current;
+
+		if (! isFlowScalarStart (*current))
+		{
+			if (! parseFlowNodeContent (properties, result))
+				return false;
+
+			skipFlowSpace();
+
+			if (current != end && *current == ':')
+				return fail ("Mapping keys must be scalars", entryStart);
+
+			return true;
+		}
+
+		Scalar scalar;
+
+		if (! parseScalar (true, scalar) || ! continuePlainScalar (-1, true, scalar))
+			return false;
+
+		skipFlowSpace();
+
+		if (current == end || *current != ':')
+			return resolveScalar (scalar, properties, result);
+
+		auto key = std::string { scalar.text };
+
+		if (! properties.anchor.empty())
+			anchorNode (properties.anchor, Node::createString (key));
+
+		++current;
+		skipFlowSpace();
+
+		Node value;
+
+		if (current != end && *current != ',' && *current != ']' && ! parseFlowNode (value))
+			return false;
+
+		result = Node { ObjectType::Object };
+		result.getObject().emplace (std::move (key), std::move (value));
+
+		return true;
+	}
+
+	[[nodiscard]] bool parseFlowMapping (Node& result)
+	{
+		const auto* const start = current++;
+
+		result = Node { ObjectType::Object };
+
+		auto& object = result.getObject();
+
+		std::vector<Node> merges;
+
+		for (;;)
+		{
+			skipFlowSpace();
+
+			if (current == end)
+				return fail ("Unterminated flow mapping", start);
+
+			if (*current == '}')
+			{
+				++current;
+				return applyMerges (merges, object);
+			}
+
+			if (*current == '?' && isBlankOrEnd (current + 1))
+			{
+				++current;
+				skipFlowSpace();
+			}
+
+			if (current != end && (*current == '[' || *current == '{' || *current == '*'))
+				return fail ("Mapping keys must be scalars");
+
+			Properties properties;
+
+			if (! parseProperties (properties, true))
+				return false;
+
+			skipFlowSpace();
+
+			Scalar key;
+
+			key.start = current;
+
+			if (current != end && *current != ':' && *current != ',' && *current != '}'
+				&& (! parseScalar (true, key) || ! continuePlainScalar (-1, true, key)))
+				return false;
+
+			// the key's text is in a scratch buffer that parsing the value may overwrite
+			auto keyText = std::string { key.text };
+
+			if (! properties.anchor.empty())
+				anchorNode (properties.anchor, Node::createString (keyText));
+
+			skipFlowSpace();
+
+			Node value;
+
+			if (current != end && *current == ':')
+			{
+				++current;
+				skipFlowSpace();
+
+				if (current != end && *current != ',' && *current != '}' && ! parseFlowNode (value))
+					return false;
+
+				skipFlowSpace();
+			}
+
+			if (key.isPlain && keyText == "<<")
+			{
+				merges.push_back (std::move (value));
+			}
+			else if (! object.try_emplace (keyText, std::move (value)).second)
+			{
+				return fail ("Duplicate mapping key '" + keyText + "'", key.start);
+			}
+
+			if (current != end && *current == ',')
+				++current;
+			else if (current == end || *current != '}')
+				return fail ("Expected ',' or '}'");
+		}
+	}
+
+	/*-------------------------------------------------------------------------------------------------------------------*/
+
+	// Parses a quoted scalar, or the first line of a plain scalar
+	[[nodiscard]] bool parseScalar (bool inFlow, Scalar& scalar)
+	{
+		scalar.start = current;
+
+		if (*current == '"')
+		{
+			scalar.isPlain = false;
+			return parseDoubleQuoted (scalar);
+		}
+
+		if (*current == '\'')
+		{
+			scalar.isPlain = false;
+			return parseSingleQuoted (scalar);
+		}
+
+		scalar.isPlain = true;
+
+		// this can only happen in a flow collection, as block nodes end at document markers
+		if (isDocumentStart() || isDocumentEnd())
+			return fail ("A document marker can't be inside a flow collection");
+
+		const auto c = *current;
+
+		const auto canStartPlain = ! isIndicator (c)
+								|| ((c == '-' || c == '?' || c == ':') && current + 1 != end && ! isBlankOrEnd (current + 1)
+									&& ! (inFlow && isFlowIndicator (current[1])));
+
+		if (! canStartPlain)
+			return fail ("Unexpected character '" + std::string (1, c) + "'");
+
+		scalar.text = scanPlainLine (inFlow);
+		return true;
+	}
+
+	// Scans one line of a plain scalar, stopping before a ": ", a " #" comment or the end of the
+	// line, and before flow indicators in flow context. Trailing blanks aren't included.
+	[[nodiscard]] std::string_view scanPlainLine (bool inFlow) noexcept
+	{
+		const auto* const start = current;
+		const auto* lastNonBlank = current;
+
+		for (auto* p = current; p != end; ++p)
+		{
+			const auto c = *p;
+
+			if (isBreak (c))
+				break;
+
+			if (c == ':' && (isBlankOrEnd (p + 1) || (inFlow && isFlowIndicator (p[1]))))
+				break;
+
+			if (c == '#' && p != start && isBlank (p[-1]))
+				break;
+
+			if (inFlow && isFlowIndicator (c))
+				break;
+
+			if (! isBlank (c))
+				lastNonBlank = p + 1;
+		}
+
+		current = lastNonBlank;
+
+		return { start, static_cast<std::size_t> (lastNonBlank - start) };
+	}
+
+	// Adds any continuation lines to a plain scalar, folding the line breaks between them. In block
+	// context, continuation lines must be indented further than the collection the scalar is in.
+	[[nodiscard]] bool continuePlainScalar (std::ptrdiff_t indent, bool inFlow, Scalar& scalar)
+	{
+		if (! scalar.isPlain)
+			return true;
+
+		auto isCopied = false;
+
+		for (;;)
+		{
+			const auto* const savedCurrent	 = current;
+			const auto* const savedLineStart = lineStart;
+
+			skipBlanks();
+
+			if (current == end || ! isBreak (*current))
+			{
+				current = savedCurrent;
+				break;
+			}
+
+			auto numBreaks = std::size_t { 0 };
+
+			while (current != end)
+			{
+				if (isBreak (*current))
+				{
+					consumeBreak();
+					++numBreaks;
+				}
+				else if (isBlank (*current))
+				{
+					++current;
+				}
+				else
+				{
+					break;
+				}
+			}
+
+			const auto canContinue = current != end && *current != '#' && (inFlow || getColumn() > indent)
+								  && ! isDocumentStart() && ! isDocumentEnd()
+								  && ! (*current == ':' && (isBlankOrEnd (current + 1) || (inFlow && isFlowIndicator (current[1]))))
+								  && ! (inFlow && isFlowIndicator (*current));
+
+			if (! canContinue)
+			{
+				current	  = savedCurrent;
+				lineStart = savedLineStart;
+				break;
+			}
+
+			if (! isCopied)
+			{
+				scratch.assign (scalar.text);
+				isCopied = true;
+			}
+
+			if (numBreaks == 1)
+				scratch += ' ';
+			else
+				scratch.append (numBreaks - 1, '\n');
+
+			scratch += scanPlainLine (inFlow);
+		}
+
+		if (isCopied)
+			scalar.text = scratch;
+
+		return true;
+	}
+
+	// folds the line break at the current position and any empty lines after it, as quoted scalars do
+	[[nodiscard]] bool foldQuotedLineBreaks (std::string& output, std::size_t keepLength)
+	{
+		// trailing blanks on the line are dropped, except for escaped ones
+		while (output.size() > keepLength && isBlank (output.back()))
+			output.pop_back();
+
+		consumeBreak();
+
+		auto numEmptyLines = std::size_t { 0 };
+
+		for (;;)
+		{
+			skipBlanks();
+
+			if (current == end || ! isBreak (*current))
+				break;
+
+			consumeBreak();
+			++numEmptyLines;
+		}
+
+		if (isDocumentStart() || isDocumentEnd())
+			return fail ("A document marker can't be inside a quoted string");
+
+		if (numEmptyLines == 0)
+			output += ' ';
+		else
+			output.append (numEmptyLines, '\n');
+
+		return true;
+	}
+
+	[[nodiscard]] bool parseSingleQuoted (Scalar& scalar)
+	{
+		const auto* const start = current++;
+
+		scratch.clear();
+
+		for (;;)
+		{
+			const auto* const runStart = current;
+
+			while (current != end && *current != '\'' && ! isBreak (*current))
+				++current;
+
+			scratch.append (runStart, current);
+
+			if (current == end)
+				return fail ("Unterminated string", start);
+
+			if (isBreak (*current))
+			{
+				if (! foldQuotedLineBreaks (scratch, 0))
+					return false;
+
+				continue;
+			}
+
+			if (current + 1 != end && current[1] == '\'')
+			{
+				scratch += '\'';
+				current += 2;
+				continue;
+			}
+
+			++current;
+			break;
+		}
+
+		scalar.text = scratch;
+		return true;
+	}
+
+	[[nodiscard]] bool parseDoubleQuoted (Scalar& scalar)
+	{
+		const auto* const start = current++;
+
+		scratch.clear();
+
+		auto keepLength = std::size_t { 0 };
+
+		for (;;)
+		{
+			const auto* const runStart = current;
+
+			while (current != end && *current != '"' && *current != '\\' && ! isBreak (*current))
+				++current;
+
+			scratch.append (runStart, current);
+
+			if (current == end)
+				return fail ("Unterminated string", start);
+
+			if (*current == '"')
+			{
+				++current;
+				break;
+			}
+
+			if (isBreak (*current))
+			{
+				if (! foldQuotedLineBreaks (scratch, keepLength))
+					return false;
+
+				continue;
+			}
+
+			if (! parseEscape())
+				return false;
+
+			keepLength = scratch.size();
+		}
+
+		scalar.text = scratch;
+		return true;
+	}
+
+	// decodes the escape sequence at the current position, which is a '\'
+	[[nodiscard]] bool parseEscape()
+	{
+		const auto* const start = current++;
+
+		if (current == end)
+			return fail ("Unterminated string");
+
+		// an escaped line break joins the lines without a space
+		if (isBreak (*current))
+		{
+			consumeBreak();
+
+			if (isDocumentStart() || isDocumentEnd())
+				return fail ("A document marker can't be inside a quoted string");
+
+			skipBlanks();
+			return true;
+		}
+
+		switch (const auto c = *current++)
+		{
+			case '0' : scratch += '\0'; return true;
+			case 'a' : scratch += '\a'; return true;
+			case 'b' : scratch += '\b'; return true;
+			case 't' :
+			case '\t' : scratch += '\t'; return true;
+			case 'n' : scratch += '\n'; return true;
+			case 'v' : scratch += '\v'; return true;
+			case 'f' : scratch += '\f'; return true;
+			case 'r' : scratch += '\r'; return true;
+			case 'e' : scratch += '\x1B'; return true;
+			case ' ' :
+			case '"' :
+			case '/' :
+			case '\\' : scratch += c; return true;
+			case 'N' : return appendCodepoint (0x85);
+			case '_' : return appendCodepoint (0xA0);
+			case 'L' : return appendCodepoint (0x2028);
+			case 'P' : return appendCodepoint (0x2029);
+			case 'x' : return parseHexEscape (2, start);
+			case 'u' : return parseHexEscape (4, start);
+			case 'U' : return parseHexEscape (8, start);
+			default : return fail ("Invalid escape sequence", start);
+		}
+	}
+
+	[[nodiscard]] bool parseHexEscape (int numDigits, const char* start)
+	{
+		if (end - current < numDigits)
+			return fail ("Invalid escape sequence", start);
+
+		std::uint32_t codepoint = 0;
+
+		const auto result = std::from_chars (current, current + numDigits, codepoint, 16);
+
+		if (result.ptr != current + numDigits)
+			return fail ("Invalid escape sequence", start);
+
+		current += numDigits;
+
+		// a UTF-16 surrogate pair, written as two escapes as in JSON
+		if (numDigits == 4 && utf8::isHighSurrogate (codepoint) && end - current >= 6 && current[0] == '\\' && current[1] == 'u')
+		{
+			std::uint32_t low = 0;
+
+			const auto lowResult = std::from_chars (current + 2, current + 6, low, 16);
+
+			if (lowResult.ptr == current + 6 && utf8::isLowSurrogate (low))
+			{
+				current += 6;
+				codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+			}
+		}
+
+		if (codepoint > 0x10FFFF || utf8::isHighSurrogate (codepoint) || utf8::isLowSurrogate (codepoint))
+			return fail ("Invalid escape sequence", start);
+
+		return appendCodepoint (codepoint);
+	}
+
+	bool appendCodepoint (std::uint32_t codepoint)
 	{
-		return formats::YAML;
+		char bytes[4];
+
+		scratch.append (bytes, utf8::encode (bytes, codepoint));
+		return true;
+	}
+
+	/*-------------------------------------------------------------------------------------------------------------------*/
+
+	// parses any anchor and tag at the current position, in either order
+	[[nodiscard]] bool parseProperties (Properties& properties, bool inFlow)
+	{
+		for (;;)
+		{
+			if (current == end)
+				return true;
+
+			if (*current == '&' && properties.anchor.empty())
+			{
+				properties.anchor = scanName();
+
+				if (properties.anchor.empty())
+					return fail ("Expected an anchor name");
+			}
+			else if (*current == '!' && properties.tag.empty())
+			{
+				properties.tag = scanTag (inFlow);
+			}
+			else
+			{
+				return true;
+			}
+
+			if (inFlow)
+				skipFlowSpace();
+			else
+				skipBlanks();
+		}
+	}
+
+	// scans an anchor or alias name, after the '&' or '*'
+	[[nodiscard]] std::string_view scanName() noexcept
+	{
+		const auto* const start = ++current;
+
+		while (current != end && ! isBlank (*current) && ! isBreak (*current) && ! isFlowIndicator (*current))
+			++current;
+
+		return { start, static_cast<std::size_t> (current - start) };
+	}
+
+	[[nodiscard]] std::string_view scanTag (bool inFlow) noexcept
+	{
+		const auto* const start = current;
+
+		if (current + 1 != end && current[1] == '<')
+		{
+			while (current != end && *current != '>' && ! isBreak (*current))
+				++current;
+
+			if (current != end && *current == '>')
+				++current;
+		}
+		else
+		{
+			while (current != end && ! isBlank (*current) && ! isBreak (*current) && ! (inFlow && isFlowIndicator (*current)))
+				++current;
+		}
+
+		return { start, static_cast<std::size_t> (current - start) };
 	}
 
-	bool supportsComments() const noexcept final
+	[[nodiscard]] bool parseAlias (Node& result)
 	{
+		const auto* const start = current;
+
+		const auto name = scanName();
+
+		const auto anchored = anchors.find (name);
+
+		if (anchored == anchors.end())
+			return fail ("Unknown alias '" + std::string { name } + "'", start);
+
+		numAliasNodes += anchored->second.numNodes;
+
+		if (numAliasNodes > limits.maxAliasNodes)
+			return fail ("The aliases in the stream expand to too many nodes", start);
+
+		result = anchored->second.node;
+		return true;
+	}
+
+	void anchorNode (std::string_view name, const Node& node)
+	{
+		auto& anchored = anchors[name];
+
+		anchored.node	  = node;
+		anchored.numNodes = countNodes (node);
+	}
+
+	[[nodiscard]] bool applyProperties (const Properties& properties, const Node& node)
+	{
+		if (! properties.anchor.empty())
+			anchorNode (properties.anchor, node);
+
 		return true;
 	}
 
-	const std::vector<std::string_view>& getFileExtensions() const noexcept final
+	// converts a scalar to a Node, as its tag or the core schema says
+	[[nodiscard]] bool resolveScalar (const Scalar& scalar, const Properties& properties, Node& result)
+	{
+		auto tag = properties.tag;
+
+		if (tag.starts_with ("!<tag:yaml.org,2002:") && tag.ends_with ('>'))
+			tag = tag.substr (20, tag.size() - 21);
+		else if (tag.starts_with ("!!"))
+			tag.remove_prefix (2);
+		else if (tag.size() > 1)
+			tag = {};
+
+		if (tag.empty())
+			result = scalar.isPlain ? resolvePlainScalar (scalar.text) : Node::createString (scalar.text);
+		else if (tag == "!" || tag == "str" || tag == "binary" || tag == "timestamp")
+			result = Node::createString (scalar.text);
+		else if (tag == "null")
+			result = Node {};
+		else if (tag == "bool")
+		{
+			bool value = false;
+
+			if (! parseBoolean (scalar.text, value))
+				return fail ("Invalid !!bool value", scalar.start);
+
+			result = Node::createBoolean (value);
+		}
+		else if (tag == "int" || tag == "float")
+		{
+			double number = 0;
+
+			if (! parseNumber (scalar.text, number))
+				return fail ("Invalid !!" + std::string { tag } + " value", scalar.start);
+
+			result = Node::createNumber (number);
+		}
+		else
+		{
+			// !!map, !!seq and the like don't make sense on a scalar, so resolve it as if it had no tag
+			result = scalar.isPlain ? resolvePlainScalar (scalar.text) : Node::createString (scalar.text);
+		}
+
+		return applyProperties (properties, result);
+	}
+
+	// Adds the members of the merge keys' mappings to the object, except where it already has
+	// members with the same keys. Earlier mappings take precedence over later ones.
+	[[nodiscard]] bool applyMerges (std::vector<Node>& merges, Object& object)
 	{
-		struct ExtensionsHolder final
+		auto mergeMapping = [&object] (Node& mapping)
 		{
-			std::vector<std::string_view> xtns;
+			for (auto& [key, value] : mapping.getObject())
+				object.try_emplace (key, std::move (value));
+		};
 
-			ExtensionsHolder()
+		for (auto& merge : merges)
+		{
+			if (merge.isObject())
 			{
-				xtns.emplace_back (".yaml");
-				xtns.emplace_back (".yml");
+				mergeMapping (merge);
+				continue;
 			}
-		};
 
-		static const ExtensionsHolder holder;
+			if (! merge.isArray())
+				return fail ("The value of a merge key must be a mapping or a sequence of mappings");
+
+			for (auto& mapping : merge.getArray())
+			{
+				if (! mapping.isObject())
+					return fail ("The value of a merge key must be a mapping or a sequence of mappings");
+
+				mergeMapping (mapping);
+			}
+		}
 
-		return holder.xtns;
+		return true;
 	}
 
-	[[nodiscard]] Node parse (std::string_view string) const final;
+	const YAMLParserLimits& limits;
 
-	[[nodiscard]] std::unique_ptr<Printer> createPrinter (bool shouldPrettyPrint) const noexcept final;
+	const std::string_view source, input;
+	const char*			   current;
+	const char* const	   end;
+	const char*			   lineStart;
+
+	bool		validated { false };
+	std::size_t depth { 0 };
+
+	std::unordered_map<std::string_view, AnchoredNode> anchors;
+	std::size_t										   numAliasNodes { 0 };
+
+	// holds the decoded text of quoted and multi-line plain scalars
+	std::string scratch;
+
+	std::string errorMessage;
+	const char* errorPos { nullptr };
 };
 
-LSERIAL_NO_EXPORT static const KnownFormats::Register<YAMLFormat> yaml_init;
+}  // namespace yaml
 
-/*-----------------------------------------------------------------------------------------------------------------------*/
+Node YAMLFormat::parse (std::string_view string) const
+{
+	return tryParse (string).getNode();
+}
 
-Node YAMLFormat::parse (std::string_view /*string*/) const
+ParseResult YAMLFormat::tryParse (std::string_view string) const
 {
-	return {};
+	std::vector<Node> documents;
+
+	yaml::YAMLParser p { string, limits };
+
+	if (! p.parseStream (documents))
+		return p.getError();
+
+	if (documents.empty())
+		return Node {};
+
+	if (documents.size() == 1)
+		return std::move (documents.front());
+
+	Node result { ObjectType::Array };
+
+	result.getArray() = std::move (documents);
+
+	return result;
 }
 
-/*-----------------------------------------------------------------------------------------------------------------------*/
+std::vector<Node> YAMLFormat::parseDocuments (std::string_view string) const
+{
+	std::vector<Node> documents;
 
-std::unique_ptr<Printer> YAMLFormat::createPrinter ([[maybe_unused]] bool shouldPrettyPrint) const noexcept
+	yaml::YAMLParser p { string, limits };
+
+	if (! p.parseStream (documents))
+		throw p.getError();
+
+	return documents;
+}
+
+// below this many bytes of input per thread, the cost of starting the threads outweighs the gains
+static constexpr auto minBytesPerParserThread = std::size_t { 64 } * 1024;
+
+namespace yaml
+{
+
+// Splits a stream into sections at the document start markers that begin lines, so that each
+// section holds whole documents. Sections are at least minSize bytes long, except the last.
+static void splitDocuments (std::string_view text, std::size_t minSize, std::vector<std::string_view>& sections)
 {
-	class YAMLPrinter final : public Printer
+	auto sectionStart = std::size_t { 0 };
+
+	for (auto pos = minSize; pos < text.size();)
 	{
-	public:
-	private:
-		std::string printNull() final
-		{
-			return {};
-		}
+		pos = text.find ("\n---", pos);
+
+		if (pos == std::string_view::npos)
+			break;
+
+		const auto afterMarker = pos + 4;
+
+		++pos;
+
+		if (afterMarker != text.size() && ! isBlank (text[afterMarker]) && ! isBreak (text[afterMarker]))
+			continue;
+
+		sections.push_back (text.substr (sectionStart, pos - sectionStart));
+
+		sectionStart = pos;
+		pos += minSize;
+	}
+
+	sections.push_back (text.substr (sectionStart));
+}
+
+}  // namespace yaml
+
+void YAMLFormat::parseDocuments (std::string_view string, const DocumentCallback& callback, std::size_t numThreads) const
+{
+	if (numThreads == 0)
+		numThreads = std::thread::hardware_concurrency();
 
-		std::string printNumber (double /*number*/) final
+	numThreads = std::min (numThreads, string.size() / minBytesPerParserThread);
+
+	if (numThreads < 2)
+	{
+		yaml::YAMLParser p { string, limits };
+
+		if (! p.parseStream (callback))
+			throw p.getError();
+
+		return;
+	}
+
+	std::vector<std::string_view> sections;
+
+	yaml::splitDocuments (string, minBytesPerParserThread, sections);
+
+	// each batch parses up to numThreads sections at once, which are freed before the next batch starts
+	std::vector<std::vector<Node>>	results (numThreads);
+	std::vector<std::exception_ptr> errors (numThreads);
+
+	for (auto batchStart = 0UL; batchStart < sections.size(); batchStart += numThreads)
+	{
+		const auto batchSize = std::min (numThreads, sections.size() - batchStart);
+
+		auto parseSection = [this, &string, &sections, &results, &errors, batchStart] (std::size_t idx)
 		{
-			return {};
-		}
+			try
+			{
+				yaml::YAMLParser p { string, sections[batchStart + idx], limits };
+
+				if (! p.parseStream (results[idx]))
+					errors[idx] = std::make_exception_ptr (p.getError());
+			}
+			catch (...)
+			{
+				errors[idx] = std::current_exception();
+			}
+		};
+
+		std::vector<std::thread> threads;
+
+		threads.reserve (batchSize - 1);
 
-		std::string printString (std::string_view /*string*/) final
+		for (auto i = 1UL; i < batchSize; ++i)
 		{
-			return {};
+			try
+			{
+				threads.emplace_back (parseSection, i);
+			}
+			catch (const std::system_error&)
+			{
+				// couldn't start a thread, so just do this section's work on this thread instead
+				parseSection (i);
+			}
 		}
 
-		std::string printBoolean (bool /*boolean*/) final
+		parseSection (0);
+
+		for (auto& thread : threads)
+			thread.join();
+
+		// the documents before an error are still passed to the callback, as they are when parsing on one thread
+		for (auto i = 0UL; i < batchSize; ++i)
 		{
-			return {};
+			for (auto& document : results[i])
+				callback (document);
+
+			std::vector<Node> {}.swap (results[i]);
+
+			if (errors[i] != nullptr)
+				std::rethrow_exception (errors[i]);
 		}
+	}
+}
+
+bool YAMLFormat::probablyMatchesString (std::string_view string) const noexcept
+{
+	auto text = string;
+
+	if (text.starts_with ("\xEF\xBB\xBF"))
+		text.remove_prefix (3);
+
+	// skip whitespace and comments
+	for (;;)
+	{
+		while (! text.empty() && (yaml::isBlank (text.front()) || yaml::isBreak (text.front())))
+			text.remove_prefix (1);
+
+		if (! text.starts_with ('#'))
+			break;
+
+		text.remove_prefix (std::min (text.find_first_of ("\r\n"), text.size()));
+	}
+
+	if (text.empty())
+		return false;
+
+	// JSON is valid YAML, but is better left to the JSON format
+	if (text.front() == '{' || text.front() == '[')
+		return false;
+
+	try
+	{
+		auto result = tryParse (string);
+
+		if (! result)
+			return false;
+
+		if (text.starts_with ("%YAML") || text.starts_with ("---"))
+			return true;
+
+		const auto& node = result.getNode();
+
+		return node.isObject() || node.isArray();
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+/*-----------------------------------------------------------------------------------------------------------------------*/
+
+namespace yaml
+{
+
+// returns true if a plain scalar with this text would be read as a string
+[[nodiscard]] static bool resolvesToString (std::string_view text) noexcept
+{
+	switch (text.front())
+	{
+		case '~' :
+		case 'n' :
+		case 'N' : return ! isNull (text);
 
-		std::string printArray (const Array& /*array*/) final
+		case 't' :
+		case 'T' :
+		case 'f' :
+		case 'F' :
 		{
-			return {};
+			bool value = false;
+			return ! parseBoolean (text, value);
 		}
 
-		std::string printObject (const Object& /*object*/) final
+		case '-' :
+		case '+' :
+		case '.' :
+		case '0' :
+		case '1' :
+		case '2' :
+		case '3' :
+		case '4' :
+		case '5' :
+		case '6' :
+		case '7' :
+		case '8' :
+		case '9' :
 		{
-			return {};
+			double number = 0;
+			return ! parseNumber (text, number);
 		}
 
-		void arrayBegin() final
+		default : return true;
+	}
+}
+
+// returns true if the string can be written as a plain scalar and be read back as the same string
+[[nodiscard]] static bool canBePlain (std::string_view text) noexcept
+{
+	if (text.empty() || isIndicator (text.front()) || isBlank (text.front()) || isBlank (text.back()) || text.back() == ':'
+		|| text.starts_with ("..."))
+		return false;
+
+	// the parser reads a plain "<<" key as a merge key
+	if (text == "<<")
+		return false;
+
+	// the parser strips a byte order mark from the start of a document
+	if (text.starts_with ("\xEF\xBB\xBF"))
+		return false;
+
+	for (auto i = std::size_t { 0 }; i < text.size(); ++i)
+	{
+		const auto c = static_cast<unsigned char> (text[i]);
+
+		if (c < 0x20 || c == 0x7F)
+			return false;
+
+		if ((c == ':' && text[i + 1] == ' ') || (c == '#' && text[i - 1] == ' '))
+			return false;
+	}
+
+	return resolvesToString (text);
+}
+
+// Writes Nodes as block-style YAML. This overrides print() rather than deriving from StaticPrinter,
+// because a collection's layout depends on whether it's a mapping's value or a sequence's entry.
+class LSERIAL_NO_EXPORT YAMLPrinter final : public Printer
+{
+public:
+	using Printer::print;
+
+	void print (const Node& node, OutputSink& sink) final
+	{
+		Printer::print (node, sink);
+
+		// non-empty collections end each of their lines themselves
+		if (! isBlockCollection (node))
+			sink.write ('\n');
+	}
+
+private:
+	[[nodiscard]] static bool isBlockCollection (const Node& node) noexcept
+	{
+		return (node.isObject() && ! node.getObject().empty()) || (node.isArray() && ! node.getArray().empty());
+	}
+
+	void printNull (OutputSink& sink) final
+	{
+		sink.write ("null");
+	}
+
+	void printNumber (double number, OutputSink& sink) final
+	{
+		if (std::isfinite (number))
 		{
+			char buffer[32];
+
+			const auto result = std::to_chars (std::begin (buffer), std::end (buffer), number);
+
+			sink.write (std::string_view { buffer, static_cast<std::size_t> (result.ptr - buffer) });
+			return;
 		}
 
-		void arrayEnd() final
+		if (std::isnan (number))
+			sink.write (".nan");
+		else if (number >= 0)
+			sink.write (".inf");
+		else
+			sink.write ("-.inf");
+	}
+
+	void printString (std::string_view string, OutputSink& sink) final
+	{
+		if (canBePlain (string))
+			sink.write (string);
+		else
+			writeQuoted (string, sink);
+	}
+
+	void printBoolean (bool boolean, OutputSink& sink) final
+	{
+		if (boolean)
+			sink.write ("true");
+		else
+			sink.write ("false");
+	}
+
+	// only called for the top level node, or for empty collections
+	void printArray (const Array& array, OutputSink& sink) final
+	{
+		if (array.empty())
+			sink.write ("[]");
+		else
+			writeSequence (array, 0, true, sink);
+	}
+
+	void printObject (const Object& object, OutputSink& sink) final
+	{
+		if (object.empty())
+			sink.write ("{}");
+		else
+			writeMapping (object, 0, true, sink);
+	}
+
+	// Each entry is written on its own line. If indentFirstLine is false, the first entry follows
+	// a "- " that is already on the line.
+	void writeMapping (const Object& object, std::size_t indent, bool indentFirstLine, OutputSink& sink)
+	{
+		for (const auto& [key, value] : object)
 		{
+			if (indentFirstLine)
+				writeIndent (indent, sink);
+
+			indentFirstLine = true;
+
+			printString (key, sink);
+			sink.write (':');
+
+			if (isBlockCollection (value))
+			{
+				sink.write ('\n');
+
+				if (value.isObject())
+					writeMapping (value.getObject(), indent + 2, true, sink);
+				else
+					writeSequence (value.getArray(), indent + 2, true, sink);
+			}
+			else
+			{
+				sink.write (' ');
+				Printer::print (value, sink);
+				sink.write ('\n');
+			}
 		}
+	}
 
-		void objectBegin() final
+	void writeSequence (const Array& array, std::size_t indent, bool indentFirstLine, OutputSink& sink)
+	{
+		for (const auto& item : array)
 		{
+			if (indentFirstLine)
+				writeIndent (indent, sink);
+
+			indentFirstLine = true;
+
+			sink.write ("- ");
+
+			if (item.isObject() && ! item.getObject().empty())
+			{
+				writeMapping (item.getObject(), indent + 2, false, sink);
+			}
+			else if (item.isArray() && ! item.getArray().empty())
+			{
+				writeSequence (item.getArray(), indent + 2, false, sink);
+			}
+			else
+			{
+				Printer::print (item, sink);
+				sink.write ('\n');
+			}
 		}
+	}
+
+	static void writeIndent (std::size_t indent, OutputSink& sink)
+	{
+		static constexpr std::string_view spaces { "                                " };
+
+		for (; indent > spaces.size(); indent -= spaces.size())
+			sink.write (spaces);
+
+		sink.write (spaces.substr (0, indent));
+	}
+
+	static void writeQuoted (std::string_view string, OutputSink& sink)
+	{
+		sink.write ('"');
+
+		auto runStart = string.begin();
 
-		void objectEnd() final
+		for (auto p = string.begin(); p != string.end(); ++p)
 		{
+			const auto c = static_cast<unsigned char> (*p);
+
+			if (c >= 0x20 && c != 0x7F && c != '"' && c != '\\')
+				continue;
+
+			sink.write (std::string_view { runStart, p });
+			runStart = p + 1;
+
+			switch (c)
+			{
+				case '"' : sink.write ("\\\""); break;
+				case '\\' : sink.write ("\\\\"); break;
+				case '\0' : sink.write ("\\0"); break;
+				case '\a' : sink.write ("\\a"); break;
+				case '\b' : sink.write ("\\b"); break;
+				case '\t' : sink.write ("\\t"); break;
+				case '\n' : sink.write ("\\n"); break;
+				case '\v' : sink.write ("\\v"); break;
+				case '\f' : sink.write ("\\f"); break;
+				case '\r' : sink.write ("\\r"); break;
+				case 0x1B : sink.write ("\\e"); break;
+				default :
+				{
+					static constexpr auto hexDigits = "0123456789ABCDEF";
+
+					const char escape[] = { '\\', 'x', hexDigits[c >> 4], hexDigits[c & 0xF] };
+
+					sink.write (std::string_view { escape, sizeof (escape) });
+				}
+			}
 		}
-	};
 
-	return std::make_unique<YAMLPrinter>();
+		sink.write (std::string_view { runStart, string.end() });
+		sink.write ('"');
+	}
+};
+
+}  // namespace yaml
+
+std::unique_ptr<Printer> YAMLFormat::createPrinter ([[maybe_unused]] bool shouldPrettyPrint) const noexcept
+{
+	return std::make_unique<yaml::YAMLPrinter>();
 }
 
 }  // namespace limes::serializing
@@ -0,0 +1,233 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_Binary.h"
+#include "lserializing/lserializing_JSON.h"
+#include "lserializing/lserializing_KnownFormats.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#define TAGS "[serializing][Binary]"
+
+namespace serial = limes::serializing;
+
+static constexpr auto document = R"({ "name": "binary", "version": 2.5, "enabled": true, "parent": null,
+"records": [ { "id": 1, "label": "one" }, { "id": 2, "label": "two" }, { "id": 3, "label": "héllo" } ],
+"empty": {}, "nothing": [] })";
+
+TEST_CASE ("Binary - round trip", TAGS)
+{
+	const serial::JSONFormat	   json;
+	const serial::BinaryFormat binary;
+
+	const auto node = json.parse (document);
+
+	const auto data = binary.serialize (node);
+
+	REQUIRE (binary.probablyMatchesString (data));
+	REQUIRE (! binary.probablyMatchesString (document));
+	REQUIRE (! json.probablyMatchesString (data));
+
+	REQUIRE (json.serialize (binary.parse (data)) == json.serialize (node));
+
+	SECTION ("Scalar root")
+	{
+		REQUIRE (binary.parse (binary.serialize (serial::Node::createNumber (-0.125))).getNumber() == -0.125);
+		REQUIRE (binary.parse (binary.serialize (serial::Node::createString (""))).getString().empty());
+		REQUIRE (binary.parse (binary.serialize (serial::Node::createNull())).isNull());
+	}
+
+	SECTION ("Names are stored once")
+	{
+		const auto records = json.parse (R"([ { "id": 1, "label": "a" }, { "id": 2, "label": "b" } ])");
+
+		const auto oneRecord = json.parse (R"([ { "id": 1, "label": "a" } ])");
+
+		// the second record adds its own values, its offset table and an array entry, but no names
+		const auto growth = binary.serialize (records).size() - binary.serialize (oneRecord).size();
+
+		REQUIRE (growth == 9 + 3 + 2 + 16 * 2 + 8);
+	}
+
+	SECTION ("Long strings")
+	{
+		const std::string text (5000, 'x');
+
+		auto array = serial::Node { serial::ObjectType::Array };
+		array.addChildString (text, "");
+
+		REQUIRE (binary.parse (binary.serialize (array))[0UL].getString() == text);
+	}
+}
+
+TEST_CASE ("Binary - views", TAGS)
+{
+	const serial::BinaryFormat binary;
+
+	const auto data = binary.serialize (serial::JSONFormat {}.parse (document));
+
+	const auto root = serial::BinaryFormat::createView (data);
+
+	REQUIRE (root.isObject());
+	REQUIRE (root.getTypeAsString() == "Object");
+	REQUIRE (root.getNumChildren() == 7);
+
+	REQUIRE (root["name"].getString() == "binary");
+	REQUIRE (root["version"].getNumber() == 2.5);
+	REQUIRE (root["enabled"].getBoolean());
+	REQUIRE (root["parent"].isNull());
+	REQUIRE (root["empty"].isObject());
+	REQUIRE (root["empty"].getNumChildren() == 0);
+	REQUIRE (root["nothing"].getNumChildren() == 0);
+
+	const auto records = root["records"];
+
+	REQUIRE (records.isArray());
+	REQUIRE (records.getNumChildren() == 3);
+	REQUIRE (records[1UL]["label"].getString() == "two");
+	REQUIRE (records[2UL]["label"].getString() == "h\xC3\xA9llo");
+
+	// object members are indexed in sorted order
+	REQUIRE (root.getChildName (0) == "empty");
+	REQUIRE (root[0UL].isObject());
+	REQUIRE (root.getChildName (6) == "version");
+
+	REQUIRE (root.hasChildWithName ("records"));
+	REQUIRE (! root.hasChildWithName ("record"));
+	REQUIRE (! records.hasChildWithName ("records"));
+
+	REQUIRE_THROWS_AS (root["missing"], std::runtime_error);
+	REQUIRE_THROWS_AS (records[3UL], std::out_of_range);
+	REQUIRE_THROWS_AS (records["name"], std::runtime_error);
+	REQUIRE_THROWS_AS (root["name"].getNumber(), std::runtime_error);
+
+	REQUIRE (records.toNode().getArray().size() == 3);
+}
+
+TEST_CASE ("Binary - malformed documents", TAGS)
+{
+	const serial::BinaryFormat binary;
+
+	REQUIRE_THROWS_AS (serial::BinaryFormat::createView (""), serial::ParseError);
+	REQUIRE_THROWS_AS (serial::BinaryFormat::createView (document), serial::ParseError);
+	REQUIRE (! binary.tryParse ("LSBN"));
+
+	const auto data = binary.serialize (serial::JSONFormat {}.parse (document));
+
+	REQUIRE_THROWS_AS (binary.parse (data.substr (0, data.size() - 1)), serial::ParseError);
+
+	// corrupting any single byte must either still decode or be reported, never read out of bounds
+	for (auto i = 0UL; i < data.size(); ++i)
+	{
+		for (const auto value : { '\x00', '\x07', '\x7F', '\xFF' })
+		{
+			auto corrupted = data;
+			corrupted[i]   = value;
+
+			try
+			{
+				[[maybe_unused]] const auto node = binary.parse (corrupted);
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+		}
+	}
+}
+
+TEST_CASE ("Binary - malformed nesting", TAGS)
+{
+	const serial::BinaryFormat binary;
+
+	// writes a null, then numLevels arrays that each hold numChildren offsets of the previous record
+	auto makeDocument = [] (std::size_t numLevels, std::size_t numChildren)
+	{
+		std::string data { "LSBN\x01\0\0\0", 8 };
+
+		auto appendOffset = [&data] (std::uint64_t offset)
+		{
+			for (auto i = 0UL; i < 8UL; ++i)
+				data += static_cast<char> (offset >> (i * 8UL));
+		};
+
+		auto previous = std::uint64_t { data.size() };
+
+		data += '\0';
+
+		for (auto level = 0UL; level < numLevels; ++level)
+		{
+			const auto record = std::uint64_t { data.size() };
+
+			data += '\x05';
+			data += static_cast<char> (numChildren);
+
+			for (auto i = 0UL; i < numChildren; ++i)
+				appendOffset (previous);
+
+			previous = record;
+		}
+
+		appendOffset (previous);
+
+		return data;
+	};
+
+	SECTION ("Containers nested too deeply")
+	{
+		REQUIRE (binary.tryParse (makeDocument (512, 1)));
+		REQUIRE (! binary.tryParse (makeDocument (513, 1)));
+		REQUIRE_THROWS_AS (serial::BinaryFormat::createView (makeDocument (200000, 1)).toNode(), serial::ParseError);
+	}
+
+	SECTION ("Containers shared by several parents")
+	{
+		// a valid document never shares arrays, but this one would expand to 2^30 nulls
+		const auto data = makeDocument (30, 2);
+
+		REQUIRE_THROWS_AS (binary.parse (data), serial::ParseError);
+
+		// views don't copy anything, so they can still read it
+		const auto view = serial::BinaryFormat::createView (data);
+
+		REQUIRE (view[1UL][0UL][1UL].getNumChildren() == 2);
+	}
+}
+
+TEST_CASE ("Binary - memory-mapped files", TAGS)
+{
+	const serial::BinaryFormat binary;
+
+	const auto node = serial::JSONFormat {}.parse (document);
+
+	const auto path = std::filesystem::temp_directory_path() / "lserial_tests_binary.lsb";
+
+	binary.serializeToFile (node, path);
+
+	{
+		const serial::BinaryFile file { path };
+
+		REQUIRE (file.getRoot()["records"][0UL]["id"].getNumber() == 1.);
+		REQUIRE (file.getRoot()["name"].getString() == "binary");
+	}
+
+	REQUIRE (serial::KnownFormats::get().parseFile (path)["version"].getNumber() == 2.5);
+
+	std::filesystem::remove (path);
+
+	REQUIRE_THROWS (serial::BinaryFile { path });
+}
@@ -0,0 +1,224 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_CBOR.h"
+#include "lserializing/lserializing_JSON.h"
+#include "lserializing/lserializing_KnownFormats.h"
+#include "TestData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define TAGS "[serializing][CBOR]"
+
+namespace serial = limes::serializing;
+
+using serial::tests::bytes;
+
+TEST_CASE ("CBOR - encoding", TAGS)
+{
+	const serial::CBORFormat format;
+
+	auto encodeNumber = [&format] (double number)
+	{
+		return format.serialize (serial::Node::createNumber (number));
+	};
+
+	SECTION ("Numbers use the preferred serialization")
+	{
+		// these are the examples from RFC 8949 appendix A
+		REQUIRE (encodeNumber (0.) == bytes ({ 0x00 }));
+		REQUIRE (encodeNumber (23.) == bytes ({ 0x17 }));
+		REQUIRE (encodeNumber (24.) == bytes ({ 0x18, 0x18 }));
+		REQUIRE (encodeNumber (1000.) == bytes ({ 0x19, 0x03, 0xE8 }));
+		REQUIRE (encodeNumber (1000000.) == bytes ({ 0x1A, 0x00, 0x0F, 0x42, 0x40 }));
+		REQUIRE (encodeNumber (1000000000000.) == bytes ({ 0x1B, 0x00, 0x00, 0x00, 0xE8, 0xD4, 0xA5, 0x10, 0x00 }));
+		REQUIRE (encodeNumber (-1.) == bytes ({ 0x20 }));
+		REQUIRE (encodeNumber (-100.) == bytes ({ 0x38, 0x63 }));
+		REQUIRE (encodeNumber (-1000.) == bytes ({ 0x39, 0x03, 0xE7 }));
+		REQUIRE (encodeNumber (-0.) == bytes ({ 0xF9, 0x80, 0x00 }));
+		REQUIRE (encodeNumber (1.5) == bytes ({ 0xF9, 0x3E, 0x00 }));
+		REQUIRE (encodeNumber (1.1) == bytes ({ 0xFB, 0x3F, 0xF1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A }));
+		REQUIRE (encodeNumber (3.4028234663852886e+38) == bytes ({ 0xFA, 0x7F, 0x7F, 0xFF, 0xFF }));
+		REQUIRE (encodeNumber (1.0e+300) == bytes ({ 0xFB, 0x7E, 0x37, 0xE4, 0x3C, 0x88, 0x00, 0x75, 0x9C }));
+		REQUIRE (encodeNumber (5.960464477539063e-8) == bytes ({ 0xF9, 0x00, 0x01 }));
+		REQUIRE (encodeNumber (0.00006103515625) == bytes ({ 0xF9, 0x04, 0x00 }));
+		REQUIRE (encodeNumber (-4.1) == bytes ({ 0xFB, 0xC0, 0x10, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66 }));
+		REQUIRE (encodeNumber (std::numeric_limits<double>::infinity()) == bytes ({ 0xF9, 0x7C, 0x00 }));
+		REQUIRE (encodeNumber (-std::numeric_limits<double>::infinity()) == bytes ({ 0xF9, 0xFC, 0x00 }));
+		REQUIRE (encodeNumber (std::numeric_limits<double>::quiet_NaN()) == bytes ({ 0xF9, 0x7E, 0x00 }));
+	}
+
+	SECTION ("Strings and containers")
+	{
+		REQUIRE (format.serialize (serial::Node::createString ("IETF")) == bytes ({ 0x64, 'I', 'E', 'T', 'F' }));
+		REQUIRE (format.serialize (serial::Node::createString (std::string (300, 'x'))).substr (0, 3) == bytes ({ 0x79, 0x01, 0x2C }));
+
+		const auto node = serial::JSONFormat {}.parse (R"({ "b": [ 2, 3 ], "a": 1, "c": [ true, false, null ] })");
+
+		REQUIRE (format.serialize (node)
+				 == bytes ({ 0xA3, 0x61, 'a', 0x01, 0x61, 'b', 0x82, 0x02, 0x03, 0x61, 'c', 0x83, 0xF5, 0xF4, 0xF6 }));
+	}
+
+	SECTION ("Typed arrays")
+	{
+		serial::CBORPrinterOptions options;
+		options.typedArrays		  = true;
+		options.minTypedArraySize = 2;
+
+		const auto printer = format.createPrinter (options);
+
+		const auto numbers = serial::JSONFormat {}.parse ("[ 1.5, -2 ]");
+
+		REQUIRE (printer->print (numbers)
+				 == bytes ({ 0xD8, 0x56, 0x50, 0, 0, 0, 0, 0, 0, 0xF8, 0x3F, 0, 0, 0, 0, 0, 0, 0, 0xC0 }));
+
+		// arrays that are too short or hold anything other than numbers are written normally
+		REQUIRE (printer->print (serial::JSONFormat {}.parse ("[ 1 ]")) == bytes ({ 0x81, 0x01 }));
+		REQUIRE (printer->print (serial::JSONFormat {}.parse ("[ 1, null ]")) == bytes ({ 0x82, 0x01, 0xF6 }));
+
+		// and the default printer never writes them
+		REQUIRE (format.serialize (numbers) == bytes ({ 0x82, 0xF9, 0x3E, 0x00, 0x21 }));
+	}
+}
+
+TEST_CASE ("CBOR - decoding", TAGS)
+{
+	const serial::CBORFormat format;
+	const serial::JSONFormat json;
+
+	SECTION ("Round trip")
+	{
+		const auto node = json.parse (R"({ "name": "héllo", "values": [ 0, -1, 255, -200, 70000, 1e300, 0.5, -5000000000, 0.1 ],
+"flags": { "on": true, "off": false, "unset": null }, "nested": [ [ [ ] ], { } ] })");
+
+		const auto encoded = format.serialize (node);
+
+		REQUIRE (encoded.size() < json.serialize (node).size());
+		REQUIRE (json.serialize (format.parse (encoded)) == json.serialize (node));
+
+		serial::CBORPrinterOptions options;
+		options.typedArrays = true;
+
+		REQUIRE (json.serialize (format.parse (format.createPrinter (options)->print (node))) == json.serialize (node));
+
+		REQUIRE (format.probablyMatchesString (encoded));
+		REQUIRE (! json.probablyMatchesString (encoded));
+
+		REQUIRE (serial::KnownFormats::get().getFormatForFileExtension (".cbor") != nullptr);
+	}
+
+	SECTION ("Indefinite lengths, tags and simple values")
+	{
+		REQUIRE (format.parse (bytes ({ 0x7F, 0x65, 's', 't', 'r', 'e', 'a', 0x64, 'm', 'i', 'n', 'g', 0xFF })).getString() == "streaming");
+		REQUIRE (format.parse (bytes ({ 0x5F, 0x42, 0x01, 0x02, 0x43, 0x03, 0x04, 0x05, 0xFF })).getString() == bytes ({ 1, 2, 3, 4, 5 }));
+
+		REQUIRE (json.serialize (format.parse (bytes ({ 0x9F, 0x01, 0x82, 0x02, 0x03, 0x9F, 0x04, 0x05, 0xFF, 0xFF })))
+				 == json.serialize (json.parse ("[ 1, [ 2, 3 ], [ 4, 5 ] ]")));
+
+		const auto map = format.parse (bytes ({ 0xBF, 0x61, 'a', 0x01, 0x61, 'b', 0x9F, 0x02, 0x03, 0xFF, 0xFF }));
+
+		REQUIRE (map["a"].getNumber() == 1.);
+		REQUIRE (map["b"][1].getNumber() == 3.);
+
+		// an epoch-based date and the self-describe tag are skipped
+		REQUIRE (format.parse (bytes ({ 0xC1, 0x1A, 0x51, 0x4B, 0x67, 0xB0 })).getNumber() == 1363896240.);
+		REQUIRE (format.parse (bytes ({ 0xD9, 0xD9, 0xF7, 0x80 })).getArray().empty());
+
+		REQUIRE (format.parse (bytes ({ 0xF7 })).isNull());
+		REQUIRE (format.parse (bytes ({ 0xFA, 0x47, 0xC3, 0x50, 0x00 })).getNumber() == 100000.);
+		REQUIRE (std::isnan (format.parse (bytes ({ 0xF9, 0x7E, 0x00 })).getNumber()));
+	}
+
+	SECTION ("Typed arrays")
+	{
+		auto parseNumbers = [&format] (const std::string& data)
+		{
+			const auto node = format.parse (data);
+
+			std::vector<double> numbers;
+
+			for (const auto& element : node.getArray())
+				numbers.push_back (element.getNumber());
+
+			REQUIRE (format.parseNumberArray (data) == numbers);
+
+			return numbers;
+		};
+
+		using Numbers = std::vector<double>;
+
+		REQUIRE (parseNumbers (bytes ({ 0xD8, 0x48, 0x42, 0xFF, 0x01 })) == Numbers { -1., 1. });
+		REQUIRE (parseNumbers (bytes ({ 0xD8, 0x41, 0x42, 0x01, 0x02 })) == Numbers { 258. });
+		REQUIRE (parseNumbers (bytes ({ 0xD8, 0x45, 0x42, 0x01, 0x02 })) == Numbers { 513. });
+		REQUIRE (parseNumbers (bytes ({ 0xD8, 0x4E, 0x44, 0xFE, 0xFF, 0xFF, 0xFF })) == Numbers { -2. });
+		REQUIRE (parseNumbers (bytes ({ 0xD8, 0x50, 0x42, 0x3E, 0x00 })) == Numbers { 1.5 });
+		REQUIRE (parseNumbers (bytes ({ 0xD8, 0x51, 0x44, 0x3F, 0xC0, 0x00, 0x00 })) == Numbers { 1.5 });
+		REQUIRE (parseNumbers (bytes ({ 0xD8, 0x56, 0x48, 0, 0, 0, 0, 0, 0, 0xF8, 0x3F })) == Numbers { 1.5 });
+		REQUIRE (parseNumbers (bytes ({ 0xD8, 0x56, 0x40 })).empty());
+
+		// plain arrays of numbers work too
+		REQUIRE (parseNumbers (bytes ({ 0x83, 0x01, 0xF9, 0x3E, 0x00, 0x20 })) == Numbers { 1., 1.5, -1. });
+		REQUIRE (parseNumbers (bytes ({ 0x9F, 0x01, 0xFF })) == Numbers { 1. });
+
+		REQUIRE_THROWS_AS (format.parseNumberArray (bytes ({ 0x82, 0x01, 0x61, 'a' })), serial::ParseError);
+		REQUIRE_THROWS_AS (format.parseNumberArray (bytes ({ 0xA0 })), serial::ParseError);
+
+		// float128, the reserved tag 76, a size that isn't a whole number of elements, and a payload that isn't a byte string
+		REQUIRE (! format.tryParse (bytes ({ 0xD8, 0x53, 0x40 })));
+		REQUIRE (! format.tryParse (bytes ({ 0xD8, 0x4C, 0x41, 0x01 })));
+		REQUIRE (! format.tryParse (bytes ({ 0xD8, 0x41, 0x43, 0x01, 0x02, 0x03 })));
+		REQUIRE (! format.tryParse (bytes ({ 0xD8, 0x56, 0x80 })));
+	}
+
+	SECTION ("Malformed input")
+	{
+		REQUIRE (! format.tryParse (""));
+		REQUIRE (! format.tryParse (bytes ({ 0x1C })));
+		REQUIRE (! format.tryParse (bytes ({ 0x1F })));
+		REQUIRE (! format.tryParse (bytes ({ 0xFF })));
+		REQUIRE (! format.tryParse (bytes ({ 0xF8, 0x20 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x82, 0x01 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x01, 0x02 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x7A, 0xFF, 0xFF, 0xFF, 0xFF, 'a' })));
+		REQUIRE (! format.tryParse (bytes ({ 0x9B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF6 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x7F, 0x41, 'a', 0xFF })));
+		REQUIRE (! format.tryParse (bytes ({ 0x9F, 0x01 })));
+		REQUIRE (! format.tryParse (bytes ({ 0xA1, 0x01, 0x02 })));
+		REQUIRE (! format.tryParse (bytes ({ 0xA1, 0x60, 0x02 })));
+		REQUIRE (! format.tryParse (bytes ({ 0xA2, 0x61, 'a', 0x01, 0x61, 'a', 0x02 })));
+
+		REQUIRE (format.tryParse (bytes ({ 0x82, 0x01, 0x19, 0x01 })).getError().what() == std::string { "Unexpected end of data at byte 4" });
+
+		// deep nesting, including of tags, is rejected rather than overflowing the stack
+		REQUIRE (! format.tryParse (std::string (100000, '\x81')));
+		REQUIRE (! format.tryParse (std::string (100000, '\xC1')));
+
+		REQUIRE_THROWS_AS (format.parse (bytes ({ 0xFF })), serial::ParseError);
+	}
+
+	SECTION ("Sniffing")
+	{
+		REQUIRE (format.probablyMatchesString (bytes ({ 0x80 })));
+		REQUIRE (format.probablyMatchesString (bytes ({ 0xA1, 0x61, 'a', 0x01 })));
+		REQUIRE (format.probablyMatchesString (bytes ({ 0x98, 0x20, 0xF6 })));
+		REQUIRE (format.probablyMatchesString (bytes ({ 0xD9, 0xD9, 0xF7, 0x01 })));
+		REQUIRE (! format.probablyMatchesString (R"({ "a": 1 })"));
+		REQUIRE (! format.probablyMatchesString (bytes ({ 0xA1, 0x01, 0x01 })));
+		REQUIRE (! format.probablyMatchesString (bytes ({ 0x80, 0x80 })));
+	}
+}
@@ -0,0 +1,296 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_Columns.h"
+#include "lserializing/lserializing_Node.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#define TAGS "[serializing][Columns]"
+
+namespace serial = limes::serializing;
+using Node		 = serial::Node;
+using ObjectType = serial::ObjectType;
+using ColumnType = serial::ColumnType;
+
+// the nth row has an id, a name, a flag every other row, and a score that is integral except in the last row
+static Node makeRows (std::size_t numRows)
+{
+	Node array { ObjectType::Array };
+
+	for (auto i = 0UL; i < numRows; ++i)
+	{
+		auto& row = array.addChildObject();
+
+		row.addChildNumber (static_cast<double> (i), "id");
+		row.addChildString ("name" + std::to_string (i), "name");
+
+		if (i % 2 == 0)
+			row.addChildBoolean (i % 4 == 0, "flag");
+		else
+			row.addChildNull ("flag");
+
+		row.addChildNumber (i + 1 == numRows ? 0.5 : static_cast<double> (i * 2), "score");
+	}
+
+	return array;
+}
+
+static bool haveSameRows (const Node& a, const Node& b)
+{
+	if (a.getNumChildren() != b.getNumChildren())
+		return false;
+
+	for (auto i = 0UL; i < a.getNumChildren(); ++i)
+	{
+		const auto& rowA = a[i].getObject();
+		const auto& rowB = b[i].getObject();
+
+		if (rowA.size() != rowB.size())
+			return false;
+
+		for (const auto& [key, value] : rowA)
+		{
+			const auto other = rowB.find (key);
+
+			if (other == rowB.end() || value.getType() != other->second.getType())
+				return false;
+
+			if ((value.isNumber() && value.getNumber() != other->second.getNumber())
+				|| (value.isString() && value.getString() != other->second.getString())
+				|| (value.isBoolean() && value.getBoolean() != other->second.getBoolean()))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+TEST_CASE ("Columns - converting to columns", TAGS)
+{
+	SECTION ("Column types and buffers")
+	{
+		const auto rows	 = makeRows (10);
+		const auto table = serial::toColumns (rows);
+
+		REQUIRE (table.numRows == 10);
+		REQUIRE (table.columns.size() == 4);
+
+		const auto* id = table.getColumn ("id");
+
+		REQUIRE (id != nullptr);
+		REQUIRE (id->type == ColumnType::Int64);
+		REQUIRE (id->nullCount == 0);
+		REQUIRE (id->validity.empty());
+		REQUIRE (id->integers.size() == 10);
+		REQUIRE (id->integers[7] == 7);
+
+		const auto* name = table.getColumn ("name");
+
+		REQUIRE (name->type == ColumnType::String);
+		REQUIRE (name->offsets.size() == 11);
+		REQUIRE (name->offsets.front() == 0);
+		REQUIRE (name->getString (3) == "name3");
+		REQUIRE (std::string (name->bytes.begin(), name->bytes.begin() + 10) == "name0name1");
+
+		const auto* flag = table.getColumn ("flag");
+
+		REQUIRE (flag->type == ColumnType::Boolean);
+		REQUIRE (flag->nullCount == 5);
+		REQUIRE (flag->validity.size() == 2);
+		REQUIRE (flag->validity[0] == 0x55);
+		REQUIRE (flag->booleans[0] == 0x11);
+		REQUIRE (flag->isNull (1));
+		REQUIRE (! flag->isNull (2));
+		REQUIRE (flag->getBoolean (4));
+		REQUIRE (! flag->getBoolean (2));
+
+		// the last score isn't integral, so the column was converted to doubles
+		const auto* score = table.getColumn ("score");
+
+		REQUIRE (score->type == ColumnType::Double);
+		REQUIRE (score->integers.empty());
+		REQUIRE (score->doubles[3] == 6.);
+		REQUIRE (score->doubles[9] == 0.5);
+
+		REQUIRE (table.getColumn ("missing") == nullptr);
+
+		for (const auto& column : table.columns)
+			REQUIRE (reinterpret_cast<std::uintptr_t> (column.validity.data()) % 64 == 0);
+	}
+
+	SECTION ("Missing fields and nulls")
+	{
+		Node array { ObjectType::Array };
+
+		array.addChildObject().addChildNumber (1., "a");
+		array.addChildObject().addChildNull ("a");
+
+		auto& third = array.addChildObject();
+
+		third.addChildString ("x", "b");
+		third.addChildNull ("c");
+
+		const auto table = serial::toColumns (array);
+
+		REQUIRE (table.columns.size() == 3);
+
+		const auto& a = table.columns[0];
+
+		REQUIRE (a.name == "a");
+		REQUIRE (a.type == ColumnType::Int64);
+		REQUIRE (a.nullCount == 2);
+		REQUIRE (a.integers.size() == 3);
+		REQUIRE (! a.isNull (0));
+		REQUIRE (a.isNull (1));
+		REQUIRE (a.isNull (2));
+
+		// fields that appear after the first row are null in the rows before
+		const auto& b = table.columns[1];
+
+		REQUIRE (b.name == "b");
+		REQUIRE (b.type == ColumnType::String);
+		REQUIRE (b.nullCount == 2);
+		REQUIRE (b.offsets.size() == 4);
+		REQUIRE (b.getString (0).empty());
+		REQUIRE (b.getString (2) == "x");
+
+		// a column of only nulls has no buffers
+		const auto& c = table.columns[2];
+
+		REQUIRE (c.type == ColumnType::Null);
+		REQUIRE (c.nullCount == 3);
+		REQUIRE (c.validity.empty());
+		REQUIRE (c.isNull (0));
+	}
+
+	SECTION ("Numbers that can't be integers")
+	{
+		Node array { ObjectType::Array };
+
+		array.addChildObject().addChildNumber (-0., "a");
+		array.addChildObject().addChildNumber (1e300, "b");
+
+		const auto table = serial::toColumns (array);
+
+		REQUIRE (table.columns[0].type == ColumnType::Double);
+		REQUIRE (table.columns[1].type == ColumnType::Double);
+	}
+
+	SECTION ("Errors")
+	{
+		REQUIRE_THROWS_AS (serial::toColumns (Node::createNumber (1.)), std::runtime_error);
+
+		Node notObjects { ObjectType::Array };
+		notObjects.addChildNumber (1.);
+
+		REQUIRE_THROWS_AS (serial::toColumns (notObjects), std::runtime_error);
+
+		Node nested { ObjectType::Array };
+		nested.addChildObject().addChildArray ("a");
+
+		REQUIRE_THROWS_AS (serial::toColumns (nested), std::runtime_error);
+
+		Node mixed { ObjectType::Array };
+		mixed.addChildObject().addChildNumber (1., "a");
+		mixed.addChildObject().addChildString ("1", "a");
+
+		REQUIRE_THROWS_AS (serial::toColumns (mixed), std::runtime_error);
+	}
+}
+
+TEST_CASE ("Columns - converting from columns", TAGS)
+{
+	SECTION ("Round trip")
+	{
+		const auto rows = makeRows (100);
+
+		REQUIRE (haveSameRows (serial::fromColumns (serial::toColumns (rows)), rows));
+	}
+
+	SECTION ("Nulls and missing fields become null members")
+	{
+		Node array { ObjectType::Array };
+
+		array.addChildObject().addChildNumber (1., "a");
+		array.addChildObject().addChildString ("x", "b");
+
+		const auto result = serial::fromColumns (serial::toColumns (array));
+
+		REQUIRE (result.getNumChildren() == 2);
+		REQUIRE (result[0UL]["a"].getNumber() == 1.);
+		REQUIRE (result[0UL]["b"].isNull());
+		REQUIRE (result[1UL]["a"].isNull());
+		REQUIRE (result[1UL]["b"].getString() == "x");
+	}
+
+	SECTION ("Inconsistent tables are rejected")
+	{
+		auto table = serial::toColumns (makeRows (10));
+
+		// the columns are in the order of the first row's members, which are sorted: flag, id, name, score
+		auto shortColumn = table;
+		shortColumn.columns[1].integers.pop_back();
+
+		REQUIRE_THROWS_AS (serial::fromColumns (shortColumn), std::runtime_error);
+
+		auto badOffsets = table;
+		badOffsets.columns[2].offsets[3] = 1000;
+
+		REQUIRE_THROWS_AS (serial::fromColumns (badOffsets), std::runtime_error);
+
+		auto duplicates = table;
+		duplicates.columns.push_back (duplicates.columns[0]);
+
+		REQUIRE_THROWS_AS (serial::fromColumns (duplicates), std::runtime_error);
+	}
+}
+
+TEST_CASE ("Columns - multithreaded conversion", TAGS)
+{
+	static constexpr auto numRows = 100000UL;
+
+	auto rows = makeRows (numRows);
+
+	// a field that only appears near the end, so the threads see different sets of columns
+	rows[numRows - 10].addChildNumber (1., "late");
+
+	const auto single = serial::toColumns (rows);
+	const auto multi  = serial::toColumns (rows, 4);
+
+	REQUIRE (multi.numRows == numRows);
+	REQUIRE (multi.columns.size() == single.columns.size());
+
+	for (const auto& column : single.columns)
+	{
+		const auto* other = multi.getColumn (column.name);
+
+		REQUIRE (other != nullptr);
+		REQUIRE (other->type == column.type);
+		REQUIRE (other->length == column.length);
+		REQUIRE (other->nullCount == column.nullCount);
+		REQUIRE (other->validity.size() == column.validity.size());
+		REQUIRE (other->validity == column.validity);
+		REQUIRE (other->booleans == column.booleans);
+		REQUIRE (other->doubles == column.doubles);
+		REQUIRE (other->integers == column.integers);
+		REQUIRE (other->offsets == column.offsets);
+		REQUIRE (other->bytes == column.bytes);
+	}
+
+	REQUIRE (haveSameRows (serial::fromColumns (multi, 4), serial::fromColumns (single)));
+}
@@ -0,0 +1,232 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_Compression.h"
+#include "lserializing/lserializing_OutputSink.h"
+#include "TestData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#define TAGS "[serializing][Compression]"
+
+namespace serial = limes::serializing;
+
+using serial::CompressionType;
+using serial::tests::bytes;
+
+// "abcabcabcabcabcabcabcabcabcabc\n", compressed by the gzip and lz4 command line tools
+static const auto gzipFixture = bytes ({ 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x4b, 0x4c, 0x4a,
+										 0x4e, 0xc4, 0x8d, 0xb8, 0x00, 0xd9, 0x04, 0x20, 0xa8, 0x1f, 0x00, 0x00, 0x00 });
+
+static const auto lz4Fixture = bytes ({ 0x04, 0x22, 0x4d, 0x18, 0x64, 0x40, 0xa7, 0x0d, 0x00, 0x00, 0x00, 0x3f, 0x61, 0x62,
+										0x63, 0x03, 0x00, 0x04, 0x50, 0x63, 0x61, 0x62, 0x63, 0x0a, 0x00, 0x00, 0x00, 0x00,
+										0xe7, 0xe1, 0xcd, 0xca });
+
+// the same, with block checksums
+static const auto lz4BlockChecksumFixture = bytes ({ 0x04, 0x22, 0x4d, 0x18, 0x74, 0x40, 0xbd, 0x0d, 0x00, 0x00, 0x00, 0x3f,
+													 0x61, 0x62, 0x63, 0x03, 0x00, 0x04, 0x50, 0x63, 0x61, 0x62, 0x63, 0x0a,
+													 0x5f, 0x81, 0x88, 0x52, 0x00, 0x00, 0x00, 0x00, 0xe7, 0xe1, 0xcd, 0xca });
+
+static constexpr std::string_view fixtureText = "abcabcabcabcabcabcabcabcabcabc\n";
+
+static std::string makeRecords (std::size_t numRecords)
+{
+	std::string text;
+
+	for (auto i = 0UL; i < numRecords; ++i)
+		text += R"({ "id": )" + std::to_string (i) + R"(, "name": "record number )" + std::to_string (i * 7) + "\" },\n";
+
+	return text;
+}
+
+static std::string makeNoise (std::size_t size)
+{
+	std::string text (size, '\0');
+
+	auto state = std::uint32_t { 12345 };
+
+	for (auto& c : text)
+	{
+		state = state * 1664525U + 1013904223U;
+		c	  = static_cast<char> (state >> 24);
+	}
+
+	return text;
+}
+
+TEST_CASE ("Compression - detection and other tools' output", TAGS)
+{
+	REQUIRE (serial::detectCompression (gzipFixture) == CompressionType::Gzip);
+	REQUIRE (serial::detectCompression (lz4Fixture) == CompressionType::LZ4);
+	REQUIRE (serial::detectCompression (R"({ "a": 1 })") == CompressionType::None);
+	REQUIRE (serial::detectCompression ("") == CompressionType::None);
+
+	REQUIRE (serial::getFileExtension (CompressionType::Gzip) == ".gz");
+	REQUIRE (serial::getFileExtension (CompressionType::LZ4) == ".lz4");
+
+	REQUIRE (serial::isCompressionAvailable (CompressionType::LZ4));
+
+	REQUIRE (serial::decompress (lz4Fixture) == fixtureText);
+	REQUIRE (serial::decompress (lz4BlockChecksumFixture) == fixtureText);
+
+	// concatenated frames, with a skippable frame between them
+	const auto skippable = bytes ({ 0x5A, 0x2A, 0x4D, 0x18, 0x03, 0x00, 0x00, 0x00, 'x', 'y', 'z' });
+
+	REQUIRE (serial::decompress (lz4Fixture + skippable + lz4Fixture) == std::string { fixtureText } + std::string { fixtureText });
+
+	if (serial::isCompressionAvailable (CompressionType::Gzip))
+	{
+		REQUIRE (serial::decompress (gzipFixture) == fixtureText);
+		REQUIRE (serial::decompress (gzipFixture + gzipFixture) == std::string { fixtureText } + std::string { fixtureText });
+	}
+	else
+	{
+		REQUIRE_THROWS_AS (serial::decompress (gzipFixture), serial::CompressionError);
+	}
+}
+
+TEST_CASE ("Compression - round trips", TAGS)
+{
+	const std::string inputs[] = { "", "a", std::string { fixtureText }, std::string (100000, 'z'),
+								   makeRecords (20000), makeNoise (300000) };
+
+	for (const auto type : { CompressionType::LZ4, CompressionType::Gzip })
+	{
+		if (! serial::isCompressionAvailable (type))
+			continue;
+
+		for (const auto& input : inputs)
+		{
+			const auto compressed = serial::compress (input, type);
+
+			REQUIRE (serial::detectCompression (compressed) == type);
+			REQUIRE (serial::decompress (compressed) == input);
+		}
+
+		// text that repeats compresses well, and text that doesn't hardly grows
+		const auto records = makeRecords (20000);
+
+		REQUIRE (serial::compress (records, type).size() < records.size() / 4);
+
+		const auto noise = makeNoise (300000);
+
+		REQUIRE (serial::compress (noise, type).size() < noise.size() + noise.size() / 100);
+	}
+}
+
+TEST_CASE ("Compression - CompressingSink", TAGS)
+{
+	const auto text = makeRecords (30000);
+
+	for (const auto type : { CompressionType::LZ4, CompressionType::Gzip })
+	{
+		if (! serial::isCompressionAvailable (type))
+		{
+			serial::StringSink output;
+			REQUIRE_THROWS_AS (serial::CompressingSink (output, type), serial::CompressionError);
+			continue;
+		}
+
+		SECTION ("Small writes")
+		{
+			serial::StringSink output;
+
+			{
+				serial::CompressingSink sink { output, type };
+
+				for (auto i = 0UL; i < text.size(); ++i)
+				{
+					if (i % 3 == 0)
+						sink.write (text[i]);
+					else
+						sink.write (std::string_view { text }.substr (i, 1));
+				}
+
+				// the destructor finishes the stream
+			}
+
+			REQUIRE (serial::decompress (output.getString()) == text);
+		}
+
+		SECTION ("Flushing")
+		{
+			serial::StringSink output;
+
+			serial::CompressingSink sink { output, type };
+
+			sink.write (std::string_view { text }.substr (0, 1000));
+			sink.flush();
+
+			REQUIRE (! output.getString().empty());
+
+			sink.write (std::string_view { text }.substr (1000));
+			sink.finish();
+
+			REQUIRE (serial::decompress (output.getString()) == text);
+
+			REQUIRE_THROWS_AS (sink.write ('x'), serial::CompressionError);
+		}
+	}
+}
+
+TEST_CASE ("Compression - corrupt data", TAGS)
+{
+	using serial::CompressionError;
+
+	REQUIRE_THROWS_AS (serial::decompress (R"({ "a": 1 })"), CompressionError);
+	REQUIRE_THROWS_AS (serial::decompress (bytes ({ 0x28, 0xB5, 0x2F, 0xFD, 0x00 })), CompressionError);
+
+	const auto compressed = serial::compress (makeRecords (1000), CompressionType::LZ4);
+
+	// truncated
+	REQUIRE_THROWS_AS (serial::decompress (std::string_view { compressed }.substr (0, compressed.size() - 1)), CompressionError);
+	REQUIRE_THROWS_AS (serial::decompress (std::string_view { compressed }.substr (0, 5)), CompressionError);
+
+	// trailing garbage
+	REQUIRE_THROWS_AS (serial::decompress (compressed + "x"), CompressionError);
+
+	auto damaged = compressed;
+
+	// the header checksum
+	damaged[6] = static_cast<char> (damaged[6] ^ 1);
+	REQUIRE_THROWS_AS (serial::decompress (damaged), CompressionError);
+
+	// the content checksum
+	damaged = compressed;
+	damaged.back() = static_cast<char> (damaged.back() ^ 1);
+	REQUIRE_THROWS_AS (serial::decompress (damaged), CompressionError);
+
+	// a literal in the middle of the block
+	damaged = compressed;
+	damaged[compressed.size() / 2] = static_cast<char> (damaged[compressed.size() / 2] ^ 0x40);
+	REQUIRE_THROWS_AS (serial::decompress (damaged), CompressionError);
+
+	// a block claiming to be bigger than the data
+	damaged = compressed;
+	damaged[9] = '\x7F';
+	REQUIRE_THROWS_AS (serial::decompress (damaged), CompressionError);
+
+	if (serial::isCompressionAvailable (CompressionType::Gzip))
+	{
+		const auto gzipped = serial::compress (makeRecords (1000), CompressionType::Gzip);
+
+		REQUIRE_THROWS_AS (serial::decompress (std::string_view { gzipped }.substr (0, gzipped.size() / 2)), CompressionError);
+
+		damaged		   = gzipped;
+		damaged.back() = static_cast<char> (damaged.back() ^ 1);
+		REQUIRE_THROWS_AS (serial::decompress (damaged), CompressionError);
+	}
+}
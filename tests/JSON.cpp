@@ -0,0 +1,632 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_JSON.h"
+#include "lserializing/lserializing_KnownFormats.h"
+#include "lserializing/lserializing_Serializer.h"
+#include "lserializing/lserializing_SHA256Sink.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#if ! defined(_WIN32)
+#	include <unistd.h>
+#endif
+
+#define TAGS "[serializing][JSON]"
+
+namespace serial = limes::serializing;
+
+TEST_CASE ("JSON - validation", TAGS)
+{
+	const serial::JSONFormat format;
+
+	SECTION ("Well-formed input")
+	{
+		REQUIRE (format.validate ("{}"));
+		REQUIRE (format.validate (" [ ] \n"));
+		REQUIRE (format.validate (R"({ "a": [ 1, -2.5, 3e10, 4E-2, 0 ], "b": { "c": null }, "d": true, "e": false })"));
+		REQUIRE (format.validate (R"([ "escapes \" \\ \/ \b \f \n \r \t \u00e9 \ud83d\ude00" ])"));
+		REQUIRE (format.validate ("[ \"h\xC3\xA9llo \xE6\x97\xA5\xE6\x9C\xAC \xF0\x9F\x98\x80\" ]"));
+		REQUIRE (format.validate (R"({ "key": { "key": 1 }, "other": [ { "key": 2 }, { "key": 3 } ] })"));
+		REQUIRE (format.validate (R"({ "\u00e9": 1, "e": 2, "\ud83d\ude00": 3 })"));
+
+		REQUIRE (format.probablyMatchesString (R"({ "key": "value" })"));
+	}
+
+	SECTION ("Malformed input")
+	{
+		REQUIRE (! format.validate (""));
+		REQUIRE (! format.validate ("   "));
+		REQUIRE (! format.validate ("42"));
+		REQUIRE (! format.validate (R"("string")"));
+		REQUIRE (! format.validate ("[ 1, 2 ] ]"));
+		REQUIRE (! format.validate ("[ 1, 2, ]"));
+		REQUIRE (! format.validate ("[ 1 2 ]"));
+		REQUIRE (! format.validate ("{ \"a\" 1 }"));
+		REQUIRE (! format.validate ("{ \"a\": 1, }"));
+		REQUIRE (! format.validate ("{ a: 1 }"));
+		REQUIRE (! format.validate ("[ 1 }"));
+		REQUIRE (! format.validate ("[ [ 1 ]"));
+		REQUIRE (! format.validate ("[ 01 ]"));
+		REQUIRE (! format.validate ("[ 1. ]"));
+		REQUIRE (! format.validate ("[ .5 ]"));
+		REQUIRE (! format.validate ("[ 1e ]"));
+		REQUIRE (! format.validate ("[ - ]"));
+		REQUIRE (! format.validate ("[ tru ]"));
+		REQUIRE (! format.validate ("[ NaN ]"));
+		REQUIRE (! format.validate ("[ \"unterminated ]"));
+		REQUIRE (! format.validate ("[ \"bad escape \\x\" ]"));
+		REQUIRE (! format.validate ("[ \"raw\ttab\" ]"));
+		REQUIRE (! format.validate (R"([ "lone surrogate \ud83d" ])"));
+		REQUIRE (! format.validate (R"([ "lone surrogate \ude00" ])"));
+		REQUIRE (! format.validate ("[ \"overlong \xC0\xAF\" ]"));
+		REQUIRE (! format.validate ("[ \"truncated \xE6\x97\" ]"));
+		REQUIRE (! format.validate ("[ \"encoded surrogate \xED\xA0\x80\" ]"));
+
+		REQUIRE (! format.probablyMatchesString ("key: value"));
+	}
+
+	SECTION ("Limits")
+	{
+		const std::string deep = std::string (600, '[') + std::string (600, ']');
+
+		REQUIRE (! format.validate (deep));
+
+		serial::JSONValidationLimits limits;
+
+		limits.maxDepth = 600;
+		REQUIRE (format.validate (deep, limits));
+
+		limits.maxDepth = 599;
+		REQUIRE (! format.validate (deep, limits));
+
+		limits.maxDepth = 2;
+		REQUIRE (format.validate ("[ [ 1 ], { \"a\": 2 } ]", limits));
+		REQUIRE (! format.validate ("[ [ [ 1 ] ] ]", limits));
+
+		limits.maxSize = 4;
+		REQUIRE (format.validate ("[ 1]", limits));
+		REQUIRE (! format.validate ("[ 1 ]", limits));
+
+		serial::JSONValidationLimits unlimited;
+
+		unlimited.maxDepth = std::numeric_limits<std::size_t>::max();
+
+		REQUIRE (format.validate ("[1]", unlimited));
+		REQUIRE (format.validate (deep, unlimited));
+
+		std::string mixed;
+
+		for (auto i = 0; i < 1000; ++i)
+			mixed += R"({ "a": [ )";
+
+		mixed += "1";
+
+		for (auto i = 0; i < 1000; ++i)
+			mixed += " ] }";
+
+		REQUIRE (format.validate (mixed, unlimited));
+
+		// the innermost array closed as an object
+		mixed[mixed.find (']')] = '}';
+		REQUIRE (! format.validate (mixed, unlimited));
+	}
+}
+
+TEST_CASE ("JSON - parsing", TAGS)
+{
+	const serial::JSONFormat format;
+
+	SECTION ("Numbers")
+	{
+		const auto node = format.parse ("[ 0, -7, 1.5, -0.25, 3e2, 2.5E-1, 12345678901234567890 ]");
+
+		const auto& array = node.getArray();
+
+		REQUIRE (array.size() == 7);
+		REQUIRE (array[0].getNumber() == 0.);
+		REQUIRE (array[1].getNumber() == -7.);
+		REQUIRE (array[2].getNumber() == 1.5);
+		REQUIRE (array[3].getNumber() == -0.25);
+		REQUIRE (array[4].getNumber() == 300.);
+		REQUIRE (array[5].getNumber() == 0.25);
+		REQUIRE (array[6].getNumber() == 12345678901234567890.);
+
+		const auto zeroes = format.parse ("[ -0, 0 ]");
+
+		REQUIRE (std::signbit (zeroes[0UL].getNumber()));
+		REQUIRE (! std::signbit (zeroes[1UL].getNumber()));
+		REQUIRE (std::signbit (format.parse (format.serialize (zeroes))[0UL].getNumber()));
+
+		REQUIRE (! format.tryParse ("[ 01 ]"));
+		REQUIRE (! format.tryParse ("[ 1. ]"));
+		REQUIRE (! format.tryParse ("[ 1x ]"));
+	}
+
+	SECTION ("Strings")
+	{
+		const auto node = format.parse (R"({ "text": "héllo 😀 \"quoted\"\n", "raw": "日本語" })");
+
+		REQUIRE (node["text"].getString() == "h\xC3\xA9llo \xF0\x9F\x98\x80 \"quoted\"\n");
+		REQUIRE (node["raw"].getString() == "日本語");
+
+		REQUIRE (! format.tryParse ("[ \"overlong \xC0\xAF\" ]"));
+		REQUIRE (! format.tryParse ("[ \"unterminated ]"));
+		REQUIRE (! format.tryParse (R"([ "lone surrogate \ud83d" ])"));
+
+		REQUIRE (format.parse (R"([ "\" \\ \/ \b \f \n \r \t \u00e9" ])")[0UL].getString() == "\" \\ / \b \f \n \r \t \xC3\xA9");
+	}
+
+	SECTION ("Input that validate() rejects is rejected")
+	{
+		for (const std::string_view text : { "[ \"raw\ttab\" ]", "[ \"raw\x01\" ]", "[ \"bad escape \\x\" ]", "[ \"bell \\a\" ]",
+											  R"([ "lone surrogate \ude00" ])", R"([ "reversed \ude00\ud83d" ])",
+											  "[ 1, 2 ] ]", "{} {}", "[] x", "{ \"a\": 1 },",
+											  R"({ "a": 1, "a": 2 })", R"({ "": 1 })", R"({ "a": 1, "b": 2, "\u0061": 3 })",
+											  R"([ { "a": 1 }, { "b": { "c": 1 }, "b": 2 } ])" })
+		{
+			REQUIRE (! format.validate (text));
+			REQUIRE (! format.tryParse (text));
+		}
+
+		REQUIRE (format.tryParse ("[ 1 ] \n\t").getNode().getArray().size() == 1);
+		REQUIRE (format.tryParse ("[ 1 ] 2").getError().what() == std::string { "Unexpected data after the end of the document" });
+	}
+}
+
+TEST_CASE ("JSON - parallel parsing", TAGS)
+{
+	const serial::JSONFormat format;
+
+	// each record is on its own line, so the input is split between the records
+	auto makeRecords = [] (std::size_t numRecords)
+	{
+		std::string text { "[\n" };
+
+		for (auto i = 0UL; i < numRecords; ++i)
+		{
+			if (i > 0)
+				text += ",\n";
+
+			const auto id = std::to_string (i);
+
+			text += R"({ "id": )" + id + R"(, "name": "record \")" + id + R"(\" \u00e9", "tags": [ true, null, [ {} ] ] })";
+		}
+
+		text += "\n]\n";
+
+		return text;
+	};
+
+	const auto records = makeRecords (10000);
+
+	// records.size() is many times the 64 kB that each thread needs before it's used
+	REQUIRE (records.size() > 700000);
+
+	SECTION ("Large array")
+	{
+		const auto expected = format.serialize (format.parse (records));
+
+		for (const auto numThreads : { 0UL, 1UL, 2UL, 4UL, 7UL })
+			REQUIRE (format.serialize (format.parseParallel (records, numThreads)) == expected);
+	}
+
+	SECTION ("Errors in more than one slice")
+	{
+		// an error near the start and another near the end, which are parsed by different threads
+		auto text = records;
+
+		text.replace (text.find (R"("id": 100,)"), 10, R"("id": 0100,)");
+		text.replace (text.find (R"("id": 9900,)"), 11, R"("id": "\x",)");
+
+		auto getError = [&text] (auto&& parseFunction) -> std::string
+		{
+			try
+			{
+				[[maybe_unused]] const auto node = parseFunction (text);
+			}
+			catch (const serial::ParseError& error)
+			{
+				return error.what();
+			}
+
+			return {};
+		};
+
+		const auto expected = getError ([&format] (std::string_view input) { return format.parse (input); });
+
+		REQUIRE (expected == "Syntax error in number");
+
+		for (const auto numThreads : { 2UL, 4UL })
+			REQUIRE (getError ([&format, numThreads] (std::string_view input) { return format.parseParallel (input, numThreads); }) == expected);
+	}
+
+	SECTION ("Input that isn't one large array")
+	{
+		const auto object = R"({ "records": )" + records + "}";
+
+		REQUIRE (format.serialize (format.parseParallel (object, 4)) == format.serialize (format.parse (object)));
+
+		REQUIRE (format.serialize (format.parseParallel (" [ 1, 2 ] ", 4)) == "[ 1, 2 ]");
+
+		REQUIRE (format.parseParallel ("", 4).isNull());
+
+		REQUIRE_THROWS_AS (format.parseParallel (records + "[]", 4), serial::ParseError);
+		REQUIRE_THROWS_AS (format.parseParallel (records.substr (0, records.size() - 3), 4), serial::ParseError);
+	}
+}
+
+TEST_CASE ("JSON - parsing from a file", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto path = std::filesystem::temp_directory_path() / "lserial_tests_parseFile.json";
+
+	{
+		std::ofstream stream { path, std::ios::binary };
+		stream << R"({ "name": "file", "values": [ 1, 2, 3 ] })";
+	}
+
+	const auto node = format.parseFile (path);
+
+	REQUIRE (node["name"].getString() == "file");
+	REQUIRE (node["values"].getArray().size() == 3);
+
+	REQUIRE (serial::KnownFormats::get().parseFile (path)["name"].getString() == "file");
+
+	std::filesystem::remove (path);
+
+	REQUIRE_THROWS (format.parseFile (path));
+}
+
+TEST_CASE ("JSON - compressed files", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto node = format.parse (R"({ "name": "compressed", "values": [ 1, 2, 3 ] })");
+
+	for (const auto type : { serial::CompressionType::LZ4, serial::CompressionType::Gzip })
+	{
+		if (! serial::isCompressionAvailable (type))
+			continue;
+
+		const auto path = std::filesystem::temp_directory_path()
+						/ ("lserial_tests_compressed.json" + std::string { serial::getFileExtension (type) });
+
+		format.serializeToFile (node, path, false, type);
+
+		REQUIRE (format.parseFile (path)["name"].getString() == "compressed");
+
+		// the format is chosen from the extension before the .gz or .lz4
+		REQUIRE (serial::KnownFormats::get().parseFile (path)["values"].getArray().size() == 3);
+
+		std::filesystem::remove (path);
+	}
+}
+
+TEST_CASE ("JSON - printing", TAGS)
+{
+	const serial::JSONFormat format;
+
+	SECTION ("Layout and keys")
+	{
+		const auto node = format.parse (R"({ "b": [ 1, 2.5, true, null ], "a": {}, "c": [] })");
+
+		REQUIRE (format.serialize (node) == R"({ "a":{}, "b":[ 1, 2.5, true, null ], "c":[] })");
+	}
+
+	SECTION ("Escapes")
+	{
+		const auto node = format.parse (R"([ "quote \" backslash \\ newline \n tab \t bell \u0007 é 😀" ])");
+
+		REQUIRE (format.serialize (node) == R"([ "quote \" backslash \\ newline \n tab \t bell \u0007 \u00e9 \ud83d\ude00" ])");
+	}
+
+	SECTION ("Raw UTF-8 output")
+	{
+		const auto printer = format.createPrinter (serial::JSONPrinterOptions { .escapeNonASCII = false });
+
+		auto node = format.parse (R"([ "quote \" tab \t é 日本 😀" ])");
+
+		REQUIRE (printer->print (node) == R"([ "quote \" tab \t é 日本 😀" ])");
+
+		node[0UL] = "invalid \xC0 utf-8";
+
+		REQUIRE (printer->print (node) == "[ \"invalid \xEF\xBF\xBD utf-8\" ]");
+	}
+
+	SECTION ("Round trip through a sink")
+	{
+		const auto node = format.parse (R"({ "name": "value", "numbers": [ 0.1, -3, 1e+300 ], "nested": { "empty": "" } })");
+
+		std::string output { "// " };
+
+		serial::StringSink sink { output };
+
+		format.serialize (node, sink);
+
+		REQUIRE (output.starts_with ("// {"));
+		const auto reparsed = format.parse (std::string_view { output }.substr (3));
+
+		REQUIRE (reparsed["numbers"][0UL].getNumber() == 0.1);
+		REQUIRE (reparsed["numbers"][2UL].getNumber() == 1e300);
+		REQUIRE (format.serialize (reparsed) == output.substr (3));
+	}
+
+	SECTION ("Reusing a Serializer")
+	{
+		serial::Serializer serializer { format };
+
+		const auto first  = format.parse (R"({ "id": 1, "tags": [ "a", "b" ] })");
+		const auto second = format.parse (R"([ "x" ])");
+
+		REQUIRE (serializer.serialize (first) == format.serialize (first));
+
+		const auto* const bufferData = serializer.serialize (first).data();
+
+		REQUIRE (serializer.serialize (second) == format.serialize (second));
+		REQUIRE (serializer.serialize (second).data() == bufferData);
+
+		std::string batch;
+
+		serializer.serializeInto (first, batch);
+		batch += '\n';
+		serializer.serializeInto (second, batch);
+
+		REQUIRE (batch == format.serialize (first) + '\n' + format.serialize (second));
+	}
+}
+
+TEST_CASE ("JSON - parallel printing", TAGS)
+{
+	const serial::JSONFormat format;
+
+	SECTION ("Large array")
+	{
+		serial::Node root { serial::ObjectType::Array };
+
+		for (auto i = 0; i < 5000; ++i)
+		{
+			auto& record = root.addChildObject();
+
+			record.addChildNumber (i, "id");
+			record.addChildString ("record \"" + std::to_string (i) + "\" \xC3\xA9", "name");
+		}
+
+		const auto expected = format.serialize (root);
+
+		for (const auto numThreads : { 1UL, 2UL, 3UL, 7UL })
+			REQUIRE (format.serializeParallel (root, numThreads) == expected);
+
+		const serial::JSONPrinterOptions options { .escapeNonASCII = false };
+
+		REQUIRE (format.serializeParallel (root, 4, options) == format.createPrinter (options)->print (root));
+	}
+
+	SECTION ("Large object")
+	{
+		serial::Node root { serial::ObjectType::Object };
+
+		for (auto i = 0; i < 3000; ++i)
+			root.addChildArray ("key" + std::to_string (i)).addChildBoolean (i % 2 == 0);
+
+		std::string output;
+
+		serial::StringSink sink { output };
+
+		format.serializeParallel (root, sink, 4);
+
+		REQUIRE (output == format.serialize (root));
+	}
+
+	SECTION ("Small and scalar nodes")
+	{
+		const auto small = format.parse (R"([ 1, "two", { "three": 3 } ])");
+
+		REQUIRE (format.serializeParallel (small, 8) == format.serialize (small));
+		REQUIRE (format.serializeParallel (serial::Node::createString ("x"), 8) == R"("x")");
+	}
+}
+
+TEST_CASE ("JSON - canonical printing", TAGS)
+{
+	const serial::JSONFormat format;
+
+	const auto printer = format.createPrinter (serial::JSONPrinterOptions { .canonical = true });
+
+	SECTION ("Numbers")
+	{
+		// the examples from RFC 8785, appendix B
+		const auto printNumber = [&printer] (double number)
+		{ return printer->print (serial::Node::createNumber (number)); };
+
+		REQUIRE (printNumber (0.) == "0");
+		REQUIRE (printNumber (-0.) == "0");
+		REQUIRE (printNumber (5e-324) == "5e-324");
+		REQUIRE (printNumber (-5e-324) == "-5e-324");
+		REQUIRE (printNumber (1.7976931348623157e308) == "1.7976931348623157e+308");
+		REQUIRE (printNumber (-1.7976931348623157e308) == "-1.7976931348623157e+308");
+		REQUIRE (printNumber (9007199254740992.) == "9007199254740992");
+		REQUIRE (printNumber (-9007199254740992.) == "-9007199254740992");
+		REQUIRE (printNumber (295147905179352830000.) == "295147905179352830000");
+		REQUIRE (printNumber (9.999999999999997e22) == "9.999999999999997e+22");
+		REQUIRE (printNumber (1e23) == "1e+23");
+		REQUIRE (printNumber (999999999999999700000.) == "999999999999999700000");
+		REQUIRE (printNumber (999999999999999900000.) == "999999999999999900000");
+		REQUIRE (printNumber (1e21) == "1e+21");
+		REQUIRE (printNumber (9.999999999999997e-7) == "9.999999999999997e-7");
+		REQUIRE (printNumber (0.000001) == "0.000001");
+		REQUIRE (printNumber (333333333.3333332) == "333333333.3333332");
+		REQUIRE (printNumber (0.1) == "0.1");
+		REQUIRE (printNumber (4.5) == "4.5");
+		REQUIRE (printNumber (-1.5e-7) == "-1.5e-7");
+
+		REQUIRE_THROWS_AS (printNumber (std::numeric_limits<double>::quiet_NaN()), std::runtime_error);
+		REQUIRE_THROWS_AS (printNumber (std::numeric_limits<double>::infinity()), std::runtime_error);
+	}
+
+	SECTION ("Key order and escaping")
+	{
+		// the sorting example from RFC 8785, section 3.2.3
+		const auto node = format.parse (R"({ "\u20ac": "Euro Sign", "\r": "Carriage Return", "\ufb33": "Hebrew Letter Dalet With Dagesh",
+											 "1": "One", "\ud83d\ude00": "Emoji: Grinning Face", "\u0080": "Control", "\u00f6": "Latin Small Letter O With Diaeresis" })");
+
+		REQUIRE (printer->print (node)
+				 == "{\"\\r\":\"Carriage Return\",\"1\":\"One\",\"\xC2\x80\":\"Control\",\"\xC3\xB6\":\"Latin Small Letter O With Diaeresis\","
+					"\"\xE2\x82\xAC\":\"Euro Sign\",\"\xF0\x9F\x98\x80\":\"Emoji: Grinning Face\",\"\xEF\xAC\xB3\":\"Hebrew Letter Dalet With Dagesh\"}");
+	}
+
+	SECTION ("Structure")
+	{
+		const auto node = format.parse (R"({ "numbers": [ 333333333.33333329, 1E30, 4.50, 2e-3, 0.000000000000000000000000001 ],
+											 "string": "\u20ac$\u000F\u000aA'\u0042\u0022\u005c\\\"\/", "literals": [ null, true, false ], "empty": {} })");
+
+		REQUIRE (printer->print (node)
+				 == R"({"empty":{},"literals":[null,true,false],"numbers":[333333333.3333333,1e+30,4.5,0.002,1e-27],)"
+					"\"string\":\"\xE2\x82\xAC$\\u000f\\nA'B\\\"\\\\\\\\\\\"/\"}");
+
+		REQUIRE (format.serializeParallel (node, 4, serial::JSONPrinterOptions { .canonical = true }) == printer->print (node));
+	}
+
+	SECTION ("Hashing")
+	{
+		const auto node = format.parse (R"({ "b": [ 1, 2 ], "a": "x" })");
+
+		serial::SHA256Sink sink;
+
+		printer->print (node, sink);
+
+		serial::SHA256Sink expected;
+
+		expected.write (R"({"a":"x","b":[1,2]})");
+
+		REQUIRE (sink.getDigest() == expected.getDigest());
+	}
+}
+
+TEST_CASE ("JSON - chunked printing", TAGS)
+{
+	const serial::JSONFormat format;
+
+	auto node = format.parse (R"({ "empty": { "array": [], "object": {} }, "nested": [ [ 1, [ 2, [ 3 ] ] ], { "a": { "b": null } } ],
+								  "€": true, "😀": false, "numbers": [ 0.1, -2, 1e300 ] })");
+
+	// long strings are printed in slices, which mustn't split escapes or UTF-8 sequences
+	std::string longString;
+
+	for (auto i = 0; i < 3000; ++i)
+		longString += "text \"quoted\" \xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\n";
+
+	node.addChildString (longString, "long");
+	node.addChildString ("key too", longString);
+
+	const auto readAll = [] (serial::ChunkedPrinter& printer, std::size_t chunkSize)
+	{
+		std::string output;
+		std::string chunk (chunkSize, '\0');
+
+		while (const auto size = printer.read (chunk.data(), chunkSize))
+		{
+			REQUIRE (size <= chunkSize);
+			output.append (chunk.data(), size);
+		}
+
+		REQUIRE (printer.isFinished());
+
+		return output;
+	};
+
+	for (const auto& options : { serial::JSONPrinterOptions {},
+								 serial::JSONPrinterOptions { .escapeNonASCII = false },
+								 serial::JSONPrinterOptions { .canonical = true } })
+	{
+		const auto expected = format.createPrinter (options)->print (node);
+
+		for (const auto chunkSize : { 1UL, 7UL, 4096UL, 65536UL })
+		{
+			const auto printer = format.createChunkedPrinter (node, options);
+
+			REQUIRE (readAll (*printer, chunkSize) == expected);
+		}
+	}
+
+	SECTION ("Scalars")
+	{
+		const auto number = serial::Node::createNumber (42.);
+
+		const auto printer = format.createChunkedPrinter (number);
+
+		REQUIRE (readAll (*printer, 1) == "42");
+	}
+
+#if ! defined(_WIN32)
+	SECTION ("Pipe consumer")
+	{
+		serial::Node records { serial::ObjectType::Array };
+
+		for (auto i = 0; i < 20000; ++i)
+		{
+			auto& record = records.addChildObject();
+
+			record.addChildNumber (i, "id");
+			record.addChildString ("record number " + std::to_string (i), "name");
+		}
+
+		int fds[2];
+
+		REQUIRE (::pipe (fds) == 0);
+
+		// the writer only produces a chunk when the pipe has accepted the last one
+		std::thread writer { [&format, &records, fd = fds[1]]
+							 {
+								 const auto printer = format.createChunkedPrinter (records);
+
+								 char chunk[65536];
+
+								 while (const auto size = printer->read (chunk, sizeof (chunk)))
+									 for (std::size_t offset = 0; offset < size;)
+									 {
+										 const auto numWritten = ::write (fd, chunk + offset, size - offset);
+
+										 if (numWritten <= 0)
+											 return;
+
+										 offset += static_cast<std::size_t> (numWritten);
+									 }
+
+								 ::close (fd);
+							 } };
+
+		std::string received;
+
+		char buffer[1000];
+
+		for (auto n = ::read (fds[0], buffer, sizeof (buffer)); n > 0; n = ::read (fds[0], buffer, sizeof (buffer)))
+			received.append (buffer, static_cast<std::size_t> (n));
+
+		writer.join();
+
+		::close (fds[0]);
+
+		REQUIRE (received == format.serialize (records));
+	}
+#endif
+}
@@ -0,0 +1,140 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_MessagePack.h"
+#include "lserializing/lserializing_JSON.h"
+#include "lserializing/lserializing_KnownFormats.h"
+#include "TestData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#define TAGS "[serializing][MessagePack]"
+
+namespace serial = limes::serializing;
+
+using serial::tests::bytes;
+
+TEST_CASE ("MessagePack - encoding", TAGS)
+{
+	const serial::MessagePackFormat format;
+
+	auto encodeNumber = [&format] (double number)
+	{
+		return format.serialize (serial::Node::createNumber (number));
+	};
+
+	SECTION ("Numbers use the smallest encoding")
+	{
+		REQUIRE (encodeNumber (0.) == bytes ({ 0x00 }));
+		REQUIRE (encodeNumber (127.) == bytes ({ 0x7F }));
+		REQUIRE (encodeNumber (128.) == bytes ({ 0xCC, 0x80 }));
+		REQUIRE (encodeNumber (65535.) == bytes ({ 0xCD, 0xFF, 0xFF }));
+		REQUIRE (encodeNumber (65536.) == bytes ({ 0xCE, 0x00, 0x01, 0x00, 0x00 }));
+		REQUIRE (encodeNumber (4294967296.) == bytes ({ 0xCF, 0, 0, 0, 1, 0, 0, 0, 0 }));
+		REQUIRE (encodeNumber (-1.) == bytes ({ 0xFF }));
+		REQUIRE (encodeNumber (-32.) == bytes ({ 0xE0 }));
+		REQUIRE (encodeNumber (-33.) == bytes ({ 0xD0, 0xDF }));
+		REQUIRE (encodeNumber (-129.) == bytes ({ 0xD1, 0xFF, 0x7F }));
+		REQUIRE (encodeNumber (1.5) == bytes ({ 0xCA, 0x3F, 0xC0, 0x00, 0x00 }));
+		REQUIRE (encodeNumber (0.1) == bytes ({ 0xCB, 0x3F, 0xB9, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A }));
+		REQUIRE (encodeNumber (-0.) == bytes ({ 0xCA, 0x80, 0x00, 0x00, 0x00 }));
+	}
+
+	SECTION ("Strings and containers")
+	{
+		REQUIRE (format.serialize (serial::Node::createString ("abc")) == bytes ({ 0xA3, 'a', 'b', 'c' }));
+		REQUIRE (format.serialize (serial::Node::createString (std::string (32, 'x'))).substr (0, 2) == bytes ({ 0xD9, 32 }));
+		REQUIRE (format.serialize (serial::Node::createString (std::string (300, 'x'))).substr (0, 3) == bytes ({ 0xDA, 0x01, 0x2C }));
+
+		const auto node = serial::JSONFormat {}.parse (R"({ "b": [ true, false, null ], "a": {} })");
+
+		REQUIRE (format.serialize (node) == bytes ({ 0x82, 0xA1, 'a', 0x80, 0xA1, 'b', 0x93, 0xC3, 0xC2, 0xC0 }));
+
+		serial::Node array { serial::ObjectType::Array };
+
+		for (auto i = 0; i < 16; ++i)
+			array.addChildNull();
+
+		REQUIRE (format.serialize (array).substr (0, 3) == bytes ({ 0xDC, 0x00, 0x10 }));
+	}
+}
+
+TEST_CASE ("MessagePack - decoding", TAGS)
+{
+	const serial::MessagePackFormat format;
+	const serial::JSONFormat		json;
+
+	SECTION ("Round trip")
+	{
+		const auto node = json.parse (R"({ "name": "héllo", "values": [ 0, -1, 255, -200, 70000, 1e300, 0.5, -5000000000 ],
+"flags": { "on": true, "off": false, "unset": null }, "nested": [ [ [ ] ], { } ] })");
+
+		const auto encoded = format.serialize (node);
+
+		REQUIRE (encoded.size() < json.serialize (node).size());
+		REQUIRE (json.serialize (format.parse (encoded)) == json.serialize (node));
+
+		REQUIRE (format.probablyMatchesString (encoded));
+		REQUIRE (! json.probablyMatchesString (encoded));
+
+		REQUIRE (serial::KnownFormats::get().getFormatForFileExtension (".msgpack") != nullptr);
+	}
+
+	SECTION ("Other encoders' choices")
+	{
+		// a uint64 that another encoder used for a small value, and a float64 that could have been a float32
+		REQUIRE (format.parse (bytes ({ 0xCF, 0, 0, 0, 0, 0, 0, 0, 5 })).getNumber() == 5.);
+		REQUIRE (format.parse (bytes ({ 0xD3, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE })).getNumber() == -2.);
+		REQUIRE (format.parse (bytes ({ 0xCB, 0x3F, 0xF8, 0, 0, 0, 0, 0, 0 })).getNumber() == 1.5);
+
+		// bin payloads and keys are treated as strings
+		const auto node = format.parse (bytes ({ 0x81, 0xC4, 0x01, 'k', 0xC4, 0x02, 'h', 'i' }));
+
+		REQUIRE (node["k"].getString() == "hi");
+	}
+
+	SECTION ("Malformed input")
+	{
+		REQUIRE (! format.tryParse (""));
+		REQUIRE (! format.tryParse (bytes ({ 0xC1 })));
+		REQUIRE (! format.tryParse (bytes ({ 0xD4, 0x01, 0x00 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x92, 0x01 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x01, 0x02 })));
+		REQUIRE (! format.tryParse (bytes ({ 0xDB, 0xFF, 0xFF, 0xFF, 0xFF, 'a' })));
+		REQUIRE (! format.tryParse (bytes ({ 0xDD, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x81, 0x01, 0x02 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x81, 0xA0, 0x02 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x82, 0xA1, 'a', 0x01, 0xA1, 'a', 0x02 })));
+
+		REQUIRE (format.tryParse (bytes ({ 0x92, 0x01, 0xCD, 0x01 })).getError().what() == std::string { "Unexpected end of data at byte 4" });
+
+		// deep nesting is rejected rather than overflowing the stack
+		REQUIRE (! format.tryParse (std::string (100000, '\x91')));
+
+		REQUIRE_THROWS_AS (format.parse (bytes ({ 0xC1 })), serial::ParseError);
+	}
+
+	SECTION ("Sniffing")
+	{
+		REQUIRE (format.probablyMatchesString (bytes ({ 0x80 })));
+		REQUIRE (format.probablyMatchesString (bytes ({ 0x81, 0xA1, 'a', 0x01 })));
+		REQUIRE (format.probablyMatchesString (bytes ({ 0xDC, 0x00, 0x10, 0xC0 })));
+		REQUIRE (! format.probablyMatchesString (R"({ "a": 1 })"));
+		REQUIRE (! format.probablyMatchesString (bytes ({ 0x81, 0x01, 0x01 })));
+		REQUIRE (! format.probablyMatchesString (bytes ({ 0x80, 0x80 })));
+	}
+}
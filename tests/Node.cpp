@@ -14,6 +14,7 @@
 
 #include "lserializing/lserializing.h"
 #include <catch2/catch_test_macros.hpp>
+#include <cstddef>
 #include <type_traits>
 #include <string>
 #include <string_view>
@@ -318,3 +319,43 @@ TEST_CASE ("Node - getName()", TAGS)
 	REQUIRE (child.hasName());
 	REQUIRE ((child.getName() == "foo"));
 }
+
+TEST_CASE ("Node - visit()", TAGS)
+{
+	const auto typeOf = [] (const Node& n)
+	{
+		return n.visit ([]<typename Value> (const Value&) -> std::string_view
+						{
+							if constexpr (std::is_same_v<Value, std::nullptr_t>)
+								return "null";
+							else if constexpr (std::is_same_v<Value, double>)
+								return "number";
+							else if constexpr (std::is_same_v<Value, std::string_view>)
+								return "string";
+							else if constexpr (std::is_same_v<Value, bool>)
+								return "boolean";
+							else if constexpr (std::is_same_v<Value, serial::Array>)
+								return "array";
+							else
+								return "object";
+						});
+	};
+
+	REQUIRE (typeOf (Node {}) == "null");
+	REQUIRE (typeOf (Node { ObjectType::Number }) == "number");
+	REQUIRE (typeOf (Node::createString ("hi")) == "string");
+	REQUIRE (typeOf (Node::createBoolean (true)) == "boolean");
+	REQUIRE (typeOf (Node { ObjectType::Array }) == "array");
+	REQUIRE (typeOf (Node { ObjectType::Object }) == "object");
+
+	const auto s = Node::createString ("hello world");
+
+	REQUIRE (s.visit ([] (const auto& value)
+					  {
+						  if constexpr (std::is_same_v<std::decay_t<decltype (value)>, std::string_view>)
+							  return value.size();
+						  else
+							  return std::size_t { 0 };
+					  })
+			 == 11UL);
+}
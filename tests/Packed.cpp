@@ -0,0 +1,191 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_Packed.h"
+#include "lserializing/lserializing_JSON.h"
+#include "lserializing/lserializing_KnownFormats.h"
+#include "TestData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <string_view>
+
+#define TAGS "[serializing][Packed]"
+
+namespace serial = limes::serializing;
+
+using serial::tests::bytes;
+
+static const std::string header { "LSPK\x01" };
+
+static std::size_t countOccurrences (std::string_view text, std::string_view pattern)
+{
+	std::size_t count { 0 };
+
+	for (auto pos = text.find (pattern); pos != std::string_view::npos; pos = text.find (pattern, pos + 1))
+		++count;
+
+	return count;
+}
+
+TEST_CASE ("Packed - encoding", TAGS)
+{
+	const serial::PackedFormat format;
+	const serial::JSONFormat   json;
+
+	SECTION ("Arrays of same-shaped objects are written as tables")
+	{
+		REQUIRE (format.serialize (json.parse (R"([ { "a": 1, "b": true }, { "b": false, "a": -1 } ])"))
+				 == header + bytes ({ 0x08, 0x02, 0x01, 'a', 0x01, 'b', 0x02, 0x03, 0x02, 0x02, 0x03, 0x01, 0x01 }));
+
+		// a later table with the same shape refers to it by number
+		REQUIRE (format.serialize (json.parse (R"({ "x": [ { "k": 0 }, { "k": 0 } ], "y": [ { "k": 1 }, { "k": 1 } ] })"))
+				 == header + bytes ({ 0x07, 0x02, 0x01, 'x', 0x08, 0x01, 0x01, 'k', 0x02, 0x03, 0x00, 0x03, 0x00,
+									  0x01, 'y', 0x09, 0x00, 0x02, 0x03, 0x02, 0x03, 0x02 }));
+	}
+
+	SECTION ("Other arrays are written normally")
+	{
+		REQUIRE (format.serialize (json.parse (R"([ { "a": 1 } ])")) == header + bytes ({ 0x06, 0x01, 0x07, 0x01, 0x01, 'a', 0x03, 0x02 }));
+		REQUIRE (format.serialize (json.parse (R"([ {}, {} ])")) == header + bytes ({ 0x06, 0x02, 0x07, 0x00, 0x07, 0x00 }));
+		REQUIRE (format.serialize (json.parse (R"([ { "a": 1 }, { "b": 1 } ])")).at (5) == 0x06);
+		REQUIRE (format.serialize (json.parse (R"([ { "a": 1 }, { "a": 1, "b": 1 } ])")).at (5) == 0x06);
+		REQUIRE (format.serialize (json.parse (R"([ { "a": 1 }, 1 ])")).at (5) == 0x06);
+	}
+
+	SECTION ("Numbers")
+	{
+		auto encodeNumber = [&format] (double number)
+		{
+			return format.serialize (serial::Node::createNumber (number));
+		};
+
+		REQUIRE (encodeNumber (0.) == header + bytes ({ 0x03, 0x00 }));
+		REQUIRE (encodeNumber (-1.) == header + bytes ({ 0x03, 0x01 }));
+		REQUIRE (encodeNumber (64.) == header + bytes ({ 0x03, 0x80, 0x01 }));
+		REQUIRE (encodeNumber (1.5) == header + bytes ({ 0x04, 0, 0, 0, 0, 0, 0, 0xF8, 0x3F }));
+		REQUIRE (encodeNumber (-0.) == header + bytes ({ 0x04, 0, 0, 0, 0, 0, 0, 0, 0x80 }));
+	}
+
+	SECTION ("Printers can be reused")
+	{
+		const auto node = json.parse (R"([ { "a": 1 }, { "a": 2 } ])");
+
+		const auto printer = format.createPrinter (false);
+
+		REQUIRE (printer->print (node) == printer->print (node));
+	}
+}
+
+TEST_CASE ("Packed - decoding", TAGS)
+{
+	const serial::PackedFormat format;
+	const serial::JSONFormat   json;
+
+	SECTION ("Round trip")
+	{
+		const auto node = json.parse (R"({ "records": [
+			{ "id": 1, "name": "first", "tags": [ 1, 2 ], "ok": true, "parent": null, "children": [ { "id": 3, "x": 0.5 }, { "id": 4, "x": -0.25 } ] },
+			{ "id": 2, "name": "héllo", "tags": [], "ok": false, "parent": { "id": 1 }, "children": [ { "id": 5, "x": 1e300 }, { "id": 6, "x": -9007199254740992 } ] },
+			{ "id": 7, "name": "", "tags": [ "mixed", 1, null ], "ok": true, "parent": [ { "z": 1 }, { "z": 2 } ], "children": [] } ],
+			"more": [ { "x": 1, "id": 9 }, { "id": 10, "x": 2 } ], "empty": [ {}, {} ] })");
+
+		const auto encoded = format.serialize (node);
+
+		REQUIRE (json.serialize (format.parse (encoded)) == json.serialize (node));
+
+		// each key is only written once
+		REQUIRE (countOccurrences (encoded, "name") == 1);
+		REQUIRE (countOccurrences (encoded, "children") == 1);
+
+		REQUIRE (format.probablyMatchesString (encoded));
+		REQUIRE (! json.probablyMatchesString (encoded));
+		REQUIRE (serial::KnownFormats::get().getFormatForFileExtension (".lspk") != nullptr);
+	}
+
+	SECTION ("Malformed input")
+	{
+		REQUIRE (! format.tryParse (""));
+		REQUIRE (! format.tryParse ("LSPK"));
+		REQUIRE (! format.tryParse (header + bytes ({})));
+		REQUIRE (! format.tryParse (header + bytes ({ 0x0A })));
+		REQUIRE (! format.tryParse (header + bytes ({ 0x00, 0x00 })));
+		REQUIRE (! format.tryParse (header + bytes ({ 0x03, 0x80 })));
+		REQUIRE (! format.tryParse (header + bytes ({ 0x04, 0x00 })));
+		REQUIRE (! format.tryParse (header + bytes ({ 0x05, 0x02, 'a' })));
+		REQUIRE (! format.tryParse (header + bytes ({ 0x06, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0x00 })));
+		REQUIRE (! format.tryParse (header + bytes ({ 0x07, 0x01, 0x00, 0x00 })));
+		REQUIRE (! format.tryParse (header + bytes ({ 0x07, 0x02, 0x01, 'a', 0x00, 0x01, 'a', 0x00 })));
+
+		// tables referring to a shape that isn't defined yet, an empty shape, unsorted or duplicate keys, and too many rows
+		REQUIRE (! format.tryParse (header + bytes ({ 0x09, 0x00, 0x01, 0x00 })));
+		REQUIRE (! format.tryParse (header + bytes ({ 0x08, 0x00, 0x05 })));
+		REQUIRE (! format.tryParse (header + bytes ({ 0x08, 0x02, 0x01, 'b', 0x01, 'a', 0x01, 0x00, 0x00 })));
+		REQUIRE (! format.tryParse (header + bytes ({ 0x08, 0x02, 0x01, 'a', 0x01, 'a', 0x01, 0x00, 0x00 })));
+		REQUIRE (! format.tryParse (header + bytes ({ 0x08, 0x02, 0x01, 'a', 0x01, 'b', 0x02, 0x00, 0x00 })));
+
+		REQUIRE (format.tryParse (header + bytes ({ 0x06, 0x02, 0x00, 0x0B })).getError().what() == std::string { "Unknown tag at byte 8" });
+
+		// deep nesting is rejected rather than overflowing the stack
+		auto nested = header;
+
+		for (auto i = 0; i < 100000; ++i)
+			nested += "\x06\x01";
+
+		REQUIRE (! format.tryParse (nested));
+
+		REQUIRE_THROWS_AS (format.parse ("LSPK"), serial::ParseError);
+	}
+
+	SECTION ("Tables with long keys and many rows")
+	{
+		// a table whose shape has one key of keyLength bytes, and numRows rows of nulls
+		auto makeTable = [] (std::size_t keyLength, std::size_t numRows)
+		{
+			auto appendVarint = [] (std::string& data, std::size_t value)
+			{
+				for (; value >= 0x80; value >>= 7)
+					data += static_cast<char> ((value & 0x7F) | 0x80);
+
+				data += static_cast<char> (value);
+			};
+
+			auto data = header + bytes ({ 0x08, 0x01 });
+
+			appendVarint (data, keyLength);
+			data.append (keyLength, 'k');
+			appendVarint (data, numRows);
+			data.append (numRows, '\0');
+
+			return data;
+		};
+
+		// 40 kB of input that would copy 400 MB of keys
+		REQUIRE (format.getLimits().maxTableKeyBytes == 64 * 1024 * 1024);
+		REQUIRE (format.tryParse (makeTable (20000, 20000)).getError().what() == std::string { "Tables copy too many bytes of keys at byte 20010" });
+
+		const auto table = makeTable (1000, 1000);
+
+		REQUIRE (format.parse (table).getArray().size() == 1000);
+
+		serial::PackedParserLimits limits;
+
+		limits.maxTableKeyBytes = 1000000;
+
+		REQUIRE (serial::PackedFormat { limits }.tryParse (table));
+
+		limits.maxTableKeyBytes = 999999;
+
+		REQUIRE (! serial::PackedFormat { limits }.tryParse (table));
+	}
+}
@@ -0,0 +1,446 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing.h"
+#include <catch2/catch_test_macros.hpp>
+#if ! defined(_WIN32)
+#	include <unistd.h>
+#endif
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define TAGS "[serializing][Printer]"
+
+namespace serial = limes::serializing;
+using Node		 = serial::Node;
+using ObjectType = serial::ObjectType;
+
+// prints nodes as S-expressions, with every value written straight into the sink
+class SExprPrinter final : public serial::Printer
+{
+private:
+	void printNull (serial::OutputSink& sink) final
+	{
+		sink.write ("nil");
+	}
+
+	void printNumber (double number, serial::OutputSink& sink) final
+	{
+		sink.write (std::to_string (static_cast<int> (number)));
+	}
+
+	void printString (std::string_view string, serial::OutputSink& sink) final
+	{
+		sink.write ('"');
+		sink.writeReferenced (string);
+		sink.write ('"');
+	}
+
+	void printBoolean (bool boolean, serial::OutputSink& sink) final
+	{
+		sink.write (boolean ? "#t" : "#f");
+	}
+
+	void printArray (const serial::Array& array, serial::OutputSink& sink) final
+	{
+		sink.write ("(list");
+
+		for (const auto& element : array)
+		{
+			sink.write (' ');
+			print (element, sink);
+		}
+
+		sink.write (')');
+	}
+
+	void printObject (const serial::Object& object, serial::OutputSink& sink) final
+	{
+		sink.write ("(dict");
+
+		for (const auto& [name, element] : object)
+		{
+			sink.write (" (");
+			sink.write (name);
+			sink.write (' ');
+			print (element, sink);
+			sink.write (')');
+		}
+
+		sink.write (')');
+	}
+
+	void arrayBegin() final
+	{
+		++numContainers;
+	}
+
+	void objectBegin() final
+	{
+		++numContainers;
+	}
+
+public:
+	int numContainers { 0 };
+};
+
+// the same output as SExprPrinter, with traversal resolved at compile time; only the array hooks are implemented
+class StaticSExprPrinter final : public serial::StaticPrinter<StaticSExprPrinter>
+{
+	friend class serial::StaticPrinter<StaticSExprPrinter>;
+
+	void printNull (serial::OutputSink& sink) final
+	{
+		sink.write ("nil");
+	}
+
+	void printNumber (double number, serial::OutputSink& sink) final
+	{
+		sink.write (std::to_string (static_cast<int> (number)));
+	}
+
+	void printString (std::string_view string, serial::OutputSink& sink) final
+	{
+		sink.write ('"');
+		sink.write (string);
+		sink.write ('"');
+	}
+
+	void printBoolean (bool boolean, serial::OutputSink& sink) final
+	{
+		sink.write (boolean ? "#t" : "#f");
+	}
+
+	void printArray (const serial::Array& array, serial::OutputSink& sink) final
+	{
+		sink.write ("(list");
+
+		for (const auto& element : array)
+		{
+			sink.write (' ');
+			print (element, sink);
+		}
+
+		sink.write (')');
+	}
+
+	void printObject (const serial::Object& object, serial::OutputSink& sink) final
+	{
+		sink.write ("(dict");
+
+		for (const auto& [name, element] : object)
+		{
+			sink.write (" (");
+			sink.write (name);
+			sink.write (' ');
+			print (element, sink);
+			sink.write (')');
+		}
+
+		sink.write (')');
+	}
+
+	void arrayBegin() final
+	{
+		++numArrays;
+	}
+
+public:
+	int numArrays { 0 };
+};
+
+static Node makeTestTree()
+{
+	Node root { ObjectType::Object };
+
+	root.addChildString ("test", "name");
+	root.addChildNumber (3., "count");
+
+	auto& list = root.addChildArray ("list");
+
+	list.addChildBoolean (true);
+	list.addChildNull();
+
+	return root;
+}
+
+static constexpr std::string_view expected { R"((dict (count 3) (list (list #t nil)) (name "test")))" };
+
+TEST_CASE ("Printer - printing into output sinks", TAGS)
+{
+	const auto root = makeTestTree();
+
+	SECTION ("String")
+	{
+		SExprPrinter printer;
+
+		REQUIRE (printer.print (root) == expected);
+		REQUIRE (printer.numContainers == 2);
+	}
+
+	SECTION ("StringSink")
+	{
+		std::string output { "prefix " };
+
+		serial::StringSink sink { output };
+
+		SExprPrinter {}.print (root, sink);
+
+		REQUIRE (output == "prefix " + std::string { expected });
+		REQUIRE (&sink.getString() == &output);
+	}
+
+	SECTION ("StreamSink")
+	{
+		std::ostringstream stream;
+
+		serial::StreamSink sink { stream };
+
+		SExprPrinter {}.print (root, sink);
+		sink.flush();
+
+		REQUIRE (stream.str() == expected);
+	}
+}
+
+TEST_CASE ("Printer - measuring output", TAGS)
+{
+	const auto root = makeTestTree();
+
+	SECTION ("measure")
+	{
+		SExprPrinter printer;
+
+		REQUIRE (printer.measure (root) == expected.size());
+	}
+
+	SECTION ("CountingSink")
+	{
+		serial::CountingSink sink;
+
+		SExprPrinter {}.print (root, sink);
+		SExprPrinter {}.print (root, sink);
+
+		REQUIRE (sink.getNumBytesWritten() == expected.size() * 2);
+	}
+
+	SECTION ("StringSink::reserve")
+	{
+		serial::StringSink sink;
+
+		sink.write ("prefix ");
+		sink.reserve (expected.size());
+
+		const auto capacity = sink.getString().capacity();
+
+		SExprPrinter {}.print (root, sink);
+
+		REQUIRE (sink.getString().capacity() == capacity);
+		REQUIRE (sink.getString() == "prefix " + std::string { expected });
+	}
+}
+
+TEST_CASE ("Printer - printing into a file", TAGS)
+{
+	const auto root = makeTestTree();
+
+	const auto path = std::filesystem::temp_directory_path() / "lserializing_Printer_FileSink.txt";
+
+	SECTION ("Small writes")
+	{
+		{
+			serial::FileSink sink { path };
+
+			SExprPrinter printer;
+
+			sink.reserve (printer.measure (root));
+
+			printer.print (root, sink);
+		}
+
+		std::ifstream	  stream { path, std::ios::binary };
+		const std::string contents { std::istreambuf_iterator<char> { stream }, std::istreambuf_iterator<char> {} };
+
+		REQUIRE (contents == expected);
+	}
+
+	SECTION ("Writes larger than the buffer")
+	{
+		const std::string big (200000, 'x');
+
+		{
+			serial::FileSink sink { path };
+
+			sink.write ('<');
+			sink.write (big);
+			sink.write (expected);
+			sink.flush();
+		}
+
+		std::ifstream	  stream { path, std::ios::binary };
+		const std::string contents { std::istreambuf_iterator<char> { stream }, std::istreambuf_iterator<char> {} };
+
+		REQUIRE (contents == "<" + big + std::string { expected });
+	}
+
+	std::filesystem::remove (path);
+
+	REQUIRE_THROWS_AS (serial::FileSink { path / "missing" / "file.txt" }, std::system_error);
+}
+
+TEST_CASE ("Printer - reusing a printer with a Serializer", TAGS)
+{
+	const auto root = makeTestTree();
+
+	auto printer = std::make_unique<SExprPrinter>();
+
+	auto& sexpr = *printer;
+
+	serial::Serializer serializer { std::move (printer) };
+
+	REQUIRE (&serializer.getPrinter() == &sexpr);
+
+	for (auto i = 0; i < 3; ++i)
+		REQUIRE (serializer.serialize (root) == expected);
+
+	REQUIRE (sexpr.numContainers == 6);
+
+	std::string output { "> " };
+
+	serializer.serializeInto (root, output);
+
+	REQUIRE (output == "> " + std::string { expected });
+
+	serializer.releaseBuffer();
+
+	REQUIRE (serializer.serialize (Node {}) == "nil");
+}
+
+TEST_CASE ("Printer - static printers", TAGS)
+{
+	const auto root = makeTestTree();
+
+	StaticSExprPrinter printer;
+
+	REQUIRE (printer.print (root) == expected);
+	REQUIRE (printer.numArrays == 1);
+
+	serial::Printer& virtualPrinter = printer;
+
+	serial::StringSink sink;
+
+	virtualPrinter.print (root, sink);
+
+	REQUIRE (sink.getString() == expected);
+	REQUIRE (virtualPrinter.measure (root) == expected.size());
+	REQUIRE (printer.numArrays == 3);
+}
+
+#if ! defined(_WIN32)
+
+// writes into a WritevSink connected to a pipe, and returns everything that came out of the other end
+template <typename WriteFunction>
+static std::string writeThroughPipe (WriteFunction&& writeFunction)
+{
+	int fds[2];
+
+	REQUIRE (::pipe (fds) == 0);
+
+	// the pipe holds much less than the output, so the writes block and are often partial
+	std::string received;
+
+	std::thread reader { [&received, fd = fds[0]]
+						 {
+							 char buffer[4096];
+
+							 for (auto n = ::read (fd, buffer, sizeof (buffer)); n > 0; n = ::read (fd, buffer, sizeof (buffer)))
+								 received.append (buffer, static_cast<std::size_t> (n));
+						 } };
+
+	{
+		serial::WritevSink sink { fds[1] };
+
+		writeFunction (sink);
+	}
+
+	::close (fds[1]);
+
+	reader.join();
+
+	::close (fds[0]);
+
+	return received;
+}
+
+TEST_CASE ("Printer - scatter-gather output", TAGS)
+{
+	// the referenced strings are long enough to get their own segments, and there are more of
+	// them than one writev() call accepts
+	std::vector<std::string> strings;
+
+	for (auto i = 0; i < 3000; ++i)
+		strings.emplace_back (600UL + static_cast<std::size_t> (i % 7), static_cast<char> ('a' + i % 26));
+
+	SECTION ("Writing")
+	{
+		const std::string big (200000, 'x');
+
+		std::string sent;
+
+		const auto received = writeThroughPipe ([&strings, &big, &sent] (serial::OutputSink& sink)
+												{
+													for (const auto& string : strings)
+													{
+														sink.write ('[');
+														sink.writeReferenced (string);
+														sink.write ("] ");
+														sink.writeReferenced ("short");
+
+														sent += '[' + string + "] short";
+													}
+
+													sink.write (big);
+													sink.flush();
+
+													sent += big;
+												});
+
+		REQUIRE (received.size() == sent.size());
+		REQUIRE (received == sent);
+	}
+
+	SECTION ("Printing")
+	{
+		Node root { ObjectType::Array };
+
+		for (const auto& string : strings)
+			root.addChildString (string, "");
+
+		const auto received = writeThroughPipe ([&root] (serial::OutputSink& sink)
+												{ SExprPrinter {}.print (root, sink); });
+
+		REQUIRE (received == SExprPrinter {}.print (root));
+	}
+}
+
+#endif
@@ -0,0 +1,208 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_Protobuf.h"
+#include "lserializing/lserializing_JSON.h"
+#include "TestData.h"
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#define TAGS "[serializing][Protobuf]"
+
+namespace serial = limes::serializing;
+
+using serial::tests::bytes;
+
+static serial::ProtobufFormat makeFormat (std::string_view descriptorJSON)
+{
+	return serial::ProtobufFormat { serial::JSONFormat {}.parse (descriptorJSON) };
+}
+
+// the messages from the examples in the protobuf encoding guide
+static constexpr auto encodingGuideDescriptor = R"({
+	"root": "Test",
+	"messages": {
+		"Test": {
+			"a": { "number": 1, "type": "int32" },
+			"b": { "number": 2, "type": "string" },
+			"c": { "number": 3, "type": "message", "message": "Test" },
+			"d": { "number": 4, "type": "sint32" },
+			"e": { "number": 5, "type": "fixed32" },
+			"f": { "number": 6, "type": "int32", "repeated": true },
+			"g": { "number": 7, "type": "string", "repeated": true },
+			"h": { "number": 8, "type": "int32", "repeated": true, "packed": false },
+			"i": { "number": 9, "type": "double" },
+			"j": { "number": 10, "type": "bool" },
+			"k": { "number": 2000, "type": "uint64" }
+		}
+	}
+})";
+
+TEST_CASE ("Protobuf - encoding", TAGS)
+{
+	const auto format = makeFormat (encodingGuideDescriptor);
+
+	const serial::JSONFormat json;
+
+	auto encode = [&format, &json] (std::string_view text)
+	{
+		return format.serialize (json.parse (text));
+	};
+
+	REQUIRE (encode (R"({ "a": 150 })") == bytes ({ 0x08, 0x96, 0x01 }));
+	REQUIRE (encode (R"({ "b": "testing" })") == bytes ({ 0x12, 0x07, 't', 'e', 's', 't', 'i', 'n', 'g' }));
+	REQUIRE (encode (R"({ "c": { "a": 150 } })") == bytes ({ 0x1A, 0x03, 0x08, 0x96, 0x01 }));
+	REQUIRE (encode (R"({ "d": -2 })") == bytes ({ 0x20, 0x03 }));
+	REQUIRE (encode (R"({ "e": 1 })") == bytes ({ 0x2D, 0x01, 0x00, 0x00, 0x00 }));
+	REQUIRE (encode (R"({ "f": [ 3, 270, 86942 ] })") == bytes ({ 0x32, 0x06, 0x03, 0x8E, 0x02, 0x9E, 0xA7, 0x05 }));
+	REQUIRE (encode (R"({ "g": [ "x", "y" ] })") == bytes ({ 0x3A, 0x01, 'x', 0x3A, 0x01, 'y' }));
+	REQUIRE (encode (R"({ "h": [ 1, 2 ] })") == bytes ({ 0x40, 0x01, 0x40, 0x02 }));
+	REQUIRE (encode (R"({ "i": 1.5 })") == bytes ({ 0x49, 0, 0, 0, 0, 0, 0, 0xF8, 0x3F }));
+	REQUIRE (encode (R"({ "j": true })") == bytes ({ 0x50, 0x01 }));
+	REQUIRE (encode (R"({ "k": 1 })") == bytes ({ 0x80, 0x7D, 0x01 }));
+
+	// negative int32s are sign-extended to 10 bytes
+	REQUIRE (encode (R"({ "a": -1 })") == bytes ({ 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 }));
+
+	// fields are written in number order, and null fields and empty repeated fields aren't written
+	REQUIRE (encode (R"({ "b": "", "a": 1, "c": null, "f": [] })") == bytes ({ 0x08, 0x01, 0x12, 0x00 }));
+
+	SECTION ("Nodes that don't fit the descriptor")
+	{
+		const auto printer = format.createPrinter (false);
+
+		REQUIRE_THROWS_AS (printer->print (json.parse (R"({ "z": 1 })")), std::runtime_error);
+		REQUIRE_THROWS_AS (printer->print (json.parse (R"({ "a": "1" })")), std::runtime_error);
+		REQUIRE_THROWS_AS (printer->print (json.parse (R"({ "a": 1.5 })")), std::runtime_error);
+		REQUIRE_THROWS_AS (printer->print (json.parse (R"({ "a": 3000000000 })")), std::runtime_error);
+		REQUIRE_THROWS_AS (printer->print (json.parse (R"({ "e": -1 })")), std::runtime_error);
+		REQUIRE_THROWS_AS (printer->print (json.parse (R"({ "f": 1 })")), std::runtime_error);
+		REQUIRE_THROWS_AS (printer->print (json.parse (R"({ "c": { "c": { "j": 1 } } })")), std::runtime_error);
+		REQUIRE_THROWS_AS (printer->print (json.parse ("[]")), std::runtime_error);
+
+		// serialize() is noexcept, so it can't throw
+		REQUIRE (encode (R"({ "z": 1 })").empty());
+		REQUIRE (encode (R"({ "c": { "c": { "j": 1 } } })").empty());
+		REQUIRE (encode ("[]").empty());
+	}
+}
+
+TEST_CASE ("Protobuf - decoding", TAGS)
+{
+	const auto format = makeFormat (encodingGuideDescriptor);
+
+	const serial::JSONFormat json;
+
+	SECTION ("Round trip")
+	{
+		const auto node = json.parse (R"({ "a": -5, "b": "héllo", "c": { "c": { "a": 1, "f": [ -1, 0, 1 ] } }, "d": -100000,
+"e": 4294967295, "f": [ 1, 300, -2 ], "g": [ "", "two" ], "h": [ 7, 8 ], "i": -0.25, "j": false, "k": 9007199254740992 })");
+
+		const auto encoded = format.serialize (node);
+
+		REQUIRE (encoded.size() < json.serialize (node).size());
+		REQUIRE (json.serialize (format.parse (encoded)) == json.serialize (node));
+
+		REQUIRE (! format.probablyMatchesString (encoded));
+	}
+
+	SECTION ("Other encoders' choices")
+	{
+		auto decodesTo = [&format, &json] (const std::string& data, std::string_view expectedJSON)
+		{
+			return json.serialize (format.parse (data)) == json.serialize (json.parse (expectedJSON));
+		};
+
+		// repeated numeric fields may be packed or not, whatever the descriptor says
+		REQUIRE (decodesTo (bytes ({ 0x30, 0x01, 0x30, 0x02, 0x32, 0x01, 0x03 }), R"({ "f": [ 1, 2, 3 ] })"));
+		REQUIRE (decodesTo (bytes ({ 0x42, 0x02, 0x01, 0x02, 0x40, 0x03 }), R"({ "h": [ 1, 2, 3 ] })"));
+
+		// unknown fields of every wire type are skipped
+		REQUIRE (decodesTo (bytes ({ 0x58, 0x01, 0x61, 0, 0, 0, 0, 0, 0, 0, 0, 0x6A, 0x01, 'x', 0x75, 0, 0, 0, 0, 0x08, 0x01 }), R"({ "a": 1 })"));
+
+		// the last value of a singular field wins, except for messages, which are merged
+		REQUIRE (decodesTo (bytes ({ 0x08, 0x01, 0x08, 0x02 }), R"({ "a": 2 })"));
+		REQUIRE (decodesTo (bytes ({ 0x1A, 0x02, 0x08, 0x01, 0x1A, 0x02, 0x20, 0x01 }), R"({ "c": { "a": 1, "d": -1 } })"));
+
+		// int32s may be written with only 5 bytes, and bools with any nonzero varint
+		REQUIRE (format.parse (bytes ({ 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F }))["a"].getNumber() == -1.);
+		REQUIRE (format.parse (bytes ({ 0x50, 0x02 }))["j"].getBoolean());
+	}
+
+	SECTION ("Malformed input")
+	{
+		REQUIRE (format.tryParse ("").getNode().getObject().empty());
+
+		REQUIRE (! format.tryParse (bytes ({ 0x08 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x08, 0x80 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x00, 0x01 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x0A, 0x01, 0x01 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x12, 0x05, 'a' })));
+		REQUIRE (! format.tryParse (bytes ({ 0x1B, 0x1C })));
+		REQUIRE (! format.tryParse (bytes ({ 0x0E, 0x01 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x2A, 0x03, 0x01, 0x02, 0x03 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x32, 0x01, 0x80 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x1A, 0x03, 0x08, 0x96 })));
+		REQUIRE (! format.tryParse (bytes ({ 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 })));
+
+		REQUIRE (format.tryParse (bytes ({ 0x08, 0x01, 0x12, 0x05, 'a' })).getError().what()
+				 == std::string { "Length is longer than the remaining data at byte 4" });
+
+		// deep nesting is rejected rather than overflowing the stack
+		std::string nested;
+
+		for (auto i = 0; i < 200; ++i)
+		{
+			auto length = nested.size();
+
+			std::string header { '\x1A' };
+
+			for (; length >= 0x80; length >>= 7)
+				header += static_cast<char> ((length & 0x7F) | 0x80);
+
+			nested = header + static_cast<char> (length) + nested;
+		}
+
+		REQUIRE (! format.tryParse (nested));
+
+		REQUIRE_THROWS_AS (format.parse (bytes ({ 0x08 })), serial::ParseError);
+	}
+}
+
+TEST_CASE ("Protobuf - descriptors", TAGS)
+{
+	auto makeDescriptor = [] (std::string_view field)
+	{
+		return std::string { R"({ "root": "M", "messages": { "M": { "x": )" } + std::string { field } + " } } }";
+	};
+
+	REQUIRE_NOTHROW (makeFormat (makeDescriptor (R"({ "number": 1, "type": "enum" })")));
+	REQUIRE_NOTHROW (makeFormat (makeDescriptor (R"({ "number": 536870911, "type": "sfixed64", "repeated": true })")));
+
+	REQUIRE_THROWS_AS (makeFormat (makeDescriptor (R"({ "number": 1, "type": "int" })")), serial::ProtobufDescriptorError);
+	REQUIRE_THROWS_AS (makeFormat (makeDescriptor (R"({ "type": "int32" })")), serial::ProtobufDescriptorError);
+	REQUIRE_THROWS_AS (makeFormat (makeDescriptor (R"({ "number": 0, "type": "int32" })")), serial::ProtobufDescriptorError);
+	REQUIRE_THROWS_AS (makeFormat (makeDescriptor (R"({ "number": 536870912, "type": "int32" })")), serial::ProtobufDescriptorError);
+	REQUIRE_THROWS_AS (makeFormat (makeDescriptor (R"({ "number": 1, "type": "message", "message": "N" })")), serial::ProtobufDescriptorError);
+	REQUIRE_THROWS_AS (makeFormat (makeDescriptor (R"({ "number": 1, "type": "int32", "repeated": 1 })")), serial::ProtobufDescriptorError);
+	REQUIRE_THROWS_AS (makeFormat (makeDescriptor ("1")), serial::ProtobufDescriptorError);
+
+	REQUIRE_THROWS_AS (makeFormat (R"({ "root": "N", "messages": { "M": {} } })"), serial::ProtobufDescriptorError);
+	REQUIRE_THROWS_AS (makeFormat (R"({ "root": "M" })"), serial::ProtobufDescriptorError);
+	REQUIRE_THROWS_AS (makeFormat (R"({ "root": "M", "messages": { "M": { "a": { "number": 1, "type": "bool" },
+"b": { "number": 1, "type": "bool" } } } })"),
+					   serial::ProtobufDescriptorError);
+}
@@ -0,0 +1,92 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <string_view>
+
+#define TAGS "[serializing][SHA256Sink]"
+
+namespace serial = limes::serializing;
+
+static std::string hashOf (std::string_view text)
+{
+	serial::SHA256Sink sink;
+
+	sink.write (text);
+
+	return sink.getHexDigest();
+}
+
+TEST_CASE ("SHA256Sink - test vectors", TAGS)
+{
+	// from FIPS 180-4 and the NIST example values
+	REQUIRE (hashOf ("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+	REQUIRE (hashOf ("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+	REQUIRE (hashOf ("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")
+			 == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+	REQUIRE (hashOf (std::string (1000000, 'a')) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST_CASE ("SHA256Sink - streaming", TAGS)
+{
+	const std::string text { "The quick brown fox jumps over the lazy dog, again and again and again." };
+
+	const auto expected = hashOf (text);
+
+	SECTION ("One character at a time")
+	{
+		serial::SHA256Sink sink;
+
+		for (const auto c : text)
+			sink.write (c);
+
+		REQUIRE (sink.getHexDigest() == expected);
+	}
+
+	SECTION ("Uneven pieces")
+	{
+		serial::SHA256Sink sink;
+
+		std::string_view remaining { text };
+
+		for (auto size = 1UL; ! remaining.empty(); size += 7)
+		{
+			const auto piece = remaining.substr (0, size);
+
+			sink.write (piece);
+			remaining.remove_prefix (piece.size());
+		}
+
+		REQUIRE (sink.getHexDigest() == expected);
+	}
+
+	SECTION ("Reading the digest doesn't end the stream")
+	{
+		serial::SHA256Sink sink;
+
+		sink.write ("ab");
+
+		REQUIRE (sink.getHexDigest() == hashOf ("ab"));
+
+		sink.write ('c');
+
+		REQUIRE (sink.getHexDigest() == hashOf ("abc"));
+
+		sink.reset();
+
+		REQUIRE (sink.getHexDigest() == hashOf (""));
+	}
+}
@@ -0,0 +1,36 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#pragma once
+
+#include <initializer_list>
+#include <string>
+
+// Helpers shared by the tests.
+
+namespace limes::serializing::tests
+{
+
+/** Returns a string holding the given bytes, so that binary documents can be written out in tests. */
+[[nodiscard]] inline std::string bytes (std::initializer_list<unsigned char> values)
+{
+	std::string result;
+
+	for (const auto value : values)
+		result += static_cast<char> (value);
+
+	return result;
+}
+
+}  // namespace limes::serializing::tests
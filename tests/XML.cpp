@@ -0,0 +1,353 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_XML.h"
+#include "lserializing/lserializing_JSON.h"
+#include "lserializing/lserializing_KnownFormats.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <string_view>
+
+#define TAGS "[serializing][XML]"
+
+namespace serial = limes::serializing;
+
+// parses the XML, and returns the result as JSON so that it can be compared with a literal
+static std::string toJSON (std::string_view xml)
+{
+	return serial::JSONFormat {}.serialize (serial::XMLFormat {}.parse (xml));
+}
+
+// reformats a JSON literal the way toJSON() does
+static std::string json (std::string_view text)
+{
+	const serial::JSONFormat format;
+
+	return format.serialize (format.parse (text));
+}
+
+TEST_CASE ("XML - mapping onto Nodes", TAGS)
+{
+	SECTION ("Elements, attributes and text")
+	{
+		REQUIRE (toJSON ("<a/>") == json (R"({"a":null})"));
+		REQUIRE (toJSON ("<a>text</a>") == json (R"({"a":"text"})"));
+		REQUIRE (toJSON (R"(<a x="1" y='two'/>)") == json (R"({"a":{"@x":"1","@y":"two"}})"));
+		REQUIRE (toJSON (R"(<a x="1">text</a>)") == json (R"({"a":{"#text":"text","@x":"1"}})"));
+		REQUIRE (toJSON ("<a><b>1</b><c/></a>") == json (R"({"a":{"b":"1","c":null}})"));
+	}
+
+	SECTION ("Repeated elements become arrays")
+	{
+		REQUIRE (toJSON ("<list><item>1</item><other/><item>2</item><item>3</item></list>")
+				 == json (R"({"list":{"item":["1","2","3"],"other":null}})"));
+
+		REQUIRE (toJSON ("<list><item id='a'/><item>text</item></list>") == json (R"({"list":{"item":[{"@id":"a"},"text"]}})"));
+	}
+
+	SECTION ("Whitespace between elements is dropped, but text is kept as it is")
+	{
+		REQUIRE (toJSON ("<a>\n  <b> padded </b>\n  <c>  </c>\n</a>") == json (R"({"a":{"b":" padded ","c":"  "}})"));
+
+		// mixed content is concatenated
+		REQUIRE (toJSON ("<p>Some <b>bold</b> text</p>") == json (R"({"p":{"#text":"Some  text","b":"bold"}})"));
+	}
+
+	SECTION ("Names keep their namespace prefixes")
+	{
+		REQUIRE (toJSON (R"(<ns:a xmlns:ns="urn:x"><ns:b-c.d>1</ns:b-c.d></ns:a>)") == json (R"({"ns:a":{"@xmlns:ns":"urn:x","ns:b-c.d":"1"}})"));
+	}
+
+	SECTION ("Non-ASCII names and text")
+	{
+		REQUIRE (toJSON ("<größe einheit='m²'>1,5</größe>") == json (R"({"größe":{"#text":"1,5","@einheit":"m²"}})"));
+	}
+}
+
+TEST_CASE ("XML - decoding", TAGS)
+{
+	SECTION ("Entities and character references")
+	{
+		REQUIRE (toJSON ("<a>&lt;&gt;&amp;&quot;&apos;</a>") == json (R"({"a":"<>&\"'"})"));
+		REQUIRE (toJSON ("<a>&#65;&#x42;&#x4a;</a>") == json (R"({"a":"ABJ"})"));
+		REQUIRE (toJSON ("<a>x &#233; &#x1F600; y</a>") == json ("{\"a\":\"x \xC3\xA9 \xF0\x9F\x98\x80 y\"}"));
+		REQUIRE (toJSON (R"(<a v="a &amp; b"/>)") == json (R"({"a":{"@v":"a & b"}})"));
+	}
+
+	SECTION ("Line breaks are normalized")
+	{
+		REQUIRE (toJSON ("<a>1\r\n2\r3\n4</a>") == json (R"({"a":"1\n2\n3\n4"})"));
+		REQUIRE (toJSON ("<a>&amp;\r\n</a>") == json (R"({"a":"&\n"})"));
+
+		// whitespace characters in attribute values become spaces, except ones written as references
+		REQUIRE (toJSON ("<a v='1\r\n2\t3&#10;4'/>") == json (R"({"a":{"@v":"1 2 3\n4"}})"));
+	}
+
+	SECTION ("CDATA sections, comments and processing instructions")
+	{
+		REQUIRE (toJSON ("<a><![CDATA[<not> &markup;]]></a>") == json (R"({"a":"<not> &markup;"})"));
+		REQUIRE (toJSON ("<a>1<!-- a <comment> -->2<?pi data?>3</a>") == json (R"({"a":"123"})"));
+		REQUIRE (toJSON ("<a><![CDATA[]]></a>") == json (R"({"a":null})"));
+	}
+
+	SECTION ("The prolog and epilog")
+	{
+		const auto document = "\xEF\xBB\xBF<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+							  "<!-- comment -->\n"
+							  "<!DOCTYPE note SYSTEM \"note.dtd\" [ <!ELEMENT note (#PCDATA)> <!ATTLIST note x CDATA \"a>b\"> ]>\n"
+							  "<note>hi</note>\n"
+							  "<!-- trailing --> <?pi?>\n";
+
+		REQUIRE (toJSON (document) == json (R"({"note":"hi"})"));
+	}
+}
+
+TEST_CASE ("XML - malformed input", TAGS)
+{
+	const serial::XMLFormat format;
+
+	REQUIRE (! format.tryParse (""));
+	REQUIRE (! format.tryParse ("text"));
+	REQUIRE (! format.tryParse ("<a>"));
+	REQUIRE (! format.tryParse ("<a></b>"));
+	REQUIRE (! format.tryParse ("<a><b></a></b>"));
+	REQUIRE (! format.tryParse ("<a/><b/>"));
+	REQUIRE (! format.tryParse ("<a/>text"));
+	REQUIRE (! format.tryParse ("<a x=1/>"));
+	REQUIRE (! format.tryParse ("<a x='1'y='2'/>"));
+	REQUIRE (! format.tryParse ("<a x='1' x='2'/>"));
+	REQUIRE (! format.tryParse ("<a x='<'/>"));
+	REQUIRE (! format.tryParse ("<a x='1/>"));
+	REQUIRE (! format.tryParse ("<a>&nbsp;</a>"));
+	REQUIRE (! format.tryParse ("<a>&amp</a>"));
+	REQUIRE (! format.tryParse ("<a>&#0;</a>"));
+	REQUIRE (! format.tryParse ("<a>&#xD800;</a>"));
+	REQUIRE (! format.tryParse ("<a>&#x110000;</a>"));
+	REQUIRE (! format.tryParse ("<a>&#12a;</a>"));
+	REQUIRE (! format.tryParse ("<a>&#X41;</a>"));
+	REQUIRE (! format.tryParse ("<a><!-- unterminated</a>"));
+	REQUIRE (! format.tryParse ("<a><![CDATA[unterminated</a>"));
+	REQUIRE (! format.tryParse ("<1a/>"));
+	REQUIRE (! format.tryParse ("<a>\xFF</a>"));
+
+	// an end tag before the root element
+	REQUIRE (! format.tryParse ("</a>"));
+	REQUIRE (! format.tryParse ("<?xml version='1.0'?>\n</a><a/>"));
+
+	const auto error = format.tryParse ("<a>\n  <b></c>\n</a>").getError();
+
+	REQUIRE (std::string_view { error.what() }.find ("</c>") != std::string_view::npos);
+
+	// deep nesting is rejected rather than overflowing the stack
+	std::string deep;
+
+	for (auto i = 0; i < 100000; ++i)
+		deep += "<a>";
+
+	REQUIRE (! format.tryParse (deep));
+
+	REQUIRE_THROWS_AS (format.parse ("<a>"), serial::ParseError);
+}
+
+TEST_CASE ("XML - SAX interface", TAGS)
+{
+	struct Recorder final : public serial::XMLHandler
+	{
+		void startElement (std::string_view name, std::span<const serial::XMLAttribute> attributes) final
+		{
+			events += "<" + std::string { name };
+
+			for (const auto& attribute : attributes)
+				events += " " + std::string { attribute.name } + "=" + std::string { attribute.value };
+
+			events += ">";
+		}
+
+		void endElement (std::string_view name) final
+		{
+			events += "</" + std::string { name } + ">";
+		}
+
+		void text (std::string_view text) final
+		{
+			events += "[" + std::string { text } + "]";
+		}
+
+		std::string events;
+	};
+
+	const serial::XMLFormat format;
+
+	Recorder recorder;
+
+	format.parse (R"(<a x="1 &amp; 2"><b/>t&lt;<!--c-->u<![CDATA[v]]></a>)", recorder);
+
+	REQUIRE (recorder.events == "<a x=1 & 2><b></b>[t<][u][v]</a>");
+
+	Recorder other;
+
+	REQUIRE_THROWS_AS (format.parse ("<a><b></a>", other), serial::ParseError);
+}
+
+TEST_CASE ("XML - printing", TAGS)
+{
+	const serial::XMLFormat	 format;
+	const serial::JSONFormat json;
+
+	serial::XMLPrinterOptions options;
+
+	options.writeDeclaration = false;
+
+	auto print = [&format, &options, &json] (std::string_view jsonText)
+	{
+		return format.createPrinter (options)->print (json.parse (jsonText));
+	};
+
+	SECTION ("Objects, arrays and scalars")
+	{
+		REQUIRE (print (R"({ "a": null })") == "<a/>");
+		REQUIRE (print (R"({ "a": { "b": 1.5, "c": true, "d": "text", "e": {} } })") == "<a><b>1.5</b><c>true</c><d>text</d><e/></a>");
+		REQUIRE (print (R"({ "list": { "item": [ 1, 2, { "x": 3 } ], "none": [] } })") == "<list><item>1</item><item>2</item><item><x>3</x></item></list>");
+		REQUIRE (print (R"({ "a": [ [ 1, 2 ], [] ] })") == "<root><a><item>1</item><item>2</item></a><a/></root>");
+		REQUIRE (print (R"([ 1, "two" ])") == "<root><item>1</item><item>two</item></root>");
+		REQUIRE (print (R"([ 1, [ 2, 3 ] ])") == "<root><item>1</item><item><item>2</item><item>3</item></item></root>");
+		REQUIRE (print (R"({ "a": [ [ [ 1 ] ] ] })") == "<root><a><item><item>1</item></item></a></root>");
+		REQUIRE (format.createPrinter (options)->print (serial::Node::createString ("just text")) == "<root>just text</root>");
+		REQUIRE (print (R"({ "a": 1, "b": 2 })") == "<root><a>1</a><b>2</b></root>");
+
+		options.rootElementName = "doc";
+
+		REQUIRE (print (R"({ "a": 1, "b": 2 })") == "<doc><a>1</a><b>2</b></doc>");
+	}
+
+	SECTION ("Attributes and text")
+	{
+		REQUIRE (print (R"({ "a": { "@id": "x", "@n": 2, "#text": "hi", "b": null } })") == R"(<a id="x" n="2">hi<b/></a>)");
+		REQUIRE (print (R"({ "a": { "@id": "x" } })") == R"(<a id="x"/>)");
+
+		// attributes can't hold arrays or objects, so those are written as elements
+		REQUIRE (print (R"({ "a": { "@list": [ 1 ] } })") == "<a><_list>1</_list></a>");
+
+		options.mapAttributes = false;
+
+		REQUIRE (print (R"({ "a": { "@id": "x", "#text": "hi" } })") == "<a><_text>hi</_text><_id>x</_id></a>");
+	}
+
+	SECTION ("Escaping")
+	{
+		REQUIRE (print (R"({ "a": "1 < 2 && 3 > \"2\"\r\n" })") == "<a>1 &lt; 2 &amp;&amp; 3 &gt; \"2\"&#13;\n</a>");
+		REQUIRE (print (R"({ "a": { "@v": "<\"&\"\t\n>" } })") == R"(<a v="&lt;&quot;&amp;&quot;&#9;&#10;&gt;"/>)");
+		REQUIRE (print (R"({ "a": "bell\u0007" })") == "<a>bell\xEF\xBF\xBD</a>");
+
+		// long runs are scanned in blocks, so put the special characters at different offsets
+		const std::string padding (37, 'x');
+
+		REQUIRE (print (R"({ "a": ")" + padding + "&" + padding + R"(" })") == "<a>" + padding + "&amp;" + padding + "</a>");
+	}
+
+	SECTION ("Names that aren't valid XML names")
+	{
+		REQUIRE (print (R"({ "a": { "1st": 1, "has space": 2, "ok-name.x": 4 } })")
+				 == "<a><_1st>1</_1st><has_space>2</has_space><ok-name.x>4</ok-name.x></a>");
+	}
+
+#if ! defined(_WIN32)
+	SECTION ("Repaired names are still valid when a WritevSink flushes")
+	{
+		// long enough that a WritevSink would keep a reference to it rather than copying it
+		const auto name = std::string (600, 'a') + " b";
+
+		serial::Node node { serial::ObjectType::Object };
+
+		node.getObject()[name] = serial::Node::createNumber (1);
+
+		auto* const file = std::tmpfile();
+
+		REQUIRE (file != nullptr);
+
+		{
+			serial::WritevSink sink { ::fileno (file) };
+
+			format.createPrinter (options)->print (node, sink);
+		}
+
+		std::rewind (file);
+
+		std::string written;
+
+		for (auto c = std::fgetc (file); c != EOF; c = std::fgetc (file))
+			written += static_cast<char> (c);
+
+		std::fclose (file);
+
+		const auto validName = std::string (600, 'a') + "_b";
+
+		REQUIRE (written == "<" + validName + ">1</" + validName + ">");
+	}
+#endif
+
+	SECTION ("Pretty printing")
+	{
+		options.prettyPrint		 = true;
+		options.writeDeclaration = true;
+
+		REQUIRE (print (R"({ "a": { "@id": 1, "b": [ 1, 2 ], "c": { "d": null }, "e": { "#text": "mixed", "f": "x" } } })")
+				 == "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+					"<a id=\"1\">\n"
+					"  <b>1</b>\n"
+					"  <b>2</b>\n"
+					"  <c>\n"
+					"    <d/>\n"
+					"  </c>\n"
+					"  <e>mixed<f>x</f></e>\n"
+					"</a>\n");
+	}
+
+	SECTION ("Printing and parsing round trip")
+	{
+		const auto node = format.parse (R"(<feed xmlns="urn:x"><entry id="1" lang="en"><title>A &amp; B</title><tag>x</tag><tag>y</tag></entry>)"
+										R"(<entry id="2"><title>Quote &quot; and &lt;tag&gt;</title><empty/></entry></feed>)");
+
+		options.writeDeclaration = true;
+
+		for (const auto pretty : { false, true })
+		{
+			options.prettyPrint = pretty;
+
+			const auto printed = format.createPrinter (options)->print (node);
+
+			REQUIRE (json.serialize (format.parse (printed)) == json.serialize (node));
+		}
+
+		REQUIRE (json.serialize (format.parse (format.serialize (node))) == json.serialize (node));
+	}
+}
+
+TEST_CASE ("XML - format detection", TAGS)
+{
+	const serial::XMLFormat format;
+
+	REQUIRE (format.probablyMatchesString ("<a/>"));
+	REQUIRE (format.probablyMatchesString ("  \n<?xml version='1.0'?><a/>"));
+	REQUIRE (format.probablyMatchesString ("\xEF\xBB\xBF<!DOCTYPE a><a/>"));
+	REQUIRE (! format.probablyMatchesString (R"({ "a": "<b>" })"));
+	REQUIRE (! format.probablyMatchesString ("< a"));
+	REQUIRE (! format.probablyMatchesString (""));
+
+	const auto& knownFormats = serial::KnownFormats::get();
+
+	REQUIRE (knownFormats.getFormatForFileExtension (".xml") == knownFormats.getFormatWithName (serial::formats::XML));
+}
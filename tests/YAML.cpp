@@ -0,0 +1,547 @@
+/*
+ * ======================================================================================
+ *  __    ____  __  __  ____  ___
+ * (  )  (_  _)(  \/  )( ___)/ __)
+ *  )(__  _)(_  )    (  )__) \__ \
+ * (____)(____)(_/\/\_)(____)(___/
+ *
+ *  This file is part of the Limes open source library and is licensed under the terms of the GNU Public License.
+ *
+ *  Commercial licenses are available; contact the maintainers at ben.the.vining@gmail.com to inquire for details.
+ *
+ * ======================================================================================
+ */
+
+#include "lserializing/lserializing_YAML.h"
+#include "lserializing/lserializing_JSON.h"
+#include "lserializing/lserializing_KnownFormats.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#define TAGS "[serializing][YAML]"
+
+namespace serial = limes::serializing;
+
+// parses the YAML, and returns the result as JSON so that it can be compared with a literal
+static std::string toJSON (std::string_view yaml)
+{
+	return serial::JSONFormat {}.serialize (serial::YAMLFormat {}.parse (yaml));
+}
+
+// reformats a JSON literal the way toJSON() does
+static std::string json (std::string_view text)
+{
+	const serial::JSONFormat format;
+
+	return format.serialize (format.parse (text));
+}
+
+TEST_CASE ("YAML - scalars", TAGS)
+{
+	const serial::YAMLFormat yaml;
+
+	SECTION ("Plain scalars are resolved with the core schema")
+	{
+		for (const auto* text : { "~", "null", "Null", "NULL", "" })
+			REQUIRE (yaml.parse (text).isNull());
+
+		REQUIRE (yaml.parse ("true").getBoolean());
+		REQUIRE (yaml.parse ("True").getBoolean());
+		REQUIRE (! yaml.parse ("FALSE").getBoolean());
+
+		REQUIRE (yaml.parse ("42").getNumber() == 42);
+		REQUIRE (yaml.parse ("-17").getNumber() == -17);
+		REQUIRE (yaml.parse ("+3").getNumber() == 3);
+		REQUIRE (yaml.parse ("0o17").getNumber() == 15);
+		REQUIRE (yaml.parse ("0x1F").getNumber() == 31);
+		REQUIRE (yaml.parse ("1.5").getNumber() == 1.5);
+		REQUIRE (yaml.parse ("-.5e2").getNumber() == -50);
+		REQUIRE (yaml.parse ("6.02E+23").getNumber() == 6.02e23);
+		REQUIRE (yaml.parse (".inf").getNumber() == INFINITY);
+		REQUIRE (yaml.parse ("-.Inf").getNumber() == -INFINITY);
+		REQUIRE (std::isnan (yaml.parse (".NaN").getNumber()));
+	}
+
+	SECTION ("Anything else is a string")
+	{
+		for (const auto* text : { "yes", "nul", "1.2.3", "0x", "0o9", "1e", "2001-12-14", "12:30", "." })
+		{
+			INFO (text);
+			REQUIRE (yaml.parse (text).isString());
+		}
+
+		REQUIRE (yaml.parse ("hello world").getString() == "hello world");
+		REQUIRE (yaml.parse ("a # comment").getString() == "a");
+		REQUIRE (yaml.parse ("a#b").getString() == "a#b");
+		REQUIRE (yaml.parse ("http://example.com:80/").getString() == "http://example.com:80/");
+	}
+
+	SECTION ("Quoted scalars are always strings")
+	{
+		REQUIRE (yaml.parse ("'true'").getString() == "true");
+		REQUIRE (yaml.parse ("\"42\"").getString() == "42");
+		REQUIRE (yaml.parse ("''").getString().empty());
+		REQUIRE (yaml.parse ("'it''s'").getString() == "it's");
+	}
+
+	SECTION ("Double-quoted escapes")
+	{
+		REQUIRE (yaml.parse (R"("a\tb\nc\\d\"e\/f")").getString() == "a\tb\nc\\d\"e/f");
+		REQUIRE (yaml.parse (R"("\x41\u00e9\U0001F600")").getString() == "A\xC3\xA9\xF0\x9F\x98\x80");
+		REQUIRE (yaml.parse (R"("\ud83d\ude00")").getString() == "\xF0\x9F\x98\x80");
+		REQUIRE (yaml.parse (R"("\_\N\L")").getString() == "\xC2\xA0\xC2\x85\xE2\x80\xA8");
+		REQUIRE (yaml.parse (R"("\0\e")").getString() == std::string { "\0\x1B", 2 });
+	}
+
+	SECTION ("Quoted scalars fold line breaks")
+	{
+		REQUIRE (yaml.parse ("\"one \n  two\n\n  three\"").getString() == "one two\nthree");
+		REQUIRE (yaml.parse ("'one\r\n  two'").getString() == "one two");
+
+		// an escaped line break joins the lines, and escaped blanks are kept
+		REQUIRE (yaml.parse ("\"one\\\n  two\"").getString() == "onetwo");
+		REQUIRE (yaml.parse ("\"one\\t\n  two\"").getString() == "one\t two");
+	}
+
+	SECTION ("Tags")
+	{
+		REQUIRE (yaml.parse ("!!str 42").getString() == "42");
+		REQUIRE (yaml.parse ("! true").getString() == "true");
+		REQUIRE (yaml.parse ("!<tag:yaml.org,2002:str> null").getString() == "null");
+		REQUIRE (yaml.parse ("!!int \"42\"").getNumber() == 42);
+		REQUIRE (yaml.parse ("!!float '1.5'").getNumber() == 1.5);
+		REQUIRE (yaml.parse ("!!bool 'true'").getBoolean());
+		REQUIRE (yaml.parse ("!!null ''").isNull());
+
+		// unknown tags are ignored
+		REQUIRE (yaml.parse ("!custom 42").getNumber() == 42);
+
+		REQUIRE (! yaml.tryParse ("!!int abc"));
+		REQUIRE (! yaml.tryParse ("!!bool yes"));
+	}
+}
+
+TEST_CASE ("YAML - block collections", TAGS)
+{
+	SECTION ("Mappings")
+	{
+		REQUIRE (toJSON ("a: 1\nb: two\nc:\n") == json (R"({"a":1,"b":"two","c":null})"));
+		REQUIRE (toJSON ("a:\n  b:\n    c: 1\n  d: 2\ne: 3") == json (R"({"a":{"b":{"c":1},"d":2},"e":3})"));
+		REQUIRE (toJSON ("'quoted key': 1\n\"1\": 2\n3: 4") == json (R"({"quoted key":1,"1":2,"3":4})"));
+		REQUIRE (toJSON ("a b: c d\nkey:value: x") == json (R"({"a b":"c d","key:value":"x"})"));
+	}
+
+	SECTION ("Sequences")
+	{
+		REQUIRE (toJSON ("- 1\n- two\n-\n- - a\n  - b") == json (R"([1,"two",null,["a","b"]])"));
+
+		// a sequence can be indented at the same level as its key
+		REQUIRE (toJSON ("a:\n- 1\n- 2\nb:\n  - 3") == json (R"({"a":[1,2],"b":[3]})"));
+	}
+
+	SECTION ("Compact nested collections")
+	{
+		REQUIRE (toJSON ("- a: 1\n  b: 2\n- c: 3") == json (R"([{"a":1,"b":2},{"c":3}])"));
+		REQUIRE (toJSON ("- - - x") == json (R"([[["x"]]])"));
+		REQUIRE (toJSON ("items:\n  - name: a\n    tags:\n      - x\n  - name: b")
+				 == json (R"({"items":[{"name":"a","tags":["x"]},{"name":"b"}]})"));
+	}
+
+	SECTION ("Multi-line plain scalars are folded")
+	{
+		REQUIRE (toJSON ("a: one\n  two\n\n  three\nb: x") == json (R"({"a":"one two\nthree","b":"x"})"));
+		REQUIRE (toJSON ("- one\n  two") == json (R"(["one two"])"));
+	}
+
+	SECTION ("Comments and blank lines")
+	{
+		REQUIRE (toJSON ("# header\n\na: 1 # trailing\n  # indented\n\nb: 2\n# end") == json (R"({"a":1,"b":2})"));
+		REQUIRE (toJSON ("a: \"x\" # comment") == json (R"({"a":"x"})"));
+	}
+
+	SECTION ("CRLF line breaks")
+	{
+		REQUIRE (toJSON ("a:\r\n  - 1\r\n  - 2\r\nb: |\r\n  x\r\n") == json (R"({"a":[1,2],"b":"x\n"})"));
+	}
+}
+
+TEST_CASE ("YAML - flow collections", TAGS)
+{
+	REQUIRE (toJSON ("[1, two, \"three\", [], {}]") == json (R"([1,"two","three",[],{}])"));
+	REQUIRE (toJSON ("{a: 1, b: [x, y], 'c': {d: e},}") == json (R"({"a":1,"b":["x","y"],"c":{"d":"e"}})"));
+	REQUIRE (toJSON ("key: [a,\n  b, # comment\n  c]") == json (R"({"key":["a","b","c"]})"));
+	REQUIRE (toJSON ("{a, b: }") == json (R"({"a":null,"b":null})"));
+	REQUIRE (toJSON ("[a: 1, b]") == json (R"([{"a":1},"b"])"));
+	REQUIRE (toJSON ("[http://x.com/a:b, c:d]") == json (R"(["http://x.com/a:b","c:d"])"));
+
+	// JSON is valid YAML
+	REQUIRE (toJSON (R"({"a":[1,2.5,true,null],"b":{"c":"d\u00e9"}})") == json (R"({"a":[1,2.5,true,null],"b":{"c":"dé"}})"));
+}
+
+TEST_CASE ("YAML - block scalars", TAGS)
+{
+	const serial::YAMLFormat yaml;
+
+	auto value = [&yaml] (std::string_view text)
+	{
+		return std::string { yaml.parse (text).getObject().at ("v").getString() };
+	};
+
+	SECTION ("Literal")
+	{
+		REQUIRE (value ("v: |\n  one\n    two\n\n  three\n") == "one\n  two\n\nthree\n");
+		REQUIRE (value ("v: |\n\n  after a blank line\nw: x") == "\nafter a blank line\n");
+		REQUIRE (value ("v: |  # comment\n  # not a comment\n") == "# not a comment\n");
+	}
+
+	SECTION ("Folded")
+	{
+		REQUIRE (value ("v: >\n  one\n  two\n\n  three\n    indented\n  four\n") == "one two\nthree\n  indented\nfour\n");
+	}
+
+	SECTION ("Chomping")
+	{
+		REQUIRE (value ("v: |\n  text\n\n\n") == "text\n");
+		REQUIRE (value ("v: |-\n  text\n\n\n") == "text");
+		REQUIRE (value ("v: |+\n  text\n\n\n") == "text\n\n\n");
+		REQUIRE (value ("v: |\n  text") == "text");
+	}
+
+	SECTION ("Indentation indicator")
+	{
+		REQUIRE (value ("v: |2\n    indented\n  less\n") == "  indented\nless\n");
+		REQUIRE (value ("v: >-2\n   x\n") == " x");
+	}
+
+	SECTION ("In sequences and at the top level")
+	{
+		REQUIRE (toJSON ("- |\n  a\n- >\n  b\n  c\n") == json (R"(["a\n","b c\n"])"));
+		REQUIRE (yaml.parse ("--- |\n  text\n").getString() == "text\n");
+	}
+}
+
+TEST_CASE ("YAML - documents", TAGS)
+{
+	const serial::YAMLFormat yaml;
+
+	SECTION ("A stream of several documents is an array")
+	{
+		REQUIRE (toJSON ("---\na: 1\n---\nb: 2\n") == json (R"([{"a":1},{"b":2}])"));
+		REQUIRE (toJSON ("a: 1\n...\n---\n- x\n...\n") == json (R"([{"a":1},["x"]])"));
+		REQUIRE (toJSON ("--- 1\n--- two\n---\n") == json (R"([1,"two",null])"));
+	}
+
+	SECTION ("A stream of one document is that document")
+	{
+		REQUIRE (toJSON ("%YAML 1.2\n---\na: 1\n...\n") == json (R"({"a":1})"));
+		REQUIRE (toJSON ("\xEF\xBB\xBF# comment\n---\n[1]") == json ("[1]"));
+	}
+
+	SECTION ("parseDocuments()")
+	{
+		const auto documents = yaml.parseDocuments ("# comment\n--- a\n---\n- b\n--- [c]\n");
+
+		REQUIRE (documents.size() == 3);
+		REQUIRE (documents[0].getString() == "a");
+		REQUIRE (documents[1].getArray().at (0).getString() == "b");
+		REQUIRE (documents[2].getArray().at (0).getString() == "c");
+
+		REQUIRE (yaml.parseDocuments ("# only a comment\n").empty());
+		REQUIRE (yaml.parseDocuments ("").empty());
+		REQUIRE (yaml.parse ("").isNull());
+
+		REQUIRE_THROWS_AS (yaml.parseDocuments ("---\na: [\n"), serial::ParseError);
+	}
+}
+
+TEST_CASE ("YAML - streaming documents", TAGS)
+{
+	const serial::YAMLFormat yaml;
+	const serial::JSONFormat jsonFormat;
+
+	// a stream large enough to be split up, with document markers in places that aren't document boundaries
+	std::string stream;
+
+	for (auto i = 0; i < 3000; ++i)
+	{
+		const auto idx = std::to_string (i);
+
+		stream += "--- # document " + idx + "\nid: " + idx + "\nbase: &b {x: " + idx + "}\nitem:\n  <<: *b\n  text: |\n    ---- not a marker\n"
+				+ "  plain: a\n    ---b\n  quoted: \"one\n    --- two\"\n  list: [x, y,\n    ---z]\n";
+
+		if (i % 100 == 0)
+			stream += "...\n%YAML 1.2\n";
+	}
+
+	const auto expected = yaml.parseDocuments (stream);
+
+	REQUIRE (expected.size() == 3000);
+	REQUIRE (expected[7].getObject().at ("item").getObject().at ("x").getNumber() == 7);
+
+	for (const auto numThreads : { std::size_t { 1 }, std::size_t { 4 }, std::size_t { 0 } })
+	{
+		INFO (numThreads);
+
+		std::vector<std::string> documents;
+
+		yaml.parseDocuments (
+			stream, [&] (serial::Node& document)
+			{
+				const auto moved = std::move (document);
+				documents.push_back (jsonFormat.serialize (moved));
+			},
+			numThreads);
+
+		REQUIRE (documents.size() == expected.size());
+
+		for (auto i = std::size_t { 0 }; i < documents.size(); ++i)
+			REQUIRE (documents[i] == jsonFormat.serialize (expected[i]));
+	}
+
+	SECTION ("Documents before an error are passed to the callback")
+	{
+		const auto invalid = stream + "---\na: [\n---\nb: 1\n";
+
+		for (const auto numThreads : { std::size_t { 1 }, std::size_t { 4 } })
+		{
+			auto numDocuments = std::size_t { 0 };
+
+			REQUIRE_THROWS_AS (yaml.parseDocuments (
+								   invalid, [&numDocuments] (serial::Node&)
+								   { ++numDocuments; },
+								   numThreads),
+							   serial::ParseError);
+
+			REQUIRE (numDocuments == 3000);
+		}
+	}
+
+	SECTION ("Anchors are local to their document")
+	{
+		REQUIRE (! yaml.tryParse ("a: &x 1\n---\nb: *x"));
+	}
+
+	SECTION ("Document markers can't be inside quoted scalars or flow collections")
+	{
+		REQUIRE (! yaml.tryParse ("a: \"x\n---\ny\""));
+		REQUIRE (! yaml.tryParse ("a: 'x\n...\n'"));
+		REQUIRE (! yaml.tryParse ("a: [x,\n---\n]"));
+	}
+}
+
+TEST_CASE ("YAML - anchors, aliases and merge keys", TAGS)
+{
+	const serial::YAMLFormat yaml;
+
+	SECTION ("Aliases are copies of the anchored nodes")
+	{
+		REQUIRE (toJSON ("a: &x 1\nb: *x\nc: &list [1, 2]\nd: *list") == json (R"({"a":1,"b":1,"c":[1,2],"d":[1,2]})"));
+		REQUIRE (toJSON ("base: &base\n  x: 1\ncopy: *base\nseq:\n- *base\n- &s str\n- *s")
+				 == json (R"({"base":{"x":1},"copy":{"x":1},"seq":[{"x":1},"str","str"]})"));
+
+		// an anchor can be redefined, and an alias refers to the most recent definition
+		REQUIRE (toJSON ("- &a 1\n- *a\n- &a 2\n- *a") == json ("[1,1,2,2]"));
+
+		// anchors on keys
+		REQUIRE (toJSON ("&k key: *k") == json (R"({"key":"key"})"));
+	}
+
+	SECTION ("Merge keys")
+	{
+		REQUIRE (toJSON ("defaults: &d\n  a: 1\n  b: 2\nitem:\n  <<: *d\n  b: 3")
+				 == json (R"({"defaults":{"a":1,"b":2},"item":{"a":1,"b":3}})"));
+
+		REQUIRE (toJSON ("- &a {x: 1, y: 1}\n- &b {y: 2, z: 2}\n- {<<: [*a, *b], w: 0}")
+				 == json (R"([{"x":1,"y":1},{"y":2,"z":2},{"w":0,"x":1,"y":1,"z":2}])"));
+
+		REQUIRE (! yaml.tryParse ("a:\n  <<: 1"));
+		REQUIRE (! yaml.tryParse ("a:\n  <<: [1]"));
+
+		// a quoted << is an ordinary key
+		REQUIRE (toJSON ("'<<': 1") == json (R"({"<<":1})"));
+	}
+
+	SECTION ("Aliases can't expand to too many nodes")
+	{
+		std::string text = "a0: &a0 [x, x, x, x, x, x, x, x, x, x]\n";
+
+		for (auto i = 1; i < 10; ++i)
+		{
+			const auto prev = "*a" + std::to_string (i - 1);
+
+			text += "a" + std::to_string (i) + ": &a" + std::to_string (i) + " [";
+
+			for (auto j = 0; j < 10; ++j)
+				text += prev + (j < 9 ? ", " : "]\n");
+		}
+
+		const auto result = yaml.tryParse (text);
+
+		REQUIRE (! result);
+	}
+
+	SECTION ("The alias limit can be changed")
+	{
+		// 200 aliases of a sequence of 10 Nodes
+		std::string text = "a: &a [1, 2, 3, 4, 5, 6, 7, 8, 9]\nb: [*a";
+
+		for (auto i = 1; i < 200; ++i)
+			text += ", *a";
+
+		text += "]\n";
+
+		REQUIRE (yaml.getLimits().maxAliasNodes == 1000000);
+		REQUIRE (yaml.tryParse (text));
+
+		serial::YAMLParserLimits limits;
+
+		limits.maxAliasNodes = 2000;
+
+		REQUIRE (serial::YAMLFormat { limits }.tryParse (text));
+
+		limits.maxAliasNodes = 1999;
+
+		REQUIRE (! serial::YAMLFormat { limits }.tryParse (text));
+		REQUIRE_THROWS_AS (serial::YAMLFormat { limits }.parseDocuments (text, [] (serial::Node&) { }, 4), serial::ParseError);
+	}
+}
+
+TEST_CASE ("YAML - malformed input", TAGS)
+{
+	const serial::YAMLFormat yaml;
+
+	for (const auto* text : {
+			 "a: 1\na: 2",			  // duplicate key
+			 "{a: 1, a: 2}",		  // duplicate key
+			 "a:\n\tb: 1",			  // tab indentation
+			 "a: 1\n  b: 2",		  // bad indentation
+			 "a:\n    b: 1\n  c: 2",  // bad indentation
+			 "a:\n  - b\n - c",		  // bad indentation
+			 "a: *unknown",			  // unknown alias
+			 "a: b: c",				  // mapping on the same line as its key
+			 "a: - b",				  // sequence on the same line as its key
+			 "[a, b",				  // unterminated flow sequence
+			 "{a: b",				  // unterminated flow mapping
+			 "\"unterminated",		  // unterminated string
+			 "\"\\q\"",				  // invalid escape
+			 "\"\\ud800\"",			  // lone surrogate
+			 "[a]: b",				  // flow collection as a key
+			 "? a\n: b",			  // explicit keys aren't supported
+			 "a: [b] c",			  // content after a value
+			 "a: |x\n  b",			  // bad block scalar header
+			 "a: \xFF",				  // invalid UTF-8
+		 })
+	{
+		INFO (text);
+		REQUIRE (! yaml.tryParse (text));
+		REQUIRE_THROWS_AS (yaml.parse (text), serial::ParseError);
+	}
+
+	SECTION ("Errors have a line and column")
+	{
+		try
+		{
+			auto result = yaml.parse ("a: 1\nb:\n  c: *nope\n");
+			FAIL ("Expected a ParseError");
+		}
+		catch (const serial::ParseError& error)
+		{
+			REQUIRE (std::string_view { error.what() }.find ("nope") != std::string_view::npos);
+		}
+	}
+
+	SECTION ("Deep nesting is an error rather than a crash")
+	{
+		REQUIRE (! yaml.tryParse (std::string (100000, '[')));
+
+		std::string nested;
+
+		for (auto i = std::size_t { 0 }; i < 1000; ++i)
+			nested += std::string (i * 2, ' ') + "-\n";
+
+		REQUIRE (! yaml.tryParse (nested));
+	}
+}
+
+TEST_CASE ("YAML - printing", TAGS)
+{
+	const serial::YAMLFormat yaml;
+	const serial::JSONFormat jsonFormat;
+
+	auto print = [&] (std::string_view jsonText)
+	{
+		return yaml.serialize (jsonFormat.parse (jsonText));
+	};
+
+	SECTION ("Block collections")
+	{
+		REQUIRE (print (R"({"a":1,"b":{"c":true,"d":null},"e":[1,[2,3],{"f":"g","h":[]}],"i":{}})")
+				 == "a: 1\nb:\n  c: true\n  d: null\ne:\n  - 1\n  - - 2\n    - 3\n  - f: g\n    h: []\ni: {}\n");
+
+		REQUIRE (print ("[]") == "[]\n");
+		REQUIRE (yaml.serialize (serial::Node::createString ("text")) == "text\n");
+	}
+
+	SECTION ("Strings are quoted when they would be read as something else")
+	{
+		REQUIRE (print (R"(["true","42","null","","- a","a: b","a #b"," pad","x:","#c","line\nbreak","tab\t","\"q\\"])")
+				 == "- \"true\"\n- \"42\"\n- \"null\"\n- \"\"\n- \"- a\"\n- \"a: b\"\n- \"a #b\"\n- \" pad\"\n- \"x:\"\n- \"#c\"\n"
+					"- \"line\\nbreak\"\n- \"tab\\t\"\n- \"\\\"q\\\\\"\n");
+
+		REQUIRE (print (R"(["plain text","a:b","a#b","1.2.3","ünïcode"])") == "- plain text\n- a:b\n- a#b\n- 1.2.3\n- ünïcode\n");
+	}
+
+	SECTION ("Numbers")
+	{
+		REQUIRE (print ("[0,-1.5,1e300]") == "- 0\n- -1.5\n- 1e+300\n");
+		REQUIRE (yaml.serialize (serial::Node::createNumber (-INFINITY)) == "-.inf\n");
+		REQUIRE (yaml.serialize (serial::Node::createNumber (NAN)) == ".nan\n");
+	}
+
+	SECTION ("Printing and parsing round trip")
+	{
+		const auto original = json (R"({"name":"x","tags":["a","true","",[]],"nested":[{"k":{"deep":[1,2,{"z":"\u0001\u007f"}]}}],"n":-0.25})");
+
+		REQUIRE (jsonFormat.serialize (yaml.parse (yaml.serialize (jsonFormat.parse (original)))) == original);
+	}
+
+	SECTION ("A \"<<\" key isn't read back as a merge key")
+	{
+		for (const auto* original : { R"({"<<":[]})", R"({"<<":1})", R"({"<<":{"a":1},"b":2})", R"(["<<"])" })
+			REQUIRE (toJSON (print (original)) == json (original));
+
+		REQUIRE (print (R"({"<<":1})") == "\"<<\": 1\n");
+	}
+
+	SECTION ("A string starting with a byte order mark keeps it")
+	{
+		for (const auto* original : { R"(["\ufeff"])", R"(["\ufeff1e3"])", R"({"\ufeffkey":"\ufeffvalue"})" })
+			REQUIRE (toJSON (print (original)) == json (original));
+
+		REQUIRE (yaml.parse (yaml.serialize (serial::Node::createString ("\xEF\xBB\xBFtext"))).getString() == "\xEF\xBB\xBFtext");
+	}
+}
+
+TEST_CASE ("YAML - format detection", TAGS)
+{
+	const serial::YAMLFormat yaml;
+
+	REQUIRE (yaml.probablyMatchesString ("a: 1\nb: [2]"));
+	REQUIRE (yaml.probablyMatchesString ("# comment\n- item"));
+	REQUIRE (yaml.probablyMatchesString ("---\njust a scalar"));
+	REQUIRE (yaml.probablyMatchesString ("%YAML 1.2\n---\n"));
+
+	REQUIRE (! yaml.probablyMatchesString ("just a scalar"));
+	REQUIRE (! yaml.probablyMatchesString (R"({"a":1})"));
+	REQUIRE (! yaml.probablyMatchesString ("[1, 2]"));
+	REQUIRE (! yaml.probablyMatchesString ("<xml/>"));
+	REQUIRE (! yaml.probablyMatchesString ("a: 1\na: 2"));
+
+	REQUIRE (serial::KnownFormats::get().getFormatForFileExtension (".yml") != nullptr);
+	REQUIRE (serial::KnownFormats::get().getFormatForFileExtension (".yml")->getName() == serial::formats::YAML);
+}